@@ -0,0 +1,100 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/nrf_rc_link.dir/DependInfo.cmake"
+  "CMakeFiles/crc_bench.dir/DependInfo.cmake"
+  "CMakeFiles/fec_codec_bench.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_irq.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_adapt.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_mailbox.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_diversity.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_diversity_irq.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_tier_full.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_fec.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_fec_p4.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_noack.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_noack_repeat.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_bulk.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_bulk_irq.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_trace.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_command.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_command_poll.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_bind.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_bind_scan.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_sync.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_sync_ack.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_schema.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_schema_ack.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_multi.dir/DependInfo.cmake"
+  "CMakeFiles/nrf_rc_link_sim_multi_irq.dir/DependInfo.cmake"
+  "CMakeFiles/link_bench.dir/DependInfo.cmake"
+  "CMakeFiles/link_bench_irq.dir/DependInfo.cmake"
+  "CMakeFiles/link_bench_adapt.dir/DependInfo.cmake"
+  "CMakeFiles/link_bench_mailbox.dir/DependInfo.cmake"
+  "CMakeFiles/link_bench_noack.dir/DependInfo.cmake"
+  "CMakeFiles/link_bench_noack_repeat.dir/DependInfo.cmake"
+  "CMakeFiles/diversity_bench.dir/DependInfo.cmake"
+  "CMakeFiles/diversity_bench_irq.dir/DependInfo.cmake"
+  "CMakeFiles/tier_bench.dir/DependInfo.cmake"
+  "CMakeFiles/tier_bench_full.dir/DependInfo.cmake"
+  "CMakeFiles/telemetry_bench.dir/DependInfo.cmake"
+  "CMakeFiles/fec_bench.dir/DependInfo.cmake"
+  "CMakeFiles/fec_bench_p4.dir/DependInfo.cmake"
+  "CMakeFiles/fec_bench_arq.dir/DependInfo.cmake"
+  "CMakeFiles/bulk_bench.dir/DependInfo.cmake"
+  "CMakeFiles/bulk_bench_irq.dir/DependInfo.cmake"
+  "CMakeFiles/trace_bench.dir/DependInfo.cmake"
+  "CMakeFiles/trace_bench_irq.dir/DependInfo.cmake"
+  "CMakeFiles/command_bench.dir/DependInfo.cmake"
+  "CMakeFiles/command_bench_poll.dir/DependInfo.cmake"
+  "CMakeFiles/bind_bench.dir/DependInfo.cmake"
+  "CMakeFiles/bind_bench_scan.dir/DependInfo.cmake"
+  "CMakeFiles/sync_bench.dir/DependInfo.cmake"
+  "CMakeFiles/sync_bench_ack.dir/DependInfo.cmake"
+  "CMakeFiles/schema_bench.dir/DependInfo.cmake"
+  "CMakeFiles/schema_bench_ack.dir/DependInfo.cmake"
+  "CMakeFiles/multi_bench.dir/DependInfo.cmake"
+  "CMakeFiles/multi_bench_irq.dir/DependInfo.cmake"
+  "CMakeFiles/trace_decode.dir/DependInfo.cmake"
+  )
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bind_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/bind_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/bind_bench.dir/bench/bind_bench.c.o"
+  "CMakeFiles/bind_bench.dir/bench/bind_bench.c.o.d"
+  "bind_bench"
+  "bind_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/bind_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bind_bench_scan.dir/bench/bench_common.c.o"
+  "CMakeFiles/bind_bench_scan.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/bind_bench_scan.dir/bench/bind_bench.c.o"
+  "CMakeFiles/bind_bench_scan.dir/bench/bind_bench.c.o.d"
+  "bind_bench_scan"
+  "bind_bench_scan.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/bind_bench_scan.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bulk_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/bulk_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/bulk_bench.dir/bench/bulk_bench.c.o"
+  "CMakeFiles/bulk_bench.dir/bench/bulk_bench.c.o.d"
+  "bulk_bench"
+  "bulk_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/bulk_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/bench/bench_common.c" "CMakeFiles/bulk_bench_irq.dir/bench/bench_common.c.o" "gcc" "CMakeFiles/bulk_bench_irq.dir/bench/bench_common.c.o.d"
+  "/root/repo/bench/bulk_bench.c" "CMakeFiles/bulk_bench_irq.dir/bench/bulk_bench.c.o" "gcc" "CMakeFiles/bulk_bench_irq.dir/bench/bulk_bench.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gb/CMakeFiles/nrf_rc_link_sim_bulk_irq.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
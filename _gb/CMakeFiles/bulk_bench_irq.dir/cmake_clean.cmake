@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bulk_bench_irq.dir/bench/bench_common.c.o"
+  "CMakeFiles/bulk_bench_irq.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/bulk_bench_irq.dir/bench/bulk_bench.c.o"
+  "CMakeFiles/bulk_bench_irq.dir/bench/bulk_bench.c.o.d"
+  "bulk_bench_irq"
+  "bulk_bench_irq.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/bulk_bench_irq.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
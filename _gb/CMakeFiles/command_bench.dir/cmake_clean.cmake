@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/command_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/command_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/command_bench.dir/bench/command_bench.c.o"
+  "CMakeFiles/command_bench.dir/bench/command_bench.c.o.d"
+  "command_bench"
+  "command_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/command_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/command_bench_poll.dir/bench/bench_common.c.o"
+  "CMakeFiles/command_bench_poll.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/command_bench_poll.dir/bench/command_bench.c.o"
+  "CMakeFiles/command_bench_poll.dir/bench/command_bench.c.o.d"
+  "command_bench_poll"
+  "command_bench_poll.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/command_bench_poll.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
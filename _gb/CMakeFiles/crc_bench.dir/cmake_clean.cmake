@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/crc_bench.dir/bench/crc_bench.c.o"
+  "CMakeFiles/crc_bench.dir/bench/crc_bench.c.o.d"
+  "CMakeFiles/crc_bench.dir/src/crc.c.o"
+  "CMakeFiles/crc_bench.dir/src/crc.c.o.d"
+  "crc_bench"
+  "crc_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/crc_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
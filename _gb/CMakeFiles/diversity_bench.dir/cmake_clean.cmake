@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/diversity_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/diversity_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/diversity_bench.dir/bench/diversity_bench.c.o"
+  "CMakeFiles/diversity_bench.dir/bench/diversity_bench.c.o.d"
+  "diversity_bench"
+  "diversity_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/diversity_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fec_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/fec_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/fec_bench.dir/bench/fec_bench.c.o"
+  "CMakeFiles/fec_bench.dir/bench/fec_bench.c.o.d"
+  "fec_bench"
+  "fec_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/fec_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
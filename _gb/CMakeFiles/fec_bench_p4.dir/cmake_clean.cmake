@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fec_bench_p4.dir/bench/bench_common.c.o"
+  "CMakeFiles/fec_bench_p4.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/fec_bench_p4.dir/bench/fec_bench.c.o"
+  "CMakeFiles/fec_bench_p4.dir/bench/fec_bench.c.o.d"
+  "fec_bench_p4"
+  "fec_bench_p4.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/fec_bench_p4.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,20 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/bench/fec_codec_bench.c" "CMakeFiles/fec_codec_bench.dir/bench/fec_codec_bench.c.o" "gcc" "CMakeFiles/fec_codec_bench.dir/bench/fec_codec_bench.c.o.d"
+  "/root/repo/src/fec.c" "CMakeFiles/fec_codec_bench.dir/src/fec.c.o" "gcc" "CMakeFiles/fec_codec_bench.dir/src/fec.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
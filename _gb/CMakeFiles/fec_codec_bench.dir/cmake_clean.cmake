@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fec_codec_bench.dir/bench/fec_codec_bench.c.o"
+  "CMakeFiles/fec_codec_bench.dir/bench/fec_codec_bench.c.o.d"
+  "CMakeFiles/fec_codec_bench.dir/src/fec.c.o"
+  "CMakeFiles/fec_codec_bench.dir/src/fec.c.o.d"
+  "fec_codec_bench"
+  "fec_codec_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/fec_codec_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/link_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/link_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/link_bench.dir/bench/link_bench.c.o"
+  "CMakeFiles/link_bench.dir/bench/link_bench.c.o.d"
+  "link_bench"
+  "link_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/link_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/multi_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/multi_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/multi_bench.dir/bench/multi_bench.c.o"
+  "CMakeFiles/multi_bench.dir/bench/multi_bench.c.o.d"
+  "multi_bench"
+  "multi_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/multi_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
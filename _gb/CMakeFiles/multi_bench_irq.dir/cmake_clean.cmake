@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/multi_bench_irq.dir/bench/bench_common.c.o"
+  "CMakeFiles/multi_bench_irq.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/multi_bench_irq.dir/bench/multi_bench.c.o"
+  "CMakeFiles/multi_bench_irq.dir/bench/multi_bench.c.o.d"
+  "multi_bench_irq"
+  "multi_bench_irq.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/multi_bench_irq.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,31 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/nrf_rc_link.dir/drivers/nrf24.c.o"
+  "CMakeFiles/nrf_rc_link.dir/drivers/nrf24.c.o.d"
+  "CMakeFiles/nrf_rc_link.dir/src/bind.c.o"
+  "CMakeFiles/nrf_rc_link.dir/src/bind.c.o.d"
+  "CMakeFiles/nrf_rc_link.dir/src/bulk.c.o"
+  "CMakeFiles/nrf_rc_link.dir/src/bulk.c.o.d"
+  "CMakeFiles/nrf_rc_link.dir/src/channel_pack.c.o"
+  "CMakeFiles/nrf_rc_link.dir/src/channel_pack.c.o.d"
+  "CMakeFiles/nrf_rc_link.dir/src/clock_sync.c.o"
+  "CMakeFiles/nrf_rc_link.dir/src/clock_sync.c.o.d"
+  "CMakeFiles/nrf_rc_link.dir/src/crc.c.o"
+  "CMakeFiles/nrf_rc_link.dir/src/crc.c.o.d"
+  "CMakeFiles/nrf_rc_link.dir/src/fec.c.o"
+  "CMakeFiles/nrf_rc_link.dir/src/fec.c.o.d"
+  "CMakeFiles/nrf_rc_link.dir/src/fhss.c.o"
+  "CMakeFiles/nrf_rc_link.dir/src/fhss.c.o.d"
+  "CMakeFiles/nrf_rc_link.dir/src/nrf_rc_driver.c.o"
+  "CMakeFiles/nrf_rc_link.dir/src/nrf_rc_driver.c.o.d"
+  "CMakeFiles/nrf_rc_link.dir/src/telemetry_mux.c.o"
+  "CMakeFiles/nrf_rc_link.dir/src/telemetry_mux.c.o.d"
+  "CMakeFiles/nrf_rc_link.dir/src/trace.c.o"
+  "CMakeFiles/nrf_rc_link.dir/src/trace.c.o.d"
+  "libnrf_rc_link.a"
+  "libnrf_rc_link.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/nrf_rc_link.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libnrf_rc_link.a"
+)
@@ -0,0 +1,35 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/drivers/nrf24.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/drivers/nrf24.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/sim/sim_hal.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/sim/sim_hal.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/sim/sim_radio.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/sim/sim_radio.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/bind.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/bind.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/bulk.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/bulk.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/channel_pack.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/channel_pack.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/clock_sync.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/clock_sync.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/crc.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/crc.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/fec.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/fec.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/fhss.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/fhss.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/nrf_rc_driver.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/nrf_rc_driver.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/telemetry_mux.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/telemetry_mux.c.o.d"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/trace.c.o"
+  "CMakeFiles/nrf_rc_link_sim_tier.dir/src/trace.c.o.d"
+  "libnrf_rc_link_sim_tier.a"
+  "libnrf_rc_link_sim_tier.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/nrf_rc_link_sim_tier.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,31 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/drivers/nrf24.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/drivers/nrf24.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/drivers/nrf24.c.o.d"
+  "/root/repo/sim/sim_hal.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/sim/sim_hal.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/sim/sim_hal.c.o.d"
+  "/root/repo/sim/sim_radio.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/sim/sim_radio.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/sim/sim_radio.c.o.d"
+  "/root/repo/src/bind.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/bind.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/bind.c.o.d"
+  "/root/repo/src/bulk.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/bulk.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/bulk.c.o.d"
+  "/root/repo/src/channel_pack.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/channel_pack.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/channel_pack.c.o.d"
+  "/root/repo/src/clock_sync.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/clock_sync.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/clock_sync.c.o.d"
+  "/root/repo/src/crc.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/crc.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/crc.c.o.d"
+  "/root/repo/src/fec.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/fec.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/fec.c.o.d"
+  "/root/repo/src/fhss.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/fhss.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/fhss.c.o.d"
+  "/root/repo/src/nrf_rc_driver.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/nrf_rc_driver.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/nrf_rc_driver.c.o.d"
+  "/root/repo/src/telemetry_mux.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/telemetry_mux.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/telemetry_mux.c.o.d"
+  "/root/repo/src/trace.c" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/trace.c.o" "gcc" "CMakeFiles/nrf_rc_link_sim_trace_irq.dir/src/trace.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/schema_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/schema_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/schema_bench.dir/bench/schema_bench.c.o"
+  "CMakeFiles/schema_bench.dir/bench/schema_bench.c.o.d"
+  "schema_bench"
+  "schema_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/schema_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
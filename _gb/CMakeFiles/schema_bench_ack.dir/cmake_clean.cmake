@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/schema_bench_ack.dir/bench/bench_common.c.o"
+  "CMakeFiles/schema_bench_ack.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/schema_bench_ack.dir/bench/schema_bench.c.o"
+  "CMakeFiles/schema_bench_ack.dir/bench/schema_bench.c.o.d"
+  "schema_bench_ack"
+  "schema_bench_ack.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/schema_bench_ack.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
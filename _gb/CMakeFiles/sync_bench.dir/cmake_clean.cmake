@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sync_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/sync_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/sync_bench.dir/bench/sync_bench.c.o"
+  "CMakeFiles/sync_bench.dir/bench/sync_bench.c.o.d"
+  "sync_bench"
+  "sync_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/sync_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/telemetry_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/telemetry_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/telemetry_bench.dir/bench/telemetry_bench.c.o"
+  "CMakeFiles/telemetry_bench.dir/bench/telemetry_bench.c.o.d"
+  "telemetry_bench"
+  "telemetry_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/telemetry_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
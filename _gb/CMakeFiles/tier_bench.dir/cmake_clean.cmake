@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tier_bench.dir/bench/bench_common.c.o"
+  "CMakeFiles/tier_bench.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/tier_bench.dir/bench/tier_bench.c.o"
+  "CMakeFiles/tier_bench.dir/bench/tier_bench.c.o.d"
+  "tier_bench"
+  "tier_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/tier_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
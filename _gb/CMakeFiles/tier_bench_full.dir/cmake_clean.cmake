@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tier_bench_full.dir/bench/bench_common.c.o"
+  "CMakeFiles/tier_bench_full.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/tier_bench_full.dir/bench/tier_bench.c.o"
+  "CMakeFiles/tier_bench_full.dir/bench/tier_bench.c.o.d"
+  "tier_bench_full"
+  "tier_bench_full.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/tier_bench_full.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/trace_bench_irq.dir/bench/bench_common.c.o"
+  "CMakeFiles/trace_bench_irq.dir/bench/bench_common.c.o.d"
+  "CMakeFiles/trace_bench_irq.dir/bench/trace_bench.c.o"
+  "CMakeFiles/trace_bench_irq.dir/bench/trace_bench.c.o.d"
+  "trace_bench_irq"
+  "trace_bench_irq.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/trace_bench_irq.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
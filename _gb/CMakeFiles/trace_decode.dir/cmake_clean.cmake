@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/trace_decode.dir/src/trace.c.o"
+  "CMakeFiles/trace_decode.dir/src/trace.c.o.d"
+  "CMakeFiles/trace_decode.dir/tools/trace_decode.c.o"
+  "CMakeFiles/trace_decode.dir/tools/trace_decode.c.o.d"
+  "trace_decode"
+  "trace_decode.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/trace_decode.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,275 @@
+/**
+* @file async_bench.c
+ * @brief Async (SPI DMA) API on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t with RC_ENABLE_SPI_DMA, driven
+ * only through the async calls: the ground sends commands with
+ * rc_link_send_command_async() and keeps a telemetry receive armed, the
+ * aircraft keeps a command receive armed and answers every
+ * BENCH_TELEMETRY_DIV commands with rc_link_send_telemetry_async(). Every
+ * outcome arrives through the rc_link_set_async_callback() callback, in
+ * interrupt context. Per scenario it reports:
+ *   - commands delivered per second and delivery ratio
+ *   - latency from the send call to the aircraft's receive callback
+ *     (p50 / p99 / max)
+ *   - command sends the callback reported ACKed, lost (no ACK) or failed
+ *     (SPI error), and starts refused as busy
+ *   - telemetry sent and received
+ *   - CRC-catch rate, as in link_bench
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * async_bench (RC_ENABLE_SPI_DMA) or async_bench_ack (telemetry on ACK
+ * payloads). Times are virtual, so results are reproducible for a given
+ * seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "packet.h"
+#include "sim.h"
+#include "bench_common.h"
+#include <stdio.h>
+#include <string.h>
+
+/** Aircraft answers every Nth command with telemetry */
+#define BENCH_TELEMETRY_DIV 10
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+    uint32_t rate_hz;           /* 0 = send as fast as the link allows */
+    uint32_t duration_ms;
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t busy;              /* Starts refused with RC_ERROR_BUSY */
+    uint32_t acked;
+    uint32_t lost;
+    uint32_t failed;
+    uint32_t received;
+    uint32_t escaped;           /* Delivered with wrong contents */
+    uint32_t telemetry_sent;
+    uint32_t telemetry_received;
+    bench_latency_t latency;
+} bench_result_t;
+
+/** Async buffers and state of one end (shared with its callback) */
+typedef struct {
+    volatile bool tx_active;
+    volatile bool telemetry_due;
+    rc_command_payload_t command;
+    rc_telemetry_payload_t telemetry;
+} bench_end_t;
+
+static uint64_t sent_at_us[65536];
+static bench_result_t result;
+static bench_end_t ground_end;
+static bench_end_t aircraft_end;
+
+/*============================================================================*/
+/* Callbacks                                                                  */
+/*============================================================================*/
+
+static void ground_callback(rc_link_t *link, uint8_t type, rc_status_t status, void *ctx)
+{
+    bench_end_t *end = (bench_end_t *)ctx;
+
+    if (type == RC_PKT_COMMAND) {
+        if (status == RC_OK) {
+            result.acked++;
+        } else if (status == RC_ERROR_TIMEOUT) {
+            result.lost++;
+        } else {
+            result.failed++;
+        }
+        end->tx_active = false;
+    } else if (type == RC_PKT_TELEMETRY) {
+        result.telemetry_received++;
+        rc_link_receive_telemetry_async(link, &end->telemetry);
+    }
+}
+
+static void aircraft_callback(rc_link_t *link, uint8_t type, rc_status_t status, void *ctx)
+{
+    bench_end_t *end = (bench_end_t *)ctx;
+
+    if (type == RC_PKT_TELEMETRY) {
+        end->tx_active = false;
+        return;
+    }
+
+    if (type != RC_PKT_COMMAND || status != RC_OK) {
+        return;
+    }
+
+    if (bench_command_valid(&end->command)) {
+        result.received++;
+        bench_record_latency(&result.latency,
+                             (uint32_t)(sim_time_us() - sent_at_us[end->command.channels[7]]));
+
+        if (result.received % BENCH_TELEMETRY_DIV == 0) {
+            end->telemetry_due = true;
+        }
+    } else {
+        result.escaped++;
+    }
+
+    rc_link_receive_command_async(link, &end->command);
+}
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc)
+{
+    memset(&result, 0, sizeof(result));
+    memset(&ground_end, 0, sizeof(ground_end));
+    memset(&aircraft_end, 0, sizeof(aircraft_end));
+
+    bench_pair_t pair;
+    bench_pair_start(&pair, 2, NULL, NULL, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    rc_link_set_async_callback(ground, ground_callback, &ground_end);
+    rc_link_set_async_callback(aircraft, aircraft_callback, &aircraft_end);
+    rc_link_receive_telemetry_async(ground, &ground_end.telemetry);
+    rc_link_receive_command_async(aircraft, &aircraft_end.command);
+
+    uint64_t end_us = (uint64_t)sc->duration_ms * 1000U;
+    uint64_t interval_us = sc->rate_hz ? 1000000U / sc->rate_hz : 0;
+    uint64_t next_send_us = 0;
+    uint16_t next_id = 0;
+    bool pending = false;
+    rc_command_payload_t cmd;
+
+    while (sim_time_us() < end_us) {
+        uint64_t now = sim_time_us();
+
+        /* Ground: one command in flight at a time */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (!pending && now >= next_send_us) {
+            bench_command(&cmd, next_id);
+            pending = true;
+            next_send_us = interval_us ? next_send_us + interval_us : now;
+        }
+
+        if (pending && !ground_end.tx_active) {
+            sent_at_us[next_id] = now;
+            ground_end.tx_active = true;
+
+            rc_status_t status = rc_link_send_command_async(ground, &cmd);
+            if (status == RC_OK) {
+                pending = false;
+                next_id++;
+                result.sent++;
+            } else {
+                ground_end.tx_active = false;
+                result.busy++;
+            }
+        }
+
+        /* Aircraft: the callback takes commands, telemetry goes out here */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        if (aircraft_end.telemetry_due && !aircraft_end.tx_active) {
+            rc_telemetry_payload_t telem;
+            memset(&telem, 0, sizeof(telem));
+            telem.battery_mv = 11100;
+            telem.gps_sats = 9;
+
+            aircraft_end.tx_active = true;
+            if (rc_link_send_telemetry_async(aircraft, &telem) == RC_OK) {
+                aircraft_end.telemetry_due = false;
+                result.telemetry_sent++;
+            } else {
+                aircraft_end.tx_active = false;
+            }
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+    rc_link_set_async_callback(ground, NULL, NULL);
+    rc_link_set_async_callback(aircraft, NULL, NULL);
+
+    rc_stats_t gs, as;
+    rc_link_get_stats(ground, &gs);
+    rc_link_get_stats(aircraft, &as);
+    uint32_t caught = gs.crc_errors + gs.version_mismatches +
+                      as.crc_errors + as.version_mismatches;
+
+    bench_check(sc->name, "deliv",
+                result.sent ? 100.0 * result.received / result.sent : BENCH_MISSING);
+    bench_check(sc->name, "p99us",
+                result.latency.count ? bench_percentile(&result.latency, 99) : BENCH_MISSING);
+    bench_check(sc->name, "err", result.failed);
+    bench_check(sc->name, "tlm rx", result.telemetry_received);
+    bench_check(sc->name, "crc",
+                (caught + result.escaped) ? 100.0 * caught / (caught + result.escaped)
+                                          : BENCH_MISSING);
+
+    printf("%-14s %7lu %8.0f %6.1f%% %7lu %7lu %7lu %6lu %5lu %4lu %6lu %6lu/%-6lu",
+           sc->name,
+           (unsigned long)result.sent,
+           (double)result.received * 1000.0 / sc->duration_ms,
+           result.sent ? 100.0 * result.received / result.sent : 0.0,
+           (unsigned long)bench_percentile(&result.latency, 50),
+           (unsigned long)bench_percentile(&result.latency, 99),
+           (unsigned long)result.latency.max_us,
+           (unsigned long)result.acked,
+           (unsigned long)result.lost,
+           (unsigned long)result.failed,
+           (unsigned long)result.busy,
+           (unsigned long)result.telemetry_sent,
+           (unsigned long)result.telemetry_received);
+
+    if (caught + result.escaped) {
+        printf(" %5.1f%%", 100.0 * caught / (caught + result.escaped));
+    } else {
+        printf(" %6s", "-");
+    }
+
+    printf("\n");
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t lossy = clean;
+    lossy.loss = 0.10;
+
+    sim_channel_t corrupt = clean;
+    corrupt.corrupt = 0.01;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean max",  clean,   0,  2000 },
+        { "clean 50Hz", clean,   50, 5000 },
+        { "loss 10%",   lossy,   50, 5000 },
+        { "corrupt 1%", corrupt, 0,  5000 },
+    };
+
+    printf("nrf_rc_link async API (SPI DMA%s, %u us step)\n",
+           RC_ENABLE_ACK_TELEMETRY ? ", ACK telemetry" : "", BENCH_STEP_US);
+    printf("%-14s %7s %8s %7s %7s %7s %7s %6s %5s %4s %6s %13s %6s\n",
+           "scenario", "sent", "rx/s", "deliv", "p50us", "p99us", "maxus",
+           "acked", "lost", "err", "busy", "tlm tx/rx", "crc");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i]);
+    }
+
+    return bench_finish();
+}
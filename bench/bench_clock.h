@@ -0,0 +1,67 @@
+/**
+ * @file bench_clock.h
+ * @brief Timing source of the codec microbenchmarks
+ *
+ * Nanoseconds from CLOCK_MONOTONIC on the host; DWT cycles with
+ * -DRC_BENCH_ON_TARGET. Header only, so a bench still builds into firmware
+ * as its one .c file. Include it before any other header: the host branch
+ * needs _POSIX_C_SOURCE set ahead of the system headers.
+ */
+
+#ifndef BENCH_CLOCK_H
+#define BENCH_CLOCK_H
+
+#ifndef RC_BENCH_ON_TARGET
+#define _POSIX_C_SOURCE 199309L     /* clock_gettime() */
+#endif
+
+#include <stdint.h>
+
+#ifdef RC_BENCH_ON_TARGET
+#include "nrf24_config.h"
+
+/** Unit of bench_now() */
+#define BENCH_UNIT "cycles"
+
+/**
+ * @brief Start the DWT cycle counter
+ */
+static inline void bench_clock_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Current time in BENCH_UNIT
+ */
+static inline uint64_t bench_now(void)
+{
+    return DWT->CYCCNT;
+}
+#else
+#include <time.h>
+
+/** Unit of bench_now() */
+#define BENCH_UNIT "ns"
+
+/**
+ * @brief Nothing to start on the host
+ */
+static inline void bench_clock_init(void)
+{
+}
+
+/**
+ * @brief Current time in BENCH_UNIT
+ */
+static inline uint64_t bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+#endif /* BENCH_CLOCK_H */
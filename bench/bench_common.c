@@ -0,0 +1,227 @@
+/**
+ * @file bench_common.c
+ * @brief Fixture and measurement helpers shared by the simulation benchmarks
+ */
+
+#include "bench_common.h"
+#include "stm32f1xx_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Limits one run can take */
+#define BENCH_MAX_LIMITS    64
+
+typedef struct {
+    const char *scenario;
+    size_t scenario_len;
+    char metric[16];
+    bool at_most;               /* "<=" (else ">=") */
+    double value;
+    bool matched;
+} bench_limit_t;
+
+static bench_limit_t limits[BENCH_MAX_LIMITS];
+static uint8_t limit_count;
+static uint32_t failures;
+
+/*============================================================================*/
+/* Fixture                                                                    */
+/*============================================================================*/
+
+#if RC_ENABLE_IRQ
+void bench_irq(void *ctx)
+{
+    rc_link_irq_handler((rc_link_t *)ctx);
+}
+#endif
+
+#if RC_ENABLE_SPI_DMA
+/* The sim completes each radio's DMA with that radio selected, and the
+ * benches put link instance N on radio N */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+    rc_link_spi_dma_complete(rc_link_instance(sim_selected()));
+}
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+    rc_link_spi_dma_complete(rc_link_instance(sim_selected()));
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+    rc_link_spi_dma_error(rc_link_instance(sim_selected()));
+}
+#endif
+
+#if RC_ENABLE_TDMA
+/* Likewise each MCU's slot timer */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+    rc_link_tdma_tick(rc_link_instance(sim_selected()));
+}
+#endif
+
+void bench_pair_start(bench_pair_t *pair, uint8_t radios, const rc_hardware_config_t *ground_hw,
+                      const rc_hardware_config_t *aircraft_hw, const sim_channel_t *channel)
+{
+    rc_hardware_config_t hw = { .get_tick_ms = HAL_GetTick };
+
+    sim_reset(radios, BENCH_SEED);
+
+    pair->ground = rc_link_instance(BENCH_GROUND);
+    pair->aircraft = rc_link_instance(BENCH_AIRCRAFT);
+
+    sim_select(BENCH_GROUND);
+    rc_link_init(pair->ground, ground_hw ? ground_hw : &hw);
+    sim_select(BENCH_AIRCRAFT);
+    rc_link_init(pair->aircraft, aircraft_hw ? aircraft_hw : &hw);
+
+#if RC_ENABLE_IRQ
+    sim_radio_set_irq(BENCH_GROUND, bench_irq, pair->ground);
+    sim_radio_set_irq(BENCH_AIRCRAFT, bench_irq, pair->aircraft);
+#endif
+
+    sim_channel_set(channel);
+}
+
+void bench_pair_stop(const bench_pair_t *pair)
+{
+    (void)pair;
+
+#if RC_ENABLE_IRQ
+    sim_radio_set_irq(BENCH_GROUND, NULL, NULL);
+    sim_radio_set_irq(BENCH_AIRCRAFT, NULL, NULL);
+#endif
+}
+
+/*============================================================================*/
+/* Commands                                                                   */
+/*============================================================================*/
+
+void bench_command(rc_command_payload_t *cmd, uint16_t id)
+{
+    for (uint8_t i = 0; i < 7; i++) {
+        cmd->channels[i] = (uint16_t)((id * 7U + i) & 0x7FF);
+    }
+    cmd->channels[7] = id;
+    cmd->switches = BENCH_SWITCHES;
+    cmd->mode = 1;
+}
+
+bool bench_command_valid(const rc_command_payload_t *cmd)
+{
+    rc_command_payload_t expect;
+    bench_command(&expect, cmd->channels[7]);
+    return memcmp(cmd, &expect, sizeof(expect)) == 0;
+}
+
+/*============================================================================*/
+/* Latency                                                                    */
+/*============================================================================*/
+
+void bench_record_latency(bench_latency_t *lat, uint32_t latency_us)
+{
+    uint32_t bin = latency_us / BENCH_BIN_US;
+
+    lat->bins[bin < BENCH_BINS ? bin : BENCH_BINS - 1]++;
+    lat->count++;
+    if (latency_us > lat->max_us) {
+        lat->max_us = latency_us;
+    }
+}
+
+uint32_t bench_percentile(const bench_latency_t *lat, uint8_t percent)
+{
+    uint64_t target = ((uint64_t)lat->count * percent + 99U) / 100U;
+    uint64_t seen = 0;
+
+    for (uint32_t i = 0; i < BENCH_BINS; i++) {
+        seen += lat->bins[i];
+        if (seen >= target && seen > 0) {
+            return i * BENCH_BIN_US;
+        }
+    }
+
+    return lat->max_us;
+}
+
+/*============================================================================*/
+/* Limits                                                                     */
+/*============================================================================*/
+
+void bench_limits_init(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *colon = strrchr(arg, ':');
+        const char *op = colon ? strpbrk(colon, "<>") : NULL;
+        size_t metric_len = op ? (size_t)(op - colon - 1) : 0;
+        bench_limit_t *limit = &limits[limit_count];
+        char *end = NULL;
+
+        if (limit_count < BENCH_MAX_LIMITS && op && op[1] == '=') {
+            limit->value = strtod(op + 2, &end);
+        }
+
+        if (!end || end == op + 2 || *end != '\0' || metric_len == 0 ||
+            metric_len >= sizeof(limit->metric)) {
+            fprintf(stderr, "bad limit \"%s\" (want scenario:metric<=value or >=value)\n", arg);
+            exit(2);
+        }
+
+        limit->scenario = arg;
+        limit->scenario_len = (size_t)(colon - arg);
+        memcpy(limit->metric, colon + 1, metric_len);
+        limit->metric[metric_len] = '\0';
+        limit->at_most = (*op == '<');
+        limit->matched = false;
+        limit_count++;
+    }
+}
+
+void bench_check(const char *scenario, const char *metric, double value)
+{
+    for (uint8_t i = 0; i < limit_count; i++) {
+        bench_limit_t *limit = &limits[i];
+        bool any = limit->scenario_len == 1 && limit->scenario[0] == '*';
+
+        if (strcmp(limit->metric, metric) != 0 ||
+            (!any && (strlen(scenario) != limit->scenario_len ||
+                      strncmp(scenario, limit->scenario, limit->scenario_len) != 0))) {
+            continue;
+        }
+
+        limit->matched = true;
+
+        bool held = value != BENCH_MISSING &&
+                    (limit->at_most ? value <= limit->value : value >= limit->value);
+        if (!held) {
+            failures++;
+            if (value == BENCH_MISSING) {
+                printf("FAIL %s: %s missing, limit %s %g\n", scenario, metric,
+                       limit->at_most ? "<=" : ">=", limit->value);
+            } else {
+                printf("FAIL %s: %s = %g, limit %s %g\n", scenario, metric, value,
+                       limit->at_most ? "<=" : ">=", limit->value);
+            }
+        }
+    }
+}
+
+int bench_finish(void)
+{
+    for (uint8_t i = 0; i < limit_count; i++) {
+        if (!limits[i].matched) {
+            failures++;
+            printf("FAIL limit \"%s\" matched no result\n", limits[i].scenario);
+        }
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file bench_common.h
+ * @brief Fixture and measurement helpers shared by the simulation benchmarks
+ *
+ * Every bench runs links against each other on the host simulation (sim/)
+ * in a main loop of BENCH_STEP_US. This is what they have in common: the
+ * ground / aircraft pair bring-up with IRQ routing, the id-derived test
+ * command, the latency histogram behind the p50 / p99 columns, and the
+ * limits that make a run pass or fail under CTest.
+ *
+ * Compiled into each bench executable, so it follows the RC_ENABLE_* flags
+ * of the driver variant that bench links against.
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================*/
+/* Constants                                                                  */
+/*============================================================================*/
+
+/** Simulated radios of the two ends */
+#define BENCH_GROUND        0
+#define BENCH_AIRCRAFT      1
+
+#define BENCH_SEED          0x1234ABCDU
+
+/** Main loop period of every node */
+#define BENCH_STEP_US       20
+
+/** Marks a real command (the failsafe command has no switches set) */
+#define BENCH_SWITCHES      0xA5
+
+/** Latency histogram: 10 µs bins up to 100 ms */
+#define BENCH_BIN_US        10
+#define BENCH_BINS          10000
+
+/*============================================================================*/
+/* Types                                                                      */
+/*============================================================================*/
+
+/**
+ * @brief Latency histogram
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t bins[BENCH_BINS];
+} bench_latency_t;
+
+/**
+ * @brief A ground and an aircraft link on radios BENCH_GROUND / BENCH_AIRCRAFT
+ */
+typedef struct {
+    rc_link_t *ground;
+    rc_link_t *aircraft;
+} bench_pair_t;
+
+/*============================================================================*/
+/* Fixture                                                                    */
+/*============================================================================*/
+
+#if RC_ENABLE_IRQ
+/**
+ * @brief sim_radio_set_irq() handler; ctx is the rc_link_t owning the radio
+ */
+void bench_irq(void *ctx);
+#endif
+
+/**
+ * @brief Reset the simulation and bring up both ends on a channel
+ *
+ * Links are rc_link_instance(BENCH_GROUND / BENCH_AIRCRAFT), each
+ * initialized with its radio selected; IRQ builds route both radios' IRQs.
+ * SPI_DMA builds get the HAL SPI callbacks from bench_common.c, forwarded
+ * to the link of the radio whose transfer completed, and TDMA builds the
+ * timer update callback, driving rc_link_tdma_tick() of that MCU's link.
+ *
+ * @param pair        Filled with the two links
+ * @param radios      Simulated radios to reset (2, more for extra receivers)
+ * @param ground_hw   Ground hardware config, NULL for HAL_GetTick() only
+ * @param aircraft_hw Aircraft hardware config, NULL for HAL_GetTick() only
+ * @param channel     Channel model for the run
+ */
+void bench_pair_start(bench_pair_t *pair, uint8_t radios, const rc_hardware_config_t *ground_hw,
+                      const rc_hardware_config_t *aircraft_hw, const sim_channel_t *channel);
+
+/**
+ * @brief Unroute the IRQs of a run started with bench_pair_start()
+ *
+ * @param pair Links of the run
+ */
+void bench_pair_stop(const bench_pair_t *pair);
+
+/*============================================================================*/
+/* Commands                                                                   */
+/*============================================================================*/
+
+/**
+ * @brief Command whose contents follow from its id (channel 7)
+ *
+ * @param cmd Output command
+ * @param id  Frame id
+ */
+void bench_command(rc_command_payload_t *cmd, uint16_t id);
+
+/**
+ * @brief Check a received command against bench_command() of its id
+ *
+ * @param cmd Received command
+ * @return true if every byte matches
+ */
+bool bench_command_valid(const rc_command_payload_t *cmd);
+
+/*============================================================================*/
+/* Latency                                                                    */
+/*============================================================================*/
+
+/**
+ * @brief Add one sample to a histogram
+ *
+ * @param lat        Histogram
+ * @param latency_us Sample; the last bin takes anything longer
+ */
+void bench_record_latency(bench_latency_t *lat, uint32_t latency_us);
+
+/**
+ * @brief Percentile of a histogram, to the bin
+ *
+ * @param lat     Histogram
+ * @param percent 0-100
+ * @return Lower edge of the bin it falls in (max_us if empty)
+ */
+uint32_t bench_percentile(const bench_latency_t *lat, uint8_t percent);
+
+/*============================================================================*/
+/* Limits                                                                     */
+/*============================================================================*/
+
+/** Value of a metric the scenario did not produce; fails any limit on it */
+#define BENCH_MISSING       (-1.0)
+
+/**
+ * @brief Take regression limits from the command line
+ *
+ * Each argument is "<scenario>:<metric><=<value>" or ">=", where metric is
+ * a column name and scenario a row's name, or "*" for every row. Without
+ * arguments nothing is checked. Exits with status 2 on a malformed one.
+ *
+ * @param argc From main()
+ * @param argv From main()
+ */
+void bench_limits_init(int argc, char **argv);
+
+/**
+ * @brief Check one result against the limits that name it
+ *
+ * Prints a FAIL line for each limit it breaks.
+ *
+ * @param scenario Row name
+ * @param metric   Column name
+ * @param value    Result, or BENCH_MISSING
+ */
+void bench_check(const char *scenario, const char *metric, double value);
+
+/**
+ * @brief Exit status of the run
+ *
+ * A limit no bench_check() call matched counts as failed, so a renamed
+ * scenario or column cannot silently disable it.
+ *
+ * @return 0 if every limit held, 1 otherwise
+ */
+int bench_finish(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_COMMON_H */
@@ -0,0 +1,390 @@
+/**
+* @file bind_bench.c
+ * @brief Binding and reconnect time on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t with RC_ENABLE_BIND and FHSS,
+ * each with a RAM store behind bind_load / bind_save. First the two bind:
+ * the ground offers a pair derived from a made-up UID and the aircraft
+ * joins the bind later. It reports:
+ *   - time from each end starting the bind to it being on the new pair
+ *   - commands delivered after both are restarted from their stores, and
+ *     by an unbound ground to the bound aircraft (should be none)
+ * Then, bound, the channel dies for a while and comes back. Per outage
+ * length, over BENCH_REPEATS runs at different frame phases, it reports:
+ *   - time from the channel coming back to the aircraft's first command
+ *     (mean / max)
+ *   - the same to rc_link_is_active() (outages long enough to lose the link)
+ *   - rc_stats_t.reconnect_ms: last frame before the loss to the first after
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * bind_bench (RC_ENABLE_REACQUIRE) or bind_bench_scan (without: the
+ * aircraft falls back to the dwell scan after RC_FHSS_SYNC_LOSS_HOPS).
+ * Times are virtual, so results are reproducible for a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include "stm32f1xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_PERIOD_US     (1000000U / RC_UPDATE_RATE_HZ)
+
+/** Aircraft joins the bind this long after the ground */
+#define BENCH_JOIN_MS       700U
+
+/** Bound: link up this long before the outage, watched this long after */
+#define BENCH_WARMUP_MS     2000U
+#define BENCH_AFTER_MS      3000U
+
+/** Runs per outage length, each shifted by BENCH_PHASE_MS */
+#define BENCH_REPEATS       4
+#define BENCH_PHASE_MS      7U
+
+typedef struct {
+    bool valid;
+    rc_bind_info_t info;
+    uint32_t saves;
+} bench_store_t;
+
+typedef struct {
+    double first_sum;           /* Channel back → first command */
+    uint32_t first_max;
+    uint32_t first_runs;
+    double active_sum;          /* Channel back → rc_link_is_active() */
+    uint32_t active_max;
+    uint32_t active_runs;
+    uint32_t reconnect_ms;      /* rc_stats_t, summed over runs */
+    uint32_t reconnects;
+} bench_result_t;
+
+static bench_store_t store[2];
+static uint16_t next_id;
+static uint32_t sent;
+static uint64_t next_send_us;
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+static bool bench_load(rc_bind_info_t *info, void *ctx)
+{
+    bench_store_t *s = (bench_store_t *)ctx;
+
+    if (s->valid) {
+        *info = s->info;
+    }
+    return s->valid;
+}
+
+static void bench_save(const rc_bind_info_t *info, void *ctx)
+{
+    bench_store_t *s = (bench_store_t *)ctx;
+
+    s->info = *info;
+    s->valid = true;
+    s->saves++;
+}
+
+static void bench_init(uint8_t end, bool stored)
+{
+    rc_hardware_config_t hw = {
+        .get_tick_ms = HAL_GetTick,
+        .bind_load = stored ? bench_load : NULL,
+        .bind_save = bench_save,
+        .bind_ctx = &store[end],
+    };
+
+    sim_select(end);
+    rc_link_init(rc_link_instance(end), &hw);
+
+    if (end == BENCH_GROUND) {
+        /* Commands on a steady grid from here: the aircraft's hop window
+         * expects the ground's frame period */
+        next_send_us = sim_time_us();
+    }
+}
+
+/* One main-loop pass of both ends; returns ids of real commands the
+ * aircraft took this pass (0 = none, else id + 1) */
+static uint32_t bench_step(void)
+{
+    rc_link_t *ground = rc_link_instance(BENCH_GROUND);
+    rc_link_t *aircraft = rc_link_instance(BENCH_AIRCRAFT);
+    rc_command_payload_t cmd;
+    uint32_t got = 0;
+
+    sim_select(BENCH_GROUND);
+    rc_link_update(ground);
+
+    if (sim_time_us() >= next_send_us) {
+        bench_command(&cmd, next_id++);
+        if (rc_link_send_command(ground, &cmd) != RC_ERROR_BUSY) {
+            sent++;
+        }
+        next_send_us += BENCH_PERIOD_US;
+    }
+
+    sim_select(BENCH_AIRCRAFT);
+    rc_link_update(aircraft);
+
+    while (rc_link_receive_command(aircraft, &cmd) == RC_OK && cmd.switches == BENCH_SWITCHES) {
+        got = (uint32_t)cmd.channels[7] + 1U;
+    }
+
+    sim_advance_us(BENCH_STEP_US);
+    return got;
+}
+
+/* Commands the aircraft took over a span */
+static uint32_t bench_deliver(uint32_t ms)
+{
+    uint64_t end_us = sim_time_us() + (uint64_t)ms * 1000U;
+    uint32_t delivered = 0;
+
+    while (sim_time_us() < end_us) {
+        if (bench_step() != 0) {
+            delivered++;
+        }
+    }
+
+    return delivered;
+}
+
+static void bench_reset(void)
+{
+    sim_reset(2, BENCH_SEED);
+    sim_channel_t clean = sim_channel_clean();
+    sim_channel_set(&clean);
+    next_id = 0;
+    sent = 0;
+}
+
+static void bench_print_address(const char *label, const bench_store_t *s)
+{
+    printf("  %-9s stored %s", label, s->valid ? "" : "nothing");
+    if (s->valid) {
+        for (uint8_t i = 0; i < RC_BIND_ADDRESS_SIZE; i++) {
+            printf("%s%02X", i ? ":" : "", s->info.address[i]);
+        }
+        printf(", hop seed %08lX (%lu write)", (unsigned long)s->info.hop_seed,
+               (unsigned long)s->saves);
+    }
+    printf("\n");
+}
+
+/*============================================================================*/
+/* Bind                                                                       */
+/*============================================================================*/
+
+static void bench_bind(void)
+{
+    static const uint8_t uid[12] = {
+        0x33, 0xFF, 0xD6, 0x05, 0x4E, 0x57, 0x38, 0x35, 0x21, 0x66, 0x14, 0x43,
+    };
+
+    memset(store, 0, sizeof(store));
+    bench_reset();
+    bench_init(BENCH_GROUND, true);
+    bench_init(BENCH_AIRCRAFT, true);
+
+    rc_link_t *ground = rc_link_instance(BENCH_GROUND);
+    rc_link_t *aircraft = rc_link_instance(BENCH_AIRCRAFT);
+    rc_bind_info_t info;
+    rc_bind_derive(uid, sizeof(uid), &info);
+
+    /* Commands are refused while binding; they start once bound */
+    sim_select(BENCH_GROUND);
+    rc_link_bind_start(ground, &info);
+
+    uint64_t join_us = (uint64_t)BENCH_JOIN_MS * 1000U;
+    uint64_t bound_us[2] = { 0, 0 };
+    bool joined = false;
+
+    while (sim_time_us() < 10000000U && (bound_us[0] == 0 || bound_us[1] == 0)) {
+        if (!joined && sim_time_us() >= join_us) {
+            sim_select(BENCH_AIRCRAFT);
+            rc_link_bind_start(aircraft, NULL);
+            joined = true;
+        }
+
+        bench_step();
+
+        for (uint8_t end = 0; end < 2; end++) {
+            if (bound_us[end] == 0 &&
+                rc_link_get_bind_state(rc_link_instance(end)) == RC_BIND_BOUND) {
+                bound_us[end] = sim_time_us();
+            }
+        }
+    }
+
+    /* The ground waits for the aircraft, so both count from the join */
+    bench_check("bind", "ground", bound_us[0] ? (bound_us[0] - join_us) / 1000.0 : BENCH_MISSING);
+    bench_check("bind", "aircraft", bound_us[1] ? (bound_us[1] - join_us) / 1000.0 : BENCH_MISSING);
+    printf("bind: ground bound %.1f ms after the aircraft joined, aircraft %.1f ms\n",
+           bound_us[0] ? (bound_us[0] - join_us) / 1000.0 : -1.0,
+           bound_us[1] ? (bound_us[1] - join_us) / 1000.0 : -1.0);
+    bench_print_address("ground", &store[BENCH_GROUND]);
+    bench_print_address("aircraft", &store[BENCH_AIRCRAFT]);
+
+    /* Both restarted: they come up on the stored pair */
+    bench_reset();
+    bench_init(BENCH_GROUND, true);
+    bench_init(BENCH_AIRCRAFT, true);
+    uint32_t bound = bench_deliver(2000);
+    uint32_t bound_sent = sent;
+
+    /* Another unit's ground, never bound, talking to ours */
+    bench_reset();
+    bench_init(BENCH_GROUND, false);
+    bench_init(BENCH_AIRCRAFT, true);
+    uint32_t stranger = bench_deliver(2000);
+
+    bench_check("restart", "deliv", bound_sent ? 100.0 * bound / bound_sent : BENCH_MISSING);
+    bench_check("unbound", "rx", stranger);
+
+    printf("  restarted from the stores: %lu of %lu commands in 2 s; unbound ground: %lu of %lu\n\n",
+           (unsigned long)bound, (unsigned long)bound_sent,
+           (unsigned long)stranger, (unsigned long)sent);
+}
+
+/*============================================================================*/
+/* Reconnect                                                                  */
+/*============================================================================*/
+
+static void bench_outage(uint32_t outage_ms, uint32_t phase_ms, bench_result_t *result)
+{
+    bench_reset();
+    bench_init(BENCH_GROUND, true);
+    bench_init(BENCH_AIRCRAFT, true);
+
+    rc_link_t *aircraft = rc_link_instance(BENCH_AIRCRAFT);
+
+    sim_channel_t clean = sim_channel_clean();
+    sim_channel_t dead = clean;
+    dead.loss = 1.0;
+
+    uint64_t down_us = (uint64_t)(BENCH_WARMUP_MS + phase_ms) * 1000U;
+    uint64_t up_us = down_us + (uint64_t)outage_ms * 1000U;
+    uint64_t end_us = up_us + (uint64_t)BENCH_AFTER_MS * 1000U;
+    bool down = false;
+    bool lost = false;
+    uint64_t first_us = 0;
+    uint64_t active_us = 0;
+
+    while (sim_time_us() < end_us) {
+        uint64_t now = sim_time_us();
+
+        if (!down && now >= down_us && now < up_us) {
+            sim_channel_set(&dead);
+            down = true;
+        } else if (down && now >= up_us) {
+            sim_channel_set(&clean);
+            down = false;
+        }
+
+        uint32_t got = bench_step();
+
+        if (now >= down_us && now < up_us && !rc_link_is_active(aircraft)) {
+            lost = true;
+        }
+        if (now >= up_us) {
+            if (got != 0 && first_us == 0) {
+                first_us = now - up_us;
+            }
+            if (lost && active_us == 0 && rc_link_is_active(aircraft)) {
+                active_us = now - up_us;
+            }
+        }
+    }
+
+    if (first_us != 0) {
+        uint32_t ms = (uint32_t)(first_us / 1000U);
+
+        result->first_sum += first_us / 1000.0;
+        result->first_max = ms > result->first_max ? ms : result->first_max;
+        result->first_runs++;
+    }
+    if (active_us != 0) {
+        uint32_t ms = (uint32_t)(active_us / 1000U);
+
+        result->active_sum += active_us / 1000.0;
+        result->active_max = ms > result->active_max ? ms : result->active_max;
+        result->active_runs++;
+    }
+
+    rc_stats_t stats;
+    rc_link_get_stats(aircraft, &stats);
+    result->reconnect_ms += stats.reconnect_ms;
+    result->reconnects += stats.reconnects;
+}
+
+static void bench_reconnect(uint32_t outage_ms)
+{
+    bench_result_t result;
+    memset(&result, 0, sizeof(result));
+
+    for (uint32_t i = 0; i < BENCH_REPEATS; i++) {
+        bench_outage(outage_ms, i * BENCH_PHASE_MS, &result);
+    }
+
+    char row[16];
+    snprintf(row, sizeof(row), "%lu", (unsigned long)outage_ms);
+    bench_check(row, "runs", result.first_runs);
+    bench_check(row, "first",
+                result.first_runs ? result.first_sum / result.first_runs : BENCH_MISSING);
+    bench_check(row, "active",
+                result.active_runs ? result.active_sum / result.active_runs : BENCH_MISSING);
+    bench_check(row, "reconnect",
+                result.reconnects ? (double)result.reconnect_ms / result.reconnects
+                                  : BENCH_MISSING);
+
+    printf("%8lu %4lu/%u",
+           (unsigned long)outage_ms, (unsigned long)result.first_runs, BENCH_REPEATS);
+    if (result.first_runs) {
+        printf(" %7.1f %6lu", result.first_sum / result.first_runs,
+               (unsigned long)result.first_max);
+    } else {
+        printf(" %7s %6s", "-", "-");
+    }
+
+    if (result.active_runs) {
+        printf(" %7.1f %6lu", result.active_sum / result.active_runs,
+               (unsigned long)result.active_max);
+    } else {
+        printf(" %7s %6s", "-", "-");
+    }
+
+    if (result.reconnects) {
+        printf(" %9.1f\n", (double)result.reconnect_ms / result.reconnects);
+    } else {
+        printf(" %9s\n", "-");
+    }
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    static const uint32_t outages_ms[] = { 50, 200, 500, 1500, 3000, 6000, 10000 };
+
+    printf("nrf_rc_link bind and reconnect (FHSS, %u hops, %u Hz commands, %s)\n\n",
+           RC_FHSS_HOP_COUNT, RC_UPDATE_RATE_HZ,
+           RC_ENABLE_REACQUIRE ? "fast reacquisition" : "dwell scan only");
+
+    bench_bind();
+
+    printf("%8s %6s %7s %6s %7s %6s %9s\n",
+           "outage", "runs", "first", "max", "active", "max", "reconnect");
+
+    for (size_t i = 0; i < sizeof(outages_ms) / sizeof(outages_ms[0]); i++) {
+        bench_reconnect(outages_ms[i]);
+    }
+
+    return bench_finish();
+}
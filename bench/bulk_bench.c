@@ -0,0 +1,259 @@
+/**
+* @file bulk_bench.c
+ * @brief Bulk streams beside the RC traffic on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t. The ground sends a command
+ * every RC_UPDATE_RATE_HZ period and the aircraft answers every other one
+ * with telemetry, while BENCH_STREAM_LEN-byte streams go back to back up
+ * (ground to aircraft) or down (aircraft to ground), each checked byte
+ * for byte against what was sent. Per scenario it reports:
+ *   - streams completed, and any that failed or arrived with wrong contents
+ *   - sustained throughput (completed bytes over the run) and the mean of
+ *     the per-stream rates rc_link_bulk_get_tx_status() reports
+ *   - data segments sent and sent again
+ *   - command delivery and latency from when the command was due to
+ *     rc_link_receive_command() returning it (p50 / p99 / max)
+ *   - telemetry frames the ground received
+ * Each channel has a row without a stream too, so the command columns
+ * show what bulk traffic costs the control path.
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * bulk_bench (polling) and bulk_bench_irq (RC_ENABLE_IRQ). Times are
+ * virtual, so results are reproducible for a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_PERIOD_US     (1000000U / RC_UPDATE_RATE_HZ)
+#define BENCH_DURATION_MS   10000U
+
+/** Bytes per stream */
+#define BENCH_STREAM_LEN    4096
+
+typedef enum {
+    BENCH_NONE,
+    BENCH_UP,                   /* Ground sends, aircraft receives */
+    BENCH_DOWN                  /* Aircraft sends, ground receives */
+} bench_direction_t;
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+    bench_direction_t direction;
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t received;
+    bench_latency_t latency;
+    uint32_t telemetry;
+    uint32_t streams;
+    uint32_t corrupt;           /* Streams that completed with wrong contents */
+    uint64_t rate_sum;          /* Per-stream bytes/s, summed */
+    uint32_t segments;
+    uint32_t repeats;
+} bench_result_t;
+
+static uint64_t due_at_us[65536];
+static bench_result_t result;
+
+static uint8_t stream_data[BENCH_STREAM_LEN];
+static uint8_t stream_buffer[BENCH_STREAM_LEN];
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+/* Contents that differ per stream */
+static void bench_stream_fill(uint32_t stream)
+{
+    for (uint32_t i = 0; i < BENCH_STREAM_LEN; i++) {
+        stream_data[i] = (uint8_t)(i * 31U + stream * 7U + (i >> 8));
+    }
+}
+
+static void bench_receive(rc_link_t *receiver)
+{
+    memset(stream_buffer, 0, sizeof(stream_buffer));
+    rc_link_bulk_receive(receiver, stream_buffer, sizeof(stream_buffer));
+}
+
+/* Each end moves on once its own side is finished: the receiver is armed
+ * again straight away, the sender starts the next stream when the last is
+ * acknowledged */
+static void bench_stream_check(rc_link_t *sender, rc_link_t *receiver)
+{
+    rc_bulk_status_t rx;
+    rc_link_bulk_get_rx_status(receiver, &rx);
+
+    if (rx.state != RC_BULK_ACTIVE) {
+        if (rx.state != RC_BULK_DONE || rx.bytes != BENCH_STREAM_LEN ||
+            memcmp(stream_buffer, stream_data, BENCH_STREAM_LEN) != 0) {
+            result.corrupt++;
+        }
+        bench_receive(receiver);
+    }
+
+    rc_bulk_status_t tx;
+    rc_link_bulk_get_tx_status(sender, &tx);
+
+    if (tx.state == RC_BULK_ACTIVE) {
+        return;
+    }
+
+    result.streams++;
+    result.rate_sum += tx.bytes_per_s;
+    result.segments += tx.segments;
+    result.repeats += tx.repeats;
+    if (tx.state != RC_BULK_DONE) {
+        result.corrupt++;
+    }
+
+    bench_stream_fill(result.streams);
+    rc_link_bulk_send(sender, stream_data, sizeof(stream_data));
+}
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc)
+{
+    memset(&result, 0, sizeof(result));
+    bench_pair_t pair;
+    bench_pair_start(&pair, 2, NULL, NULL, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    rc_link_t *sender = (sc->direction == BENCH_UP) ? ground : aircraft;
+    rc_link_t *receiver = (sc->direction == BENCH_UP) ? aircraft : ground;
+    if (sc->direction != BENCH_NONE) {
+        bench_stream_fill(0);
+        bench_receive(receiver);
+        rc_link_bulk_send(sender, stream_data, sizeof(stream_data));
+    }
+
+    uint64_t end_us = (uint64_t)BENCH_DURATION_MS * 1000U;
+    uint64_t next_send_us = 0;
+    uint16_t next_id = 0;
+    bool pending = false;
+    rc_command_payload_t cmd;
+
+    while (sim_time_us() < end_us) {
+        /* Ground: a fresh command every period, the last one while busy */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (sim_time_us() >= next_send_us) {
+            bench_command(&cmd, next_id);
+            due_at_us[next_id] = next_send_us;
+            next_id++;
+            pending = true;
+            result.sent++;
+            next_send_us += BENCH_PERIOD_US;
+        }
+
+        if (pending && rc_link_send_command(ground, &cmd) != RC_ERROR_BUSY) {
+            pending = false;
+        }
+
+        rc_telemetry_payload_t tlm;
+        while (rc_link_receive_telemetry(ground, &tlm) == RC_OK) {
+            result.telemetry++;
+        }
+
+        /* Aircraft: take commands, answer every other one */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        rc_command_payload_t rx;
+        while (rc_link_receive_command(aircraft, &rx) == RC_OK && rx.switches == BENCH_SWITCHES) {
+            result.received++;
+            bench_record_latency(&result.latency,
+                                 (uint32_t)(sim_time_us() - due_at_us[rx.channels[7]]));
+
+            if (rx.channels[7] % 2 == 0) {
+                memset(&tlm, 0, sizeof(tlm));
+                tlm.rssi = (uint8_t)rx.channels[7];
+                rc_link_send_telemetry(aircraft, &tlm);
+            }
+        }
+
+        if (sc->direction != BENCH_NONE) {
+            bench_stream_check(sender, receiver);
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+
+    bench_check(sc->name, "strm", result.streams);
+    bench_check(sc->name, "bad", result.corrupt);
+    bench_check(sc->name, "B/s",
+                (double)result.streams * BENCH_STREAM_LEN * 1000.0 / BENCH_DURATION_MS);
+    bench_check(sc->name, "deliv",
+                result.sent ? 100.0 * result.received / result.sent : BENCH_MISSING);
+    bench_check(sc->name, "p99us",
+                result.latency.count ? bench_percentile(&result.latency, 99) : BENCH_MISSING);
+
+    printf("%-16s %4lu %4lu %7lu %7lu %6lu %6lu %6.1f%% %6lu %6lu %6lu %5lu\n",
+           sc->name,
+           (unsigned long)result.streams,
+           (unsigned long)result.corrupt,
+           (unsigned long)((uint64_t)result.streams * BENCH_STREAM_LEN * 1000U / BENCH_DURATION_MS),
+           (unsigned long)(result.streams ? result.rate_sum / result.streams : 0),
+           (unsigned long)result.segments,
+           (unsigned long)result.repeats,
+           result.sent ? 100.0 * result.received / result.sent : 0.0,
+           (unsigned long)bench_percentile(&result.latency, 50),
+           (unsigned long)bench_percentile(&result.latency, 99),
+           (unsigned long)result.latency.max_us,
+           (unsigned long)result.telemetry);
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t loss10 = clean;
+    loss10.loss = 0.10;
+
+    sim_channel_t loss30 = clean;
+    loss30.loss = 0.30;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean, none",     clean,  BENCH_NONE },
+        { "clean, up",       clean,  BENCH_UP },
+        { "clean, down",     clean,  BENCH_DOWN },
+        { "loss 10%, none",  loss10, BENCH_NONE },
+        { "loss 10%, up",    loss10, BENCH_UP },
+        { "loss 10%, down",  loss10, BENCH_DOWN },
+        { "loss 30%, none",  loss30, BENCH_NONE },
+        { "loss 30%, up",    loss30, BENCH_UP },
+        { "loss 30%, down",  loss30, BENCH_DOWN },
+    };
+
+    printf("nrf_rc_link bulk streams (%s, %u Hz commands, %u-byte streams, window %u, %u us step)\n",
+           RC_ENABLE_IRQ ? "IRQ" : "polling", RC_UPDATE_RATE_HZ, BENCH_STREAM_LEN,
+           RC_BULK_WINDOW, BENCH_STEP_US);
+    printf("%-16s %4s %4s %7s %7s %6s %6s %7s %6s %6s %6s %5s\n",
+           "scenario", "strm", "bad", "B/s", "strmB/s", "segs", "resent",
+           "deliv", "p50us", "p99us", "maxus", "tlm");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i]);
+    }
+
+    return bench_finish();
+}
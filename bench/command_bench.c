@@ -0,0 +1,278 @@
+/**
+* @file command_bench.c
+ * @brief Command delivery to the outputs on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t. The ground sends a command
+ * every RC_UPDATE_RATE_HZ period with the four sticks moving on sine
+ * waves of 0.5-3 Hz. The aircraft runs a BENCH_LOOP_US control loop that
+ * takes new commands with rc_link_receive_command() and, between them,
+ * asks rc_link_predict_command() for the value to output. Per scenario it
+ * reports:
+ *   - commands delivered, and latency from when a command was due to the
+ *     control loop seeing it (p50 / p99)
+ *   - with RC_ENABLE_COMMAND_CALLBACK, the same latency to the callback
+ *     (p50 / p99) and to the cycle count it was stamped with (p50)
+ *   - stick error at every loop pass against the newest command sent, for
+ *     outputs that hold the last command and outputs that follow
+ *     rc_link_predict_command() (mean / max, over passes with a frame
+ *     missed, 0-2047 scale)
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * command_bench (IRQ, mailbox and callback) or command_bench_poll
+ * (polling). Times are virtual, so results are reproducible for a given
+ * seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include "../drivers/include/nrf24.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/** Aircraft control loop period */
+#define BENCH_LOOP_US       1000U
+
+#define BENCH_PERIOD_US     (1000000U / RC_UPDATE_RATE_HZ)
+#define BENCH_DURATION_MS   20000U
+
+#define BENCH_STICKS        4
+#define BENCH_PI            3.14159265358979323846
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t sent;
+    bench_latency_t loop;
+    bench_latency_t callback;
+    bench_latency_t stamp;
+    uint32_t gap_passes;        /* Loop passes with a frame missed */
+    uint64_t hold_error;        /* Summed over those passes and the sticks */
+    uint64_t predict_error;
+    uint32_t hold_max;
+    uint32_t predict_max;
+} bench_result_t;
+
+static uint64_t due_at_us[65536];
+static uint16_t sent_sticks[65536][BENCH_STICKS];
+static bench_result_t result;
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+static void bench_sticks(rc_command_payload_t *cmd, uint16_t id, uint64_t due_us)
+{
+    static const double hz[BENCH_STICKS] = { 0.5, 1.0, 2.0, 3.0 };
+    double t = (double)due_us / 1e6;
+
+    memset(cmd, 0, sizeof(*cmd));
+    for (uint8_t i = 0; i < BENCH_STICKS; i++) {
+        cmd->channels[i] = (uint16_t)lround(RC_CHANNEL_CENTER + 600.0 * sin(2.0 * BENCH_PI * hz[i] * t));
+        sent_sticks[id][i] = cmd->channels[i];
+    }
+    cmd->channels[7] = id;
+    cmd->switches = BENCH_SWITCHES;
+    cmd->mode = 1;
+}
+
+static void bench_record(bench_latency_t *lat, uint64_t at_us, uint16_t id)
+{
+    bench_record_latency(lat, (uint32_t)(at_us - due_at_us[id]));
+}
+
+static uint32_t bench_error(const rc_command_payload_t *out, uint16_t id, uint32_t *max)
+{
+    uint32_t sum = 0;
+
+    for (uint8_t i = 0; i < BENCH_STICKS; i++) {
+        int32_t diff = (int32_t)out->channels[i] - (int32_t)sent_sticks[id][i];
+        uint32_t error = (uint32_t)(diff < 0 ? -diff : diff);
+
+        sum += error;
+        if (error > *max) {
+            *max = error;
+        }
+    }
+
+    return sum;
+}
+
+#if RC_ENABLE_COMMAND_CALLBACK
+static void bench_on_command(rc_link_t *link, const rc_command_sample_t *sample, void *ctx)
+{
+    (void)link;
+    (void)ctx;
+
+    if (sample->command.switches != BENCH_SWITCHES) {
+        return;
+    }
+
+    uint16_t id = sample->command.channels[7];
+    uint32_t age_us = nrf24_cycles_to_us(nrf24_cycle_count() - sample->rx_cycles);
+
+    bench_record(&result.callback, sim_time_us(), id);
+    bench_record(&result.stamp, sim_time_us() - age_us, id);
+}
+#endif
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc)
+{
+    memset(&result, 0, sizeof(result));
+    bench_pair_t pair;
+    bench_pair_start(&pair, 2, NULL, NULL, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+#if RC_ENABLE_COMMAND_CALLBACK
+    rc_link_set_command_callback(aircraft, bench_on_command, NULL);
+#endif
+
+    uint64_t end_us = (uint64_t)BENCH_DURATION_MS * 1000U;
+    uint64_t next_send_us = 0;
+    uint64_t next_loop_us = 0;
+    uint16_t next_id = 0;
+    bool pending = false;
+    bool held = false;
+    rc_command_payload_t cmd;
+    rc_command_payload_t hold;
+
+    while (sim_time_us() < end_us) {
+        /* Ground: a fresh command every period, the last one while busy */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (sim_time_us() >= next_send_us) {
+            bench_sticks(&cmd, next_id, next_send_us);
+            due_at_us[next_id] = next_send_us;
+            next_id++;
+            pending = true;
+            result.sent++;
+            next_send_us += BENCH_PERIOD_US;
+        }
+
+        if (pending && rc_link_send_command(ground, &cmd) != RC_ERROR_BUSY) {
+            pending = false;
+        }
+
+        /* Aircraft: the control loop */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        if (sim_time_us() >= next_loop_us) {
+            next_loop_us += BENCH_LOOP_US;
+
+            rc_command_payload_t rx;
+            while (rc_link_receive_command(aircraft, &rx) == RC_OK && rx.switches == BENCH_SWITCHES) {
+                bench_record(&result.loop, sim_time_us(), rx.channels[7]);
+                memcpy(&hold, &rx, sizeof(hold));
+                held = true;
+            }
+
+            rc_command_payload_t predicted;
+            uint8_t missed = 0;
+
+            if (held && rc_link_predict_command(aircraft, &predicted, &missed) == RC_OK &&
+                predicted.switches == BENCH_SWITCHES && missed > 0) {
+                /* Newest command the ground has put out by now */
+                uint16_t newest = (uint16_t)(next_id - 1);
+
+                result.gap_passes++;
+                result.hold_error += bench_error(&hold, newest, &result.hold_max);
+                result.predict_error += bench_error(&predicted, newest, &result.predict_max);
+            }
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+
+    uint32_t samples = result.gap_passes * BENCH_STICKS;
+
+    bench_check(sc->name, "deliv",
+                result.sent ? 100.0 * result.loop.count / result.sent : BENCH_MISSING);
+    bench_check(sc->name, "loop99",
+                result.loop.count ? bench_percentile(&result.loop, 99) : BENCH_MISSING);
+#if RC_ENABLE_COMMAND_CALLBACK
+    bench_check(sc->name, "cb99",
+                result.callback.count ? bench_percentile(&result.callback, 99) : BENCH_MISSING);
+#else
+    bench_check(sc->name, "cb99", BENCH_MISSING);
+#endif
+    bench_check(sc->name, "predE",
+                samples ? (double)result.predict_error / samples : BENCH_MISSING);
+
+    printf("%-12s %6.1f%% %6lu %6lu",
+           sc->name,
+           result.sent ? 100.0 * result.loop.count / result.sent : 0.0,
+           (unsigned long)bench_percentile(&result.loop, 50),
+           (unsigned long)bench_percentile(&result.loop, 99));
+#if RC_ENABLE_COMMAND_CALLBACK
+    printf(" %6lu %6lu %6lu",
+           (unsigned long)bench_percentile(&result.callback, 50),
+           (unsigned long)bench_percentile(&result.callback, 99),
+           (unsigned long)bench_percentile(&result.stamp, 50));
+#else
+    printf(" %6s %6s %6s", "-", "-", "-");
+#endif
+    printf(" %6lu %6.1f %5lu %6.1f %5lu\n",
+           (unsigned long)result.gap_passes,
+           samples ? (double)result.hold_error / samples : 0.0,
+           (unsigned long)result.hold_max,
+           samples ? (double)result.predict_error / samples : 0.0,
+           (unsigned long)result.predict_max);
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t loss30 = clean;
+    loss30.loss = 0.30;
+
+    sim_channel_t loss50 = clean;
+    loss50.loss = 0.50;
+
+    sim_channel_t burst = clean;
+    burst.loss = 0.01;
+    burst.burst_enter = 0.02;
+    burst.burst_exit = 0.10;
+    burst.burst_loss = 0.80;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean",    clean },
+        { "loss 30%", loss30 },
+        { "loss 50%", loss50 },
+        { "burst",    burst },
+    };
+
+    printf("nrf_rc_link command delivery (%s%s, %u Hz commands, %u us control loop, "
+           "predict %u frames)\n",
+           RC_ENABLE_IRQ ? "IRQ" : "polling",
+           RC_ENABLE_COMMAND_CALLBACK ? " + callback" : "",
+           RC_UPDATE_RATE_HZ, BENCH_LOOP_US, RC_PREDICT_FRAMES);
+    printf("%-12s %7s %6s %6s %6s %6s %6s %6s %6s %5s %6s %5s\n",
+           "scenario", "deliv", "loop50", "loop99", "cb50", "cb99", "stmp50",
+           "gaps", "holdE", "max", "predE", "max");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i]);
+    }
+
+    return bench_finish();
+}
@@ -0,0 +1,242 @@
+/**
+ * @file diversity_bench.c
+ * @brief Two aircraft receivers against one on the host simulation
+ *
+ * The aircraft's rc_link_t drives radio 1 and, with RC_ENABLE_DIVERSITY,
+ * a receive-only second radio 2 on its own SPI bus and pins; the ground is
+ * radio 0. Each channel scenario runs with one receiver, then with both,
+ * and reports:
+ *   - commands delivered per second and delivery ratio
+ *   - latency from the send call to rc_link_receive_command() returning it
+ *     (p50 / p99 / max)
+ *   - retransmits the ground needed, and telemetry that made it back
+ *   - frames each receiver delivered first, and copies the combiner dropped
+ *
+ * Every receiver draws its own loss in the simulation, so the numbers show
+ * what independent antennas buy; bursts hit both at once.
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * diversity_bench (polling mode) or diversity_bench_irq (RC_ENABLE_IRQ).
+ * Times are virtual, so results are reproducible for a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "nrf24.h"
+#include "sim.h"
+#include "bench_common.h"
+#include "stm32f1xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+/** Simulated radio of the aircraft's second receiver */
+#define BENCH_DIVERSITY     2
+
+/** Aircraft answers every Nth command with telemetry */
+#define BENCH_TELEMETRY_DIV 10
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+    uint32_t rate_hz;
+    uint32_t duration_ms;
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t received;
+    uint32_t escaped;           /* Delivered with wrong contents */
+    uint32_t telemetry;
+    bench_latency_t latency;
+} bench_result_t;
+
+static uint64_t sent_at_us[65536];
+static bench_result_t result;
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+static nrf24_hw_t bench_wiring(uint8_t radio)
+{
+    /* Own bus and port per radio, so both answer whatever is selected */
+    nrf24_hw_t hw = {
+        .spi = sim_spi_bus(radio),
+        .csn_port = sim_gpio_port(radio),
+        .csn_pin = SPI1_CSN_NRF_Pin,
+        .ce_port = sim_gpio_port(radio),
+        .ce_pin = NRF_CE_Pin
+    };
+
+    return hw;
+}
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc, bool diversity)
+{
+    memset(&result, 0, sizeof(result));
+
+    nrf24_hw_t primary = bench_wiring(BENCH_AIRCRAFT);
+    nrf24_hw_t second = bench_wiring(BENCH_DIVERSITY);
+    rc_hardware_config_t aircraft_hw = {
+        .get_tick_ms = HAL_GetTick,
+        .radio = &primary,
+        .diversity_radio = diversity ? &second : NULL
+    };
+    bench_pair_t pair;
+
+    bench_pair_start(&pair, 3, NULL, &aircraft_hw, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+#if RC_ENABLE_IRQ
+    sim_radio_set_irq(BENCH_DIVERSITY, bench_irq, aircraft);
+#endif
+
+    uint64_t end_us = (uint64_t)sc->duration_ms * 1000U;
+    uint64_t interval_us = 1000000U / sc->rate_hz;
+    uint64_t next_send_us = 0;
+    uint16_t next_id = 0;
+    bool pending = false;
+    rc_command_payload_t cmd;
+
+    while (sim_time_us() < end_us) {
+        uint64_t now = sim_time_us();
+
+        /* Ground: send due commands, drain telemetry */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (!pending && now >= next_send_us) {
+            bench_command(&cmd, next_id);
+            sent_at_us[next_id] = now;
+            pending = true;
+            next_send_us += interval_us;
+        }
+
+        if (pending) {
+            rc_status_t status = rc_link_send_command(ground, &cmd);
+            if (status != RC_ERROR_BUSY) {
+                pending = false;
+                next_id++;
+                result.sent++;
+            }
+        }
+
+        rc_telemetry_payload_t telem;
+        while (rc_link_receive_telemetry(ground, &telem) == RC_OK) {
+            result.telemetry++;
+        }
+
+        /* Aircraft: its radios are wired for good, no selection needed */
+        rc_link_update(aircraft);
+
+        rc_command_payload_t rx;
+        while (rc_link_receive_command(aircraft, &rx) == RC_OK) {
+            if (rx.switches != BENCH_SWITCHES) {
+                break;  /* Failsafe values */
+            }
+
+            if (!bench_command_valid(&rx)) {
+                result.escaped++;
+                continue;
+            }
+
+            result.received++;
+            bench_record_latency(&result.latency,
+                                 (uint32_t)(sim_time_us() - sent_at_us[rx.channels[7]]));
+
+            if (result.received % BENCH_TELEMETRY_DIV == 0) {
+                memset(&telem, 0, sizeof(telem));
+                telem.battery_mv = 11100;
+                telem.gps_sats = 9;
+                rc_link_send_telemetry(aircraft, &telem);
+            }
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+#if RC_ENABLE_IRQ
+    sim_radio_set_irq(BENCH_DIVERSITY, NULL, NULL);
+#endif
+
+    rc_stats_t as;
+    sim_channel_stats_t cs;
+    rc_link_get_stats(aircraft, &as);
+    sim_channel_get_stats(&cs);
+
+    char row[32];
+    snprintf(row, sizeof(row), "%s/%u", sc->name, diversity ? 2U : 1U);
+    bench_check(row, "deliv",
+                result.sent ? 100.0 * result.received / result.sent : BENCH_MISSING);
+    bench_check(row, "p99us",
+                result.latency.count ? bench_percentile(&result.latency, 99) : BENCH_MISSING);
+    bench_check(row, "bad", result.escaped);
+
+    printf("%-10s %2u %7lu %7.1f %6.1f%% %7lu %7lu %7lu %6lu %6lu %6lu %6lu %5lu %4lu\n",
+           diversity ? "" : sc->name, diversity ? 2U : 1U,
+           (unsigned long)result.sent,
+           (double)result.received * 1000.0 / sc->duration_ms,
+           result.sent ? 100.0 * result.received / result.sent : 0.0,
+           (unsigned long)bench_percentile(&result.latency, 50),
+           (unsigned long)bench_percentile(&result.latency, 99),
+           (unsigned long)result.latency.max_us,
+           (unsigned long)cs.retransmits,
+           (unsigned long)result.telemetry,
+           (unsigned long)as.diversity_rx[0],
+           (unsigned long)as.diversity_rx[1],
+           (unsigned long)as.diversity_duplicates,
+           (unsigned long)result.escaped);
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t lossy = clean;
+    lossy.loss = 0.30;
+
+    sim_channel_t burst = clean;
+    burst.loss = 0.01;
+    burst.burst_enter = 0.02;
+    burst.burst_exit = 0.10;
+    burst.burst_loss = 0.80;
+
+    /* Fading out at 2 Mbps: about 1/3 and 2/3 of the frames lost */
+    sim_channel_t range = clean;
+    range.signal_dbm = -81;
+
+    sim_channel_t edge = clean;
+    edge.signal_dbm = -83;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean",    clean, 100, 5000 },
+        { "loss 30%", lossy, 100, 5000 },
+        { "burst",    burst, 100, 5000 },
+        { "range",    range, 100, 5000 },
+        { "edge",     edge,  100, 5000 },
+    };
+
+    printf("nrf_rc_link diversity simulation (%s, %u us step)\n",
+           RC_ENABLE_IRQ ? "IRQ" : "polling", BENCH_STEP_US);
+    printf("%-10s %2s %7s %7s %7s %7s %7s %7s %6s %6s %6s %6s %5s %4s\n",
+           "scenario", "rx", "sent", "rx/s", "deliv", "p50us", "p99us", "maxus",
+           "retx", "telem", "ant0", "ant1", "dup", "bad");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i], false);
+        bench_run(&scenarios[i], true);
+    }
+
+    return bench_finish();
+}
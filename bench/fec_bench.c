@@ -0,0 +1,180 @@
+/**
+* @file fec_bench.c
+ * @brief Forward error correction against retransmission on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t with the ground sending a fresh
+ * command every BENCH_PERIOD_US, over channels that damage bytes of some
+ * frames (sim_channel_t.errors) or lose them outright. Per scenario it
+ * reports:
+ *   - delivery ratio and latency from the send call to
+ *     rc_link_receive_command() returning it (p50 / p99 / max)
+ *   - radio retransmits and commands the link gave up on
+ *   - frames FEC repaired and dropped as beyond repair (RC_ENABLE_FEC)
+ *   - commands delivered with wrong contents
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * fec_bench (RC_ENABLE_FEC) and fec_bench_arq (the default auto-ACK link,
+ * where the radio CRC drops a damaged frame and it is sent again). Times
+ * are virtual, so results are reproducible for a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include <stdio.h>
+#include <string.h>
+
+/** 250 Hz commands */
+#define BENCH_PERIOD_US     4000U
+#define BENCH_DURATION_MS   10000U
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t received;
+    uint32_t escaped;           /* Delivered with wrong contents */
+    bench_latency_t latency;
+} bench_result_t;
+
+static uint64_t sent_at_us[65536];
+static bench_result_t result;
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc)
+{
+    memset(&result, 0, sizeof(result));
+
+    bench_pair_t pair;
+    bench_pair_start(&pair, 2, NULL, NULL, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    uint64_t end_us = (uint64_t)BENCH_DURATION_MS * 1000U;
+    uint64_t next_send_us = 0;
+    uint16_t next_id = 0;
+    bool pending = false;
+    rc_command_payload_t cmd;
+
+    while (sim_time_us() < end_us) {
+        uint64_t now = sim_time_us();
+
+        /* Ground: a fresh command every period, the last one while busy */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (now >= next_send_us) {
+            bench_command(&cmd, next_id);
+            sent_at_us[next_id] = now;
+            next_id++;
+            pending = true;
+            result.sent++;
+            next_send_us += BENCH_PERIOD_US;
+        }
+
+        if (pending && rc_link_send_command(ground, &cmd) != RC_ERROR_BUSY) {
+            pending = false;
+        }
+
+        /* Aircraft: take commands */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        rc_command_payload_t rx;
+        while (rc_link_receive_command(aircraft, &rx) == RC_OK) {
+            if (rx.switches != BENCH_SWITCHES) {
+                break;  /* Failsafe values */
+            }
+
+            if (!bench_command_valid(&rx)) {
+                result.escaped++;
+                continue;
+            }
+
+            result.received++;
+            bench_record_latency(&result.latency,
+                                 (uint32_t)(sim_time_us() - sent_at_us[rx.channels[7]]));
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+
+    rc_stats_t as;
+    sim_channel_stats_t cs;
+    rc_link_get_stats(aircraft, &as);
+    sim_channel_get_stats(&cs);
+
+    bench_check(sc->name, "deliv",
+                result.sent ? 100.0 * result.received / result.sent : BENCH_MISSING);
+    bench_check(sc->name, "p99us",
+                result.latency.count ? bench_percentile(&result.latency, 99) : BENCH_MISSING);
+    bench_check(sc->name, "bad", result.escaped);
+
+    printf("%-16s %6.1f%% %7lu %7lu %7lu %6lu %6lu %6lu %6lu %6lu %5lu\n",
+           sc->name,
+           result.sent ? 100.0 * result.received / result.sent : 0.0,
+           (unsigned long)bench_percentile(&result.latency, 50),
+           (unsigned long)bench_percentile(&result.latency, 99),
+           (unsigned long)result.latency.max_us,
+           (unsigned long)cs.retransmits,
+           (unsigned long)cs.max_rt,
+           (unsigned long)cs.errored,
+           (unsigned long)as.fec_corrected,
+           (unsigned long)as.fec_uncorrectable,
+           (unsigned long)result.escaped);
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t hit10 = clean;
+    hit10.errors = 0.10;
+    hit10.error_bytes = 1;
+
+    sim_channel_t hit30 = clean;
+    hit30.errors = 0.30;
+    hit30.error_bytes = 1;
+
+    sim_channel_t hit_multi = clean;
+    hit_multi.errors = 0.20;
+    hit_multi.error_bytes = RC_FEC_PARITY / 2 + 1;
+
+    sim_channel_t lossy = clean;
+    lossy.loss = 0.10;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean",           clean },
+        { "1 byte 10%",      hit10 },
+        { "1 byte 30%",      hit30 },
+        { "beyond FEC 20%",  hit_multi },
+        { "loss 10%",        lossy },
+    };
+
+    printf("nrf_rc_link FEC (%s, %u Hz commands, %u us step)\n",
+           RC_ENABLE_FEC ? "FEC, no ACKs" : "auto-ACK, retransmits",
+           1000000U / BENCH_PERIOD_US, BENCH_STEP_US);
+    printf("%-16s %7s %7s %7s %7s %6s %6s %6s %6s %6s %5s\n",
+           "scenario", "deliv", "p50us", "p99us", "maxus",
+           "retx", "maxrt", "damage", "fixed", "unfix", "bad");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i]);
+    }
+
+    return bench_finish();
+}
@@ -0,0 +1,310 @@
+/**
+* @file link_bench.c
+ * @brief End-to-end link benchmark on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t against each other over the
+ * simulated radios (sim/) and reports, per channel scenario:
+ *   - commands delivered per second and delivery ratio
+ *   - latency from the send call to rc_link_receive_command() returning it
+ *     (p50 / p99 / max)
+ *   - CRC-catch rate: injected bit flips rejected by the link CRC, out of
+ *     those that hit checksummed bytes
+ *   - aircraft link quality / RSSI estimate (at the end, or when the channel
+ *     goes dead), and how long LQ takes to fall below 90% after that
+ *   - failsafe trigger time after the channel goes dead
+ *   - the ground's link profile at the end (RC_ENABLE_LINK_ADAPT)
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * link_bench (polling mode), link_bench_irq (RC_ENABLE_IRQ),
+ * link_bench_irq_reply (and RC_ENABLE_REPLY_WINDOW), link_bench_dma (and
+ * RC_ENABLE_SPI_DMA, the synchronous calls over DMA reads), link_bench_adapt
+ * (RC_ENABLE_LINK_ADAPT), link_bench_mailbox (RC_ENABLE_MAILBOX, where the
+ * receive side only sees the newest command), link_bench_noack
+ * (RC_ENABLE_NO_ACK) or link_bench_noack_repeat (each command sent twice).
+ * Times are virtual, so results are reproducible for a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include <stdio.h>
+#include <string.h>
+
+/** Aircraft answers every Nth command with telemetry */
+#define BENCH_TELEMETRY_DIV 10
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+    uint32_t rate_hz;           /* 0 = send as fast as the link allows */
+    uint32_t duration_ms;
+    uint32_t outage_ms;         /* Channel dies at this time (0 = never) */
+    int8_t fade_dbm;            /* At outage_ms the signal drops to this
+                                 * instead (0 = channel dies) */
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t received;
+    uint32_t escaped;           /* Delivered with wrong contents */
+    uint32_t telemetry;
+    uint64_t last_rx_us;
+    uint64_t failsafe_us;       /* 0 = not triggered */
+    uint64_t lq_drop_us;        /* Aircraft LQ first < 90% after the outage */
+    uint8_t lq;                 /* Aircraft LQ at the end / at the outage */
+    uint8_t rssi;
+    bench_latency_t latency;
+} bench_result_t;
+
+static uint64_t sent_at_us[65536];
+static bench_result_t result;
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc)
+{
+    memset(&result, 0, sizeof(result));
+
+    bench_pair_t pair;
+    bench_pair_start(&pair, 2, NULL, NULL, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    uint64_t end_us = (uint64_t)sc->duration_ms * 1000U;
+    uint64_t outage_us = (uint64_t)sc->outage_ms * 1000U;
+    uint64_t interval_us = sc->rate_hz ? 1000000U / sc->rate_hz : 0;
+    uint64_t next_send_us = 0;
+    uint16_t next_id = 0;
+    bool pending = false;
+    bool faded = false;
+    rc_command_payload_t cmd;
+
+    while (sim_time_us() < end_us) {
+        uint64_t now = sim_time_us();
+
+        if (outage_us && now >= outage_us && !faded) {
+            result.lq = rc_link_get_link_quality(aircraft);
+#if RC_ENABLE_RSSI
+            result.rssi = rc_link_get_rssi(aircraft);
+#endif
+            sim_channel_t after = sc->channel;
+            if (sc->fade_dbm) {
+                after.signal_dbm = sc->fade_dbm;
+            } else {
+                after.loss = 1.0;
+                after.burst_loss = 1.0;
+            }
+            sim_channel_set(&after);
+            faded = true;
+        }
+
+        /* Ground: send due commands, drain telemetry */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (!pending && now >= next_send_us) {
+            bench_command(&cmd, next_id);
+            sent_at_us[next_id] = now;
+            pending = true;
+            next_send_us = interval_us ? next_send_us + interval_us : now;
+        }
+
+        if (pending) {
+            rc_status_t status = rc_link_send_command(ground, &cmd);
+            if (status != RC_ERROR_BUSY) {
+                pending = false;
+                next_id++;
+                result.sent++;
+            }
+        }
+
+        rc_telemetry_payload_t telem;
+        sim_select(BENCH_GROUND);
+        while (rc_link_receive_telemetry(ground, &telem) == RC_OK) {
+            result.telemetry++;
+        }
+
+        /* Aircraft: take commands, answer some with telemetry */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        if (outage_us && now >= outage_us && result.lq_drop_us == 0 &&
+            rc_link_get_link_quality(aircraft) < 90) {
+            result.lq_drop_us = now;
+        }
+
+        rc_command_payload_t rx;
+        while (rc_link_receive_command(aircraft, &rx) == RC_OK) {
+            if (rx.switches != BENCH_SWITCHES) {
+                /* Failsafe values: note when they first appear after loss */
+                if (result.received > 0 && result.failsafe_us == 0 &&
+                    outage_us && sim_time_us() >= outage_us) {
+                    result.failsafe_us = sim_time_us();
+                }
+                break;
+            }
+
+            if (!bench_command_valid(&rx)) {
+                result.escaped++;
+                continue;
+            }
+
+            result.received++;
+            result.last_rx_us = sim_time_us();
+            bench_record_latency(&result.latency,
+                                 (uint32_t)(sim_time_us() - sent_at_us[rx.channels[7]]));
+
+            if (result.received % BENCH_TELEMETRY_DIV == 0) {
+                memset(&telem, 0, sizeof(telem));
+                telem.battery_mv = 11100;
+                telem.gps_sats = 9;
+                rc_link_send_telemetry(aircraft, &telem);
+            }
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    if (!outage_us || sc->fade_dbm) {
+        result.lq = rc_link_get_link_quality(aircraft);
+#if RC_ENABLE_RSSI
+        result.rssi = rc_link_get_rssi(aircraft);
+#endif
+    }
+
+    bench_pair_stop(&pair);
+
+    rc_stats_t gs, as;
+    sim_channel_stats_t cs;
+    rc_link_get_stats(ground, &gs);
+    rc_link_get_stats(aircraft, &as);
+    sim_channel_get_stats(&cs);
+
+    uint32_t active_ms = (sc->outage_ms && !sc->fade_dbm) ? sc->outage_ms : sc->duration_ms;
+    uint32_t caught = gs.crc_errors + gs.version_mismatches +
+                      as.crc_errors + as.version_mismatches;
+
+    bench_check(sc->name, "deliv",
+                result.sent ? 100.0 * result.received / result.sent : BENCH_MISSING);
+    bench_check(sc->name, "p99us",
+                result.latency.count ? bench_percentile(&result.latency, 99) : BENCH_MISSING);
+    bench_check(sc->name, "crc",
+                (caught + result.escaped) ? 100.0 * caught / (caught + result.escaped)
+                                          : BENCH_MISSING);
+    bench_check(sc->name, "failsafe",
+                result.failsafe_us ? (double)((result.failsafe_us - outage_us) / 1000U)
+                                   : BENCH_MISSING);
+
+    printf("%-14s %7lu %8.0f %6.1f%% %7lu %7lu %7lu %6lu",
+           sc->name,
+           (unsigned long)result.sent,
+           (double)result.received * 1000.0 / active_ms,
+           result.sent ? 100.0 * result.received / result.sent : 0.0,
+           (unsigned long)bench_percentile(&result.latency, 50),
+           (unsigned long)bench_percentile(&result.latency, 99),
+           (unsigned long)result.latency.max_us,
+           (unsigned long)cs.retransmits);
+
+    /* Flips in the unused tail of a static-width frame are harmless and
+     * neither caught nor escaped, so rate against what reached the CRC */
+    if (caught + result.escaped) {
+        printf(" %5.1f%%", 100.0 * caught / (caught + result.escaped));
+    } else {
+        printf(" %6s", "-");
+    }
+
+    printf(" %4u %4u", result.lq, result.rssi);
+
+    if (result.lq_drop_us) {
+        printf(" %5lu ms", (unsigned long)((result.lq_drop_us - outage_us) / 1000U));
+    } else {
+        printf(" %8s", "-");
+    }
+
+    if (result.failsafe_us && result.failsafe_us >= result.last_rx_us) {
+        printf(" %6lu/%lu ms",
+               (unsigned long)((result.failsafe_us - outage_us) / 1000U),
+               (unsigned long)((result.failsafe_us - result.last_rx_us) / 1000U));
+    } else if (result.failsafe_us) {
+        /* Link came back afterwards (fade) */
+        printf(" %9lu ms", (unsigned long)((result.failsafe_us - outage_us) / 1000U));
+    } else {
+        printf(" %12s", "-");
+    }
+
+#if RC_ENABLE_LINK_ADAPT
+    printf(" %4u", rc_link_adapt_get_profile(ground));
+#else
+    printf(" %4s", "-");
+#endif
+
+    printf("\n");
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t lossy = clean;
+    lossy.loss = 0.10;
+
+    sim_channel_t burst = clean;
+    burst.loss = 0.01;
+    burst.burst_enter = 0.02;
+    burst.burst_exit = 0.10;
+    burst.burst_loss = 0.80;
+
+    sim_channel_t corrupt = clean;
+    corrupt.corrupt = 0.01;
+
+    sim_channel_t far = clean;
+    far.latency_us = 200;
+    far.signal_dbm = -80;
+    far.loss = 0.05;
+
+    /* Past 1 and 2 Mbps sensitivity */
+    sim_channel_t range = clean;
+    range.signal_dbm = -89;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean max",  clean,   0,  2000, 0,    0 },
+        { "clean 50Hz", clean,   50, 5000, 0,    0 },
+        { "loss 10%",   lossy,   50, 5000, 0,    0 },
+        { "burst",      burst,   50, 5000, 0,    0 },
+        { "corrupt 1%", corrupt, 0,  5000, 0,    0 },
+        { "far",        far,     0,  2000, 0,    0 },
+        { "range",      range,   50, 5000, 0,    0 },
+        { "fade",       clean,   50, 6000, 3000, -89 },
+        { "failsafe",   clean,   50, 3000, 1000, 0 },
+    };
+
+#if RC_ENABLE_NO_ACK
+    char no_ack[32];
+    snprintf(no_ack, sizeof(no_ack), ", no-ACK commands x%u", RC_NO_ACK_REPEATS);
+#else
+    const char *no_ack = "";
+#endif
+
+    printf("nrf_rc_link simulation (%s%s%s%s%s, %u us step)\n",
+           RC_ENABLE_IRQ ? "IRQ" : "polling",
+           RC_ENABLE_SPI_DMA ? ", SPI DMA" : "",
+           RC_ENABLE_MAILBOX ? ", mailbox" : "",
+           RC_ENABLE_LINK_ADAPT ? ", link adaptation" : "", no_ack, BENCH_STEP_US);
+    printf("%-14s %7s %8s %7s %7s %7s %7s %6s %6s %4s %4s %8s %12s %4s\n",
+           "scenario", "sent", "rx/s", "deliv", "p50us", "p99us", "maxus",
+           "retx", "crc", "lq", "rssi", "lq<90", "failsafe", "prof");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i]);
+    }
+
+    return bench_finish();
+}
@@ -0,0 +1,295 @@
+/**
+* @file multi_bench.c
+ * @brief One ground radio serving several aircraft on the host simulation
+ *
+ * The ground rc_link_t owns radio 0 and talks to aircraft on pipes 0-2
+ * (RC_ENABLE_MULTI_LINK), sharing the uplink by weight through
+ * rc_link_next_peer(). Reports per aircraft and channel scenario:
+ *   - weight, commands sent to it and delivered per second
+ *   - delivery ratio and latency from the send call to the aircraft's
+ *     rc_link_receive_command() returning it (p50 / p99)
+ *   - telemetry frames the ground routed back to that peer's link
+ *   - when an aircraft powers down mid-run ("drop"), how long the ground
+ *     takes to declare that peer lost while the others carry on
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * multi_bench (polling mode) or multi_bench_irq (RC_ENABLE_IRQ with
+ * RC_ENABLE_REPLY_WINDOW, as every aircraft answers). Times are virtual, so
+ * results are reproducible for a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include "stm32f1xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+/** Aircraft on radios 1-3, after the ground's */
+#define BENCH_PEERS         3
+
+/** Aircraft answer every Nth command with telemetry */
+#define BENCH_TELEMETRY_DIV 5
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+    uint32_t rate_hz;           /* Total uplink rate, 0 = as fast as possible */
+    uint32_t duration_ms;
+    uint32_t drop_ms;           /* Last aircraft powers down then (0 = never) */
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t received;
+    uint32_t escaped;           /* Delivered with wrong contents, or to the wrong aircraft */
+    uint32_t telemetry;
+    uint64_t lost_us;           /* Ground declared the peer lost (0 = never) */
+    bench_latency_t latency;
+} bench_result_t;
+
+/** Aircraft addresses; bytes 1-4 are shared, as pipes 2-5 require */
+static const uint8_t bench_address[BENCH_PEERS][5] = {
+    { 0xA1, 0x5A, 0x5A, 0x5A, 0x5A },
+    { 0xA2, 0x5A, 0x5A, 0x5A, 0x5A },
+    { 0xA3, 0x5A, 0x5A, 0x5A, 0x5A },
+};
+
+static const uint8_t bench_weight[BENCH_PEERS] = { 2, 1, 1 };
+
+static uint64_t sent_at_us[BENCH_PEERS][65536];
+static bench_result_t result[BENCH_PEERS];
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+/* bench_command() with the aircraft it is for in channel 6 */
+static void bench_peer_command(rc_command_payload_t *cmd, uint8_t peer, uint16_t id)
+{
+    bench_command(cmd, id);
+    cmd->channels[6] = peer;
+}
+
+static bool bench_peer_command_valid(const rc_command_payload_t *cmd, uint8_t peer)
+{
+    rc_command_payload_t expect;
+    bench_peer_command(&expect, peer, cmd->channels[7]);
+    return memcmp(cmd, &expect, sizeof(expect)) == 0;
+}
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc)
+{
+    memset(result, 0, sizeof(result));
+    sim_reset(1 + BENCH_PEERS, BENCH_SEED);
+
+    rc_hardware_config_t hw = { .get_tick_ms = HAL_GetTick };
+    rc_link_t *ground = rc_link_instance(0);
+    rc_link_t *peers[BENCH_PEERS];
+    rc_link_t *aircraft[BENCH_PEERS];
+
+    /* Ground: itself on pipe 0, one peer link per further aircraft */
+    sim_select(BENCH_GROUND);
+    rc_link_init(ground, &hw);
+    rc_link_set_address(ground, bench_address[0]);
+    rc_link_set_peer_weight(ground, bench_weight[0]);
+    peers[0] = ground;
+
+    for (uint8_t i = 1; i < BENCH_PEERS; i++) {
+        peers[i] = rc_link_instance(i);
+        rc_link_add_peer(ground, i, peers[i], bench_address[i], bench_weight[i]);
+    }
+
+    for (uint8_t i = 0; i < BENCH_PEERS; i++) {
+        aircraft[i] = rc_link_instance(BENCH_PEERS + i);
+        sim_select(1 + i);
+        rc_link_init(aircraft[i], &hw);
+        rc_link_set_address(aircraft[i], bench_address[i]);
+#if RC_ENABLE_IRQ
+        sim_radio_set_irq(1 + i, bench_irq, aircraft[i]);
+#endif
+    }
+
+#if RC_ENABLE_IRQ
+    sim_radio_set_irq(BENCH_GROUND, bench_irq, ground);
+#endif
+
+    sim_channel_set(&sc->channel);
+
+    uint64_t end_us = (uint64_t)sc->duration_ms * 1000U;
+    uint64_t drop_us = (uint64_t)sc->drop_ms * 1000U;
+    uint64_t interval_us = sc->rate_hz ? 1000000U / sc->rate_hz : 0;
+    uint64_t next_send_us = 0;
+    uint16_t next_id[BENCH_PEERS] = { 0 };
+    bool dropped = false;
+    rc_link_t *target = NULL;
+    uint8_t target_idx = 0;
+    rc_command_payload_t cmd;
+
+    while (sim_time_us() < end_us) {
+        uint64_t now = sim_time_us();
+
+        if (drop_us && now >= drop_us && !dropped) {
+            sim_select(BENCH_PEERS);  /* Radio of the last aircraft */
+            rc_link_deinit(aircraft[BENCH_PEERS - 1]);
+            dropped = true;
+        }
+
+        /* Ground: one uplink slot at a time, shared by weight */
+        sim_select(BENCH_GROUND);
+        for (uint8_t i = 0; i < BENCH_PEERS; i++) {
+            rc_link_update(peers[i]);
+
+            if (drop_us && result[i].lost_us == 0 && now >= drop_us &&
+                !rc_link_is_active(peers[i])) {
+                result[i].lost_us = now;
+            }
+        }
+
+        if (!target && now >= next_send_us) {
+            target = rc_link_next_peer(ground);
+            for (uint8_t i = 0; i < BENCH_PEERS; i++) {
+                if (target == peers[i]) {
+                    target_idx = i;
+                }
+            }
+            bench_peer_command(&cmd, target_idx, next_id[target_idx]);
+            sent_at_us[target_idx][next_id[target_idx]] = now;
+            next_send_us = interval_us ? next_send_us + interval_us : now;
+        }
+
+        if (target) {
+            rc_status_t status = rc_link_send_command(target, &cmd);
+            if (status != RC_ERROR_BUSY) {
+                next_id[target_idx]++;
+                result[target_idx].sent++;
+                target = NULL;
+            }
+        }
+
+        rc_telemetry_payload_t telem;
+        for (uint8_t i = 0; i < BENCH_PEERS; i++) {
+            sim_select(BENCH_GROUND);
+            while (rc_link_receive_telemetry(peers[i], &telem) == RC_OK) {
+                if (telem.gps_sats == i) {
+                    result[i].telemetry++;
+                } else {
+                    result[i].escaped++;
+                }
+            }
+        }
+
+        /* Aircraft: take commands, answer some with telemetry */
+        for (uint8_t i = 0; i < BENCH_PEERS; i++) {
+            if (dropped && i == BENCH_PEERS - 1) {
+                continue;
+            }
+
+            sim_select(1 + i);
+            rc_link_update(aircraft[i]);
+
+            rc_command_payload_t rx;
+            while (rc_link_receive_command(aircraft[i], &rx) == RC_OK) {
+                if (rx.switches != BENCH_SWITCHES) {
+                    break;  /* Failsafe values */
+                }
+
+                if (!bench_peer_command_valid(&rx, i)) {
+                    result[i].escaped++;
+                    continue;
+                }
+
+                result[i].received++;
+                bench_record_latency(&result[i].latency,
+                                     (uint32_t)(sim_time_us() - sent_at_us[i][rx.channels[7]]));
+
+                if (result[i].received % BENCH_TELEMETRY_DIV == 0) {
+                    memset(&telem, 0, sizeof(telem));
+                    telem.battery_mv = 11100;
+                    telem.gps_sats = i;  /* Tags the sender */
+                    rc_link_send_telemetry(aircraft[i], &telem);
+                }
+            }
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    for (uint8_t i = 0; i < BENCH_PEERS; i++) {
+        sim_radio_set_irq(1 + i, NULL, NULL);
+        if (i > 0) {
+            sim_select(BENCH_GROUND);
+            rc_link_deinit(peers[i]);
+        }
+    }
+    sim_radio_set_irq(BENCH_GROUND, NULL, NULL);
+
+    for (uint8_t i = 0; i < BENCH_PEERS; i++) {
+        const bench_result_t *r = &result[i];
+        uint32_t active_ms = (sc->drop_ms && i == BENCH_PEERS - 1) ? sc->drop_ms : sc->duration_ms;
+
+        char row[32];
+        snprintf(row, sizeof(row), "%s/%u", sc->name, i);
+        bench_check(row, "deliv", r->sent ? 100.0 * r->received / r->sent : BENCH_MISSING);
+        bench_check(row, "p99us",
+                    r->latency.count ? bench_percentile(&r->latency, 99) : BENCH_MISSING);
+        bench_check(row, "bad", r->escaped);
+        bench_check(row, "lost",
+                    r->lost_us ? (double)((r->lost_us - drop_us) / 1000U) : BENCH_MISSING);
+
+        printf("%-12s %4u %3u %7lu %7.0f %6.1f%% %7lu %7lu %6lu %4lu",
+               i == 0 ? sc->name : "", i, bench_weight[i],
+               (unsigned long)r->sent,
+               (double)r->received * 1000.0 / active_ms,
+               r->sent ? 100.0 * r->received / r->sent : 0.0,
+               (unsigned long)bench_percentile(&r->latency, 50),
+               (unsigned long)bench_percentile(&r->latency, 99),
+               (unsigned long)r->telemetry,
+               (unsigned long)r->escaped);
+
+        if (r->lost_us) {
+            printf(" %6lu ms", (unsigned long)((r->lost_us - drop_us) / 1000U));
+        } else {
+            printf(" %9s", "-");
+        }
+
+        printf("\n");
+    }
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t lossy = clean;
+    lossy.loss = 0.10;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean max",   clean, 0,   2000, 0 },
+        { "clean 200Hz", clean, 200, 5000, 0 },
+        { "loss 10%",    lossy, 200, 5000, 0 },
+        { "drop",        clean, 200, 4000, 2000 },
+    };
+
+    printf("nrf_rc_link multi-link simulation (%s, %u aircraft, %u us step)\n",
+           RC_ENABLE_IRQ ? "IRQ" : "polling", BENCH_PEERS, BENCH_STEP_US);
+    printf("%-12s %4s %3s %7s %7s %7s %7s %7s %6s %4s %9s\n",
+           "scenario", "pipe", "wt", "sent", "rx/s", "deliv", "p50us", "p99us",
+           "telem", "bad", "lost");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i]);
+    }
+
+    return bench_finish();
+}
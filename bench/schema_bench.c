@@ -0,0 +1,433 @@
+/**
+* @file schema_bench.c
+ * @brief Generated payload codecs on the host simulation
+ *
+ * Defines an uplink gimbal payload and a downlink ESC payload with
+ * payload_schema.h, then:
+ *   - sizes: wire bytes and airtime against the same fields as a packed
+ *     struct of their C types
+ *   - codec: round trip of random values over every field, checked against
+ *     the value masked (and sign-extended) to the field's width
+ *   - link: the ground sends a gimbal every RC_UPDATE_RATE_HZ period, the
+ *     aircraft an ESC report after every BENCH_ESC_EVERY gimbals; both ends
+ *     decode through the generated dispatcher and check every field, and
+ *     count repeats of a seq (retransmits whose ACK was lost). Every
+ *     BENCH_STALE_EVERY periods the ground sends a gimbal one byte longer,
+ *     as a newer schema would, which must reach the fallback handler.
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * schema_bench (polling) or schema_bench_ack (IRQ, ESC on ACK payloads).
+ * Times are virtual, so results are reproducible for a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "payload_schema.h"
+#include "sim.h"
+#include "bench_common.h"
+#include "stm32f1xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_PERIOD_US     (1000000U / RC_UPDATE_RATE_HZ)
+#define BENCH_DURATION_MS   10000U
+
+/** Aircraft: ESC report after this many gimbals */
+#define BENCH_ESC_EVERY     4
+
+/** Ground: an over-long gimbal every this many periods */
+#define BENCH_STALE_EVERY   50
+
+/** Codec round trips */
+#define BENCH_CODEC_ROUNDS  100000U
+
+/*============================================================================*/
+/* Schema                                                                     */
+/*============================================================================*/
+
+#define GIMBAL_FIELDS(X) \
+    X(uint16_t, seq,     10) \
+    X(uint16_t, pan,     12) \
+    X(uint16_t, tilt,    12) \
+    X(uint16_t, roll,    12) \
+    X(int8_t,   trim,     5) \
+    X(uint8_t,  mode,     3) \
+    X(bool,     stabilise, 1)
+
+#define ESC_FIELDS(X) \
+    X(uint16_t, seq,     10) \
+    X(uint32_t, rpm,     17) \
+    X(int8_t,   temp_c,   8) \
+    X(uint16_t, current, 10) \
+    X(uint16_t, voltage, 11) \
+    X(uint8_t,  motor,    2)
+
+#define BENCH_PAYLOADS(P) \
+    P(gimbal, RC_PKT_USER_UP + 0,   GIMBAL_FIELDS) \
+    P(esc,    RC_PKT_USER_DOWN + 0, ESC_FIELDS)
+
+RC_SCHEMA_DEFINE(BENCH_PAYLOADS)
+RC_SCHEMA_DISPATCH(bench, BENCH_PAYLOADS)
+
+/* What the same fields cost as a hand-written packed struct */
+#define BENCH_PACKED_FIELD(type, field, bits)   type field;
+#define BENCH_PACKED(name, id, FIELDS) \
+    typedef struct __attribute__((packed)) { FIELDS(BENCH_PACKED_FIELD) } name##_packed_t;
+BENCH_PAYLOADS(BENCH_PACKED)
+
+/*============================================================================*/
+/* Values                                                                     */
+/*============================================================================*/
+
+typedef struct {
+    uint32_t sent;
+    uint32_t received;      /* Distinct seq */
+    uint32_t duplicates;    /* Retransmits whose ACK was lost */
+    uint32_t errors;        /* Field differs from what was sent */
+    int32_t last_seq;
+} bench_count_t;
+
+typedef struct {
+    bench_count_t gimbal;
+    bench_count_t esc;
+    uint32_t stale_sent;
+    uint32_t stale_received;
+    uint32_t other;         /* Fallback frames that are not the stale gimbal */
+    uint32_t esc_due;       /* Aircraft: reports owed */
+    uint16_t esc_seq;
+} bench_result_t;
+
+static bench_result_t result;
+static uint32_t rng_state;
+
+static uint32_t bench_rand(void)
+{
+    /* xorshift32 */
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* Field values are a function of seq, so the receiver can check them */
+static uint32_t bench_mix(uint32_t seq, uint32_t salt)
+{
+    uint32_t x = (seq + 1U) * 0x9E3779B1U ^ salt;
+
+    x ^= x >> 15;
+    x *= 0x85EBCA6BU;
+    x ^= x >> 13;
+    return x;
+}
+
+static void bench_gimbal(uint16_t seq, gimbal_t *g)
+{
+    g->seq = seq & 0x3FF;
+    g->pan = (uint16_t)(bench_mix(seq, 1) & 0xFFF);
+    g->tilt = (uint16_t)(bench_mix(seq, 2) & 0xFFF);
+    g->roll = (uint16_t)(bench_mix(seq, 3) & 0xFFF);
+    g->trim = (int8_t)((int32_t)(bench_mix(seq, 4) % 32) - 16);
+    g->mode = (uint8_t)(bench_mix(seq, 5) & 0x07);
+    g->stabilise = (bench_mix(seq, 6) & 1) != 0;
+}
+
+static void bench_esc(uint16_t seq, esc_t *e)
+{
+    e->seq = seq & 0x3FF;
+    e->rpm = bench_mix(seq, 7) & 0x1FFFF;
+    e->temp_c = (int8_t)((int32_t)(bench_mix(seq, 8) % 256) - 128);
+    e->current = (uint16_t)(bench_mix(seq, 9) & 0x3FF);
+    e->voltage = (uint16_t)(bench_mix(seq, 10) & 0x7FF);
+    e->motor = (uint8_t)(bench_mix(seq, 11) & 0x03);
+}
+
+/* Sends go out in seq order, so a repeat is the last one again */
+static bool bench_count(bench_count_t *count, uint16_t seq, bool equal)
+{
+    if ((int32_t)seq == count->last_seq) {
+        count->duplicates++;
+        return false;
+    }
+
+    count->last_seq = seq;
+    count->received++;
+    count->errors += !equal;
+    return true;
+}
+
+static bool bench_gimbal_equal(const gimbal_t *a, const gimbal_t *b)
+{
+    return a->seq == b->seq && a->pan == b->pan && a->tilt == b->tilt && a->roll == b->roll &&
+           a->trim == b->trim && a->mode == b->mode && a->stabilise == b->stabilise;
+}
+
+static bool bench_esc_equal(const esc_t *a, const esc_t *b)
+{
+    return a->seq == b->seq && a->rpm == b->rpm && a->temp_c == b->temp_c &&
+           a->current == b->current && a->voltage == b->voltage && a->motor == b->motor;
+}
+
+/*============================================================================*/
+/* Sizes and Codec                                                            */
+/*============================================================================*/
+
+static void bench_sizes(void)
+{
+    rc_link_t *link = rc_link_instance(BENCH_GROUND);
+    rc_hardware_config_t hw = { .get_tick_ms = HAL_GetTick };
+
+    sim_reset(1, BENCH_SEED);
+    sim_select(BENCH_GROUND);
+    rc_link_init(link, &hw);
+
+    printf("%-8s %5s %7s %7s %9s %9s\n", "payload", "bits", "schema", "struct",
+           "air(us)", "struct(us)");
+    printf("%-8s %5d %6dB %6uB %9lu %9lu\n", "gimbal", gimbal_bits, gimbal_size,
+           (unsigned)sizeof(gimbal_packed_t),
+           (unsigned long)rc_link_get_airtime_us(link, gimbal_size),
+           (unsigned long)rc_link_get_airtime_us(link, sizeof(gimbal_packed_t)));
+    printf("%-8s %5d %6dB %6uB %9lu %9lu\n", "esc", esc_bits, esc_size,
+           (unsigned)sizeof(esc_packed_t),
+           (unsigned long)rc_link_get_airtime_us(link, esc_size),
+           (unsigned long)rc_link_get_airtime_us(link, sizeof(esc_packed_t)));
+}
+
+static void bench_codec(void)
+{
+    uint32_t errors = 0;
+    uint8_t wire[RC_MAX_PAYLOAD_SIZE];
+
+    rng_state = BENCH_SEED;
+
+    for (uint32_t i = 0; i < BENCH_CODEC_ROUNDS; i++) {
+        gimbal_t g, g_out, g_want;
+        esc_t e, e_out, e_want;
+
+        /* Full-range values; what comes back is their low bits */
+        g.seq = (uint16_t)bench_rand();
+        g.pan = (uint16_t)bench_rand();
+        g.tilt = (uint16_t)bench_rand();
+        g.roll = (uint16_t)bench_rand();
+        g.trim = (int8_t)bench_rand();
+        g.mode = (uint8_t)bench_rand();
+        g.stabilise = (bench_rand() & 1) != 0;
+
+        g_want = g;
+        g_want.seq &= 0x3FF;
+        g_want.pan &= 0xFFF;
+        g_want.tilt &= 0xFFF;
+        g_want.roll &= 0xFFF;
+        g_want.trim = (int8_t)(((g.trim & 0x1F) ^ 0x10) - 0x10);
+        g_want.mode &= 0x07;
+
+        gimbal_encode(&g, wire);
+        gimbal_decode(wire, &g_out);
+        errors += !bench_gimbal_equal(&g_out, &g_want);
+
+        e.seq = (uint16_t)bench_rand();
+        e.rpm = bench_rand();
+        e.temp_c = (int8_t)bench_rand();
+        e.current = (uint16_t)bench_rand();
+        e.voltage = (uint16_t)bench_rand();
+        e.motor = (uint8_t)bench_rand();
+
+        e_want = e;
+        e_want.seq &= 0x3FF;
+        e_want.rpm &= 0x1FFFF;
+        e_want.current &= 0x3FF;
+        e_want.voltage &= 0x7FF;
+        e_want.motor &= 0x03;
+
+        esc_encode(&e, wire);
+        esc_decode(wire, &e_out);
+        errors += !bench_esc_equal(&e_out, &e_want);
+    }
+
+    bench_check("codec", "err", errors);
+    printf("codec: %lu round trips per payload, %lu errors\n",
+           (unsigned long)BENCH_CODEC_ROUNDS, (unsigned long)errors);
+}
+
+/*============================================================================*/
+/* Handlers                                                                   */
+/*============================================================================*/
+
+static void on_gimbal(rc_link_t *link, const gimbal_t *msg, void *ctx)
+{
+    gimbal_t want;
+
+    (void)link;
+    (void)ctx;
+    bench_gimbal(msg->seq, &want);
+    if (bench_count(&result.gimbal, msg->seq, bench_gimbal_equal(msg, &want))) {
+        result.esc_due += (result.gimbal.received % BENCH_ESC_EVERY == 0);
+    }
+}
+
+static void on_esc(rc_link_t *link, const esc_t *msg, void *ctx)
+{
+    esc_t want;
+
+    (void)link;
+    (void)ctx;
+    bench_esc(msg->seq, &want);
+    bench_count(&result.esc, msg->seq, bench_esc_equal(msg, &want));
+}
+
+static void on_other(rc_link_t *link, uint8_t type, const void *payload, uint8_t payload_len,
+                     void *ctx)
+{
+    (void)link;
+    (void)payload;
+    (void)ctx;
+
+    if (type == gimbal_type && payload_len == gimbal_size + 1) {
+        result.stale_received++;
+    } else {
+        result.other++;
+    }
+}
+
+/* A gimbal from a newer schema: one field more */
+static rc_status_t bench_send_stale(rc_link_t *link, const gimbal_t *g)
+{
+    void *payload;
+    rc_status_t status = rc_link_tx_acquire(link, gimbal_type, gimbal_size + 1, &payload);
+
+    if (status != RC_OK) {
+        return status;
+    }
+
+    gimbal_encode(g, (uint8_t *)payload);
+    ((uint8_t *)payload)[gimbal_size] = 0x5A;
+    return rc_link_tx_commit(link);
+}
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const char *name, const sim_channel_t *channel)
+{
+    memset(&result, 0, sizeof(result));
+    result.gimbal.last_seq = -1;
+    result.esc.last_seq = -1;
+
+    bench_pair_t pair;
+    bench_handlers_t handlers = {
+        .gimbal = on_gimbal,
+        .esc = on_esc,
+        .fallback = on_other,
+    };
+
+    bench_pair_start(&pair, 2, NULL, NULL, channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    uint64_t end_us = (uint64_t)BENCH_DURATION_MS * 1000U;
+    uint64_t next_send_us = sim_time_us();
+    uint32_t periods = 0;
+    uint16_t seq = 0;
+    bool pending = false;
+    bool stale = false;
+
+    while (sim_time_us() < end_us) {
+        /* Ground: a gimbal every period */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (sim_time_us() >= next_send_us) {
+            stale = (++periods % BENCH_STALE_EVERY == 0);
+            pending = true;
+            next_send_us += BENCH_PERIOD_US;
+        }
+
+        if (pending) {
+            gimbal_t g;
+            bench_gimbal(seq, &g);
+
+            rc_status_t status = stale ? bench_send_stale(ground, &g) : gimbal_send(ground, &g);
+            if (status != RC_ERROR_BUSY) {
+                pending = false;
+                if (stale) {
+                    result.stale_sent++;
+                } else {
+                    result.gimbal.sent++;
+                    seq++;
+                }
+            }
+        }
+
+        rc_link_process_rx(ground, bench_dispatch, &handlers);
+
+        /* Aircraft: ESC reports as gimbals arrive */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+        rc_link_process_rx(aircraft, bench_dispatch, &handlers);
+
+        if (result.esc_due > 0) {
+            esc_t e;
+            bench_esc(result.esc_seq, &e);
+
+            if (esc_send(aircraft, &e) == RC_OK) {
+                result.esc_due--;
+                result.esc_seq++;
+                result.esc.sent++;
+            }
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+
+    bench_check(name, "gimbal rx",
+                result.gimbal.sent ? 100.0 * result.gimbal.received / result.gimbal.sent
+                                   : BENCH_MISSING);
+    bench_check(name, "gimbal err", result.gimbal.errors);
+    bench_check(name, "esc rx",
+                result.esc.sent ? 100.0 * result.esc.received / result.esc.sent : BENCH_MISSING);
+    bench_check(name, "esc err", result.esc.errors);
+
+    printf("%-10s %6lu %6.1f%% %4lu %4lu %5lu %6.1f%% %4lu %4lu %5lu/%-5lu %5lu\n",
+           name,
+           (unsigned long)result.gimbal.sent,
+           result.gimbal.sent ? 100.0 * result.gimbal.received / result.gimbal.sent : 0.0,
+           (unsigned long)result.gimbal.duplicates,
+           (unsigned long)result.gimbal.errors,
+           (unsigned long)result.esc.sent,
+           result.esc.sent ? 100.0 * result.esc.received / result.esc.sent : 0.0,
+           (unsigned long)result.esc.duplicates,
+           (unsigned long)result.esc.errors,
+           (unsigned long)result.stale_received,
+           (unsigned long)result.stale_sent,
+           (unsigned long)result.other);
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t loss30 = clean;
+    loss30.loss = 0.30;
+
+    printf("nrf_rc_link payload schema (%s%s, %u Hz gimbal, ESC every %u)\n",
+           RC_ENABLE_IRQ ? "IRQ" : "polling",
+           RC_ENABLE_ACK_TELEMETRY ? " + ACK telemetry" : "",
+           RC_UPDATE_RATE_HZ, BENCH_ESC_EVERY);
+
+    bench_sizes();
+    bench_codec();
+
+    printf("%-10s %6s %7s %4s %4s %5s %7s %4s %4s %11s %5s\n",
+           "scenario", "gimbal", "rx", "dup", "err", "esc", "rx", "dup", "err", "stale", "other");
+    bench_run("clean", &clean);
+    bench_run("loss 30%", &loss30);
+
+    return bench_finish();
+}
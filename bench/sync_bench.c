@@ -0,0 +1,265 @@
+/**
+* @file sync_bench.c
+ * @brief Round trip and clock offset estimates on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t with RC_ENABLE_CLOCK_SYNC. The
+ * aircraft's get_tick_us runs BENCH_OFFSET_US ahead of the ground's and
+ * drifts by the scenario's ppm. The ground sends a command every
+ * RC_UPDATE_RATE_HZ period, a ping in its place whenever
+ * rc_link_sync_pending() says so; the aircraft sends telemetry after
+ * every BENCH_TELEMETRY_EVERY commands. Per scenario it reports:
+ *   - pings sent and samples taken (echo matched to an ACKed ping)
+ *   - round trip of the pings ACKed (p50 / max) and the filtered one
+ *   - error of the offset estimate against the true offset at each new
+ *     sample (mean / max of the absolute value)
+ *   - commands and telemetry delivered, to show the pings cost little
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * sync_bench (polling) or sync_bench_ack (IRQ, echoes on ACK payloads).
+ * Times are virtual, so results are reproducible for a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include "stm32f1xx_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_PERIOD_US     (1000000U / RC_UPDATE_RATE_HZ)
+#define BENCH_DURATION_MS   20000U
+
+/** Aircraft clock at ground time 0 */
+#define BENCH_OFFSET_US     1234567
+
+/** Aircraft: telemetry after this many commands */
+#define BENCH_TELEMETRY_EVERY 5
+
+/** Round trips kept for the percentiles */
+#define BENCH_MAX_SAMPLES   1024
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+    int32_t drift_ppm;          /* Aircraft clock against the ground's */
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t pings;
+    uint32_t samples;
+    uint32_t rtt[BENCH_MAX_SAMPLES];    /* Each ping ACKed, rc_stats_t.sync_rtt_last_us */
+    uint32_t rtt_count;
+    uint32_t rtt_filtered;
+    double error_sum;
+    uint32_t error_max;
+    uint32_t commands_sent;
+    uint32_t commands_received;
+    uint32_t telemetry_sent;
+    uint32_t telemetry_received;
+} bench_result_t;
+
+static bench_result_t result;
+static int32_t drift_ppm;
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+static uint32_t bench_ground_us(void)
+{
+    return (uint32_t)sim_time_us();
+}
+
+static uint32_t bench_aircraft_us(void)
+{
+    int64_t t = (int64_t)sim_time_us();
+
+    return (uint32_t)(BENCH_OFFSET_US + t + t * drift_ppm / 1000000);
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void bench_take_sample(rc_link_t *ground)
+{
+    rc_stats_t stats;
+    uint32_t rtt;
+    int32_t offset;
+
+    if (rc_link_get_stats(ground, &stats) != RC_OK || stats.sync_samples == result.samples ||
+        rc_link_get_clock_sync(ground, &rtt, &offset) != RC_OK) {
+        return;
+    }
+
+    result.samples = stats.sync_samples;
+    if (result.rtt_count < BENCH_MAX_SAMPLES) {
+        result.rtt[result.rtt_count++] = stats.sync_rtt_last_us;
+    }
+    result.rtt_filtered = rtt;
+
+    int32_t truth = (int32_t)(bench_aircraft_us() - bench_ground_us());
+    int32_t error = offset - truth;
+    uint32_t magnitude = (uint32_t)(error < 0 ? -error : error);
+
+    result.error_sum += magnitude;
+    if (magnitude > result.error_max) {
+        result.error_max = magnitude;
+    }
+}
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc)
+{
+    memset(&result, 0, sizeof(result));
+    drift_ppm = sc->drift_ppm;
+
+    rc_hardware_config_t ground_hw = { .get_tick_ms = HAL_GetTick, .get_tick_us = bench_ground_us };
+    rc_hardware_config_t aircraft_hw = { .get_tick_ms = HAL_GetTick,
+                                         .get_tick_us = bench_aircraft_us };
+    bench_pair_t pair;
+
+    bench_pair_start(&pair, 2, &ground_hw, &aircraft_hw, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    uint64_t end_us = (uint64_t)BENCH_DURATION_MS * 1000U;
+    uint64_t next_send_us = sim_time_us();
+    bool pending = false;
+    bool ping = false;
+    uint32_t heard = 0;
+    rc_command_payload_t cmd;
+
+    bench_command(&cmd, 0);
+
+    while (sim_time_us() < end_us) {
+        /* Ground: a command or a ping every period */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (sim_time_us() >= next_send_us) {
+            ping = rc_link_sync_pending(ground);
+            pending = true;
+            next_send_us += BENCH_PERIOD_US;
+        }
+
+        if (pending) {
+            rc_status_t status = ping ? rc_link_sync_ping(ground) : rc_link_send_command(ground, &cmd);
+
+            if (status != RC_ERROR_BUSY) {
+                pending = false;
+                if (ping) {
+                    result.pings++;
+                } else {
+                    result.commands_sent++;
+                }
+            }
+        }
+
+        rc_telemetry_payload_t tlm;
+        while (rc_link_receive_telemetry(ground, &tlm) == RC_OK) {
+            result.telemetry_received++;
+        }
+
+        bench_take_sample(ground);
+
+        /* Aircraft: commands in, telemetry out now and then */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        rc_command_payload_t rx;
+        while (rc_link_receive_command(aircraft, &rx) == RC_OK && rx.switches == BENCH_SWITCHES) {
+            result.commands_received++;
+
+            if (++heard % BENCH_TELEMETRY_EVERY == 0) {
+                memset(&tlm, 0, sizeof(tlm));
+                if (rc_link_send_telemetry(aircraft, &tlm) == RC_OK) {
+                    result.telemetry_sent++;
+                }
+            }
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+
+    qsort(result.rtt, result.rtt_count, sizeof(result.rtt[0]), cmp_u32);
+
+    bench_check(sc->name, "samples", result.samples);
+    bench_check(sc->name, "errMean",
+                result.samples ? result.error_sum / result.samples : BENCH_MISSING);
+    bench_check(sc->name, "errMax", result.samples ? result.error_max : BENCH_MISSING);
+    bench_check(sc->name, "cmds",
+                result.commands_sent ? 100.0 * result.commands_received / result.commands_sent
+                                     : BENCH_MISSING);
+    bench_check(sc->name, "tlm",
+                result.telemetry_sent ? 100.0 * result.telemetry_received / result.telemetry_sent
+                                      : BENCH_MISSING);
+
+    printf("%-14s %5ld %5lu %7lu %6lu %6lu %6lu %7.1f %6lu %6.1f%% %6.1f%%\n",
+           sc->name,
+           (long)sc->drift_ppm,
+           (unsigned long)result.pings,
+           (unsigned long)result.samples,
+           result.rtt_count ? (unsigned long)result.rtt[result.rtt_count / 2] : 0UL,
+           result.rtt_count ? (unsigned long)result.rtt[result.rtt_count - 1] : 0UL,
+           (unsigned long)result.rtt_filtered,
+           result.samples ? result.error_sum / result.samples : 0.0,
+           (unsigned long)result.error_max,
+           result.commands_sent ? 100.0 * result.commands_received / result.commands_sent : 0.0,
+           result.telemetry_sent ? 100.0 * result.telemetry_received / result.telemetry_sent : 0.0);
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t latency = clean;
+    latency.latency_us = 500;
+
+    sim_channel_t loss30 = clean;
+    loss30.loss = 0.30;
+
+    sim_channel_t burst = clean;
+    burst.loss = 0.01;
+    burst.burst_enter = 0.02;
+    burst.burst_exit = 0.10;
+    burst.burst_loss = 0.80;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean",        clean,   0 },
+        { "clean",        clean,   50 },
+        { "latency 500us", latency, 50 },
+        { "loss 30%",     loss30,  50 },
+        { "burst",        burst,   50 },
+    };
+
+    printf("nrf_rc_link clock sync (%s%s, ping every %u ms, window %u, %u Hz commands)\n",
+           RC_ENABLE_IRQ ? "IRQ" : "polling",
+           RC_ENABLE_ACK_TELEMETRY ? " + ACK telemetry" : "",
+           RC_SYNC_INTERVAL_MS, RC_SYNC_WINDOW, RC_UPDATE_RATE_HZ);
+    printf("%-14s %5s %5s %7s %6s %6s %6s %7s %6s %7s %7s\n",
+           "scenario", "ppm", "pings", "samples", "rtt50", "rttmax", "rttF",
+           "errMean", "errMax", "cmds", "tlm");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i]);
+    }
+
+    return bench_finish();
+}
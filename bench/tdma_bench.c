@@ -0,0 +1,219 @@
+/**
+* @file tdma_bench.c
+ * @brief TDMA slot schedule on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t with RC_ENABLE_TDMA, each with
+ * its own simulated slot timer calling rc_link_tdma_tick(). Both main
+ * loops stage about one payload per frame, unsynchronized to the slots:
+ * the ground a new command, the aircraft a telemetry frame, which goes out
+ * in the next downlink slot.
+ * Per scenario it reports:
+ *   - uplink and downlink frames received per second, and their ratio
+ *     (RC_TDMA_TELEMETRY_RATIO on a clean channel)
+ *   - staged commands delivered, and latency from staging to
+ *     rc_link_receive_command() returning them (p50 / p99 / max)
+ *   - slot jitter: largest deviation of the gap between consecutive
+ *     uplink frames at the aircraft from the frame period
+ *   - uplink slots the ground and downlink slots the aircraft skipped
+ *     because the radio or SPI was still busy
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * tdma_bench (250 Hz) or tdma_bench_500 (500 Hz). Times are virtual, so
+ * results are reproducible for a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_FRAME_US      (1000000U / RC_TDMA_RATE_HZ)
+
+/** Main loops stage on their own clock, 1% slow, so staging sweeps every
+ *  phase of the frame without two landing in one */
+#define BENCH_STAGE_US      (BENCH_FRAME_US + BENCH_FRAME_US / 100U)
+#define BENCH_DURATION_MS   5000U
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t staged;
+    uint32_t delivered;         /* Staged commands the aircraft saw */
+    uint32_t uplink;            /* Frames the aircraft received, repeats too */
+    uint32_t downlink;          /* Telemetry frames the ground received */
+    uint32_t jitter_us;
+    bench_latency_t latency;
+} bench_result_t;
+
+static uint64_t staged_at_us[65536];
+static bench_result_t result;
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc)
+{
+    memset(&result, 0, sizeof(result));
+
+    bench_pair_t pair;
+    bench_pair_start(&pair, 2, NULL, NULL, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    uint64_t end_us = (uint64_t)BENCH_DURATION_MS * 1000U;
+    uint64_t next_stage_us = 0;
+    uint64_t last_uplink_us = 0;
+    uint16_t next_id = 0;
+    uint16_t last_id = 0;
+    bool seen = false;
+
+    while (sim_time_us() < end_us) {
+        uint64_t now = sim_time_us();
+        bool stage = now >= next_stage_us;
+
+        if (stage) {
+            next_stage_us += BENCH_STAGE_US;
+        }
+
+        /* Ground: stage the next command, count telemetry */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (stage) {
+            rc_command_payload_t cmd;
+            bench_command(&cmd, next_id);
+            staged_at_us[next_id] = now;
+            if (rc_link_send_command(ground, &cmd) == RC_OK) {
+                next_id++;
+                result.staged++;
+            }
+        }
+
+        rc_telemetry_payload_t telem;
+        while (rc_link_receive_telemetry(ground, &telem) == RC_OK) {
+            result.downlink++;
+        }
+
+        /* Aircraft: take every uplink frame, stage telemetry */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        rc_command_payload_t rx;
+        while (rc_link_receive_command(aircraft, &rx) == RC_OK) {
+            if (rx.switches != BENCH_SWITCHES || !bench_command_valid(&rx)) {
+                break;  /* Failsafe values */
+            }
+
+            uint64_t rx_us = sim_time_us();
+            if (result.uplink > 0 && rx_us - last_uplink_us < 2U * BENCH_FRAME_US) {
+                uint64_t gap = rx_us - last_uplink_us;
+                uint32_t off = (uint32_t)(gap > BENCH_FRAME_US ? gap - BENCH_FRAME_US
+                                                               : BENCH_FRAME_US - gap);
+                if (off > result.jitter_us) {
+                    result.jitter_us = off;
+                }
+            }
+            last_uplink_us = rx_us;
+            result.uplink++;
+
+            /* The ground repeats its last command between new ones */
+            uint16_t id = rx.channels[7];
+            if (!seen || id != last_id) {
+                result.delivered++;
+                bench_record_latency(&result.latency, (uint32_t)(rx_us - staged_at_us[id]));
+                last_id = id;
+                seen = true;
+            }
+        }
+
+        if (stage) {
+            memset(&telem, 0, sizeof(telem));
+            telem.battery_mv = 11100;
+            telem.gps_sats = 9;
+            rc_link_send_telemetry(aircraft, &telem);
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+
+    rc_stats_t gs, as;
+    rc_link_get_stats(ground, &gs);
+    rc_link_get_stats(aircraft, &as);
+
+    bench_check(sc->name, "up/s", (double)result.uplink * 1000.0 / BENCH_DURATION_MS);
+    bench_check(sc->name, "down/s", (double)result.downlink * 1000.0 / BENCH_DURATION_MS);
+    bench_check(sc->name, "ratio",
+                result.downlink ? (double)result.uplink / result.downlink : BENCH_MISSING);
+    bench_check(sc->name, "deliv",
+                result.staged ? 100.0 * result.delivered / result.staged : BENCH_MISSING);
+    bench_check(sc->name, "p99us",
+                result.latency.count ? bench_percentile(&result.latency, 99) : BENCH_MISSING);
+    bench_check(sc->name, "jitter", result.jitter_us);
+    bench_check(sc->name, "upOvr", gs.tdma_uplink_overruns);
+    bench_check(sc->name, "dnOvr", as.tdma_downlink_overruns);
+
+    printf("%-14s %6.0f %6.0f %6.2f %6.1f%% %6lu %6lu %6lu %6lu %6lu %6lu\n",
+           sc->name,
+           (double)result.uplink * 1000.0 / BENCH_DURATION_MS,
+           (double)result.downlink * 1000.0 / BENCH_DURATION_MS,
+           result.downlink ? (double)result.uplink / result.downlink : 0.0,
+           result.staged ? 100.0 * result.delivered / result.staged : 0.0,
+           (unsigned long)bench_percentile(&result.latency, 50),
+           (unsigned long)bench_percentile(&result.latency, 99),
+           (unsigned long)result.latency.max_us,
+           (unsigned long)result.jitter_us,
+           (unsigned long)gs.tdma_uplink_overruns,
+           (unsigned long)as.tdma_downlink_overruns);
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t lossy = clean;
+    lossy.loss = 0.10;
+
+    sim_channel_t burst = clean;
+    burst.loss = 0.01;
+    burst.burst_enter = 0.02;
+    burst.burst_exit = 0.10;
+    burst.burst_loss = 0.80;
+
+    sim_channel_t far = clean;
+    far.latency_us = 200;
+    far.signal_dbm = -80;
+    far.loss = 0.05;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean",    clean },
+        { "loss 10%", lossy },
+        { "burst",    burst },
+        { "far",      far },
+    };
+
+    printf("nrf_rc_link TDMA (%u Hz frames, downlink every %u, %u us slots, %u us step)\n",
+           RC_TDMA_RATE_HZ, RC_TDMA_TELEMETRY_RATIO, (unsigned)RC_TDMA_HALF_FRAME_US,
+           BENCH_STEP_US);
+    printf("%-14s %6s %6s %6s %7s %6s %6s %6s %6s %6s %6s\n",
+           "scenario", "up/s", "down/s", "ratio", "deliv", "p50us", "p99us", "maxus",
+           "jitter", "upOvr", "dnOvr");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i]);
+    }
+
+    return bench_finish();
+}
@@ -0,0 +1,223 @@
+/**
+ * @file telemetry_bench.c
+ * @brief Multiplexed telemetry scheduling on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t. The ground sends commands at
+ * BENCH_COMMAND_HZ; the aircraft answers every Nth one with an
+ * RC_PKT_TELEMETRY_MUX frame built from a set of items with different
+ * target rates and priorities. Per scenario and item it reports:
+ *   - target rate, priority and value size
+ *   - the rate the ground cache was actually updated at
+ *   - the longest gap between updates
+ * and per scenario the frames sent and their mean payload. The over-budget
+ * scenario halves the downlink rate: frames fill up and the 50 Hz item is
+ * capped at the frame rate, while the slower items keep theirs.
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * telemetry_bench. Times are virtual, so results are reproducible for a
+ * given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include "stm32f1xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_COMMAND_HZ    250
+
+typedef struct {
+    uint8_t id;
+    const char *name;
+    uint8_t len;
+    uint16_t rate_hz;
+    uint8_t priority;
+} bench_item_t;
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+    uint8_t telemetry_div;      /* Telemetry frame every Nth command */
+    uint32_t duration_ms;
+} bench_scenario_t;
+
+static const bench_item_t items[] = {
+    { RC_TLM_CURRENT_MA,  "current",  2, 50, 3 },
+    { RC_TLM_ATTITUDE,    "attitude", 6, 25, 2 },
+    { RC_TLM_BATTERY_MV,  "battery",  2, 10, 2 },
+    { RC_TLM_VARIO,       "vario",    2, 10, 1 },
+    { RC_TLM_HEADING,     "heading",  2, 10, 1 },
+    { RC_TLM_GPS_POS,     "gps pos",  8, 5,  1 },
+    { RC_TLM_GPS_ALT,     "gps alt",  2, 5,  1 },
+    { RC_TLM_GROUNDSPEED, "speed",    2, 5,  1 },
+    { RC_TLM_RSSI,        "rssi",     1, 5,  0 },
+    { RC_TLM_FLIGHT_MODE, "mode",     1, 2,  0 },
+    { RC_TLM_GPS_SATS,    "gps sats", 1, 1,  0 },
+    { RC_TLM_ERROR_FLAGS, "errors",   1, 1,  0 },
+};
+
+#define BENCH_ITEMS         (sizeof(items) / sizeof(items[0]))
+
+static rc_tlm_mux_t mux;
+static rc_tlm_cache_t cache;
+
+static uint32_t seen_updates[BENCH_ITEMS];
+static uint32_t seen_time_ms[BENCH_ITEMS];
+static uint32_t max_gap_ms[BENCH_ITEMS];
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+static void bench_mux_init(void)
+{
+    rc_tlm_mux_init(&mux);
+
+    for (size_t i = 0; i < BENCH_ITEMS; i++) {
+        rc_tlm_register(&mux, items[i].id, items[i].len, items[i].rate_hz, items[i].priority);
+    }
+}
+
+static void bench_sensors(uint32_t sample)
+{
+    /* Every item changes every sample; RSSI comes from the link */
+    uint8_t value[RC_TLM_MAX_ITEM_SIZE];
+
+    for (size_t i = 0; i < BENCH_ITEMS; i++) {
+        for (uint8_t b = 0; b < items[i].len; b++) {
+            value[b] = (uint8_t)(sample + i + b);
+        }
+        rc_tlm_set(&mux, items[i].id, value);
+    }
+}
+
+static void bench_track(uint32_t start_ms)
+{
+    for (size_t i = 0; i < BENCH_ITEMS; i++) {
+        const rc_tlm_value_t *v = rc_tlm_cache_get(&cache, items[i].id);
+        if (!v || v->updates == seen_updates[i]) {
+            continue;
+        }
+
+        uint32_t since = seen_updates[i] ? seen_time_ms[i] : start_ms;
+        if (v->time_ms - since > max_gap_ms[i]) {
+            max_gap_ms[i] = v->time_ms - since;
+        }
+        seen_updates[i] = v->updates;
+        seen_time_ms[i] = v->time_ms;
+    }
+}
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc)
+{
+    memset(seen_updates, 0, sizeof(seen_updates));
+    memset(seen_time_ms, 0, sizeof(seen_time_ms));
+    memset(max_gap_ms, 0, sizeof(max_gap_ms));
+
+    bench_pair_t pair;
+    bench_pair_start(&pair, 2, NULL, NULL, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    bench_mux_init();
+    rc_tlm_cache_init(&cache);
+
+    uint64_t end_us = (uint64_t)sc->duration_ms * 1000U;
+    uint64_t interval_us = 1000000U / BENCH_COMMAND_HZ;
+    uint64_t next_send_us = 0;
+    uint32_t received = 0;
+    uint32_t frames = 0;
+    uint32_t frame_bytes = 0;
+    uint32_t start_ms = HAL_GetTick();
+    rc_command_payload_t cmd = RC_FAILSAFE_COMMAND;
+
+    cmd.mode = 1;
+
+    while (sim_time_us() < end_us) {
+        /* Ground: send due commands, fold telemetry into the cache */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (sim_time_us() >= next_send_us &&
+            rc_link_send_command(ground, &cmd) != RC_ERROR_BUSY) {
+            next_send_us += interval_us;
+        }
+
+        while (rc_link_receive_telemetry_mux(ground, &cache) == RC_OK) {
+            bench_track(start_ms);
+        }
+
+        /* Aircraft: sample sensors per command, answer some with telemetry */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        rc_command_payload_t rx;
+        while (rc_link_receive_command(aircraft, &rx) == RC_OK && rx.mode == 1) {
+            bench_sensors(++received);
+
+            if (received % sc->telemetry_div == 0) {
+                uint8_t probe[RC_MAX_PAYLOAD_SIZE];
+                uint8_t len = rc_tlm_mux_build(&mux, HAL_GetTick(), probe, sizeof(probe));
+
+                if (rc_link_send_telemetry_mux(aircraft, &mux) == RC_OK) {
+                    frames++;
+                    frame_bytes += len;
+                }
+            }
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+
+    printf("%s: %lu frames, %.1f payload bytes each\n", sc->name, (unsigned long)frames,
+           frames ? (double)frame_bytes / frames : 0.0);
+
+    for (size_t i = 0; i < BENCH_ITEMS; i++) {
+        char row[64];
+        snprintf(row, sizeof(row), "%s/%s", sc->name, items[i].name);
+        bench_check(row, "rx hz", (double)seen_updates[i] * 1000.0 / sc->duration_ms);
+        bench_check(row, "gapms", max_gap_ms[i]);
+
+        printf("  %-10s %4u %4u %4u %7.1f %7lu\n",
+               items[i].name, items[i].rate_hz, items[i].priority, items[i].len,
+               (double)seen_updates[i] * 1000.0 / sc->duration_ms,
+               (unsigned long)max_gap_ms[i]);
+    }
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t lossy = clean;
+    lossy.loss = 0.20;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean, 50 Hz downlink",     clean, 5,  5000 },
+        { "loss 20%, 50 Hz downlink",  lossy, 5,  5000 },
+        { "clean, 25 Hz (over budget)", clean, 10, 5000 },
+    };
+
+    printf("nrf_rc_link telemetry mux (%u Hz commands, %u us step)\n",
+           BENCH_COMMAND_HZ, BENCH_STEP_US);
+    printf("  %-10s %4s %4s %4s %7s %7s\n", "item", "hz", "prio", "len", "rx hz", "gapms");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i]);
+    }
+
+    return bench_finish();
+}
@@ -0,0 +1,258 @@
+/**
+ * @file tier_bench.c
+ * @brief Tiered against full command frames on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t at 250 kbps with dynamic
+ * payloads. Sticks (channels 0-3) change every frame; the other channels,
+ * switches and mode change every BENCH_AUX_PERIOD_MS, as a pilot flipping
+ * switches would. Reports per channel scenario:
+ *   - frame exchange air time, commands delivered per second and delivery
+ *     ratio
+ *   - stick latency from the send call to rc_link_receive_command()
+ *     returning it (p50 / p99)
+ *   - aux latency: from the ground changing every aux value until the
+ *     aircraft's command holds all of them (p50 / max)
+ *   - keyframes sent, and commands whose sticks arrived wrong
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * tier_bench (RC_ENABLE_TIERED_COMMAND) and tier_bench_full (full commands,
+ * same radio settings). Times are virtual, so results are reproducible for
+ * a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include <stdio.h>
+#include <string.h>
+
+/** Aircraft answers every Nth command with telemetry */
+#define BENCH_TELEMETRY_DIV 10
+
+/** Aux channels, switches and mode change this often */
+#define BENCH_AUX_PERIOD_MS 250
+
+/** Marks a real command (the failsafe command has mode 0) */
+#define BENCH_MODE          1
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+    uint32_t rate_hz;           /* 0 = send as fast as the link allows */
+    uint32_t duration_ms;
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t received;
+    uint32_t escaped;           /* Sticks delivered with wrong contents */
+    bench_latency_t stick;
+    bench_latency_t aux;
+} bench_result_t;
+
+static uint64_t sent_at_us[65536];
+static bench_result_t result;
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+static void bench_sticks(rc_command_payload_t *cmd, uint16_t id)
+{
+    /* Frame id in channels 0-1, so the aircraft can tell which one it got */
+    cmd->channels[0] = id & 0x7FF;
+    cmd->channels[1] = (uint16_t)(id >> 11);
+    cmd->channels[2] = (uint16_t)((id * 7U + 2) & 0x7FF);
+    cmd->channels[3] = (uint16_t)((id * 7U + 3) & 0x7FF);
+}
+
+static void bench_aux(rc_command_payload_t *cmd, uint16_t gen)
+{
+    for (uint8_t i = 4; i < RC_COMMAND_CHANNELS; i++) {
+        cmd->channels[i] = (uint16_t)((gen * 13U + i * 100U) & 0x7FF);
+    }
+    cmd->switches = (uint8_t)gen;
+    cmd->mode = BENCH_MODE;
+}
+
+static uint16_t bench_id(const rc_command_payload_t *cmd)
+{
+    return (uint16_t)(cmd->channels[0] | (cmd->channels[1] << 11));
+}
+
+static bool bench_sticks_valid(const rc_command_payload_t *cmd)
+{
+    rc_command_payload_t expect;
+    bench_sticks(&expect, bench_id(cmd));
+    return memcmp(cmd->channels, expect.channels, 4 * sizeof(uint16_t)) == 0;
+}
+
+static bool bench_aux_match(const rc_command_payload_t *cmd, uint16_t gen)
+{
+    rc_command_payload_t expect;
+    bench_aux(&expect, gen);
+    return memcmp(&cmd->channels[4], &expect.channels[4], 4 * sizeof(uint16_t)) == 0 &&
+           cmd->switches == expect.switches && cmd->mode == expect.mode;
+}
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc)
+{
+    memset(&result, 0, sizeof(result));
+
+    bench_pair_t pair;
+    bench_pair_start(&pair, 2, NULL, NULL, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    uint64_t end_us = (uint64_t)sc->duration_ms * 1000U;
+    uint64_t interval_us = sc->rate_hz ? 1000000U / sc->rate_hz : 0;
+    uint64_t next_send_us = 0;
+    uint64_t aux_changed_us = 0;
+    uint16_t next_id = 0;
+    uint16_t aux_gen = 0;
+    bool aux_seen = false;
+    bool pending = false;
+    rc_command_payload_t cmd;
+
+    bench_aux(&cmd, aux_gen);
+
+    while (sim_time_us() < end_us) {
+        uint64_t now = sim_time_us();
+
+        if (now >= aux_changed_us + BENCH_AUX_PERIOD_MS * 1000U) {
+            aux_gen++;
+            aux_changed_us = now;
+            aux_seen = false;
+        }
+
+        /* Ground: send due commands, drain telemetry */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (!pending && now >= next_send_us) {
+            bench_sticks(&cmd, next_id);
+            bench_aux(&cmd, aux_gen);
+            sent_at_us[next_id] = now;
+            pending = true;
+            next_send_us = interval_us ? next_send_us + interval_us : now;
+        }
+
+        if (pending) {
+            rc_status_t status = rc_link_send_command(ground, &cmd);
+            if (status != RC_ERROR_BUSY) {
+                pending = false;
+                next_id++;
+                result.sent++;
+            }
+        }
+
+        rc_telemetry_payload_t telem;
+        while (rc_link_receive_telemetry(ground, &telem) == RC_OK) {
+        }
+
+        /* Aircraft: take commands, answer some with telemetry */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        rc_command_payload_t rx;
+        while (rc_link_receive_command(aircraft, &rx) == RC_OK) {
+            if (rx.mode != BENCH_MODE) {
+                break;  /* Failsafe values */
+            }
+
+            if (!bench_sticks_valid(&rx)) {
+                result.escaped++;
+                continue;
+            }
+
+            result.received++;
+            bench_record_latency(&result.stick,
+                                 (uint32_t)(sim_time_us() - sent_at_us[bench_id(&rx)]));
+
+            if (!aux_seen && aux_gen > 0 && bench_aux_match(&rx, aux_gen)) {
+                bench_record_latency(&result.aux, (uint32_t)(sim_time_us() - aux_changed_us));
+                aux_seen = true;
+            }
+
+            if (result.received % BENCH_TELEMETRY_DIV == 0) {
+                memset(&telem, 0, sizeof(telem));
+                telem.battery_mv = 11100;
+                rc_link_send_telemetry(aircraft, &telem);
+            }
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+
+    rc_stats_t gs;
+    rc_link_get_stats(ground, &gs);
+
+#if RC_ENABLE_TIERED_COMMAND
+    uint8_t frame_len = sizeof(rc_command_tier_t);
+#else
+    uint8_t frame_len = sizeof(rc_command_payload_t);
+#endif
+
+    bench_check(sc->name, "deliv",
+                result.sent ? 100.0 * result.received / result.sent : BENCH_MISSING);
+    bench_check(sc->name, "p99us",
+                result.stick.count ? bench_percentile(&result.stick, 99) : BENCH_MISSING);
+    bench_check(sc->name, "auxmax", result.aux.count ? result.aux.max_us : BENCH_MISSING);
+    bench_check(sc->name, "bad", result.escaped);
+
+    printf("%-14s %6lu %7lu %8.0f %6.1f%% %7lu %7lu %7lu %7lu %5lu %4lu\n",
+           sc->name,
+           (unsigned long)rc_link_get_airtime_us(ground, frame_len),
+           (unsigned long)result.sent,
+           (double)result.received * 1000.0 / sc->duration_ms,
+           result.sent ? 100.0 * result.received / result.sent : 0.0,
+           (unsigned long)bench_percentile(&result.stick, 50),
+           (unsigned long)bench_percentile(&result.stick, 99),
+           (unsigned long)bench_percentile(&result.aux, 50),
+           (unsigned long)result.aux.max_us,
+           (unsigned long)gs.tier_keyframes,
+           (unsigned long)result.escaped);
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t lossy = clean;
+    lossy.loss = 0.10;
+
+    sim_channel_t heavy = clean;
+    heavy.loss = 0.30;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean max",    clean, 0,   3000 },
+        { "loss 10% max", lossy, 0,   3000 },
+        { "clean 250Hz",  clean, 250, 3000 },
+        { "loss 30% 250", heavy, 250, 3000 },
+    };
+
+    printf("nrf_rc_link command tiers (%s, %u kbps, %u us step)\n",
+           RC_ENABLE_TIERED_COMMAND ? "tiered" : "full commands",
+           RC_DATA_RATE == 0 ? 250U : RC_DATA_RATE == 1 ? 1000U : 2000U, BENCH_STEP_US);
+    printf("%-14s %6s %7s %8s %7s %7s %7s %7s %7s %5s %4s\n",
+           "scenario", "airus", "sent", "rx/s", "deliv", "p50us", "p99us",
+           "aux50", "auxmax", "keys", "bad");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i]);
+    }
+
+    return bench_finish();
+}
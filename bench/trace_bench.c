@@ -0,0 +1,256 @@
+/**
+* @file trace_bench.c
+ * @brief Packet trace capture and export on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t with RC_ENABLE_TRACE. The ground
+ * sends a command every RC_UPDATE_RATE_HZ period and the aircraft answers
+ * every other one with telemetry. Every millisecond each end drains its
+ * trace ring with rc_link_trace_read() into what a UART at the scenario's
+ * baud rate could have sent since, and the bytes are decoded back with
+ * rc_trace_unpack(). Per scenario it reports:
+ *   - records exported per second, per end, and per event (both ends)
+ *   - records lost to the ring wrapping (rc_stats_t.trace_lost)
+ *   - export bandwidth and how much of the UART it used
+ *   - records that failed to decode (should be 0)
+ * The outage scenario drops every frame for a second, so the aircraft
+ * records entering and leaving failsafe.
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * trace_bench (polling) or trace_bench_irq (RC_ENABLE_IRQ). Give a file
+ * name, ahead of any limits, to also write the aircraft's export of the
+ * last scenario there, for trace_decode. Times are virtual, so results
+ * are reproducible for a given seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "sim.h"
+#include "bench_common.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_PERIOD_US     (1000000U / RC_UPDATE_RATE_HZ)
+#define BENCH_DURATION_MS   10000U
+
+/** Trace drain period */
+#define BENCH_DRAIN_US      1000U
+
+/** Outage scenario: every frame lost over this window */
+#define BENCH_OUTAGE_START_MS   4000U
+#define BENCH_OUTAGE_MS         1000U
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+    uint32_t baud;              /* Export UART, 8N1 */
+    bool outage;
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t records[2];        /* Exported, per end */
+    uint32_t events[RC_TRACE_EVENT_COUNT];
+    uint32_t lost[2];
+    uint32_t bytes;
+    uint32_t bad;               /* Failed to decode */
+} bench_result_t;
+
+static bench_result_t result;
+static FILE *capture;
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+/* Export what the UART had time for since the last drain; time it had to
+ * spare carries over, up to one buffer. Credit counts millionths of a
+ * byte, so slow rates do not round to nothing */
+static void bench_drain(rc_link_t *link, uint8_t end, uint64_t *credit, uint32_t baud,
+                        FILE *out)
+{
+    uint8_t buffer[256];
+
+    *credit += (uint64_t)(baud / 10U) * BENCH_DRAIN_US;
+    if (*credit > (uint64_t)sizeof(buffer) * 1000000U) {
+        *credit = (uint64_t)sizeof(buffer) * 1000000U;
+    }
+
+    uint16_t len = rc_link_trace_read(link, buffer, (uint16_t)(*credit / 1000000U));
+    *credit -= (uint64_t)len * 1000000U;
+
+    for (uint16_t i = 0; i < len; i += RC_TRACE_RECORD_SIZE) {
+        rc_trace_record_t record;
+
+        if (!rc_trace_unpack(buffer + i, &record)) {
+            result.bad++;
+            continue;
+        }
+        result.records[end]++;
+        result.events[RC_TRACE_EVENT(record.info)]++;
+    }
+
+    result.bytes += len;
+    if (out && len > 0) {
+        fwrite(buffer, 1, len, out);
+    }
+}
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc, FILE *out)
+{
+    memset(&result, 0, sizeof(result));
+
+    bench_pair_t pair;
+    bench_pair_start(&pair, 2, NULL, NULL, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    sim_channel_t dead = sc->channel;
+    dead.loss = 1.0;
+
+    uint64_t end_us = (uint64_t)BENCH_DURATION_MS * 1000U;
+    uint64_t next_send_us = 0;
+    uint64_t next_drain_us = BENCH_DRAIN_US;
+    uint64_t credit[2] = { 0, 0 };
+    uint16_t next_id = 0;
+    bool pending = false;
+    bool down = false;
+    rc_command_payload_t cmd;
+
+    while (sim_time_us() < end_us) {
+        if (sc->outage) {
+            uint64_t ms = sim_time_us() / 1000U;
+            bool in = ms >= BENCH_OUTAGE_START_MS && ms < BENCH_OUTAGE_START_MS + BENCH_OUTAGE_MS;
+            if (in != down) {
+                sim_channel_set(in ? &dead : &sc->channel);
+                down = in;
+            }
+        }
+
+        /* Ground: a fresh command every period, the last one while busy */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        if (sim_time_us() >= next_send_us) {
+            bench_command(&cmd, next_id++);
+            pending = true;
+            next_send_us += BENCH_PERIOD_US;
+        }
+
+        if (pending && rc_link_send_command(ground, &cmd) != RC_ERROR_BUSY) {
+            pending = false;
+        }
+
+        rc_telemetry_payload_t tlm;
+        while (rc_link_receive_telemetry(ground, &tlm) == RC_OK) {
+        }
+
+        /* Aircraft: take commands, answer every other one */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        rc_command_payload_t rx;
+        while (rc_link_receive_command(aircraft, &rx) == RC_OK && rx.switches == BENCH_SWITCHES) {
+            if (rx.channels[7] % 2 == 0) {
+                memset(&tlm, 0, sizeof(tlm));
+                tlm.rssi = (uint8_t)rx.channels[7];
+                rc_link_send_telemetry(aircraft, &tlm);
+            }
+        }
+
+        if (sim_time_us() >= next_drain_us) {
+            bench_drain(ground, BENCH_GROUND, &credit[BENCH_GROUND], sc->baud, NULL);
+            bench_drain(aircraft, BENCH_AIRCRAFT, &credit[BENCH_AIRCRAFT], sc->baud, out);
+            next_drain_us += BENCH_DRAIN_US;
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+
+    rc_stats_t stats;
+    rc_link_get_stats(ground, &stats);
+    result.lost[BENCH_GROUND] = stats.trace_lost;
+    rc_link_get_stats(aircraft, &stats);
+    result.lost[BENCH_AIRCRAFT] = stats.trace_lost;
+
+    uint32_t seconds = BENCH_DURATION_MS / 1000U;
+    uint32_t bytes_per_s = result.bytes / seconds;
+
+    bench_check(sc->name, "drops", result.events[RC_TRACE_RX_DROP]);
+    bench_check(sc->name, "fs", result.events[RC_TRACE_FAILSAFE]);
+    bench_check(sc->name, "lostA", result.lost[BENCH_AIRCRAFT]);
+    bench_check(sc->name, "bad", result.bad);
+
+    printf("%-16s %6lu %6lu %6lu %6lu %6lu %6lu %4lu %6lu %6lu %6lu %6.1f%% %3lu\n",
+           sc->name,
+           (unsigned long)(result.records[BENCH_GROUND] / seconds),
+           (unsigned long)(result.records[BENCH_AIRCRAFT] / seconds),
+           (unsigned long)(result.events[RC_TRACE_TX] / seconds),
+           (unsigned long)(result.events[RC_TRACE_RX] / seconds),
+           (unsigned long)result.events[RC_TRACE_RX_DROP],
+           (unsigned long)result.events[RC_TRACE_MODE],
+           (unsigned long)result.events[RC_TRACE_FAILSAFE],
+           (unsigned long)result.lost[BENCH_GROUND],
+           (unsigned long)result.lost[BENCH_AIRCRAFT],
+           (unsigned long)bytes_per_s,
+           100.0 * bytes_per_s / (2.0 * sc->baud / 10.0),
+           (unsigned long)result.bad);
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    /* An optional capture file name comes before any limits */
+    if (argc > 1 && !strpbrk(argv[1], "<>")) {
+        capture = fopen(argv[1], "wb");
+        if (!capture) {
+            perror(argv[1]);
+            return 1;
+        }
+        argc--;
+        argv++;
+    }
+
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t loss10 = clean;
+    loss10.loss = 0.10;
+
+    sim_channel_t corrupt = clean;
+    corrupt.corrupt = 0.05;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean",           clean,   921600, false },
+        { "loss 10%",        loss10,  921600, false },
+        { "corrupt 5%",      corrupt, 921600, false },
+        { "clean, 115200",   clean,   115200, false },
+        { "loss 10%, 115200", loss10, 115200, false },
+        { "clean, 4800",     clean,   4800,   false },
+        { "outage 1 s",      clean,   921600, true },
+    };
+    const size_t count = sizeof(scenarios) / sizeof(scenarios[0]);
+
+    printf("nrf_rc_link packet trace (%s, %u Hz commands, %u-record rings, drained every %u us)\n",
+           RC_ENABLE_IRQ ? "IRQ" : "polling", RC_UPDATE_RATE_HZ, RC_TRACE_SIZE, BENCH_DRAIN_US);
+    printf("%-16s %6s %6s %6s %6s %6s %6s %4s %6s %6s %6s %7s %3s\n",
+           "scenario", "gnd/s", "air/s", "tx/s", "rx/s", "drops", "modes", "fs",
+           "lostG", "lostA", "B/s", "uart", "bad");
+
+    for (size_t i = 0; i < count; i++) {
+        bench_run(&scenarios[i], i == count - 1 ? capture : NULL);
+    }
+
+    if (capture) {
+        fclose(capture);
+    }
+
+    return bench_finish();
+}
@@ -0,0 +1,239 @@
+/**
+* @file txq_bench.c
+ * @brief Pipelined TX queue on the host simulation
+ *
+ * Runs a ground and an aircraft rc_link_t with RC_ENABLE_TX_QUEUE. The
+ * ground sends commands as fast as the link allows, either pipelined with
+ * rc_link_queue_packet() whenever rc_link_tx_queue_free() has a slot, or
+ * one at a time with rc_link_send_command() for comparison; the aircraft
+ * takes them with rc_link_receive_command(). Per scenario and mode it
+ * reports:
+ *   - commands delivered per second and delivery ratio
+ *   - latency from the send call to rc_link_receive_command() returning it
+ *     (p50 / p99 / max)
+ *   - queued packets the completion callback reported ACKed or lost, and
+ *     completions out of queue order
+ *   - CRC-catch rate, as in link_bench
+ *
+ * Host build: cmake (RC_BUILD_SIM is on by default off-target), then run
+ * txq_bench. Times are virtual, so results are reproducible for a given
+ * seed.
+ */
+
+#include "nrf_rc_driver.h"
+#include "nrf24.h"
+#include "packet.h"
+#include "sim.h"
+#include "bench_common.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_DURATION_MS   2000U
+
+typedef struct {
+    const char *name;
+    sim_channel_t channel;
+} bench_scenario_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t received;
+    uint32_t escaped;           /* Delivered with wrong contents */
+    uint32_t acked;
+    uint32_t lost;
+    uint32_t out_of_order;
+    uint8_t next_sequence;      /* Expected in the next completion */
+    bool sequence_valid;
+    bench_latency_t latency;
+} bench_result_t;
+
+static uint64_t sent_at_us[65536];
+static bench_result_t result;
+
+/*============================================================================*/
+/* Callback                                                                   */
+/*============================================================================*/
+
+static void txq_callback(rc_link_t *link, uint8_t type, uint8_t sequence,
+                         rc_status_t status, void *ctx)
+{
+    (void)link;
+    (void)type;
+    (void)ctx;
+
+    if (result.sequence_valid && sequence != result.next_sequence) {
+        result.out_of_order++;
+    }
+    result.next_sequence = (uint8_t)(sequence + 1);
+    result.sequence_valid = true;
+
+    if (status == RC_OK) {
+        result.acked++;
+    } else {
+        result.lost++;
+    }
+}
+
+/*============================================================================*/
+/* Scenario                                                                   */
+/*============================================================================*/
+
+static void bench_run(const bench_scenario_t *sc, bool queued)
+{
+    memset(&result, 0, sizeof(result));
+
+    bench_pair_t pair;
+    bench_pair_start(&pair, 2, NULL, NULL, &sc->channel);
+    rc_link_t *ground = pair.ground;
+    rc_link_t *aircraft = pair.aircraft;
+
+    rc_link_set_tx_queue_callback(ground, txq_callback, NULL);
+
+    uint64_t end_us = (uint64_t)BENCH_DURATION_MS * 1000U;
+    uint16_t next_id = 0;
+    rc_command_payload_t cmd;
+
+    while (sim_time_us() < end_us) {
+        uint64_t now = sim_time_us();
+
+        /* Ground: keep the FIFO full, or one send at a time */
+        sim_select(BENCH_GROUND);
+        rc_link_update(ground);
+
+        bool more = true;
+        while (more) {
+            bench_command(&cmd, next_id);
+            sent_at_us[next_id] = now;
+
+            rc_status_t status;
+            if (queued) {
+                status = rc_link_tx_queue_free(ground)
+                             ? rc_link_queue_packet(ground, RC_PKT_COMMAND, &cmd,
+                                                    sizeof(cmd), NULL)
+                             : RC_ERROR_BUSY;
+            } else {
+                status = rc_link_send_command(ground, &cmd);
+                more = false;
+            }
+
+            if (status == RC_ERROR_BUSY) {
+                break;
+            }
+            next_id++;
+            result.sent++;
+        }
+
+        /* Aircraft: take commands */
+        sim_select(BENCH_AIRCRAFT);
+        rc_link_update(aircraft);
+
+        rc_command_payload_t rx;
+        while (rc_link_receive_command(aircraft, &rx) == RC_OK) {
+            if (rx.switches != BENCH_SWITCHES) {
+                break;  /* Failsafe values */
+            }
+
+            if (!bench_command_valid(&rx)) {
+                result.escaped++;
+                continue;
+            }
+
+            result.received++;
+            bench_record_latency(&result.latency,
+                                 (uint32_t)(sim_time_us() - sent_at_us[rx.channels[7]]));
+        }
+
+        sim_advance_us(BENCH_STEP_US);
+    }
+
+    bench_pair_stop(&pair);
+    rc_link_set_tx_queue_callback(ground, NULL, NULL);
+
+    rc_stats_t gs, as;
+    rc_link_get_stats(ground, &gs);
+    rc_link_get_stats(aircraft, &as);
+    uint32_t caught = gs.crc_errors + gs.version_mismatches +
+                      as.crc_errors + as.version_mismatches;
+
+    char row[32];
+    snprintf(row, sizeof(row), "%s/%s", sc->name, queued ? "queue" : "single");
+    bench_check(row, "deliv",
+                result.sent ? 100.0 * result.received / result.sent : BENCH_MISSING);
+    bench_check(row, "p99us",
+                result.latency.count ? bench_percentile(&result.latency, 99) : BENCH_MISSING);
+    if (queued) {
+        bench_check(row, "order", result.out_of_order);
+    }
+    bench_check(row, "crc",
+                (caught + result.escaped) ? 100.0 * caught / (caught + result.escaped)
+                                          : BENCH_MISSING);
+
+    printf("%-14s %-6s %7lu %8.0f %6.1f%% %7lu %7lu %7lu",
+           sc->name, queued ? "queue" : "single",
+           (unsigned long)result.sent,
+           (double)result.received * 1000.0 / BENCH_DURATION_MS,
+           result.sent ? 100.0 * result.received / result.sent : 0.0,
+           (unsigned long)bench_percentile(&result.latency, 50),
+           (unsigned long)bench_percentile(&result.latency, 99),
+           (unsigned long)result.latency.max_us);
+
+    if (queued) {
+        printf(" %6lu %5lu %5lu",
+               (unsigned long)result.acked,
+               (unsigned long)result.lost,
+               (unsigned long)result.out_of_order);
+    } else {
+        printf(" %6s %5s %5s", "-", "-", "-");
+    }
+
+    if (caught + result.escaped) {
+        printf(" %5.1f%%", 100.0 * caught / (caught + result.escaped));
+    } else {
+        printf(" %6s", "-");
+    }
+
+    printf("\n");
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+int main(int argc, char **argv)
+{
+    bench_limits_init(argc, argv);
+
+    sim_channel_t clean = sim_channel_clean();
+
+    sim_channel_t lossy = clean;
+    lossy.loss = 0.10;
+
+    sim_channel_t burst = clean;
+    burst.loss = 0.01;
+    burst.burst_enter = 0.02;
+    burst.burst_exit = 0.10;
+    burst.burst_loss = 0.80;
+
+    sim_channel_t corrupt = clean;
+    corrupt.corrupt = 0.01;
+
+    const bench_scenario_t scenarios[] = {
+        { "clean",      clean },
+        { "loss 10%",   lossy },
+        { "burst",      burst },
+        { "corrupt 1%", corrupt },
+    };
+
+    printf("nrf_rc_link TX queue (IRQ, %u-deep FIFO, %u us step)\n",
+           NRF24_FIFO_DEPTH, BENCH_STEP_US);
+    printf("%-14s %-6s %7s %8s %7s %7s %7s %7s %6s %5s %5s %6s\n",
+           "scenario", "mode", "sent", "rx/s", "deliv", "p50us", "p99us", "maxus",
+           "acked", "lost", "order", "crc");
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        bench_run(&scenarios[i], false);
+        bench_run(&scenarios[i], true);
+    }
+
+    return bench_finish();
+}
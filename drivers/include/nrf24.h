@@ -11,11 +11,25 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "nrf24_config.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*============================================================================*/
+/* Public Constants                                                           */
+/*============================================================================*/
+
+/** Standby to TX/RX settling time (Tstby2a) in µs */
+#define NRF24_SETTLE_US         130
+
+/** Depth of the TX and RX hardware FIFOs */
+#define NRF24_FIFO_DEPTH        3
+
+/** RX data pipes (0-5) */
+#define NRF24_PIPE_COUNT        6
+
 /*============================================================================*/
 /* Public Types                                                               */
 /*============================================================================*/
@@ -39,14 +53,92 @@ typedef enum {
     NRF24_TX_POWER_0DBM   = 3
 } nrf24_tx_power_t;
 
+/**
+ * @brief Events reported by nrf24_irq_handler()
+ */
+typedef enum {
+    NRF24_EVENT_NONE     = 0,
+    NRF24_EVENT_RX_READY = (1 << 0),    /* Payload waiting in RX FIFO */
+    NRF24_EVENT_TX_DONE  = (1 << 1),    /* Packet sent (and ACKed if enabled) */
+    NRF24_EVENT_MAX_RT   = (1 << 2)     /* Retries exhausted, TX FIFO flushed */
+} nrf24_event_t;
+
+/**
+ * @brief SPI DMA transfer kinds
+ */
+typedef enum {
+    NRF24_DMA_IDLE = 0,
+    NRF24_DMA_TX_PAYLOAD,       /* W_TX_PAYLOAD upload */
+    NRF24_DMA_RX_PAYLOAD        /* R_RX_PAYLOAD download */
+} nrf24_dma_op_t;
+
+/**
+ * @brief SPI bus and pins one radio is wired to
+ *
+ * nrf24_init() uses the nrf24_config.h macros; pass your own to
+ * nrf24_init_hw() for every further radio on the MCU. Radios may share a
+ * bus as long as each has its own CSN.
+ */
+typedef struct nrf24_hw {
+    SPI_HandleTypeDef *spi;     /* SPI peripheral */
+    GPIO_TypeDef *csn_port;     /* Chip select (active low) */
+    uint16_t csn_pin;
+    GPIO_TypeDef *ce_port;      /* Chip enable */
+    uint16_t ce_pin;
+} nrf24_hw_t;
+
+struct nrf24;
+
+/**
+ * @brief SPI DMA completion callback (runs in DMA interrupt context)
+ *
+ * @param nrf  Pointer to nRF24 handle
+ * @param op   Completed transfer kind
+ * @param ok   false if the SPI reported an error
+ * @param data Received payload (NRF24_DMA_RX_PAYLOAD only, else NULL)
+ * @param len  Received payload length
+ * @param ctx  User context from nrf24_set_dma_callback()
+ */
+typedef void (*nrf24_dma_callback_t)(struct nrf24 *nrf, nrf24_dma_op_t op, bool ok,
+                                     const uint8_t *data, uint8_t len, void *ctx);
+
 /**
  * @brief nRF24 driver handle
  */
-typedef struct {
-    uint8_t channel;            /* RF channel (0-125) */
-    uint8_t payload_size;       /* Payload size in bytes (1-32) */
+typedef struct nrf24 {
+    nrf24_hw_t hw;              /* SPI handle and pins */
+    uint8_t channel;            /* RF channel (0-125), RF_CH shadow */
+    uint8_t payload_size;       /* Static payload size in bytes (1-32) */
+    nrf24_data_rate_t data_rate;    /* Current air data rate */
     bool is_rx_mode;            /* Current mode: true=RX, false=TX */
     bool initialized;           /* Initialization status */
+    bool dynamic_payload;       /* Dynamic payload length on open pipes */
+    bool ack_payload;           /* Payloads carried on auto-ACK */
+    bool auto_ack;              /* EN_AA follows EN_RXADDR, else 0 (receive only) */
+    bool tx_no_ack;             /* Payloads go out with W_TX_PAYLOAD_NOACK */
+    volatile bool tx_busy;      /* Async transmit in flight */
+    uint32_t spi_transactions;  /* SPI transactions issued (CSN assertions) */
+    uint8_t status;             /* STATUS clocked out by the last command */
+
+    /* Register shadows: last value written, so updates need no read-back */
+    uint8_t reg_config;         /* CONFIG */
+    uint8_t reg_rf_setup;       /* RF_SETUP */
+    uint8_t reg_setup_retr;     /* SETUP_RETR */
+    uint8_t reg_feature;        /* FEATURE */
+    uint8_t reg_dynpd;          /* DYNPD */
+    uint8_t reg_en_rxaddr;      /* EN_RXADDR */
+    uint8_t tx_addr[5];         /* TX_ADDR */
+    uint8_t rx_addr[5];         /* RX_ADDR_P0 */
+    uint8_t rx_addr_p1[5];      /* RX_ADDR_P1 */
+    uint8_t rx_addr_lsb[NRF24_PIPE_COUNT - 2];  /* RX_ADDR_P2..P5 */
+
+    /* SPI DMA transport */
+    volatile nrf24_dma_op_t dma_op;         /* Transfer in progress */
+    nrf24_dma_callback_t dma_callback;      /* Completion callback */
+    void *dma_ctx;                          /* Callback context */
+    uint8_t dma_tx_buf[33];                 /* Command byte + payload */
+    uint8_t dma_rx_buf[33];                 /* STATUS byte + payload */
+    uint8_t dma_rx_len;                     /* Payload length being read */
 } nrf24_t;
 
 /*============================================================================*/
@@ -66,6 +158,32 @@ typedef struct {
  */
 bool nrf24_init(nrf24_t *nrf, uint8_t channel, uint8_t payload_size);
 
+/**
+ * @brief Initialize an nRF24L01+ wired to the given SPI bus and pins
+ *
+ * Same as nrf24_init() for a radio other than the one in nrf24_config.h.
+ *
+ * @param nrf          Pointer to nRF24 handle
+ * @param hw           SPI handle and pins (copied)
+ * @param channel      RF channel (0-125)
+ * @param payload_size Payload size in bytes (1-32)
+ * @return true if initialization successful
+ */
+bool nrf24_init_hw(nrf24_t *nrf, const nrf24_hw_t *hw, uint8_t channel, uint8_t payload_size);
+
+/**
+ * @brief Recover the radio without a full init
+ *
+ * Drops CE, flushes both FIFOs, clears interrupts and reapplies the
+ * configuration from the register shadows. Skips the power-on waits
+ * while the chip is still powered, so it completes in well under 1 ms.
+ * Use after a transmission hung or the chip misbehaved.
+ *
+ * @param nrf Pointer to nRF24 handle (initialized, no DMA in progress)
+ * @return true if the registers read back correctly afterwards
+ */
+bool nrf24_reinit(nrf24_t *nrf);
+
 /**
  * @brief Set RF channel
  *
@@ -74,6 +192,30 @@ bool nrf24_init(nrf24_t *nrf, uint8_t channel, uint8_t payload_size);
  */
 void nrf24_set_channel(nrf24_t *nrf, uint8_t channel);
 
+/**
+ * @brief Switch RF channel between frames
+ *
+ * Single RF_CH write with CE dropped around it, so the PLL relocks
+ * (within NRF24_SETTLE_US) before the radio listens again. Does nothing
+ * if already on that channel.
+ *
+ * @param nrf     Pointer to nRF24 handle
+ * @param channel RF channel (0-125)
+ */
+void nrf24_hop(nrf24_t *nrf, uint8_t channel);
+
+/**
+ * @brief Switch data rate and TX power between frames
+ *
+ * Single RF_SETUP write with CE dropped around it, like nrf24_hop(). Does
+ * nothing if the radio is already set up that way.
+ *
+ * @param nrf   Pointer to nRF24 handle
+ * @param rate  Data rate
+ * @param power TX power level
+ */
+void nrf24_set_rf(nrf24_t *nrf, nrf24_data_rate_t rate, nrf24_tx_power_t power);
+
 /**
  * @brief Set TX power level
  *
@@ -101,6 +243,21 @@ void nrf24_set_data_rate(nrf24_t *nrf, nrf24_data_rate_t rate);
  */
 void nrf24_set_addresses(nrf24_t *nrf, const uint8_t *tx_addr, const uint8_t *rx_addr);
 
+/**
+ * @brief Open or close an extra RX pipe (1-5)
+ *
+ * Pipes 2-5 only own addr[0]; bytes 1-4 are shared with pipe 1 and must
+ * match those of every other open pipe 1-5 (the first one sets them).
+ * The pipe gets auto-ACK, payload_size static width and, if enabled,
+ * dynamic payload length like pipe 0.
+ *
+ * @param nrf  Pointer to nRF24 handle
+ * @param pipe RX pipe (1-5)
+ * @param addr Address (5 bytes), NULL to close the pipe
+ * @return false if the pipe is out of range or the address cannot be used
+ */
+bool nrf24_set_rx_pipe(nrf24_t *nrf, uint8_t pipe, const uint8_t *addr);
+
 /**
  * @brief Set auto-retransmit parameters
  *
@@ -110,6 +267,113 @@ void nrf24_set_addresses(nrf24_t *nrf, const uint8_t *tx_addr, const uint8_t *rx
  */
 void nrf24_set_auto_retransmit(nrf24_t *nrf, uint8_t delay, uint8_t count);
 
+/**
+ * @brief Enable dynamic payload length
+ *
+ * Sets EN_DPL in FEATURE and the DYNPD bit of every open pipe. Once enabled, transmit
+ * accepts any length 1-32 and receive reports the actual width read with
+ * R_RX_PL_WID. Must be enabled on both ends.
+ *
+ * @param nrf    Pointer to nRF24 handle
+ * @param enable true to enable, false to return to payload_size frames
+ */
+void nrf24_enable_dynamic_payload(nrf24_t *nrf, bool enable);
+
+/**
+ * @brief Enable or disable auto-ACK on every open pipe
+ *
+ * On by default. A radio that only listens in on a link (a diversity
+ * receiver) turns it off so it never answers on air. The chip needs
+ * auto-ACK for dynamic payloads, so use static payloads then.
+ *
+ * @param nrf    Pointer to nRF24 handle
+ * @param enable true to ACK received frames
+ */
+void nrf24_set_auto_ack(nrf24_t *nrf, bool enable);
+
+/**
+ * @brief Enable or disable the radio's own 1-byte CRC
+ *
+ * On by default. Without it the radio hands over frames with bit errors
+ * instead of dropping them, for a forward error correction code to repair.
+ * The chip forces it on while any pipe has auto-ACK, so turn that off
+ * first. Must match on both ends.
+ *
+ * @param nrf    Pointer to nRF24 handle
+ * @param enable true to check and append the CRC
+ */
+void nrf24_set_crc(nrf24_t *nrf, bool enable);
+
+/**
+ * @brief Allow payloads that ask for no ACK (FEATURE.EN_DYN_ACK)
+ *
+ * Off by default. Needed for nrf24_set_tx_no_ack() to take effect; the
+ * receiver needs no setting of its own.
+ *
+ * @param nrf    Pointer to nRF24 handle
+ * @param enable true to allow W_TX_PAYLOAD_NOACK
+ */
+void nrf24_enable_dyn_ack(nrf24_t *nrf, bool enable);
+
+/**
+ * @brief Send the following payloads without asking for an ACK
+ *
+ * Applies to every payload written from now on, until changed. Such a
+ * frame goes out once: TX_DS fires as soon as it has left, with no
+ * auto-retransmit and no MAX_RT, whether or not anyone received it.
+ * Ignored unless nrf24_enable_dyn_ack() is on.
+ *
+ * @param nrf    Pointer to nRF24 handle
+ * @param no_ack true for W_TX_PAYLOAD_NOACK, false for W_TX_PAYLOAD
+ */
+void nrf24_set_tx_no_ack(nrf24_t *nrf, bool no_ack);
+
+/**
+ * @brief Enable payloads on auto-ACK packets
+ *
+ * Sets EN_ACK_PAY in FEATURE. Enabling also turns on dynamic payload
+ * length, which ACK payloads require. Must be enabled on both ends.
+ *
+ * @param nrf    Pointer to nRF24 handle
+ * @param enable true to enable
+ */
+void nrf24_enable_ack_payload(nrf24_t *nrf, bool enable);
+
+/**
+ * @brief On-air time of one packet
+ *
+ * Preamble, 5-byte address, packet control field, payload and 1-byte CRC
+ * at the current data rate. Excludes the 130µs settling time and the ACK.
+ *
+ * @param nrf Pointer to nRF24 handle
+ * @param len Payload length in bytes (0 for a bare ACK)
+ * @return Air time in µs (rounded up)
+ */
+uint32_t nrf24_airtime_us(const nrf24_t *nrf, uint8_t len);
+
+/**
+ * @brief Compare the chip's configuration with the register shadows
+ *
+ * Reads back every register the driver configures, addresses included.
+ * A mismatch usually means the radio browned out and reset while the
+ * MCU kept running.
+ *
+ * @param nrf Pointer to nRF24 handle
+ * @return true if every register matches
+ */
+bool nrf24_verify_registers(nrf24_t *nrf);
+
+/**
+ * @brief Rewrite the chip's configuration from the register shadows
+ *
+ * Applies the same register table as nrf24_init(), CONFIG last. Waits for
+ * power-up only if the chip had dropped out of PWR_UP. Does not touch the
+ * FIFOs. Must not be called with a transmission in flight.
+ *
+ * @param nrf Pointer to nRF24 handle
+ */
+void nrf24_resync_registers(nrf24_t *nrf);
+
 /*============================================================================*/
 /* Mode Control                                                               */
 /*============================================================================*/
@@ -135,6 +399,16 @@ void nrf24_mode_rx(nrf24_t *nrf);
  */
 void nrf24_power_down(nrf24_t *nrf);
 
+/**
+ * @brief Stop listening without leaving RX mode
+ *
+ * Drops CE only (Standby-I), so no SPI traffic; nrf24_listen() resumes.
+ * Frames already in the RX FIFO stay there.
+ *
+ * @param nrf Pointer to nRF24 handle
+ */
+void nrf24_standby(nrf24_t *nrf);
+
 /*============================================================================*/
 /* Data Transfer                                                              */
 /*============================================================================*/
@@ -153,6 +427,28 @@ void nrf24_power_down(nrf24_t *nrf);
  */
 bool nrf24_transmit(nrf24_t *nrf, const uint8_t *data, uint8_t len);
 
+/**
+ * @brief First half of nrf24_transmit(): upload the payload and pulse CE
+ *
+ * Switches to TX mode if needed. Follow with nrf24_transmit_wait().
+ *
+ * @param nrf  Pointer to nRF24 handle
+ * @param data Data buffer to transmit
+ * @param len  Data length (must equal payload_size)
+ * @return true if the payload was uploaded
+ */
+bool nrf24_transmit_upload(nrf24_t *nrf, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Second half of nrf24_transmit(): wait for TX_DS or MAX_RT
+ *
+ * @param nrf Pointer to nRF24 handle
+ * @return true if transmission successful
+ *
+ * @note Blocking call with timeout (~10ms); flushes TX on failure
+ */
+bool nrf24_transmit_wait(nrf24_t *nrf);
+
 /**
  * @brief Receive packet (non-blocking)
  *
@@ -165,6 +461,24 @@ bool nrf24_transmit(nrf24_t *nrf, const uint8_t *data, uint8_t len);
  */
 bool nrf24_receive(nrf24_t *nrf, uint8_t *buffer, uint8_t *len);
 
+/**
+ * @brief Drain the RX FIFO in one go
+ *
+ * Clears RX_DR, then reads payloads until FIFO_STATUS reports RX_EMPTY.
+ * Packets arriving meanwhile are picked up too; a packet after the final
+ * check raises RX_DR again. Stays in the current mode, so it also drains
+ * ACK payloads on a PTX.
+ *
+ * @param nrf     Pointer to nRF24 handle
+ * @param buffers Output buffers, 32 bytes each (need not be contiguous)
+ * @param lens    Output: length of each payload read
+ * @param pipes   Output: pipe each payload arrived on (may be NULL)
+ * @param max     Number of buffers (NRF24_FIFO_DEPTH drains a full FIFO)
+ * @return Number of payloads read
+ */
+uint8_t nrf24_receive_batch(nrf24_t *nrf, uint8_t *const *buffers, uint8_t *lens,
+                            uint8_t *pipes, uint8_t max);
+
 /**
  * @brief Check if RX data is available
  *
@@ -173,6 +487,210 @@ bool nrf24_receive(nrf24_t *nrf, uint8_t *buffer, uint8_t *len);
  */
 bool nrf24_is_data_available(nrf24_t *nrf);
 
+/**
+ * @brief Queue a payload for the next auto-ACK on a pipe (PRX)
+ *
+ * Does not change mode. Up to three ACK payloads can be pending.
+ *
+ * @param nrf  Pointer to nRF24 handle
+ * @param pipe RX pipe (0-5) whose next ACK carries the payload
+ * @param data Payload
+ * @param len  Payload length (1-32)
+ * @return true if queued
+ */
+bool nrf24_write_ack_payload(nrf24_t *nrf, uint8_t pipe, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Read a payload that arrived on an auto-ACK (PTX)
+ *
+ * Unlike nrf24_receive() this stays in TX mode.
+ *
+ * @param nrf    Pointer to nRF24 handle
+ * @param buffer Output buffer (32 bytes)
+ * @param len    Output: received data length
+ * @return true if a payload was read
+ */
+bool nrf24_receive_ack_payload(nrf24_t *nrf, uint8_t *buffer, uint8_t *len);
+
+/**
+ * @brief Read one payload from the RX FIFO
+ *
+ * Does not switch mode, check STATUS or clear flags. Intended for the
+ * interrupt path after nrf24_irq_handler() reported NRF24_EVENT_RX_READY.
+ *
+ * @param nrf    Pointer to nRF24 handle
+ * @param buffer Output buffer (at least payload_size bytes)
+ * @param len    Output: received data length
+ * @return true if payload read
+ */
+bool nrf24_read_payload(nrf24_t *nrf, uint8_t *buffer, uint8_t *len);
+
+/*============================================================================*/
+/* Signal Quality                                                             */
+/*============================================================================*/
+
+/**
+ * @brief Retransmissions the last payload needed
+ *
+ * Reads ARC_CNT from OBSERVE_TX. Reset whenever a new payload is written.
+ *
+ * @param nrf Pointer to nRF24 handle
+ * @return 0 (first attempt ACKed) to the configured retransmit count
+ */
+uint8_t nrf24_retransmit_count(nrf24_t *nrf);
+
+/**
+ * @brief Read the received power detector
+ *
+ * RPD is latched on every valid packet, so read it after a reception. It
+ * is a single threshold, not a level.
+ *
+ * @param nrf Pointer to nRF24 handle
+ * @return true if the last packet arrived at -64 dBm or stronger
+ */
+bool nrf24_received_power_high(nrf24_t *nrf);
+
+/*============================================================================*/
+/* Interrupt-Driven Operation                                                 */
+/*============================================================================*/
+
+/**
+ * @brief Start a transmission without waiting for the result
+ *
+ * Switches to TX mode, uploads the payload and pulses CE. Completion is
+ * reported by nrf24_irq_handler() as NRF24_EVENT_TX_DONE or
+ * NRF24_EVENT_MAX_RT.
+ *
+ * @param nrf  Pointer to nRF24 handle
+ * @param data Data buffer to transmit
+ * @param len  Data length (must equal payload_size)
+ * @return true if transmission started, false if busy or invalid
+ */
+bool nrf24_transmit_start(nrf24_t *nrf, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Add a payload to the TX FIFO without waiting
+ *
+ * Switches to TX mode, uploads the payload and leaves CE high, so up to
+ * NRF24_FIFO_DEPTH payloads go out back to back while the next ones are
+ * uploaded. Each completion raises NRF24_EVENT_TX_DONE; MAX_RT stops the
+ * queue and flushes it (see nrf24_irq_handler()).
+ *
+ * @param nrf  Pointer to nRF24 handle
+ * @param data Data buffer to transmit
+ * @param len  Data length
+ * @return true if queued, false if FIFO_STATUS reports TX_FULL or invalid
+ */
+bool nrf24_queue_payload(nrf24_t *nrf, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Check whether every queued payload has left the TX FIFO
+ *
+ * @param nrf Pointer to nRF24 handle
+ * @return true if FIFO_STATUS reports TX_EMPTY
+ */
+bool nrf24_tx_fifo_empty(nrf24_t *nrf);
+
+/**
+ * @brief Enter RX mode without waiting for RX settling
+ *
+ * Safe to call from interrupt context. The radio starts listening on its
+ * own once the 130µs settling time has elapsed.
+ *
+ * @param nrf Pointer to nRF24 handle
+ */
+void nrf24_listen(nrf24_t *nrf);
+
+/**
+ * @brief Service the nRF24 IRQ line
+ *
+ * Call from the EXTI handler of the IRQ pin. Reads STATUS and clears all
+ * interrupt flags in a single SPI transaction, then flushes the TX FIFO on
+ * MAX_RT. The RX payload (if any) is left in the FIFO for the caller.
+ *
+ * @param nrf Pointer to nRF24 handle
+ * @return Bitmask of nrf24_event_t
+ */
+uint8_t nrf24_irq_handler(nrf24_t *nrf);
+
+/*============================================================================*/
+/* SPI DMA Transport                                                          */
+/*============================================================================*/
+
+/**
+ * @brief Set the SPI DMA completion callback
+ *
+ * @param nrf      Pointer to nRF24 handle
+ * @param callback Completion callback
+ * @param ctx      User context passed to the callback
+ */
+void nrf24_set_dma_callback(nrf24_t *nrf, nrf24_dma_callback_t callback, void *ctx);
+
+/**
+ * @brief Start a transmission with the payload uploaded by SPI DMA
+ *
+ * CE is raised before the upload so the radio transmits as soon as CSN is
+ * released in the DMA-complete interrupt. TX completion is still reported
+ * by nrf24_irq_handler().
+ *
+ * @param nrf  Pointer to nRF24 handle
+ * @param data Data buffer to transmit (copied, may be reused on return)
+ * @param len  Data length (must equal payload_size)
+ * @return true if the DMA transfer started
+ */
+bool nrf24_transmit_start_dma(nrf24_t *nrf, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Read one RX payload by SPI DMA
+ *
+ * The payload is delivered to the DMA callback.
+ *
+ * @param nrf Pointer to nRF24 handle
+ * @return true if the DMA transfer started
+ */
+bool nrf24_read_payload_dma(nrf24_t *nrf);
+
+/**
+ * @brief SPI DMA complete hook
+ *
+ * Call from HAL_SPI_TxCpltCallback() and HAL_SPI_TxRxCpltCallback() for
+ * the radio's SPI. Releases CSN and invokes the DMA callback.
+ *
+ * @param nrf Pointer to nRF24 handle
+ */
+void nrf24_spi_dma_complete(nrf24_t *nrf);
+
+/**
+ * @brief SPI DMA error hook
+ *
+ * Call from HAL_SPI_ErrorCallback() for the radio's SPI.
+ *
+ * @param nrf Pointer to nRF24 handle
+ */
+void nrf24_spi_dma_error(nrf24_t *nrf);
+
+/*============================================================================*/
+/* Timing                                                                     */
+/*============================================================================*/
+
+/**
+ * @brief Read the DWT cycle counter
+ *
+ * Enables the counter on first use (shared with the driver's µs delays).
+ * Wraps every 2^32 cycles (~59 s at 72 MHz); subtract unsigned.
+ *
+ * @return Current CPU cycle count
+ */
+uint32_t nrf24_cycle_count(void);
+
+/**
+ * @brief Convert a cycle count to microseconds
+ *
+ * @param cycles CPU cycles
+ * @return Microseconds at SystemCoreClock (rounded down)
+ */
+uint32_t nrf24_cycles_to_us(uint32_t cycles);
+
 /*============================================================================*/
 /* Low-Level Register Access                                                  */
 /*============================================================================*/
@@ -12,21 +12,34 @@
 #define NRF24_REG_RF_SETUP      0x06
 #define NRF24_REG_STATUS        0x07
 
+/* Signal Quality */
+#define NRF24_REG_OBSERVE_TX    0x08
+#define NRF24_REG_RPD           0x09
+
 /* RX/TX Addresses */
 #define NRF24_REG_RX_ADDR_P0    0x0A
+#define NRF24_REG_RX_ADDR_P1    0x0B    /* Full 5 bytes */
+#define NRF24_REG_RX_ADDR_P2    0x0C    /* P2-P5: LSB only, rest from P1 */
 #define NRF24_REG_TX_ADDR       0x10
 
 /* Payload Width */
-#define NRF24_REG_RX_PW_P0      0x11
+#define NRF24_REG_RX_PW_P0      0x11    /* RX_PW_Pn = RX_PW_P0 + n */
 
 /* FIFO Status */
 #define NRF24_REG_FIFO_STATUS   0x17
 
+/* Feature Registers */
+#define NRF24_REG_DYNPD         0x1C
+#define NRF24_REG_FEATURE       0x1D
+
 /* Commands */
 #define NRF24_CMD_R_REGISTER    0x00
 #define NRF24_CMD_W_REGISTER    0x20
 #define NRF24_CMD_R_RX_PAYLOAD  0x61
 #define NRF24_CMD_W_TX_PAYLOAD  0xA0
+#define NRF24_CMD_W_TX_PAYLOAD_NOACK 0xB0   /* Needs FEATURE.EN_DYN_ACK */
+#define NRF24_CMD_R_RX_PL_WID   0x60
+#define NRF24_CMD_W_ACK_PAYLOAD 0xA8    /* OR with pipe number (0-5) */
 #define NRF24_CMD_FLUSH_TX      0xE1
 #define NRF24_CMD_FLUSH_RX      0xE2
 #define NRF24_CMD_NOP           0xFF
@@ -40,6 +53,33 @@
 #define NRF24_STATUS_RX_DR      (1 << 6)
 #define NRF24_STATUS_TX_DS      (1 << 5)
 #define NRF24_STATUS_MAX_RT     (1 << 4)
+#define NRF24_STATUS_RX_P_NO    (0x07 << 1)     /* Pipe of RX FIFO head */
+#define NRF24_STATUS_RX_P_NO_SHIFT  1
+#define NRF24_RX_P_NO_EMPTY     0x07            /* RX_P_NO when FIFO empty */
+
+/* OBSERVE_TX register bits */
+#define NRF24_OBSERVE_ARC_CNT   0x0F            /* Retransmits of the last payload */
+#define NRF24_OBSERVE_PLOS_SHIFT    4           /* Lost packets (cleared by RF_CH write) */
+
+/* RPD register bits */
+#define NRF24_RPD_HIGH          (1 << 0)        /* Received power >= -64 dBm */
+
+/* FIFO_STATUS register bits */
+#define NRF24_FIFO_RX_EMPTY     (1 << 0)
+#define NRF24_FIFO_RX_FULL      (1 << 1)
+#define NRF24_FIFO_TX_EMPTY     (1 << 4)
+#define NRF24_FIFO_TX_FULL      (1 << 5)
+
+/* FEATURE register bits */
+#define NRF24_FEATURE_EN_DYN_ACK    (1 << 0)
+#define NRF24_FEATURE_EN_ACK_PAY    (1 << 1)
+#define NRF24_FEATURE_EN_DPL        (1 << 2)
+
+/* DYNPD register bits */
+#define NRF24_DYNPD_DPL_P0      (1 << 0)
+
+/* EN_AA, EN_RXADDR and DYNPD: bit n = pipe n */
+#define NRF24_PIPE_MASK         0x3F
 
 /* RF_SETUP register positions */
 #define NRF24_RF_SETUP_DR_LOW   5
@@ -8,55 +8,92 @@
 #include "include/nrf24_registers.h"
 #include <string.h>
 
+/*============================================================================*/
+/* Private Types                                                              */
+/*============================================================================*/
+
+/** Single-byte registers applied by nrf24_apply_config() */
+#define NRF24_CONFIG_REGS       19
+
+/**
+ * @brief Register/value pair of the configuration table
+ */
+typedef struct {
+    uint8_t reg;
+    uint8_t value;
+} nrf24_reg_value_t;
+
 /*============================================================================*/
 /* Private Function Prototypes                                                */
 /*============================================================================*/
 
-static void nrf24_csn_low(void);
-static void nrf24_csn_high(void);
-static void nrf24_ce_low(void);
-static void nrf24_ce_high(void);
+static void nrf24_csn_low(nrf24_t *nrf);
+static void nrf24_csn_high(nrf24_t *nrf);
+static void nrf24_ce_low(nrf24_t *nrf);
+static void nrf24_ce_high(nrf24_t *nrf);
 static void nrf24_delay_us(uint32_t us);
+static uint8_t nrf24_transfer(nrf24_t *nrf, uint8_t cmd, const uint8_t *tx, uint8_t *rx, uint8_t len);
 static void nrf24_write_register_multi(nrf24_t *nrf, uint8_t reg, const uint8_t *data, uint8_t len);
+static uint8_t nrf24_en_aa(const nrf24_t *nrf);
+static uint8_t nrf24_config_table(const nrf24_t *nrf, nrf24_reg_value_t *table);
+static void nrf24_apply_config(nrf24_t *nrf);
+static void nrf24_set_prim_rx(nrf24_t *nrf, bool rx);
+static uint8_t nrf24_tx_command(const nrf24_t *nrf);
+static void nrf24_send_payload(nrf24_t *nrf, const uint8_t *data, uint8_t len);
+static void nrf24_dma_finish(nrf24_t *nrf, bool ok);
+static bool nrf24_tx_len_valid(const nrf24_t *nrf, uint8_t len);
+static bool nrf24_rx_fifo_pending(uint8_t status);
+static uint8_t nrf24_read_rx_width(nrf24_t *nrf);
 
 /*============================================================================*/
 /* GPIO Control                                                               */
 /*============================================================================*/
 
-static inline void nrf24_csn_low(void)
+static inline void nrf24_csn_low(nrf24_t *nrf)
 {
-    HAL_GPIO_WritePin(NRF24_CSN_PORT, NRF24_CSN_PIN, GPIO_PIN_RESET);
+    nrf->spi_transactions++;
+    HAL_GPIO_WritePin(nrf->hw.csn_port, nrf->hw.csn_pin, GPIO_PIN_RESET);
 }
 
-static inline void nrf24_csn_high(void)
+static inline void nrf24_csn_high(nrf24_t *nrf)
 {
-    HAL_GPIO_WritePin(NRF24_CSN_PORT, NRF24_CSN_PIN, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(nrf->hw.csn_port, nrf->hw.csn_pin, GPIO_PIN_SET);
 }
 
-static inline void nrf24_ce_low(void)
+static inline void nrf24_ce_low(nrf24_t *nrf)
 {
-    HAL_GPIO_WritePin(NRF24_CE_PORT, NRF24_CE_PIN, GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(nrf->hw.ce_port, nrf->hw.ce_pin, GPIO_PIN_RESET);
 }
 
-static inline void nrf24_ce_high(void)
+static inline void nrf24_ce_high(nrf24_t *nrf)
 {
-    HAL_GPIO_WritePin(NRF24_CE_PORT, NRF24_CE_PIN, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(nrf->hw.ce_port, nrf->hw.ce_pin, GPIO_PIN_SET);
 }
 
 /*============================================================================*/
 /* Timing                                                                     */
 /*============================================================================*/
 
-static void nrf24_delay_us(uint32_t us)
+uint32_t nrf24_cycle_count(void)
 {
-    /* Use DWT cycle counter for precise microsecond delays */
+    /* DWT cycle counter: precise delays and latency stamps */
     if (!(CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk)) {
         CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
         DWT->CYCCNT = 0;
         DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
     }
 
-    uint32_t start = DWT->CYCCNT;
+    return DWT->CYCCNT;
+}
+
+uint32_t nrf24_cycles_to_us(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000U);
+}
+
+static void nrf24_delay_us(uint32_t us)
+{
+    uint32_t start = nrf24_cycle_count();
     uint32_t cycles = us * (SystemCoreClock / 1000000U);
 
     while ((DWT->CYCCNT - start) < cycles);
@@ -66,47 +103,53 @@ static void nrf24_delay_us(uint32_t us)
 /* Low-Level Register Access                                                  */
 /*============================================================================*/
 
+static uint8_t nrf24_transfer(nrf24_t *nrf, uint8_t cmd, const uint8_t *tx, uint8_t *rx, uint8_t len)
+{
+    /* Command and data in one transfer; STATUS comes back with the command byte */
+    uint8_t tx_buf[33];
+    uint8_t rx_buf[33];
+
+    tx_buf[0] = cmd;
+    if (tx) {
+        memcpy(&tx_buf[1], tx, len);
+    } else {
+        memset(&tx_buf[1], NRF24_CMD_NOP, len);
+    }
+
+    nrf24_csn_low(nrf);
+    HAL_SPI_TransmitReceive(nrf->hw.spi, tx_buf, rx_buf, len + 1, NRF24_SPI_TIMEOUT);
+    nrf24_csn_high(nrf);
+
+    if (rx) {
+        memcpy(rx, &rx_buf[1], len);
+    }
+
+    nrf->status = rx_buf[0];
+    return rx_buf[0];
+}
+
 uint8_t nrf24_read_register(nrf24_t *nrf, uint8_t reg)
 {
-    uint8_t tx_buf[2] = {NRF24_CMD_R_REGISTER | reg, 0xFF};
-    uint8_t rx_buf[2] = {0};
+    uint8_t value = 0;
 
-    nrf24_csn_low();
-    HAL_SPI_TransmitReceive(&NRF24_SPI_HANDLE, tx_buf, rx_buf, 2, NRF24_SPI_TIMEOUT);
-    nrf24_csn_high();
+    nrf24_transfer(nrf, NRF24_CMD_R_REGISTER | reg, NULL, &value, 1);
 
-    return rx_buf[1];
+    return value;
 }
 
 void nrf24_write_register(nrf24_t *nrf, uint8_t reg, uint8_t value)
 {
-    uint8_t tx_buf[2] = {NRF24_CMD_W_REGISTER | reg, value};
-
-    nrf24_csn_low();
-    HAL_SPI_Transmit(&NRF24_SPI_HANDLE, tx_buf, 2, NRF24_SPI_TIMEOUT);
-    nrf24_csn_high();
+    nrf24_transfer(nrf, NRF24_CMD_W_REGISTER | reg, &value, NULL, 1);
 }
 
 static void nrf24_write_register_multi(nrf24_t *nrf, uint8_t reg, const uint8_t *data, uint8_t len)
 {
-    uint8_t cmd = NRF24_CMD_W_REGISTER | reg;
-
-    nrf24_csn_low();
-    HAL_SPI_Transmit(&NRF24_SPI_HANDLE, &cmd, 1, NRF24_SPI_TIMEOUT);
-    HAL_SPI_Transmit(&NRF24_SPI_HANDLE, (uint8_t *)data, len, NRF24_SPI_TIMEOUT);
-    nrf24_csn_high();
+    nrf24_transfer(nrf, NRF24_CMD_W_REGISTER | reg, data, NULL, len);
 }
 
 uint8_t nrf24_get_status(nrf24_t *nrf)
 {
-    uint8_t cmd = NRF24_CMD_NOP;
-    uint8_t status = 0;
-
-    nrf24_csn_low();
-    HAL_SPI_TransmitReceive(&NRF24_SPI_HANDLE, &cmd, &status, 1, NRF24_SPI_TIMEOUT);
-    nrf24_csn_high();
-
-    return status;
+    return nrf24_transfer(nrf, NRF24_CMD_NOP, NULL, NULL, 0);
 }
 
 void nrf24_clear_interrupts(nrf24_t *nrf)
@@ -118,20 +161,63 @@ void nrf24_clear_interrupts(nrf24_t *nrf)
 
 void nrf24_flush_tx(nrf24_t *nrf)
 {
-    uint8_t cmd = NRF24_CMD_FLUSH_TX;
-
-    nrf24_csn_low();
-    HAL_SPI_Transmit(&NRF24_SPI_HANDLE, &cmd, 1, NRF24_SPI_TIMEOUT);
-    nrf24_csn_high();
+    nrf24_transfer(nrf, NRF24_CMD_FLUSH_TX, NULL, NULL, 0);
 }
 
 void nrf24_flush_rx(nrf24_t *nrf)
 {
-    uint8_t cmd = NRF24_CMD_FLUSH_RX;
+    nrf24_transfer(nrf, NRF24_CMD_FLUSH_RX, NULL, NULL, 0);
+}
+
+static uint8_t nrf24_en_aa(const nrf24_t *nrf)
+{
+    return nrf->auto_ack ? nrf->reg_en_rxaddr : 0;
+}
+
+static uint8_t nrf24_config_table(const nrf24_t *nrf, nrf24_reg_value_t *table)
+{
+    uint8_t n = 0;
+
+    table[n++] = (nrf24_reg_value_t){NRF24_REG_SETUP_AW, 0x03};     /* 5-byte addresses */
+    table[n++] = (nrf24_reg_value_t){NRF24_REG_EN_AA, nrf24_en_aa(nrf)};   /* Auto-ACK on open pipes */
+    table[n++] = (nrf24_reg_value_t){NRF24_REG_EN_RXADDR, nrf->reg_en_rxaddr};
+    table[n++] = (nrf24_reg_value_t){NRF24_REG_RF_CH, nrf->channel};
+    table[n++] = (nrf24_reg_value_t){NRF24_REG_RF_SETUP, nrf->reg_rf_setup};
+    table[n++] = (nrf24_reg_value_t){NRF24_REG_SETUP_RETR, nrf->reg_setup_retr};
+    table[n++] = (nrf24_reg_value_t){NRF24_REG_RX_PW_P0, nrf->payload_size};
+
+    for (uint8_t pipe = 1; pipe < NRF24_PIPE_COUNT; pipe++) {
+        if (!(nrf->reg_en_rxaddr & (1 << pipe))) {
+            continue;
+        }
+        table[n++] = (nrf24_reg_value_t){NRF24_REG_RX_PW_P0 + pipe, nrf->payload_size};
+        if (pipe >= 2) {
+            table[n++] = (nrf24_reg_value_t){NRF24_REG_RX_ADDR_P2 + pipe - 2, nrf->rx_addr_lsb[pipe - 2]};
+        }
+    }
+    table[n++] = (nrf24_reg_value_t){NRF24_REG_FEATURE, nrf->reg_feature};
+    table[n++] = (nrf24_reg_value_t){NRF24_REG_DYNPD, nrf->reg_dynpd};
+
+    /* Last, so the chip only powers up fully configured */
+    table[n++] = (nrf24_reg_value_t){NRF24_REG_CONFIG, nrf->reg_config};
+
+    return n;
+}
+
+static void nrf24_apply_config(nrf24_t *nrf)
+{
+    nrf24_reg_value_t table[NRF24_CONFIG_REGS];
+    uint8_t count = nrf24_config_table(nrf, table);
+
+    nrf24_write_register_multi(nrf, NRF24_REG_TX_ADDR, nrf->tx_addr, 5);
+    nrf24_write_register_multi(nrf, NRF24_REG_RX_ADDR_P0, nrf->rx_addr, 5);
+    if (nrf->reg_en_rxaddr & (NRF24_PIPE_MASK & ~0x01)) {
+        nrf24_write_register_multi(nrf, NRF24_REG_RX_ADDR_P1, nrf->rx_addr_p1, 5);
+    }
 
-    nrf24_csn_low();
-    HAL_SPI_Transmit(&NRF24_SPI_HANDLE, &cmd, 1, NRF24_SPI_TIMEOUT);
-    nrf24_csn_high();
+    for (uint8_t i = 0; i < count; i++) {
+        nrf24_write_register(nrf, table[i].reg, table[i].value);
+    }
 }
 
 /*============================================================================*/
@@ -140,53 +226,63 @@ void nrf24_flush_rx(nrf24_t *nrf)
 
 bool nrf24_init(nrf24_t *nrf, uint8_t channel, uint8_t payload_size)
 {
-    if (!nrf || payload_size == 0 || payload_size > 32 || channel > 125) {
+    nrf24_hw_t hw = {
+        .spi = &NRF24_SPI_HANDLE,
+        .csn_port = NRF24_CSN_PORT,
+        .csn_pin = NRF24_CSN_PIN,
+        .ce_port = NRF24_CE_PORT,
+        .ce_pin = NRF24_CE_PIN
+    };
+
+    return nrf24_init_hw(nrf, &hw, channel, payload_size);
+}
+
+bool nrf24_init_hw(nrf24_t *nrf, const nrf24_hw_t *hw, uint8_t channel, uint8_t payload_size)
+{
+    if (!nrf || !hw || !hw->spi || payload_size == 0 || payload_size > 32 || channel > 125) {
         return false;
     }
 
-    /* Clear handle */
+    /* Clear handle; FEATURE and DYNPD shadows start at 0 */
     memset(nrf, 0, sizeof(nrf24_t));
 
+    nrf->hw = *hw;
     nrf->channel = channel;
     nrf->payload_size = payload_size;
     nrf->is_rx_mode = false;
 
-    /* Ensure CE is low (standby) */
-    nrf24_ce_low();
-    nrf24_csn_high();
-
-    /* Wait for power-on reset */
-    HAL_Delay(5);
+    /* 2Mbps, 0dBm */
+    nrf->reg_rf_setup = (1 << NRF24_RF_SETUP_DR_HIGH) | (NRF24_TX_POWER_0DBM << NRF24_RF_SETUP_PWR);
+    nrf->data_rate = NRF24_DATA_RATE_2MBPS;
 
-    /* Power down first */
-    nrf24_write_register(nrf, NRF24_REG_CONFIG, 0x00);
-    nrf24_delay_us(1500);
+    /* Auto-retransmit: 500µs delay, 3 retries */
+    nrf->reg_setup_retr = (1 << 4) | 3;
 
-    /* Set RF channel */
-    nrf24_write_register(nrf, NRF24_REG_RF_CH, channel);
-
-    /* Set data rate to 2Mbps and TX power to 0dBm */
-    nrf24_set_data_rate(nrf, NRF24_DATA_RATE_2MBPS);
-    nrf24_set_tx_power(nrf, NRF24_TX_POWER_0DBM);
-
-    /* Set address width to 5 bytes */
-    nrf24_write_register(nrf, NRF24_REG_SETUP_AW, 0x03);
+    /* Default addresses */
+    memset(nrf->tx_addr, 0xE7, sizeof(nrf->tx_addr));
+    memset(nrf->rx_addr, 0xE7, sizeof(nrf->rx_addr));
+    memset(nrf->rx_addr_p1, 0xC2, sizeof(nrf->rx_addr_p1));
+    for (uint8_t i = 0; i < sizeof(nrf->rx_addr_lsb); i++) {
+        nrf->rx_addr_lsb[i] = (uint8_t)(0xC3 + i);
+    }
 
-    /* Enable auto-ACK on pipe 0 */
-    nrf24_write_register(nrf, NRF24_REG_EN_AA, 0x01);
+    /* Pipe 0 only until nrf24_set_rx_pipe() opens more */
+    nrf->reg_en_rxaddr = 0x01;
+    nrf->auto_ack = true;
 
-    /* Enable RX pipe 0 */
-    nrf24_write_register(nrf, NRF24_REG_EN_RXADDR, 0x01);
+    /* Power up in RX mode with CRC enabled (8-bit) */
+    nrf->reg_config = NRF24_CONFIG_PWR_UP | NRF24_CONFIG_CRC_EN | NRF24_CONFIG_PRIM_RX;
 
-    /* Set auto-retransmit: 500µs delay, 3 retries */
-    nrf24_set_auto_retransmit(nrf, 1, 3);
+    /* Ensure CE is low (standby) */
+    nrf24_ce_low(nrf);
+    nrf24_csn_high(nrf);
 
-    /* Set RX payload width */
-    nrf24_write_register(nrf, NRF24_REG_RX_PW_P0, payload_size);
+    /* Wait for power-on reset */
+    HAL_Delay(5);
 
-    /* Set default addresses */
-    uint8_t addr[5] = {0xE7, 0xE7, 0xE7, 0xE7, 0xE7};
-    nrf24_set_addresses(nrf, addr, addr);
+    /* Whole register set in one pass, overwriting anything left from before
+     * an MCU reset */
+    nrf24_apply_config(nrf);
 
     /* Clear status flags */
     nrf24_clear_interrupts(nrf);
@@ -195,18 +291,37 @@ bool nrf24_init(nrf24_t *nrf, uint8_t channel, uint8_t payload_size)
     nrf24_flush_tx(nrf);
     nrf24_flush_rx(nrf);
 
-    /* Power up in RX mode with CRC enabled (8-bit) */
-    uint8_t config = NRF24_CONFIG_PWR_UP | NRF24_CONFIG_CRC_EN | NRF24_CONFIG_PRIM_RX;
-    nrf24_write_register(nrf, NRF24_REG_CONFIG, config);
     nrf->is_rx_mode = true;
 
     nrf24_delay_us(1500);  /* Wait for power-up */
 
+    /* is_rx_mode means listening: mode_rx() will not raise CE for us */
+    nrf24_ce_high(nrf);
+
     nrf->initialized = true;
 
     return true;
 }
 
+bool nrf24_reinit(nrf24_t *nrf)
+{
+    if (!nrf || !nrf->initialized || nrf->dma_op != NRF24_DMA_IDLE) {
+        return false;
+    }
+
+    /* Abort whatever the radio was doing */
+    nrf24_ce_low(nrf);
+    nrf24_flush_tx(nrf);
+    nrf24_flush_rx(nrf);
+    nrf24_clear_interrupts(nrf);
+    nrf->tx_busy = false;
+
+    /* Reapply the configuration; only waits if the chip lost power */
+    nrf24_resync_registers(nrf);
+
+    return nrf24_verify_registers(nrf);
+}
+
 void nrf24_set_channel(nrf24_t *nrf, uint8_t channel)
 {
     if (!nrf || channel > 125) {
@@ -217,15 +332,62 @@ void nrf24_set_channel(nrf24_t *nrf, uint8_t channel)
     nrf24_write_register(nrf, NRF24_REG_RF_CH, channel);
 }
 
+void nrf24_hop(nrf24_t *nrf, uint8_t channel)
+{
+    if (!nrf || channel > 125 || channel == nrf->channel) {
+        return;
+    }
+
+    nrf24_ce_low(nrf);
+    nrf->channel = channel;
+    nrf24_write_register(nrf, NRF24_REG_RF_CH, channel);
+
+    if (nrf->is_rx_mode) {
+        nrf24_ce_high(nrf);
+    }
+}
+
+void nrf24_set_rf(nrf24_t *nrf, nrf24_data_rate_t rate, nrf24_tx_power_t power)
+{
+    if (!nrf) {
+        return;
+    }
+
+    uint8_t rf_setup = nrf->reg_rf_setup;
+    rf_setup &= ~((1 << NRF24_RF_SETUP_DR_LOW) | (1 << NRF24_RF_SETUP_DR_HIGH) | 0x06);
+    rf_setup |= (power << NRF24_RF_SETUP_PWR);
+
+    if (rate == NRF24_DATA_RATE_250KBPS) {
+        rf_setup |= (1 << NRF24_RF_SETUP_DR_LOW);
+    } else if (rate == NRF24_DATA_RATE_2MBPS) {
+        rf_setup |= (1 << NRF24_RF_SETUP_DR_HIGH);
+    }
+
+    if (rf_setup == nrf->reg_rf_setup) {
+        return;
+    }
+
+    nrf24_ce_low(nrf);
+    nrf->reg_rf_setup = rf_setup;
+    nrf->data_rate = rate;
+    nrf24_write_register(nrf, NRF24_REG_RF_SETUP, rf_setup);
+
+    if (nrf->is_rx_mode) {
+        nrf24_ce_high(nrf);
+    }
+}
+
 void nrf24_set_tx_power(nrf24_t *nrf, nrf24_tx_power_t power)
 {
     if (!nrf) {
         return;
     }
 
-    uint8_t rf_setup = nrf24_read_register(nrf, NRF24_REG_RF_SETUP);
+    uint8_t rf_setup = nrf->reg_rf_setup;
     rf_setup &= ~(0x06);  /* Clear power bits */
     rf_setup |= (power << NRF24_RF_SETUP_PWR);
+
+    nrf->reg_rf_setup = rf_setup;
     nrf24_write_register(nrf, NRF24_REG_RF_SETUP, rf_setup);
 }
 
@@ -235,7 +397,7 @@ void nrf24_set_data_rate(nrf24_t *nrf, nrf24_data_rate_t rate)
         return;
     }
 
-    uint8_t rf_setup = nrf24_read_register(nrf, NRF24_REG_RF_SETUP);
+    uint8_t rf_setup = nrf->reg_rf_setup;
     rf_setup &= ~((1 << NRF24_RF_SETUP_DR_LOW) | (1 << NRF24_RF_SETUP_DR_HIGH));
 
     switch (rate) {
@@ -250,7 +412,10 @@ void nrf24_set_data_rate(nrf24_t *nrf, nrf24_data_rate_t rate)
             break;
     }
 
+    nrf->reg_rf_setup = rf_setup;
     nrf24_write_register(nrf, NRF24_REG_RF_SETUP, rf_setup);
+
+    nrf->data_rate = rate;
 }
 
 void nrf24_set_addresses(nrf24_t *nrf, const uint8_t *tx_addr, const uint8_t *rx_addr)
@@ -259,39 +424,281 @@ void nrf24_set_addresses(nrf24_t *nrf, const uint8_t *tx_addr, const uint8_t *rx
         return;
     }
 
+    memcpy(nrf->tx_addr, tx_addr, sizeof(nrf->tx_addr));
+    memcpy(nrf->rx_addr, rx_addr, sizeof(nrf->rx_addr));
+
     nrf24_write_register_multi(nrf, NRF24_REG_TX_ADDR, tx_addr, 5);
     nrf24_write_register_multi(nrf, NRF24_REG_RX_ADDR_P0, rx_addr, 5);
 }
 
+bool nrf24_set_rx_pipe(nrf24_t *nrf, uint8_t pipe, const uint8_t *addr)
+{
+    if (!nrf || pipe == 0 || pipe >= NRF24_PIPE_COUNT) {
+        return false;
+    }
+
+    uint8_t bit = (uint8_t)(1 << pipe);
+    uint8_t en = nrf->reg_en_rxaddr;
+
+    if (!addr) {
+        en &= (uint8_t)~bit;
+    } else if (pipe == 1) {
+        /* Pipes 2-5 would move with it */
+        if ((en & (NRF24_PIPE_MASK & ~0x03)) && memcmp(&nrf->rx_addr_p1[1], &addr[1], 4) != 0) {
+            return false;
+        }
+        memcpy(nrf->rx_addr_p1, addr, sizeof(nrf->rx_addr_p1));
+        nrf24_write_register_multi(nrf, NRF24_REG_RX_ADDR_P1, addr, 5);
+        en |= bit;
+    } else {
+        /* Bytes 1-4 are pipe 1's; replace them only if no other pipe uses them */
+        if (memcmp(&nrf->rx_addr_p1[1], &addr[1], 4) != 0) {
+            if (en & (NRF24_PIPE_MASK & ~0x01 & ~bit)) {
+                return false;
+            }
+            memcpy(nrf->rx_addr_p1, addr, sizeof(nrf->rx_addr_p1));
+            nrf24_write_register_multi(nrf, NRF24_REG_RX_ADDR_P1, addr, 5);
+        }
+        nrf->rx_addr_lsb[pipe - 2] = addr[0];
+        nrf24_write_register(nrf, NRF24_REG_RX_ADDR_P2 + pipe - 2, addr[0]);
+        en |= bit;
+    }
+
+    if (addr) {
+        nrf24_write_register(nrf, NRF24_REG_RX_PW_P0 + pipe, nrf->payload_size);
+    }
+
+    nrf->reg_en_rxaddr = en;
+    nrf24_write_register(nrf, NRF24_REG_EN_AA, nrf24_en_aa(nrf));
+    nrf24_write_register(nrf, NRF24_REG_EN_RXADDR, en);
+
+    if (nrf->dynamic_payload) {
+        nrf->reg_dynpd = en;
+        nrf24_write_register(nrf, NRF24_REG_DYNPD, en);
+    }
+
+    return true;
+}
+
+void nrf24_enable_dynamic_payload(nrf24_t *nrf, bool enable)
+{
+    if (!nrf) {
+        return;
+    }
+
+    uint8_t feature = nrf->reg_feature;
+    uint8_t dynpd = nrf->reg_dynpd;
+
+    if (enable) {
+        feature |= NRF24_FEATURE_EN_DPL;
+        dynpd = nrf->reg_en_rxaddr;  /* Every open pipe */
+    } else {
+        /* ACK payloads cannot exist without DPL */
+        feature &= ~(NRF24_FEATURE_EN_DPL | NRF24_FEATURE_EN_ACK_PAY);
+        dynpd = 0;
+        nrf->ack_payload = false;
+    }
+
+    nrf->reg_feature = feature;
+    nrf->reg_dynpd = dynpd;
+    nrf24_write_register(nrf, NRF24_REG_FEATURE, feature);
+    nrf24_write_register(nrf, NRF24_REG_DYNPD, dynpd);
+
+    nrf->dynamic_payload = enable;
+}
+
+void nrf24_set_auto_ack(nrf24_t *nrf, bool enable)
+{
+    if (!nrf) {
+        return;
+    }
+
+    nrf->auto_ack = enable;
+    nrf24_write_register(nrf, NRF24_REG_EN_AA, nrf24_en_aa(nrf));
+}
+
+void nrf24_set_crc(nrf24_t *nrf, bool enable)
+{
+    if (!nrf) {
+        return;
+    }
+
+    if (enable) {
+        nrf->reg_config |= NRF24_CONFIG_CRC_EN;
+    } else {
+        nrf->reg_config &= ~NRF24_CONFIG_CRC_EN;
+    }
+    nrf24_write_register(nrf, NRF24_REG_CONFIG, nrf->reg_config);
+}
+
+void nrf24_enable_dyn_ack(nrf24_t *nrf, bool enable)
+{
+    if (!nrf) {
+        return;
+    }
+
+    if (enable) {
+        nrf->reg_feature |= NRF24_FEATURE_EN_DYN_ACK;
+    } else {
+        nrf->reg_feature &= ~NRF24_FEATURE_EN_DYN_ACK;
+    }
+    nrf24_write_register(nrf, NRF24_REG_FEATURE, nrf->reg_feature);
+}
+
+void nrf24_set_tx_no_ack(nrf24_t *nrf, bool no_ack)
+{
+    if (!nrf) {
+        return;
+    }
+
+    nrf->tx_no_ack = no_ack;
+}
+
+void nrf24_enable_ack_payload(nrf24_t *nrf, bool enable)
+{
+    if (!nrf) {
+        return;
+    }
+
+    if (enable && !nrf->dynamic_payload) {
+        nrf24_enable_dynamic_payload(nrf, true);
+    }
+
+    uint8_t feature = nrf->reg_feature;
+
+    if (enable) {
+        feature |= NRF24_FEATURE_EN_ACK_PAY;
+    } else {
+        feature &= ~NRF24_FEATURE_EN_ACK_PAY;
+    }
+
+    nrf->reg_feature = feature;
+    nrf24_write_register(nrf, NRF24_REG_FEATURE, feature);
+
+    nrf->ack_payload = enable;
+}
+
+uint32_t nrf24_airtime_us(const nrf24_t *nrf, uint8_t len)
+{
+    if (!nrf) {
+        return 0;
+    }
+
+    /* Preamble (8) + address (40) + packet control field (9) + CRC (8) */
+    uint32_t crc_bits = (nrf->reg_config & NRF24_CONFIG_CRC_EN) ? 8U : 0U;
+    uint32_t bits = 57U + crc_bits + 8U * len;
+
+    switch (nrf->data_rate) {
+        case NRF24_DATA_RATE_250KBPS:
+            return bits * 4U;
+        case NRF24_DATA_RATE_1MBPS:
+            return bits;
+        case NRF24_DATA_RATE_2MBPS:
+        default:
+            return (bits + 1U) / 2U;
+    }
+}
+
 void nrf24_set_auto_retransmit(nrf24_t *nrf, uint8_t delay, uint8_t count)
 {
     if (!nrf) {
         return;
     }
 
-    uint8_t setup_retr = ((delay & 0x0F) << 4) | (count & 0x0F);
-    nrf24_write_register(nrf, NRF24_REG_SETUP_RETR, setup_retr);
+    nrf->reg_setup_retr = ((delay & 0x0F) << 4) | (count & 0x0F);
+    nrf24_write_register(nrf, NRF24_REG_SETUP_RETR, nrf->reg_setup_retr);
+}
+
+bool nrf24_verify_registers(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return false;
+    }
+
+    nrf24_reg_value_t table[NRF24_CONFIG_REGS];
+    uint8_t count = nrf24_config_table(nrf, table);
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t value = nrf24_read_register(nrf, table[i].reg);
+
+        /* RF_SETUP bit 0 is obsolete and reads back undefined on some parts */
+        if (table[i].reg == NRF24_REG_RF_SETUP) {
+            value = (value & 0xFE) | (table[i].value & 0x01);
+        }
+
+        if (value != table[i].value) {
+            return false;
+        }
+    }
+
+    uint8_t addr[5];
+
+    nrf24_transfer(nrf, NRF24_CMD_R_REGISTER | NRF24_REG_TX_ADDR, NULL, addr, 5);
+    if (memcmp(addr, nrf->tx_addr, 5) != 0) {
+        return false;
+    }
+
+    nrf24_transfer(nrf, NRF24_CMD_R_REGISTER | NRF24_REG_RX_ADDR_P0, NULL, addr, 5);
+    if (memcmp(addr, nrf->rx_addr, 5) != 0) {
+        return false;
+    }
+
+    if (nrf->reg_en_rxaddr & (NRF24_PIPE_MASK & ~0x01)) {
+        nrf24_transfer(nrf, NRF24_CMD_R_REGISTER | NRF24_REG_RX_ADDR_P1, NULL, addr, 5);
+        return memcmp(addr, nrf->rx_addr_p1, 5) == 0;
+    }
+
+    return true;
+}
+
+void nrf24_resync_registers(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return;
+    }
+
+    bool was_up = nrf24_read_register(nrf, NRF24_REG_CONFIG) & NRF24_CONFIG_PWR_UP;
+
+    nrf24_ce_low(nrf);
+    nrf24_apply_config(nrf);
+
+    if (!was_up && (nrf->reg_config & NRF24_CONFIG_PWR_UP)) {
+        nrf24_delay_us(1500);  /* Wait for power-up */
+    }
+
+    if (nrf->is_rx_mode) {
+        nrf24_ce_high(nrf);
+    }
 }
 
 /*============================================================================*/
 /* Mode Control                                                               */
 /*============================================================================*/
 
+static void nrf24_set_prim_rx(nrf24_t *nrf, bool rx)
+{
+    nrf24_ce_low(nrf);
+
+    uint8_t config = nrf->reg_config;
+    if (rx) {
+        config |= NRF24_CONFIG_PRIM_RX;   /* Set RX bit */
+    } else {
+        config &= ~NRF24_CONFIG_PRIM_RX;  /* Clear RX bit for TX mode */
+    }
+    nrf->reg_config = config;
+    nrf24_write_register(nrf, NRF24_REG_CONFIG, config);
+
+    nrf->is_rx_mode = rx;
+}
+
 void nrf24_mode_tx(nrf24_t *nrf)
 {
     if (!nrf || !nrf->is_rx_mode) {
         return;  /* Already in TX mode */
     }
 
-    nrf24_ce_low();
-
-    uint8_t config = nrf24_read_register(nrf, NRF24_REG_CONFIG);
-    config &= ~NRF24_CONFIG_PRIM_RX;  /* Clear RX bit for TX mode */
-    nrf24_write_register(nrf, NRF24_REG_CONFIG, config);
-
-    nrf24_delay_us(130);  /* Tpd2stby + Tstby2a */
-
-    nrf->is_rx_mode = false;
+    nrf24_set_prim_rx(nrf, false);
+    nrf24_delay_us(NRF24_SETTLE_US);  /* Tpd2stby + Tstby2a */
 }
 
 void nrf24_mode_rx(nrf24_t *nrf)
@@ -300,16 +707,9 @@ void nrf24_mode_rx(nrf24_t *nrf)
         return;  /* Already in RX mode */
     }
 
-    nrf24_ce_low();
-
-    uint8_t config = nrf24_read_register(nrf, NRF24_REG_CONFIG);
-    config |= NRF24_CONFIG_PRIM_RX;  /* Set RX bit */
-    nrf24_write_register(nrf, NRF24_REG_CONFIG, config);
-
-    nrf24_ce_high();  /* Start listening */
-    nrf24_delay_us(130);  /* Tpd2stby + Tstby2a */
-
-    nrf->is_rx_mode = true;
+    nrf24_set_prim_rx(nrf, true);
+    nrf24_ce_high(nrf);  /* Start listening */
+    nrf24_delay_us(NRF24_SETTLE_US);  /* Tpd2stby + Tstby2a */
 }
 
 void nrf24_power_down(nrf24_t *nrf)
@@ -318,39 +718,95 @@ void nrf24_power_down(nrf24_t *nrf)
         return;
     }
 
-    nrf24_ce_low();
+    nrf24_ce_low(nrf);
 
-    uint8_t config = nrf24_read_register(nrf, NRF24_REG_CONFIG);
-    config &= ~NRF24_CONFIG_PWR_UP;
-    nrf24_write_register(nrf, NRF24_REG_CONFIG, config);
+    nrf->reg_config &= ~NRF24_CONFIG_PWR_UP;
+    nrf24_write_register(nrf, NRF24_REG_CONFIG, nrf->reg_config);
 
     nrf->initialized = false;
 }
 
+void nrf24_standby(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return;
+    }
+
+    nrf24_ce_low(nrf);
+}
+
 /*============================================================================*/
 /* Data Transfer                                                              */
 /*============================================================================*/
 
+static uint8_t nrf24_tx_command(const nrf24_t *nrf)
+{
+    /* The chip only takes the NOACK command with EN_DYN_ACK set */
+    bool no_ack = nrf->tx_no_ack && (nrf->reg_feature & NRF24_FEATURE_EN_DYN_ACK);
+
+    return no_ack ? NRF24_CMD_W_TX_PAYLOAD_NOACK : NRF24_CMD_W_TX_PAYLOAD;
+}
+
+static void nrf24_send_payload(nrf24_t *nrf, const uint8_t *data, uint8_t len)
+{
+    nrf24_transfer(nrf, nrf24_tx_command(nrf), data, NULL, len);
+
+    /* Pulse CE to start transmission */
+    nrf24_ce_high(nrf);
+    nrf24_delay_us(15);  /* Minimum 10µs pulse */
+    nrf24_ce_low(nrf);
+}
+
+static bool nrf24_tx_len_valid(const nrf24_t *nrf, uint8_t len)
+{
+    if (nrf->dynamic_payload) {
+        return len > 0 && len <= 32;
+    }
+
+    return len == nrf->payload_size;
+}
+
+static bool nrf24_rx_fifo_pending(uint8_t status)
+{
+    /* RX_P_NO tracks the FIFO head, so it survives a cleared RX_DR */
+    uint8_t pipe = (status & NRF24_STATUS_RX_P_NO) >> NRF24_STATUS_RX_P_NO_SHIFT;
+    return pipe != NRF24_RX_P_NO_EMPTY;
+}
+
+static uint8_t nrf24_read_rx_width(nrf24_t *nrf)
+{
+    uint8_t width = 0;
+
+    nrf24_transfer(nrf, NRF24_CMD_R_RX_PL_WID, NULL, &width, 1);
+
+    return width;
+}
+
 bool nrf24_transmit(nrf24_t *nrf, const uint8_t *data, uint8_t len)
 {
-    if (!nrf || !data || len != nrf->payload_size) {
+    return nrf24_transmit_upload(nrf, data, len) && nrf24_transmit_wait(nrf);
+}
+
+bool nrf24_transmit_upload(nrf24_t *nrf, const uint8_t *data, uint8_t len)
+{
+    if (!nrf || !data || !nrf24_tx_len_valid(nrf, len)) {
         return false;
     }
 
     /* Switch to TX mode */
     nrf24_mode_tx(nrf);
 
-    /* Write payload */
-    uint8_t cmd = NRF24_CMD_W_TX_PAYLOAD;
-    nrf24_csn_low();
-    HAL_SPI_Transmit(&NRF24_SPI_HANDLE, &cmd, 1, NRF24_SPI_TIMEOUT);
-    HAL_SPI_Transmit(&NRF24_SPI_HANDLE, (uint8_t *)data, len, NRF24_SPI_TIMEOUT);
-    nrf24_csn_high();
+    /* Write payload and pulse CE */
+    nrf24_send_payload(nrf, data, len);
 
-    /* Pulse CE to start transmission */
-    nrf24_ce_high();
-    nrf24_delay_us(15);  /* Minimum 10µs pulse */
-    nrf24_ce_low();
+    return true;
+}
+
+bool nrf24_transmit_wait(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return false;
+    }
 
     /* Wait for TX complete or max retries (with timeout) */
     uint32_t start = NRF24_GET_TICK_MS();
@@ -387,18 +843,15 @@ bool nrf24_receive(nrf24_t *nrf, uint8_t *buffer, uint8_t *len)
 
     /* Check if data available */
     uint8_t status = nrf24_get_status(nrf);
-    if (!(status & NRF24_STATUS_RX_DR)) {
+    if (!nrf24_rx_fifo_pending(status)) {
         return false;
     }
 
     /* Read payload */
-    uint8_t cmd = NRF24_CMD_R_RX_PAYLOAD;
-    nrf24_csn_low();
-    HAL_SPI_Transmit(&NRF24_SPI_HANDLE, &cmd, 1, NRF24_SPI_TIMEOUT);
-    HAL_SPI_Receive(&NRF24_SPI_HANDLE, buffer, nrf->payload_size, NRF24_SPI_TIMEOUT);
-    nrf24_csn_high();
-
-    *len = nrf->payload_size;
+    if (!nrf24_read_payload(nrf, buffer, len)) {
+        nrf24_clear_interrupts(nrf);
+        return false;
+    }
 
     /* Clear RX interrupt */
     nrf24_clear_interrupts(nrf);
@@ -406,6 +859,33 @@ bool nrf24_receive(nrf24_t *nrf, uint8_t *buffer, uint8_t *len)
     return true;
 }
 
+uint8_t nrf24_receive_batch(nrf24_t *nrf, uint8_t *const *buffers, uint8_t *lens,
+                            uint8_t *pipes, uint8_t max)
+{
+    if (!nrf || !buffers || !lens) {
+        return 0;
+    }
+
+    /* Clear RX_DR first so nothing that lands after the last check is missed */
+    nrf24_write_register(nrf, NRF24_REG_STATUS, NRF24_STATUS_RX_DR);
+
+    uint8_t count = 0;
+
+    while (count < max &&
+           !(nrf24_read_register(nrf, NRF24_REG_FIFO_STATUS) & NRF24_FIFO_RX_EMPTY)) {
+        if (pipes) {
+            /* STATUS clocked out with that read names the head's pipe */
+            pipes[count] = (uint8_t)((nrf->status & NRF24_STATUS_RX_P_NO) >> NRF24_STATUS_RX_P_NO_SHIFT);
+        }
+        if (!nrf24_read_payload(nrf, buffers[count], &lens[count])) {
+            break;  /* Corrupt entry, FIFO flushed */
+        }
+        count++;
+    }
+
+    return count;
+}
+
 bool nrf24_is_data_available(nrf24_t *nrf)
 {
     if (!nrf) {
@@ -413,5 +893,314 @@ bool nrf24_is_data_available(nrf24_t *nrf)
     }
 
     uint8_t status = nrf24_get_status(nrf);
-    return (status & NRF24_STATUS_RX_DR) != 0;
-}
\ No newline at end of file
+    return nrf24_rx_fifo_pending(status);
+}
+
+bool nrf24_write_ack_payload(nrf24_t *nrf, uint8_t pipe, const uint8_t *data, uint8_t len)
+{
+    if (!nrf || !data || !nrf->ack_payload || pipe > 5 || len == 0 || len > 32) {
+        return false;
+    }
+
+    nrf24_transfer(nrf, NRF24_CMD_W_ACK_PAYLOAD | pipe, data, NULL, len);
+
+    return true;
+}
+
+bool nrf24_receive_ack_payload(nrf24_t *nrf, uint8_t *buffer, uint8_t *len)
+{
+    if (!nrf || !buffer || !len || !nrf->ack_payload) {
+        return false;
+    }
+
+    uint8_t status = nrf24_get_status(nrf);
+    if (!nrf24_rx_fifo_pending(status)) {
+        return false;
+    }
+
+    bool ok = nrf24_read_payload(nrf, buffer, len);
+
+    /* Clear RX_DR only; TX flags belong to the transmit path */
+    nrf24_write_register(nrf, NRF24_REG_STATUS, NRF24_STATUS_RX_DR);
+
+    return ok;
+}
+
+bool nrf24_read_payload(nrf24_t *nrf, uint8_t *buffer, uint8_t *len)
+{
+    if (!nrf || !buffer || !len) {
+        return false;
+    }
+
+    uint8_t width = nrf->payload_size;
+
+    if (nrf->dynamic_payload) {
+        width = nrf24_read_rx_width(nrf);
+
+        /* Datasheet: a width above 32 means a corrupt FIFO entry */
+        if (width == 0 || width > 32) {
+            nrf24_flush_rx(nrf);
+            return false;
+        }
+    }
+
+    nrf24_transfer(nrf, NRF24_CMD_R_RX_PAYLOAD, NULL, buffer, width);
+
+    *len = width;
+
+    return true;
+}
+
+/*============================================================================*/
+/* Signal Quality                                                             */
+/*============================================================================*/
+
+uint8_t nrf24_retransmit_count(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return 0;
+    }
+
+    return nrf24_read_register(nrf, NRF24_REG_OBSERVE_TX) & NRF24_OBSERVE_ARC_CNT;
+}
+
+bool nrf24_received_power_high(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return false;
+    }
+
+    return (nrf24_read_register(nrf, NRF24_REG_RPD) & NRF24_RPD_HIGH) != 0;
+}
+
+/*============================================================================*/
+/* Interrupt-Driven Operation                                                 */
+/*============================================================================*/
+
+bool nrf24_transmit_start(nrf24_t *nrf, const uint8_t *data, uint8_t len)
+{
+    if (!nrf || !data || !nrf24_tx_len_valid(nrf, len) || nrf->tx_busy) {
+        return false;
+    }
+
+    /* Switch to TX mode; the chip handles Tstby2a itself after CE rises */
+    if (nrf->is_rx_mode) {
+        nrf24_set_prim_rx(nrf, false);
+    }
+
+    nrf->tx_busy = true;
+
+    /* Write payload and pulse CE */
+    nrf24_send_payload(nrf, data, len);
+
+    return true;
+}
+
+bool nrf24_queue_payload(nrf24_t *nrf, const uint8_t *data, uint8_t len)
+{
+    if (!nrf || !data || !nrf24_tx_len_valid(nrf, len)) {
+        return false;
+    }
+
+    if (nrf24_read_register(nrf, NRF24_REG_FIFO_STATUS) & NRF24_FIFO_TX_FULL) {
+        return false;
+    }
+
+    if (nrf->is_rx_mode) {
+        nrf24_set_prim_rx(nrf, false);
+    }
+
+    nrf->tx_busy = true;
+
+    /* CE stays high: the chip sends whatever is queued, then idles in standby-II */
+    nrf24_transfer(nrf, nrf24_tx_command(nrf), data, NULL, len);
+    nrf24_ce_high(nrf);
+
+    return true;
+}
+
+bool nrf24_tx_fifo_empty(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return true;
+    }
+
+    return (nrf24_read_register(nrf, NRF24_REG_FIFO_STATUS) & NRF24_FIFO_TX_EMPTY) != 0;
+}
+
+void nrf24_listen(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return;
+    }
+
+    if (!nrf->is_rx_mode) {
+        nrf24_set_prim_rx(nrf, true);
+    }
+
+    nrf24_ce_high(nrf);
+}
+
+uint8_t nrf24_irq_handler(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return NRF24_EVENT_NONE;
+    }
+
+    /* Writing 1s clears the flags; STATUS is clocked out before the write */
+    uint8_t tx_buf[2] = {
+        NRF24_CMD_W_REGISTER | NRF24_REG_STATUS,
+        NRF24_STATUS_RX_DR | NRF24_STATUS_TX_DS | NRF24_STATUS_MAX_RT
+    };
+    uint8_t rx_buf[2] = {0};
+
+    nrf24_csn_low(nrf);
+    HAL_SPI_TransmitReceive(nrf->hw.spi, tx_buf, rx_buf, 2, NRF24_SPI_TIMEOUT);
+    nrf24_csn_high(nrf);
+
+    uint8_t status = rx_buf[0];
+    uint8_t events = NRF24_EVENT_NONE;
+
+    if (status & NRF24_STATUS_RX_DR) {
+        events |= NRF24_EVENT_RX_READY;
+    }
+
+    if (status & NRF24_STATUS_TX_DS) {
+        events |= NRF24_EVENT_TX_DONE;
+        nrf->tx_busy = false;
+    }
+
+    if (status & NRF24_STATUS_MAX_RT) {
+        /* Failed payload stays in the FIFO until flushed */
+        nrf24_flush_tx(nrf);
+        events |= NRF24_EVENT_MAX_RT;
+        nrf->tx_busy = false;
+    }
+
+    return events;
+}
+
+/*============================================================================*/
+/* SPI DMA Transport                                                          */
+/*============================================================================*/
+
+void nrf24_set_dma_callback(nrf24_t *nrf, nrf24_dma_callback_t callback, void *ctx)
+{
+    if (!nrf) {
+        return;
+    }
+
+    nrf->dma_callback = callback;
+    nrf->dma_ctx = ctx;
+}
+
+bool nrf24_transmit_start_dma(nrf24_t *nrf, const uint8_t *data, uint8_t len)
+{
+    if (!nrf || !data || !nrf24_tx_len_valid(nrf, len) ||
+        nrf->tx_busy || nrf->dma_op != NRF24_DMA_IDLE) {
+        return false;
+    }
+
+    if (nrf->is_rx_mode) {
+        nrf24_set_prim_rx(nrf, false);
+    }
+
+    nrf->dma_tx_buf[0] = nrf24_tx_command(nrf);
+    memcpy(&nrf->dma_tx_buf[1], data, len);
+
+    /* CE high first: TX starts when CSN rises with a payload in the FIFO */
+    nrf24_ce_high(nrf);
+
+    nrf->tx_busy = true;
+    nrf->dma_op = NRF24_DMA_TX_PAYLOAD;
+
+    nrf24_csn_low(nrf);
+    if (HAL_SPI_Transmit_DMA(nrf->hw.spi, nrf->dma_tx_buf, len + 1) != HAL_OK) {
+        nrf24_csn_high(nrf);
+        nrf24_ce_low(nrf);
+        nrf->dma_op = NRF24_DMA_IDLE;
+        nrf->tx_busy = false;
+        return false;
+    }
+
+    return true;
+}
+
+bool nrf24_read_payload_dma(nrf24_t *nrf)
+{
+    if (!nrf || nrf->dma_op != NRF24_DMA_IDLE) {
+        return false;
+    }
+
+    uint8_t width = nrf->payload_size;
+
+    if (nrf->dynamic_payload) {
+        width = nrf24_read_rx_width(nrf);
+
+        if (width == 0 || width > 32) {
+            nrf24_flush_rx(nrf);
+            return false;
+        }
+    }
+
+    memset(nrf->dma_tx_buf, NRF24_CMD_NOP, width + 1);
+    nrf->dma_tx_buf[0] = NRF24_CMD_R_RX_PAYLOAD;
+
+    nrf->dma_rx_len = width;
+    nrf->dma_op = NRF24_DMA_RX_PAYLOAD;
+
+    nrf24_csn_low(nrf);
+    if (HAL_SPI_TransmitReceive_DMA(nrf->hw.spi, nrf->dma_tx_buf, nrf->dma_rx_buf,
+                                    width + 1) != HAL_OK) {
+        nrf24_csn_high(nrf);
+        nrf->dma_op = NRF24_DMA_IDLE;
+        return false;
+    }
+
+    return true;
+}
+
+static void nrf24_dma_finish(nrf24_t *nrf, bool ok)
+{
+    nrf24_dma_op_t op = nrf->dma_op;
+
+    if (op == NRF24_DMA_IDLE) {
+        return;  /* Not our transfer */
+    }
+
+    nrf24_csn_high(nrf);
+    nrf->dma_op = NRF24_DMA_IDLE;
+
+    if (op == NRF24_DMA_TX_PAYLOAD && !ok) {
+        /* Nothing reliable reached the FIFO */
+        nrf24_ce_low(nrf);
+        nrf24_flush_tx(nrf);
+        nrf->tx_busy = false;
+    }
+
+    if (nrf->dma_callback) {
+        if (op == NRF24_DMA_RX_PAYLOAD && ok) {
+            nrf->dma_callback(nrf, op, ok, &nrf->dma_rx_buf[1], nrf->dma_rx_len, nrf->dma_ctx);
+        } else {
+            nrf->dma_callback(nrf, op, ok, NULL, 0, nrf->dma_ctx);
+        }
+    }
+}
+
+void nrf24_spi_dma_complete(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return;
+    }
+
+    nrf24_dma_finish(nrf, true);
+}
+
+void nrf24_spi_dma_error(nrf24_t *nrf)
+{
+    if (!nrf) {
+        return;
+    }
+
+    nrf24_dma_finish(nrf, false);
+}
@@ -0,0 +1,105 @@
+/**
+* @file bind.h
+ * @brief Bind pairs and the RC_PKT_BIND payload
+ *
+ * A bind pair is what two units share once bound: the 5-byte radio
+ * address and the seed of their hop table. The ground makes one up,
+ * typically from the MCU's unique ID (rc_bind_derive()), and hands it
+ * to the aircraft on the bind channel:
+ *
+ *   ground                          aircraft
+ *     OFFER (pair) ──────────────────→  stores it, answers
+ *     ←──────────────────── ACCEPT (pair)
+ *   stores it, moves on              moves on once the offers stop
+ */
+
+#ifndef BIND_H
+#define BIND_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /** Radio address width */
+    #define RC_BIND_ADDRESS_SIZE        5
+
+    /**
+     * @brief What two bound units share
+     */
+    typedef struct {
+        uint8_t address[RC_BIND_ADDRESS_SIZE];  /* TX and pipe 0 address */
+        uint32_t hop_seed;                      /* FHSS bind ID */
+    } rc_bind_info_t;
+
+    /**
+     * @brief Read the stored pair
+     *
+     * @param info Filled in
+     * @param ctx  Context given with the callback
+     * @return true if a pair was stored
+     */
+    typedef bool (*rc_bind_load_t)(rc_bind_info_t *info, void *ctx);
+
+    /**
+     * @brief Store a new pair, e.g. in a flash page
+     *
+     * Called from rc_link_update() when a bind completes.
+     *
+     * @param info Pair to keep
+     * @param ctx  Context given with the callback
+     */
+    typedef void (*rc_bind_save_t)(const rc_bind_info_t *info, void *ctx);
+
+    /**
+     * @brief Where a link stands
+     */
+    typedef enum {
+        RC_BIND_UNBOUND = 0,        /* RC_RF_ADDRESS and RC_FHSS_BIND_ID */
+        RC_BIND_RUNNING,            /* On the bind channel */
+        RC_BIND_BOUND               /* On a pair of its own */
+    } rc_bind_state_t;
+
+    /** RC_PKT_BIND phases */
+    #define RC_BIND_OFFER               1   /* Ground → aircraft: take this pair */
+    #define RC_BIND_ACCEPT              2   /* Aircraft → ground: pair taken */
+
+    /**
+     * @brief RC_PKT_BIND payload
+     */
+    typedef struct __attribute__((packed)) {
+        uint8_t phase;                          /* RC_BIND_OFFER / RC_BIND_ACCEPT */
+        uint8_t address[RC_BIND_ADDRESS_SIZE];
+        uint32_t hop_seed;
+    } rc_bind_payload_t;
+
+    /**
+     * @brief Make a pair from a unique ID
+     *
+     * The same ID always gives the same pair, so a ground that rebinds
+     * keeps its address. Address bytes that would read as preamble or a
+     * flat line (0x00, 0x55, 0xAA, 0xFF) are avoided, and so are the
+     * RC_RF_ADDRESS and RC_BIND_ADDRESS.
+     *
+     * @param uid  Unique bytes, e.g. the 96-bit STM32 UID
+     * @param len  Byte count
+     * @param info Filled in
+     */
+    void rc_bind_derive(const uint8_t *uid, uint8_t len, rc_bind_info_t *info);
+
+    /**
+     * @brief Check a pair before using it
+     *
+     * @param info Pair
+     * @return true if its address is one rc_bind_derive() could produce
+     */
+    bool rc_bind_valid(const rc_bind_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIND_H */
@@ -0,0 +1,242 @@
+/**
+* @file bulk.h
+ * @brief Bulk stream segmentation, reassembly and selective-repeat ARQ
+ *
+ * Moves a buffer larger than one payload (parameter dumps, blackbox logs,
+ * OSD fonts) as numbered segments in RC_PKT_BULK frames. The sender keeps
+ * up to RC_BULK_WINDOW segments in flight; the receiver stores them at
+ * their offset in whatever order they land and answers a poll with a
+ * selective ACK, so only the segments it lacks are sent again:
+ *
+ *   Data ┌───────┬────────┬─────┬──────────────────────────────┐
+ *        │ flags │ stream │ seq │ 0-RC_BULK_SEGMENT_SIZE bytes │
+ *        └───────┴────────┴─────┴──────────────────────────────┘
+ *   ACK  ┌───────┬────────┬──────┬───────────────┬───────┐
+ *        │ flags │ stream │ base │ mask (4 B LE) │ grant │
+ *        └───────┴────────┴──────┴───────────────┴───────┘
+ *
+ * seq is the segment number mod 256; base is the first segment the
+ * receiver still lacks, and bit i of mask is set if base + i has arrived.
+ * Every segment but the last (RC_BULK_FIN) is full size. The ACK's grant
+ * is how many segments the sender may put on air right away, for streams
+ * the other end paces. A receiver started again answers with OPEN, and
+ * CLOSED if the stream before completed, so a sender that lost the final
+ * ACK still finishes.
+ *
+ * The module only keeps the books; the link decides when frames go out
+ * (rc_link_bulk_send()).
+ */
+
+#ifndef BULK_H
+#define BULK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /** Frame flags (first payload byte) */
+    #define RC_BULK_ACK                 0x01    /* ACK frame, else data */
+    #define RC_BULK_POLL                0x02    /* Data: answer with an ACK now */
+    #define RC_BULK_FIN                 0x04    /* Data: last segment of the stream */
+    #define RC_BULK_ABORT               0x08    /* ACK: receiver gave up on the stream */
+    #define RC_BULK_OPEN                0x10    /* ACK: no stream yet, base/mask empty */
+    #define RC_BULK_CLOSED              0x20    /* OPEN ACK: stream finished last, base its count */
+
+    /** Bytes in front of a data segment */
+    #define RC_BULK_DATA_HEADER         3
+
+    /** ACK payload length */
+    #define RC_BULK_ACK_LEN             8
+
+    /** Data bytes per full segment */
+    #define RC_BULK_SEGMENT_SIZE        (RC_MAX_PAYLOAD_SIZE - RC_BULK_DATA_HEADER)
+
+    /**
+     * @brief Where a stream is
+     */
+    typedef enum {
+        RC_BULK_IDLE = 0,           /* Never started, or cancelled */
+        RC_BULK_ACTIVE,             /* Moving data */
+        RC_BULK_DONE,               /* Every byte acknowledged / reassembled */
+        RC_BULK_FAILED              /* Receiver buffer too small */
+    } rc_bulk_state_t;
+
+    /**
+     * @brief Progress of one stream
+     */
+    typedef struct {
+        rc_bulk_state_t state;
+        uint32_t bytes;             /* TX: acknowledged in order; RX: reassembled in order */
+        uint32_t total;             /* Stream size; RX: 0 until the last segment arrives */
+        uint32_t elapsed_ms;        /* First segment to completion (or now) */
+        uint32_t bytes_per_s;       /* bytes over elapsed_ms */
+        uint32_t segments;          /* TX: data frames sent; RX: new segments stored */
+        uint32_t repeats;           /* TX: segments sent again; RX: copies dropped */
+    } rc_bulk_status_t;
+
+    /*============================================================================*/
+    /* Sender                                                                     */
+    /*============================================================================*/
+
+    /**
+     * @brief Sending end of a stream
+     */
+    typedef struct {
+        const uint8_t *data;        /* Caller's buffer, read as segments go out */
+        uint32_t len;
+        uint32_t count;             /* Segments in the stream, at least 1 */
+        uint32_t base;              /* Oldest segment not acknowledged */
+        uint32_t next;              /* Next segment never sent */
+        uint32_t acked;             /* Bit i: base + i acknowledged out of order */
+        uint32_t round;             /* Bit i: base + i sent since the last ACK */
+        uint8_t stream;             /* Stream ID, new per rc_bulk_tx_start() */
+        rc_bulk_state_t state;
+        uint32_t start_ms;
+        uint32_t end_ms;
+        uint32_t sent;
+        uint32_t resent;
+    } rc_bulk_tx_t;
+
+    /**
+     * @brief Start sending a buffer
+     *
+     * The buffer is read in place until the stream is done, failed or
+     * restarted.
+     *
+     * @param tx     Sender (stream ID moves on from the previous stream)
+     * @param data   Bytes to send
+     * @param len    Byte count (0 sends one empty final segment)
+     * @param now_ms Current tick
+     */
+    void rc_bulk_tx_start(rc_bulk_tx_t *tx, const uint8_t *data, uint32_t len, uint32_t now_ms);
+
+    /**
+     * @brief Whether a segment is waiting to go out
+     *
+     * @param tx Sender
+     * @return true if rc_bulk_tx_build() has something to send
+     */
+    bool rc_bulk_tx_ready(const rc_bulk_tx_t *tx);
+
+    /**
+     * @brief Build the next data frame payload
+     *
+     * Segments the last ACK reported missing go first, then new ones while
+     * the window has room. POLL is set if asked for, or if this empties
+     * what can be sent before the next ACK.
+     *
+     * @param tx     Sender
+     * @param out    Payload buffer, RC_MAX_PAYLOAD_SIZE bytes
+     * @param poll   Ask the receiver to acknowledge now
+     * @return Payload length, 0 if nothing is ready
+     */
+    uint8_t rc_bulk_tx_build(rc_bulk_tx_t *tx, uint8_t *out, bool poll);
+
+    /**
+     * @brief Fold in an ACK
+     *
+     * Segments it does not acknowledge become ready again.
+     *
+     * @param tx      Sender
+     * @param payload ACK payload
+     * @param len     Payload length
+     * @param now_ms  Current tick
+     * @return Segments the receiver grants, 0 if none or not an ACK for tx
+     */
+    uint8_t rc_bulk_tx_on_ack(rc_bulk_tx_t *tx, const uint8_t *payload, uint8_t len,
+                              uint32_t now_ms);
+
+    /**
+     * @brief Give up waiting on an ACK: every unacknowledged segment is ready again
+     *
+     * @param tx Sender
+     */
+    void rc_bulk_tx_timeout(rc_bulk_tx_t *tx);
+
+    /**
+     * @brief Progress of the sending end
+     *
+     * @param tx     Sender
+     * @param now_ms Current tick
+     * @param status Filled in
+     */
+    void rc_bulk_tx_status(const rc_bulk_tx_t *tx, uint32_t now_ms, rc_bulk_status_t *status);
+
+    /*============================================================================*/
+    /* Receiver                                                                   */
+    /*============================================================================*/
+
+    /**
+     * @brief Receiving end of a stream
+     */
+    typedef struct {
+        uint8_t *buffer;            /* Caller's buffer, segments land at their offset */
+        uint32_t size;
+        bool bound;                 /* stream holds the ID being received */
+        bool retired;               /* stream holds the previous ID, not taken again */
+        bool closed;                /* The previous stream completed */
+        uint8_t stream;
+        uint8_t closed_base;        /* Its segment count, mod 256 */
+        uint32_t base;              /* First segment missing */
+        uint32_t mask;              /* Bit i: base + i stored */
+        uint32_t count;             /* Segments in the stream, 0 until RC_BULK_FIN */
+        uint32_t len;               /* Stream size, from the RC_BULK_FIN segment */
+        rc_bulk_state_t state;
+        uint32_t start_ms;
+        uint32_t end_ms;
+        uint32_t stored;
+        uint32_t duplicates;
+    } rc_bulk_rx_t;
+
+    /**
+     * @brief Start receiving into a buffer
+     *
+     * The next stream ID heard is taken, other than the one received last;
+     * a stream that does not fit fails.
+     *
+     * @param rx     Receiver
+     * @param buffer Destination
+     * @param size   Buffer size
+     */
+    void rc_bulk_rx_start(rc_bulk_rx_t *rx, uint8_t *buffer, uint32_t size);
+
+    /**
+     * @brief Store a data frame
+     *
+     * @param rx      Receiver
+     * @param payload Data payload
+     * @param len     Payload length
+     * @param now_ms  Current tick
+     * @return true if the sender polled: an ACK is owed
+     */
+    bool rc_bulk_rx_on_data(rc_bulk_rx_t *rx, const uint8_t *payload, uint8_t len,
+                            uint32_t now_ms);
+
+    /**
+     * @brief Build an ACK payload
+     *
+     * @param rx    Receiver
+     * @param out   Payload buffer, RC_BULK_ACK_LEN bytes
+     * @param grant Segments the sender may send on receipt
+     * @return Payload length (RC_BULK_ACK_LEN)
+     */
+    uint8_t rc_bulk_rx_build_ack(const rc_bulk_rx_t *rx, uint8_t *out, uint8_t grant);
+
+    /**
+     * @brief Progress of the receiving end
+     *
+     * @param rx     Receiver
+     * @param now_ms Current tick
+     * @param status Filled in
+     */
+    void rc_bulk_rx_status(const rc_bulk_rx_t *rx, uint32_t now_ms, rc_bulk_status_t *status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BULK_H */
@@ -0,0 +1,90 @@
+/**
+* @file channel_pack.h
+ * @brief Bit-packed RC channel encoding
+ *
+ * Channels are packed LSB-first into a contiguous bit stream, the same
+ * layout SBUS and CRSF use for their 11-bit channel frames. Full
+ * resolution channels take 11 bits (0-2047); aux channels can be sent at
+ * 10 bits, dropping the least significant bit.
+ */
+
+#ifndef CHANNEL_PACK_H
+#define CHANNEL_PACK_H
+
+#include <stdint.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /**
+     * @brief Unpacked channel frame (application side of RC_PKT_CHANNELS)
+     */
+    typedef struct {
+        uint16_t channels[RC_CHANNELS_COUNT];   /* 11-bit first, then 10-bit aux */
+        uint8_t switches;                       /* 8 binary switches */
+        uint8_t mode;                           /* Flight mode */
+    } rc_channels_t;
+
+    /**
+     * @brief Pack channels at 11 bits each
+     *
+     * Values above RC_CHANNEL_MAX are clamped.
+     *
+     * @param out      Output buffer, RC_CHANNEL_PACKED_BYTES(count, 11) bytes
+     * @param channels Channel values (0-2047)
+     * @param count    Number of channels
+     */
+    void rc_channels_pack_11bit(uint8_t *out, const uint16_t *channels, uint8_t count);
+
+    /**
+     * @brief Unpack channels stored at 11 bits each
+     *
+     * @param channels Output channel values (0-2047)
+     * @param in       Packed buffer
+     * @param count    Number of channels
+     */
+    void rc_channels_unpack_11bit(uint16_t *channels, const uint8_t *in, uint8_t count);
+
+    /**
+     * @brief Pack channels at 10 bits each
+     *
+     * Takes the same 0-2047 range as the 11-bit format and drops the LSB.
+     *
+     * @param out      Output buffer, RC_CHANNEL_PACKED_BYTES(count, 10) bytes
+     * @param channels Channel values (0-2047)
+     * @param count    Number of channels
+     */
+    void rc_channels_pack_10bit(uint8_t *out, const uint16_t *channels, uint8_t count);
+
+    /**
+     * @brief Unpack channels stored at 10 bits each
+     *
+     * @param channels Output channel values (0-2046, even steps)
+     * @param in       Packed buffer
+     * @param count    Number of channels
+     */
+    void rc_channels_unpack_10bit(uint16_t *channels, const uint8_t *in, uint8_t count);
+
+    /**
+     * @brief Encode a channel frame into its wire payload
+     *
+     * @param channels Unpacked channel frame
+     * @param payload  Output payload
+     */
+    void rc_channels_encode(const rc_channels_t *channels, rc_channels_payload_t *payload);
+
+    /**
+     * @brief Decode a wire payload into a channel frame
+     *
+     * @param payload  Received payload
+     * @param channels Output channel frame
+     */
+    void rc_channels_decode(const rc_channels_payload_t *payload, rc_channels_t *channels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHANNEL_PACK_H */
@@ -0,0 +1,85 @@
+/**
+* @file clock_sync.h
+ * @brief RC_PKT_HEARTBEAT payload and the round-trip filter
+ *
+ * The ground times a ping from its write to the radio (t1) to the ACK
+ * (t1 + rtt); the aircraft stamps its reception (t2) and echoes it:
+ *
+ *   ground                          aircraft
+ *     t1  PING (id) ────────────────→  t2
+ *     t1 + rtt  ←── ACK
+ *         ←──────────────────── ECHO (id, t2)
+ *   offset = t2 - (t1 + rtt / 2)
+ *
+ * A sample that waited for a retransmit has a long round trip and an
+ * offset skewed by up to half of it, so the estimate is the offset of
+ * the shortest round trip among the last RC_SYNC_WINDOW samples.
+ */
+
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /** RC_PKT_HEARTBEAT phases */
+    #define RC_SYNC_PING                1   /* Ground → aircraft: stamp this */
+    #define RC_SYNC_ECHO                2   /* Aircraft → ground: stamp taken */
+
+    /**
+     * @brief RC_PKT_HEARTBEAT payload
+     */
+    typedef struct __attribute__((packed)) {
+        uint8_t phase;                  /* RC_SYNC_PING / RC_SYNC_ECHO */
+        uint8_t id;                     /* Ping the echo answers */
+        uint32_t rx_us;                 /* ECHO: aircraft tick_us at reception */
+    } rc_sync_payload_t;
+
+    /**
+     * @brief Last RC_SYNC_WINDOW samples
+     */
+    typedef struct {
+        uint32_t rtt_us[RC_SYNC_WINDOW];
+        int32_t offset_us[RC_SYNC_WINDOW];
+        uint8_t count;
+        uint8_t next;                   /* Oldest once the window is full */
+    } rc_sync_filter_t;
+
+    /**
+     * @brief Drop all samples
+     *
+     * @param filter Filter
+     */
+    void rc_sync_reset(rc_sync_filter_t *filter);
+
+    /**
+     * @brief Add a sample, replacing the oldest once the window is full
+     *
+     * @param filter    Filter
+     * @param rtt_us    Round trip of the ping
+     * @param offset_us Aircraft clock minus ground clock it gave
+     */
+    void rc_sync_add(rc_sync_filter_t *filter, uint32_t rtt_us, int32_t offset_us);
+
+    /**
+     * @brief Offset of the shortest round trip in the window
+     *
+     * Ties go to the newer sample, which has drifted least.
+     *
+     * @param filter    Filter
+     * @param rtt_us    Shortest round trip
+     * @param offset_us Its offset
+     * @return false if the window is empty
+     */
+    bool rc_sync_estimate(const rc_sync_filter_t *filter, uint32_t *rtt_us, int32_t *offset_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCK_SYNC_H */
@@ -29,6 +29,26 @@
 #define RC_UPDATE_RATE_HZ           50
 #endif
 
+/**
+ * Link quality window: the last N expected packets (8-32)
+ *
+ * LQ is the share of them that arrived. Each miss costs 100/N points as
+ * soon as it is noticed: on the next arrival's sequence gap, or on the
+ * aircraft when no command came for RC_LQ_INTERVAL_MS.
+ */
+#ifndef RC_LQ_WINDOW
+#define RC_LQ_WINDOW                32
+#endif
+
+#if RC_LQ_WINDOW < 8 || RC_LQ_WINDOW > 32
+#error "RC_LQ_WINDOW must be 8-32"
+#endif
+
+/** Aircraft: expected command interval; silence this long counts a miss */
+#ifndef RC_LQ_INTERVAL_MS
+#define RC_LQ_INTERVAL_MS           (1000 / RC_UPDATE_RATE_HZ)
+#endif
+
 /*============================================================================*/
 /* RF Configuration                                                           */
 /*============================================================================*/
@@ -38,6 +58,11 @@
 #define RC_RF_CHANNEL               76
 #endif
 
+/** Radio address (5 bytes); RC_ENABLE_BIND replaces it with a bound one */
+#ifndef RC_RF_ADDRESS
+#define RC_RF_ADDRESS               { 0xE7, 0xE7, 0xE7, 0xE7, 0xE7 }
+#endif
+
 /** TX power level (0-3) */
 #ifndef RC_TX_POWER
 #define RC_TX_POWER                 3
@@ -48,6 +73,28 @@
 #define RC_DATA_RATE                2
 #endif
 
+/**
+ * Carry telemetry on the auto-ACK of each command packet
+ *
+ * The aircraft stays in RX and the ground in TX, so neither side pays the
+ * mode turnaround. rc_link_send_telemetry() only queues the next ACK
+ * payload. Must match on both ends.
+ */
+#ifndef RC_ENABLE_ACK_TELEMETRY
+#define RC_ENABLE_ACK_TELEMETRY     0
+#endif
+
+/**
+ * Send frames as header + payload + CRC instead of a fixed 32 bytes
+ *
+ * Uses the nRF24 dynamic payload length feature, so a command frame is
+ * airborne for a fraction of the time. Always on with ACK telemetry.
+ * Must match on both ends.
+ */
+#ifndef RC_ENABLE_DYNAMIC_PAYLOAD
+#define RC_ENABLE_DYNAMIC_PAYLOAD   0
+#endif
+
 /** Auto-retransmit count (0-15) */
 #ifndef RC_AUTO_RETRANSMIT_COUNT
 #define RC_AUTO_RETRANSMIT_COUNT    3
@@ -58,22 +105,336 @@
 #define RC_AUTO_RETRANSMIT_DELAY    1
 #endif
 
+/*============================================================================*/
+/* TDMA Frame Scheduler                                                       */
+/*============================================================================*/
+
+/**
+ * Fixed-rate frames timed by NRF24_TIM_HANDLE
+ *
+ * Every frame opens with an uplink slot (ground → aircraft); every
+ * RC_TDMA_TELEMETRY_RATIO-th frame also has a downlink slot half a frame
+ * later. Send calls only stage the next frame. The ground repeats the
+ * last command when nothing new is staged. Requires RC_ENABLE_IRQ and a
+ * 1 MHz timer whose update callback calls rc_link_tdma_tick().
+ * Must match on both ends.
+ */
+#ifndef RC_ENABLE_TDMA
+#define RC_ENABLE_TDMA              0
+#endif
+
+/** Frame rate in Hz (50, 150, 250 or 500) */
+#ifndef RC_TDMA_RATE_HZ
+#define RC_TDMA_RATE_HZ             250
+#endif
+
+/** One downlink slot per this many frames */
+#ifndef RC_TDMA_TELEMETRY_RATIO
+#define RC_TDMA_TELEMETRY_RATIO     4
+#endif
+
+/** Slot timer period: half a frame */
+#define RC_TDMA_HALF_FRAME_US       (1000000UL / (2 * RC_TDMA_RATE_HZ))
+
+#if RC_ENABLE_TDMA && RC_TDMA_RATE_HZ != 50 && RC_TDMA_RATE_HZ != 150 && \
+    RC_TDMA_RATE_HZ != 250 && RC_TDMA_RATE_HZ != 500
+#error "RC_TDMA_RATE_HZ must be 50, 150, 250 or 500"
+#endif
+
+#if RC_TDMA_TELEMETRY_RATIO < 1 || 256 % RC_TDMA_TELEMETRY_RATIO != 0
+#error "RC_TDMA_TELEMETRY_RATIO must divide 256"
+#endif
+
+/*============================================================================*/
+/* Frequency Hopping                                                          */
+/*============================================================================*/
+
+/**
+ * Hop channels every frame instead of staying on RC_RF_CHANNEL
+ *
+ * The ground tunes to hop_table[sequence % RC_FHSS_HOP_COUNT] before each
+ * transmission; the aircraft follows the received sequence numbers. Needs
+ * rc_link_update() called at least once per frame. Must match on both ends.
+ */
+#ifndef RC_ENABLE_FHSS
+#define RC_ENABLE_FHSS              0
+#endif
+
+/** Default bind ID, seeds the hop table */
+#ifndef RC_FHSS_BIND_ID
+#define RC_FHSS_BIND_ID             0x52434C4BUL
+#endif
+
+/** Hop table length (must divide 256 so it stays in step with sequence wrap) */
+#ifndef RC_FHSS_HOP_COUNT
+#define RC_FHSS_HOP_COUNT           16
+#endif
+
+/** RF channel range to hop over (2402-2480 MHz) */
+#ifndef RC_FHSS_CHANNEL_MIN
+#define RC_FHSS_CHANNEL_MIN         2
+#endif
+
+#ifndef RC_FHSS_CHANNEL_MAX
+#define RC_FHSS_CHANNEL_MAX         80
+#endif
+
+/** Minimum distance in MHz between consecutive hops */
+#ifndef RC_FHSS_MIN_SPACING
+#define RC_FHSS_MIN_SPACING         6
+#endif
+
+/** Nominal frame period the aircraft expects between ground packets */
+#ifndef RC_FHSS_FRAME_MS
+#if RC_ENABLE_TDMA
+#define RC_FHSS_FRAME_MS            (1000 / RC_TDMA_RATE_HZ)
+#else
+#define RC_FHSS_FRAME_MS            (1000 / RC_UPDATE_RATE_HZ)
+#endif
+#endif
+
+/** Aircraft hops this long after a packet unless telemetry goes out first
+ *  (with TDMA the aircraft hops at the downlink slot instead) */
+#ifndef RC_FHSS_HOP_DELAY_MS
+#define RC_FHSS_HOP_DELAY_MS        ((RC_FHSS_FRAME_MS / 2) > 0 ? (RC_FHSS_FRAME_MS / 2) : 1)
+#endif
+
+/** Consecutive missed hops before the aircraft drops to dwell/scan */
+#ifndef RC_FHSS_SYNC_LOSS_HOPS
+#define RC_FHSS_SYNC_LOSS_HOPS      RC_FHSS_HOP_COUNT
+#endif
+
+/** Dwell per channel while resyncing (must exceed one full hop cycle) */
+#ifndef RC_FHSS_DWELL_MS
+#define RC_FHSS_DWELL_MS            (RC_FHSS_FRAME_MS * RC_FHSS_HOP_COUNT * 3 / 2)
+#endif
+
+/** Frames between staging a new blacklist and switching to it */
+#ifndef RC_FHSS_MAP_LEAD
+#define RC_FHSS_MAP_LEAD            RC_FHSS_HOP_COUNT
+#endif
+
+#if RC_ENABLE_FHSS
+_Static_assert(256 % RC_FHSS_HOP_COUNT == 0, "RC_FHSS_HOP_COUNT must divide 256");
+_Static_assert(RC_FHSS_CHANNEL_MAX <= 125 && RC_FHSS_CHANNEL_MIN <= RC_FHSS_CHANNEL_MAX,
+               "Invalid FHSS channel range");
+_Static_assert(RC_FHSS_CHANNEL_MAX - RC_FHSS_CHANNEL_MIN + 1 >= RC_FHSS_HOP_COUNT,
+               "FHSS channel range smaller than hop table");
+_Static_assert(RC_FHSS_MAP_LEAD < 128, "RC_FHSS_MAP_LEAD must be under half the sequence space");
+#endif
+
+/*============================================================================*/
+/* Link Adaptation                                                            */
+/*============================================================================*/
+
+/**
+ * Step data rate and TX power with link quality
+ *
+ * The ground scores every transmission attempt (ACKed or not) in a
+ * RC_LQ_WINDOW history and walks a profile ladder: 250 kbps, 1 Mbps and
+ * 2 Mbps at 0 dBm, then 2 Mbps at -6 dBm. Each switch is announced in the
+ * header flags of the RC_ADAPT_LEAD packets before it and only happens if
+ * one of them was ACKed; both ends change at the same sequence number.
+ * Both fall back to 250 kbps after RC_ADAPT_FALLBACK_MS without contact.
+ * Replaces RC_DATA_RATE / RC_TX_POWER. Must match on both ends.
+ */
+#ifndef RC_ENABLE_LINK_ADAPT
+#define RC_ENABLE_LINK_ADAPT        0
+#endif
+
+/** Step to a more robust profile when attempt success drops below this (%) */
+#ifndef RC_ADAPT_LQ_DOWN
+#define RC_ADAPT_LQ_DOWN            50
+#endif
+
+/** Step to a faster profile once attempt success reaches this (%) */
+#ifndef RC_ADAPT_LQ_UP
+#define RC_ADAPT_LQ_UP              80
+#endif
+
+/** Wait after stepping down before trying faster again (doubles, up to
+ *  16x, while step-ups keep failing within it) */
+#ifndef RC_ADAPT_HOLD_MS
+#define RC_ADAPT_HOLD_MS            1000
+#endif
+
+/** Packets between announcing a switch and making it (1-7) */
+#ifndef RC_ADAPT_LEAD
+#define RC_ADAPT_LEAD               6
+#endif
+
+/** Return to the 250 kbps profile after this long without contact */
+#ifndef RC_ADAPT_FALLBACK_MS
+#define RC_ADAPT_FALLBACK_MS        200
+#endif
+
+#if RC_ADAPT_LEAD < 1 || RC_ADAPT_LEAD > 7
+#error "RC_ADAPT_LEAD must be 1-7"
+#endif
+
+#if RC_ADAPT_LQ_DOWN >= RC_ADAPT_LQ_UP
+#error "RC_ADAPT_LQ_DOWN must be below RC_ADAPT_LQ_UP"
+#endif
+
+/*============================================================================*/
+/* CRC Configuration                                                          */
+/*============================================================================*/
+
+#define RC_CRC_BITWISE              0   /* 8 shifts per byte, no tables */
+#define RC_CRC_TABLE                1   /* 256-entry lookup table */
+
+/** CRC implementation */
+#ifndef RC_CRC_BACKEND
+#define RC_CRC_BACKEND              RC_CRC_TABLE
+#endif
+
+#if RC_CRC_BACKEND != RC_CRC_BITWISE && RC_CRC_BACKEND != RC_CRC_TABLE
+#error "RC_CRC_BACKEND must be RC_CRC_BITWISE or RC_CRC_TABLE"
+#endif
+
+/**
+ * Frame check width in bits (8 or 16)
+ *
+ * CRC-16 detects all burst errors up to 16 bits and costs one payload
+ * byte. Must match on both ends.
+ */
+#ifndef RC_CRC_WIDTH
+#define RC_CRC_WIDTH                8
+#endif
+
+#if RC_CRC_WIDTH != 8 && RC_CRC_WIDTH != 16
+#error "RC_CRC_WIDTH must be 8 or 16"
+#endif
+
+#define RC_CRC_SIZE                 (RC_CRC_WIDTH / 8)
+
+/**
+ * Reed-Solomon forward error correction (fec.h)
+ *
+ * Every 32-byte frame ends in RC_FEC_PARITY check bytes, so a receiver
+ * corrects up to RC_FEC_PARITY / 2 damaged bytes in place instead of
+ * dropping the frame; the link CRC still checks the result. The nRF24 only
+ * hands over damaged frames with its own CRC off, which the chip only
+ * allows with auto-ACK off: frames go out once, without retransmits or
+ * hardware ACKs. Must match on both ends.
+ */
+#ifndef RC_ENABLE_FEC
+#define RC_ENABLE_FEC               0
+#endif
+
+/**
+ * Parity bytes per frame with RC_ENABLE_FEC (2 or 4)
+ *
+ * Each pair corrects one byte and takes one from the payload: 24 bytes
+ * are left with 2, 22 with 4 (one fewer each with CRC-16). The default
+ * RC_CHANNELS_HIRES shrinks to fit: 14 with 4, 15 with 2 and CRC-16, 13
+ * with both. CRC-16 with 4 leaves 21 bytes, one short of the default
+ * rc_telemetry_payload_t.
+ */
+#ifndef RC_FEC_PARITY
+#define RC_FEC_PARITY               2
+#endif
+
+#if RC_FEC_PARITY != 2 && RC_FEC_PARITY != 4
+#error "RC_FEC_PARITY must be 2 or 4"
+#endif
+
+#if RC_ENABLE_FEC
+#define RC_FEC_SIZE                 RC_FEC_PARITY
+#else
+#define RC_FEC_SIZE                 0
+#endif
+
 /*============================================================================*/
 /* Payload Structures                                                         */
 /*============================================================================*/
 
-/** Maximum payload size (nRF24 packet = 32 bytes - 5 header - 1 CRC) */
-#define RC_MAX_PAYLOAD_SIZE         26
+/** Maximum payload size (nRF24 packet = 32 bytes - 5 header - CRC - FEC parity) */
+#define RC_MAX_PAYLOAD_SIZE         (32 - 5 - RC_CRC_SIZE - RC_FEC_SIZE)
+
+/** Channels in an RC command */
+#define RC_COMMAND_CHANNELS         8
 
 /**
  * @brief RC command payload (ground → aircraft)
  */
 typedef struct __attribute__((packed)) {
-    uint16_t channels[8];       /* RC channels 0-2047 */
+    uint16_t channels[RC_COMMAND_CHANNELS]; /* RC channels 0-2047 */
     uint8_t switches;           /* 8 binary switches */
     uint8_t mode;               /* Flight mode */
 } rc_command_payload_t;
 
+/** Channel value range shared by all command formats */
+#define RC_CHANNEL_MAX              2047
+#define RC_CHANNEL_CENTER           1024
+
+/** Aux channels appended at 10-bit resolution in RC_PKT_CHANNELS */
+#ifndef RC_CHANNELS_LORES
+#define RC_CHANNELS_LORES           0
+#endif
+
+/** Bytes needed for count channels of the given bit width */
+#define RC_CHANNEL_PACKED_BYTES(count, bits) (((count) * (bits) + 7) / 8)
+
+/** Most 11-bit channels that fit beside the aux block, switches and mode */
+#define RC_CHANNELS_HIRES_MAX       ((RC_MAX_PAYLOAD_SIZE - 2 - \
+                                      RC_CHANNEL_PACKED_BYTES(RC_CHANNELS_LORES, 10)) * 8 / 11)
+
+/**
+ * Channels sent at full 11-bit resolution in RC_PKT_CHANNELS
+ *
+ * Default 16, or as many as fit when CRC-16 or FEC parity shortens the
+ * payload (see RC_FEC_PARITY).
+ */
+#ifndef RC_CHANNELS_HIRES
+#if RC_CHANNELS_HIRES_MAX < 16
+#define RC_CHANNELS_HIRES           RC_CHANNELS_HIRES_MAX
+#else
+#define RC_CHANNELS_HIRES           16
+#endif
+#endif
+
+#if RC_CHANNELS_HIRES > RC_CHANNELS_HIRES_MAX
+#error "RC_CHANNELS_HIRES + RC_CHANNELS_LORES do not fit RC_MAX_PAYLOAD_SIZE; lower RC_CHANNELS_HIRES (see RC_CHANNELS_HIRES_MAX)"
+#endif
+
+#define RC_CHANNELS_COUNT           (RC_CHANNELS_HIRES + RC_CHANNELS_LORES)
+
+#define RC_CHANNELS_PACKED_SIZE     (RC_CHANNEL_PACKED_BYTES(RC_CHANNELS_HIRES, 11) + \
+                                     RC_CHANNEL_PACKED_BYTES(RC_CHANNELS_LORES, 10))
+
+/**
+ * @brief Bit-packed channel payload (ground → aircraft)
+ *
+ * Default 16 × 11 bits = 22 bytes, 24 with switches and mode.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t channels[RC_CHANNELS_PACKED_SIZE];  /* 11-bit block, then 10-bit block */
+    uint8_t switches;           /* 8 binary switches */
+    uint8_t mode;               /* Flight mode */
+} rc_channels_payload_t;
+
+/** Command channels sent in every tiered frame (RC_ENABLE_TIERED_COMMAND) */
+#ifndef RC_TIER_STICKS
+#define RC_TIER_STICKS              4
+#endif
+
+#if RC_TIER_STICKS < 1 || RC_TIER_STICKS >= RC_COMMAND_CHANNELS
+#error "RC_TIER_STICKS must be 1-7"
+#endif
+
+/**
+ * @brief Tiered command payload (ground → aircraft, RC_ENABLE_TIERED_COMMAND)
+ *
+ * Sent as RC_PKT_COMMAND and told apart from a full command by its length:
+ * default 4 × 11 bits of sticks plus one aux slot = 9 bytes.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t sticks[RC_CHANNEL_PACKED_BYTES(RC_TIER_STICKS, 11)];  /* Channels 0.., 11-bit */
+    uint8_t slot;               /* Channel RC_TIER_STICKS + slot, or switches/mode last */
+    uint8_t value[2];           /* Its value (little-endian), or switches then mode */
+} rc_command_tier_t;
+
 /**
  * @brief Telemetry payload (aircraft → ground)
  */
@@ -87,10 +448,28 @@ typedef struct __attribute__((packed)) {
     uint16_t current_ma;        /* Current (mA) */
     int16_t heading;            /* Heading (deg*10) */
     uint8_t flight_mode;        /* Flight mode */
-    uint8_t rssi;               /* Signal strength */
+    uint8_t rssi;               /* Signal strength 0-100 (set by RC_ENABLE_RSSI) */
     uint8_t error_flags;        /* Error bits */
 } rc_telemetry_payload_t;
 
+/** Telemetry items one rc_tlm_mux_t / rc_tlm_cache_t can hold */
+#ifndef RC_TLM_MAX_ITEMS
+#define RC_TLM_MAX_ITEMS            16
+#endif
+
+/** Largest value a multiplexed telemetry item can carry (bytes) */
+#ifndef RC_TLM_MAX_ITEM_SIZE
+#define RC_TLM_MAX_ITEM_SIZE        12
+#endif
+
+#if RC_TLM_MAX_ITEMS < 1 || RC_TLM_MAX_ITEMS > 32
+#error "RC_TLM_MAX_ITEMS must be 1-32"
+#endif
+
+#if RC_TLM_MAX_ITEM_SIZE < 1 || RC_TLM_MAX_ITEM_SIZE > RC_MAX_PAYLOAD_SIZE - 2
+#error "RC_TLM_MAX_ITEM_SIZE must fit one record in a payload"
+#endif
+
 /** Failsafe command values */
 #ifndef RC_FAILSAFE_COMMAND
 #define RC_FAILSAFE_COMMAND { \
@@ -103,8 +482,12 @@ typedef struct __attribute__((packed)) {
 /* Compile-time validation */
 _Static_assert(sizeof(rc_command_payload_t) <= RC_MAX_PAYLOAD_SIZE,
                "Command payload too large");
+_Static_assert(sizeof(rc_channels_payload_t) <= RC_MAX_PAYLOAD_SIZE,
+               "Packed channel payload too large");
 _Static_assert(sizeof(rc_telemetry_payload_t) <= RC_MAX_PAYLOAD_SIZE,
-               "Telemetry payload too large");
+               "Telemetry payload too large (CRC-16 with RC_FEC_PARITY 4 leaves 21 bytes)");
+_Static_assert(sizeof(rc_command_tier_t) < sizeof(rc_command_payload_t),
+               "Tiered command must be shorter than a full one");
 
 /*============================================================================*/
 /* Optional Features                                                          */
@@ -115,6 +498,538 @@ _Static_assert(sizeof(rc_telemetry_payload_t) <= RC_MAX_PAYLOAD_SIZE,
 #define RC_ENABLE_STATISTICS        1
 #endif
 
+/**
+ * Estimate signal strength from RPD and retransmit counts
+ *
+ * Costs one register read per RX drain (RPD) and per completed TX
+ * (OBSERVE_TX ARC_CNT). The estimate is written into the rssi field of
+ * every telemetry packet sent.
+ */
+#ifndef RC_ENABLE_RSSI
+#define RC_ENABLE_RSSI              1
+#endif
+
+/**
+ * Enable interrupt-driven operation
+ *
+ * The nRF24 IRQ pin must be wired to an EXTI line whose callback calls
+ * rc_link_irq_handler(). Send calls return once the payload is uploaded
+ * and receive calls never touch SPI.
+ */
+#ifndef RC_ENABLE_IRQ
+#define RC_ENABLE_IRQ               0
+#endif
+
+/**
+ * Ground waits for the aircraft's reply after each frame (IRQ mode)
+ *
+ * For aircraft that answer commands with frames of their own (telemetry
+ * without RC_ENABLE_ACK_TELEMETRY) while the ground sends back to back:
+ * otherwise a reply and the next command key up together and both retry
+ * to MAX_RT. The ground keeps listening for the aircraft's turnaround,
+ * one full downlink frame and its ACK at the current data rate, plus
+ * RC_REPLY_SLACK_US, and send calls return RC_ERROR_BUSY until then.
+ * A plain ACK carries nothing, so the ground cannot tell a reply is
+ * coming and pays this after every frame: leave it off when the aircraft
+ * seldom replies or commands are paced slower than the window. Requires
+ * RC_ENABLE_IRQ; not with RC_ENABLE_ACK_TELEMETRY (no turnaround) or
+ * RC_ENABLE_TDMA (slotted).
+ */
+#ifndef RC_ENABLE_REPLY_WINDOW
+#define RC_ENABLE_REPLY_WINDOW      0
+#endif
+
+/** Aircraft time to service RX_DR and queue its reply, in the reply window (µs) */
+#ifndef RC_REPLY_SLACK_US
+#define RC_REPLY_SLACK_US           100
+#endif
+
+#if RC_ENABLE_REPLY_WINDOW && (!RC_ENABLE_IRQ || RC_ENABLE_ACK_TELEMETRY || RC_ENABLE_TDMA)
+#error "RC_ENABLE_REPLY_WINDOW requires RC_ENABLE_IRQ, without ACK_TELEMETRY or TDMA"
+#endif
+
+/**
+ * Enable SPI DMA payload transfers and the rc_link_*_async() calls
+ *
+ * Requires RC_ENABLE_IRQ. The SPI TX, TX/RX and error callbacks must be
+ * forwarded to rc_link_spi_dma_complete() / rc_link_spi_dma_error().
+ */
+#ifndef RC_ENABLE_SPI_DMA
+#define RC_ENABLE_SPI_DMA           0
+#endif
+
+/**
+ * Received packets waiting to be read, by type
+ *
+ * The radio's 3-deep RX FIFO is drained in full into this ring. Receive
+ * calls take the oldest packet of the type they want, so other types wait
+ * for their reader. When full, the oldest packet is dropped.
+ */
+#ifndef RC_RX_RING_SIZE
+#define RC_RX_RING_SIZE             4
+#endif
+
+#if RC_RX_RING_SIZE < 3
+#error "RC_RX_RING_SIZE must hold a full RX FIFO (3)"
+#endif
+
+/** Link handles statically allocated for rc_link_instance() */
+#ifndef RC_LINK_INSTANCES
+#define RC_LINK_INSTANCES           1
+#endif
+
+#if RC_ENABLE_SPI_DMA && !RC_ENABLE_IRQ
+#error "RC_ENABLE_SPI_DMA requires RC_ENABLE_IRQ"
+#endif
+
+#if RC_ENABLE_TDMA && !RC_ENABLE_IRQ
+#error "RC_ENABLE_TDMA requires RC_ENABLE_IRQ"
+#endif
+
+/**
+ * Latency histograms (rc_link_get_latency_stats())
+ *
+ * Stamps each hot-path stage with the DWT cycle counter and bins the
+ * durations into log2 µs buckets. Adds a few cycles per stage; compiles
+ * out entirely when 0.
+ */
+#ifndef RC_ENABLE_LATENCY_STATS
+#define RC_ENABLE_LATENCY_STATS     0
+#endif
+
+/** Buckets per stage: 0 counts < 2 µs, n counts [2^n, 2^(n+1)) µs, the last is open */
+#ifndef RC_LATENCY_BUCKETS
+#define RC_LATENCY_BUCKETS          16
+#endif
+
+/**
+ * Pipelined TX queue (rc_link_queue_packet())
+ *
+ * Keeps up to three packets in the radio's TX FIFO and reports each one's
+ * outcome through a callback. Throughput over per-packet confirmation:
+ * telemetry bursts, bulk transfers. Queued packets share one channel, so
+ * this cannot be combined with FHSS or TDMA.
+ */
+#ifndef RC_ENABLE_TX_QUEUE
+#define RC_ENABLE_TX_QUEUE          0
+#endif
+
+#if RC_ENABLE_TX_QUEUE && !RC_ENABLE_IRQ
+#error "RC_ENABLE_TX_QUEUE requires RC_ENABLE_IRQ"
+#endif
+
+#if RC_ENABLE_TX_QUEUE && (RC_ENABLE_FHSS || RC_ENABLE_TDMA)
+#error "RC_ENABLE_TX_QUEUE cannot be combined with RC_ENABLE_FHSS or RC_ENABLE_TDMA"
+#endif
+
+#if RC_ENABLE_LINK_ADAPT && (RC_ENABLE_TX_QUEUE || RC_ENABLE_TDMA)
+#error "RC_ENABLE_LINK_ADAPT cannot be combined with RC_ENABLE_TX_QUEUE or RC_ENABLE_TDMA"
+#endif
+
+/**
+ * Lock-free mailbox between the radio IRQ and the control loop
+ *
+ * The IRQ decodes commands as they arrive and publishes the newest one
+ * through a seqlock; rc_link_get_latest_command() and
+ * rc_link_receive_command() read it without locks or masking interrupts.
+ * Telemetry goes the other way through a single-producer ring the IRQ
+ * drains. Cannot be combined with TX_QUEUE, TDMA or SPI_DMA, which own the
+ * transmit side themselves.
+ */
+#ifndef RC_ENABLE_MAILBOX
+#define RC_ENABLE_MAILBOX           0
+#endif
+
+/** Telemetry frames the control loop can queue ahead of the radio (power of two) */
+#ifndef RC_MAILBOX_TX_SIZE
+#define RC_MAILBOX_TX_SIZE          4
+#endif
+
+#if RC_ENABLE_MAILBOX && !RC_ENABLE_IRQ
+#error "RC_ENABLE_MAILBOX requires RC_ENABLE_IRQ"
+#endif
+
+#if RC_ENABLE_MAILBOX && (RC_ENABLE_TX_QUEUE || RC_ENABLE_TDMA || RC_ENABLE_SPI_DMA)
+#error "RC_ENABLE_MAILBOX cannot be combined with RC_ENABLE_TX_QUEUE, RC_ENABLE_TDMA or RC_ENABLE_SPI_DMA"
+#endif
+
+#if RC_MAILBOX_TX_SIZE < 2 || RC_MAILBOX_TX_SIZE > 128 || \
+    (RC_MAILBOX_TX_SIZE & (RC_MAILBOX_TX_SIZE - 1))
+#error "RC_MAILBOX_TX_SIZE must be a power of two, 2-128"
+#endif
+
+/**
+ * Command callback (rc_link_set_command_callback())
+ *
+ * The radio IRQ hands every new command to a callback as soon as it is
+ * decoded, stamped with the cycle count of the RX interrupt, so outputs
+ * can follow within microseconds of reception instead of at the next
+ * control loop pass. The mailbox still holds the newest command for the
+ * loop. Requires RC_ENABLE_MAILBOX.
+ */
+#ifndef RC_ENABLE_COMMAND_CALLBACK
+#define RC_ENABLE_COMMAND_CALLBACK  0
+#endif
+
+#if RC_ENABLE_COMMAND_CALLBACK && !RC_ENABLE_MAILBOX
+#error "RC_ENABLE_COMMAND_CALLBACK requires RC_ENABLE_MAILBOX"
+#endif
+
+/**
+ * Missed-frame prediction (rc_link_predict_command())
+ *
+ * Over the first RC_PREDICT_FRAMES command frames that fail to arrive, the
+ * channels in RC_PREDICT_CHANNELS carry on along the slope of the last two
+ * commands received; after that they hold. Other channels, switches and
+ * mode hold the last values. Link loss still brings the failsafe values.
+ */
+#ifndef RC_ENABLE_PREDICT
+#define RC_ENABLE_PREDICT           0
+#endif
+
+/** Missed frames extrapolated before holding (1-4) */
+#ifndef RC_PREDICT_FRAMES
+#define RC_PREDICT_FRAMES           2
+#endif
+
+/** Command channels extrapolated, bit per channel (default: the four sticks) */
+#ifndef RC_PREDICT_CHANNELS
+#define RC_PREDICT_CHANNELS         0x0F
+#endif
+
+#if RC_PREDICT_FRAMES < 1 || RC_PREDICT_FRAMES > 4
+#error "RC_PREDICT_FRAMES must be 1-4"
+#endif
+
+/**
+ * Several peers on one radio (rc_link_add_peer())
+ *
+ * A ground radio listens on up to six RX pipes, one per aircraft. Each
+ * peer is its own rc_link_t with its own address, sequencing, failsafe
+ * and statistics; received frames are routed by the pipe they arrived on
+ * and rc_link_next_peer() shares the uplink between them. Retunes, slot
+ * timing and queued sends assume a single peer, so this cannot be
+ * combined with FHSS, TDMA, LINK_ADAPT, TX_QUEUE, SPI_DMA or MAILBOX.
+ */
+#ifndef RC_ENABLE_MULTI_LINK
+#define RC_ENABLE_MULTI_LINK        0
+#endif
+
+#if RC_ENABLE_MULTI_LINK && (RC_ENABLE_FHSS || RC_ENABLE_TDMA || RC_ENABLE_LINK_ADAPT || \
+                             RC_ENABLE_TX_QUEUE || RC_ENABLE_SPI_DMA || RC_ENABLE_MAILBOX)
+#error "RC_ENABLE_MULTI_LINK cannot be combined with FHSS, TDMA, LINK_ADAPT, TX_QUEUE, SPI_DMA or MAILBOX"
+#endif
+
+/**
+ * Second receiver on the same link (rc_hardware_config_t.diversity_radio)
+ *
+ * Another nRF24 with its own antenna listens on the link's channel and
+ * address with auto-ACK off, so it never answers on air, and pauses while
+ * the primary transmits. Frames from both feed a combiner that keeps the
+ * first copy of each header sequence with a valid CRC. The chip only does
+ * dynamic payloads with auto-ACK, and retunes, ACK payloads, queued sends
+ * and DMA reads assume one radio, so this cannot be combined with
+ * DYNAMIC_PAYLOAD, ACK_TELEMETRY, FHSS, TDMA, LINK_ADAPT, TX_QUEUE,
+ * SPI_DMA or MULTI_LINK.
+ */
+#ifndef RC_ENABLE_DIVERSITY
+#define RC_ENABLE_DIVERSITY         0
+#endif
+
+#if RC_ENABLE_DIVERSITY && (RC_ENABLE_DYNAMIC_PAYLOAD || RC_ENABLE_ACK_TELEMETRY || \
+                            RC_ENABLE_FHSS || RC_ENABLE_TDMA || RC_ENABLE_LINK_ADAPT || \
+                            RC_ENABLE_TX_QUEUE || RC_ENABLE_SPI_DMA || RC_ENABLE_MULTI_LINK)
+#error "RC_ENABLE_DIVERSITY cannot be combined with DYNAMIC_PAYLOAD, ACK_TELEMETRY, FHSS, TDMA, LINK_ADAPT, TX_QUEUE, SPI_DMA or MULTI_LINK"
+#endif
+
+/**
+ * Rate-tiered command frames (rc_link_send_command())
+ *
+ * The first RC_TIER_STICKS channels go in every frame; the rest and
+ * switches/mode share one slot per frame. The slot carries whatever
+ * differs from what the aircraft last ACKed, otherwise the next one in
+ * turn. A full command (keyframe) goes out every
+ * RC_TIER_KEYFRAME_INTERVAL frames and until one is ACKed; the aircraft
+ * rebuilds full commands on top of it. Frames only get shorter on air with
+ * RC_ENABLE_DYNAMIC_PAYLOAD. TDMA repeats and async receives bypass the
+ * tracking, so this cannot be combined with TDMA or SPI_DMA.
+ * Must match on both ends.
+ */
+#ifndef RC_ENABLE_TIERED_COMMAND
+#define RC_ENABLE_TIERED_COMMAND    0
+#endif
+
+/** One frame in this many is a keyframe (2-255) */
+#ifndef RC_TIER_KEYFRAME_INTERVAL
+#define RC_TIER_KEYFRAME_INTERVAL   32
+#endif
+
+#if RC_TIER_KEYFRAME_INTERVAL < 2 || RC_TIER_KEYFRAME_INTERVAL > 255
+#error "RC_TIER_KEYFRAME_INTERVAL must be 2-255"
+#endif
+
+#if RC_ENABLE_TIERED_COMMAND && (RC_ENABLE_TDMA || RC_ENABLE_SPI_DMA)
+#error "RC_ENABLE_TIERED_COMMAND cannot be combined with RC_ENABLE_TDMA or RC_ENABLE_SPI_DMA"
+#endif
+
+/*
+ * RC_ENABLE_FEC (CRC Configuration above) runs without auto-ACK: dynamic
+ * payloads and ACK payloads need it, and hop blacklisting, adaptation,
+ * tier tracking, queued sends and peer sharing judge delivery by it. DMA
+ * reads decode in the driver's buffer, which cannot be corrected in place.
+ */
+#if RC_ENABLE_FEC && (RC_ENABLE_DYNAMIC_PAYLOAD || RC_ENABLE_ACK_TELEMETRY || RC_ENABLE_FHSS || \
+                      RC_ENABLE_LINK_ADAPT || RC_ENABLE_TIERED_COMMAND || RC_ENABLE_TX_QUEUE || \
+                      RC_ENABLE_SPI_DMA || RC_ENABLE_MULTI_LINK)
+#error "RC_ENABLE_FEC cannot be combined with DYNAMIC_PAYLOAD, ACK_TELEMETRY, FHSS, LINK_ADAPT, TIERED_COMMAND, TX_QUEUE, SPI_DMA or MULTI_LINK"
+#endif
+
+/**
+ * Commands without ACKs (rc_link_set_no_ack())
+ *
+ * Packet types in the link's no-ACK set go out with W_TX_PAYLOAD_NOACK:
+ * once, without auto-retransmit, and TX_DS as soon as the frame has left,
+ * so a send never waits on a lost ACK and what goes out next is always
+ * the newest command. The aircraft sees losses as sequence gaps. Types
+ * outside the set keep auto-ACK. ACK payloads, hop blacklisting,
+ * adaptation, tier tracking and peer sharing judge commands by their ACK,
+ * so this cannot be combined with ACK_TELEMETRY, FHSS, LINK_ADAPT,
+ * TIERED_COMMAND, MULTI_LINK or FEC (which has no ACKs at all).
+ */
+#ifndef RC_ENABLE_NO_ACK
+#define RC_ENABLE_NO_ACK            0
+#endif
+
+/** Initial no-ACK set: bit per rc_packet_type_t (commands and packed channels) */
+#ifndef RC_NO_ACK_TYPES
+#define RC_NO_ACK_TYPES             ((1UL << RC_PKT_COMMAND) | (1UL << RC_PKT_CHANNELS))
+#endif
+
+/**
+ * Times each no-ACK command goes out (1-4)
+ *
+ * Copies follow RC_NO_ACK_REPEAT_GAP_MS apart from rc_link_update(), with
+ * the same sequence number, until the next command replaces them; the
+ * aircraft drops the copies it already has. Spreading them over the frame
+ * rides out short fades a back-to-back retransmit would fall into.
+ * Repeats go through the plain send path, so more than one cannot be
+ * combined with TDMA, TX_QUEUE, SPI_DMA or MAILBOX.
+ */
+#ifndef RC_NO_ACK_REPEATS
+#define RC_NO_ACK_REPEATS           1
+#endif
+
+/** Spacing of repeated commands (default: frame period / RC_NO_ACK_REPEATS) */
+#ifndef RC_NO_ACK_REPEAT_GAP_MS
+#define RC_NO_ACK_REPEAT_GAP_MS     ((1000 / RC_UPDATE_RATE_HZ) / RC_NO_ACK_REPEATS)
+#endif
+
+#if RC_NO_ACK_REPEATS < 1 || RC_NO_ACK_REPEATS > 4
+#error "RC_NO_ACK_REPEATS must be 1-4"
+#endif
+
+#if RC_ENABLE_NO_ACK && (RC_ENABLE_ACK_TELEMETRY || RC_ENABLE_FHSS || RC_ENABLE_LINK_ADAPT || \
+                         RC_ENABLE_TIERED_COMMAND || RC_ENABLE_MULTI_LINK || RC_ENABLE_FEC)
+#error "RC_ENABLE_NO_ACK cannot be combined with ACK_TELEMETRY, FHSS, LINK_ADAPT, TIERED_COMMAND, MULTI_LINK or FEC"
+#endif
+
+#if RC_ENABLE_NO_ACK && RC_NO_ACK_REPEATS > 1 && \
+    (RC_ENABLE_TDMA || RC_ENABLE_TX_QUEUE || RC_ENABLE_SPI_DMA || RC_ENABLE_MAILBOX)
+#error "RC_NO_ACK_REPEATS > 1 cannot be combined with TDMA, TX_QUEUE, SPI_DMA or MAILBOX"
+#endif
+
+/**
+ * Bulk stream service: buffers of any size in RC_PKT_BULK frames
+ *
+ * Segments go out without ACKs (W_TX_PAYLOAD_NOACK) and are recovered by
+ * a selective-repeat window of their own, only in the spare time between
+ * control frames: the ground sends from RC_BULK_REPLY_MS past each
+ * command and stops RC_BULK_GUARD_MS before the next, RC_UPDATE_RATE_HZ
+ * later; the aircraft only answers what the ground polls or grants. The
+ * ground has to hold its command rate, and the aircraft answer commands
+ * within RC_BULK_REPLY_MS. Both ends need it. Scheduled around the plain send
+ * path, so it cannot be combined with ACK_TELEMETRY, TDMA, FHSS,
+ * LINK_ADAPT, TX_QUEUE, SPI_DMA, MAILBOX, MULTI_LINK or
+ * RC_NO_ACK_REPEATS > 1.
+ */
+#ifndef RC_ENABLE_BULK
+#define RC_ENABLE_BULK              0
+#endif
+
+/** Segments in flight before the sender needs an ACK (1-32) */
+#ifndef RC_BULK_WINDOW
+#define RC_BULK_WINDOW              16
+#endif
+
+/** Air kept clear after a command, for retries and the aircraft's reply */
+#ifndef RC_BULK_REPLY_MS
+#define RC_BULK_REPLY_MS            3
+#endif
+
+/** Air kept clear before the next command */
+#ifndef RC_BULK_GUARD_MS
+#define RC_BULK_GUARD_MS            1
+#endif
+
+/** Silence after a poll or grant before the ground gives up on the answer */
+#ifndef RC_BULK_ACK_TIMEOUT_MS
+#define RC_BULK_ACK_TIMEOUT_MS      2
+#endif
+
+#if RC_BULK_WINDOW < 1 || RC_BULK_WINDOW > 32
+#error "RC_BULK_WINDOW must be 1-32"
+#endif
+
+#if RC_ENABLE_BULK && (RC_ENABLE_ACK_TELEMETRY || RC_ENABLE_TDMA || RC_ENABLE_FHSS || \
+                       RC_ENABLE_LINK_ADAPT || RC_ENABLE_TX_QUEUE || RC_ENABLE_SPI_DMA || \
+                       RC_ENABLE_MAILBOX || RC_ENABLE_MULTI_LINK)
+#error "RC_ENABLE_BULK cannot be combined with ACK_TELEMETRY, TDMA, FHSS, LINK_ADAPT, TX_QUEUE, SPI_DMA, MAILBOX or MULTI_LINK"
+#endif
+
+#if RC_ENABLE_BULK && RC_ENABLE_NO_ACK && RC_NO_ACK_REPEATS > 1
+#error "RC_ENABLE_BULK cannot be combined with RC_NO_ACK_REPEATS > 1"
+#endif
+
+/**
+ * Binary packet trace (rc_link_trace_read())
+ *
+ * Records every frame sent, read or dropped, link profile switch and
+ * failsafe change as an 8-byte record in a RAM ring of RC_TRACE_SIZE per
+ * link: a DWT read, an atomic increment and two word stores, so it can
+ * stay on in flight. Drained in the background over ITM/SWO
+ * (rc_link_trace_drain_itm()) or any byte link such as a DMA UART;
+ * tools/trace_decode.c prints the records on the host. When the reader
+ * falls behind, the oldest records are overwritten and counted lost.
+ */
+#ifndef RC_ENABLE_TRACE
+#define RC_ENABLE_TRACE             0
+#endif
+
+/** Trace records kept per link (power of 2) */
+#ifndef RC_TRACE_SIZE
+#define RC_TRACE_SIZE               128
+#endif
+
+#if RC_TRACE_SIZE < 2 || (RC_TRACE_SIZE & (RC_TRACE_SIZE - 1)) != 0
+#error "RC_TRACE_SIZE must be a power of 2"
+#endif
+
+/*============================================================================*/
+/* Bind and Reacquisition                                                     */
+/*============================================================================*/
+
+/**
+ * Bind procedure (rc_link_bind_start())
+ *
+ * The ground offers a 5-byte address and hop seed of its own on
+ * RC_BIND_CHANNEL at RC_BIND_ADDRESS; the aircraft answers, and both
+ * store the pair through rc_hardware_config_t.bind_save and move to it.
+ * rc_link_init() loads a stored pair through bind_load, so units bound
+ * to different grounds no longer hear each other. Unbound links stay on
+ * the default address and RC_FHSS_BIND_ID. Both ends need it. Bind
+ * frames use the plain send path, so it cannot be combined with TDMA,
+ * TX_QUEUE, SPI_DMA, MAILBOX or MULTI_LINK.
+ */
+#ifndef RC_ENABLE_BIND
+#define RC_ENABLE_BIND              0
+#endif
+
+/** Reserved RF channel for binding, outside the default hop range */
+#ifndef RC_BIND_CHANNEL
+#define RC_BIND_CHANNEL             81
+#endif
+
+/** Address both ends use while binding */
+#ifndef RC_BIND_ADDRESS
+#define RC_BIND_ADDRESS             { 0x3A, 0xC5, 0x96, 0x69, 0x5C }
+#endif
+
+/** Ground: time between bind offers */
+#ifndef RC_BIND_INTERVAL_MS
+#define RC_BIND_INTERVAL_MS         10
+#endif
+
+/** Aircraft: silence after its answer before it takes the new address;
+ *  the ground stops offering once it has the answer */
+#ifndef RC_BIND_SETTLE_MS
+#define RC_BIND_SETTLE_MS           (RC_BIND_INTERVAL_MS * 10)
+#endif
+
+/** Give up and keep the old address after this long (0 = never) */
+#ifndef RC_BIND_TIMEOUT_MS
+#define RC_BIND_TIMEOUT_MS          30000
+#endif
+
+#if RC_BIND_CHANNEL > 125
+#error "RC_BIND_CHANNEL must be 0-125"
+#endif
+
+#if RC_ENABLE_BIND && (RC_ENABLE_TDMA || RC_ENABLE_TX_QUEUE || RC_ENABLE_SPI_DMA || \
+                       RC_ENABLE_MAILBOX || RC_ENABLE_MULTI_LINK)
+#error "RC_ENABLE_BIND cannot be combined with TDMA, TX_QUEUE, SPI_DMA, MAILBOX or MULTI_LINK"
+#endif
+
+/**
+ * Fast reacquisition after link loss (receiver only)
+ *
+ * The first valid frame after a loss brings the link back at once,
+ * instead of counting the frames missed during the outage as a fresh
+ * loss. With FHSS the aircraft keeps hopping on the ground's schedule
+ * for RC_REACQUIRE_COAST_MS after the last frame it heard, so it is on
+ * the right channel when the ground comes back; only after that does
+ * it drop to the RC_FHSS_DWELL_MS scan, which finds a ground that
+ * restarted its sequence.
+ */
+#ifndef RC_ENABLE_REACQUIRE
+#define RC_ENABLE_REACQUIRE         0
+#endif
+
+/** Keep following the hop schedule this long without frames (FHSS) */
+#ifndef RC_REACQUIRE_COAST_MS
+#define RC_REACQUIRE_COAST_MS       5000
+#endif
+
+/*============================================================================*/
+/* Clock Sync                                                                 */
+/*============================================================================*/
+
+/**
+ * Round trip and clock offset (rc_link_sync_ping())
+ *
+ * The ground sends an RC_PKT_HEARTBEAT ping in place of a command, timed
+ * from the write to the radio to its ACK; the aircraft echoes the
+ * rc_hardware_config_t.get_tick_us stamp it took on reception. Across
+ * the last RC_SYNC_WINDOW samples the ground keeps the one with the
+ * shortest round trip, whose offset is the least skewed by retransmits
+ * and late service. The offset assumes the two halves of the round trip
+ * are equal. Both ends need it. Pings keep their ACK whatever the
+ * no-ACK set says. Echoes and stamps assume one radio serviced outside
+ * the IRQ, so this cannot be combined with FEC, TX_QUEUE, MAILBOX or
+ * MULTI_LINK.
+ */
+#ifndef RC_ENABLE_CLOCK_SYNC
+#define RC_ENABLE_CLOCK_SYNC        0
+#endif
+
+/** Ground: rc_link_sync_pending() asks for a ping this often */
+#ifndef RC_SYNC_INTERVAL_MS
+#define RC_SYNC_INTERVAL_MS         100
+#endif
+
+/** Samples the minimum round trip is taken over (1-32) */
+#ifndef RC_SYNC_WINDOW
+#define RC_SYNC_WINDOW              8
+#endif
+
+#if RC_SYNC_WINDOW < 1 || RC_SYNC_WINDOW > 32
+#error "RC_SYNC_WINDOW must be 1-32"
+#endif
+
+#if RC_ENABLE_CLOCK_SYNC && (RC_ENABLE_FEC || RC_ENABLE_TX_QUEUE || RC_ENABLE_MAILBOX || \
+                             RC_ENABLE_MULTI_LINK)
+#error "RC_ENABLE_CLOCK_SYNC cannot be combined with FEC, TX_QUEUE, MAILBOX or MULTI_LINK"
+#endif
+
 /** Enable debug logging */
 #ifndef RC_ENABLE_LOGGING
 #define RC_ENABLE_LOGGING           0
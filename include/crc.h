@@ -1,6 +1,10 @@
 /**
 * @file crc.h
- * @brief CRC-8 calculation
+ * @brief CRC-8 / CRC-16 calculation
+ *
+ * The backend (bitwise or table) is chosen with RC_CRC_BACKEND and the
+ * protocol width with RC_CRC_WIDTH in config.h. All backends produce
+ * identical results.
  */
 
 #ifndef CRC_H
@@ -8,11 +12,29 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "config.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+    /** Protocol CRC type, as selected by RC_CRC_WIDTH */
+#if RC_CRC_WIDTH == 16
+    typedef uint16_t rc_crc_t;
+#else
+    typedef uint8_t rc_crc_t;
+#endif
+
+    /** Initial values, for starting an incremental calculation */
+    #define RC_CRC8_INIT                0x00
+    #define RC_CRC16_INIT               0xFFFF
+
+#if RC_CRC_WIDTH == 16
+    #define RC_CRC_INIT                 RC_CRC16_INIT
+#else
+    #define RC_CRC_INIT                 RC_CRC8_INIT
+#endif
+
     /**
      * @brief Calculate CRC-8 checksum
      *
@@ -25,8 +47,122 @@ extern "C" {
      */
     uint8_t rc_crc8_calculate(const uint8_t *data, size_t len);
 
+    /**
+     * @brief Calculate CRC-16 checksum
+     *
+     * Uses CRC-16-CCITT polynomial: 0x1021
+     * Initial value: 0xFFFF
+     *
+     * @param data Data buffer
+     * @param len  Length of data
+     * @return CRC-16 checksum
+     */
+    uint16_t rc_crc16_calculate(const uint8_t *data, size_t len);
+
+    /**
+     * @brief Calculate the protocol CRC (RC_CRC_WIDTH bits)
+     *
+     * @param data Data buffer
+     * @param len  Length of data
+     * @return Checksum
+     */
+    static inline rc_crc_t rc_crc_calculate(const uint8_t *data, size_t len)
+    {
+#if RC_CRC_WIDTH == 16
+        return rc_crc16_calculate(data, len);
+#else
+        return rc_crc8_calculate(data, len);
+#endif
+    }
+
+    /**
+     * @brief Continue a CRC-8 over more data
+     *
+     * rc_crc8_update(rc_crc8_update(RC_CRC8_INIT, a, n), b, m) equals the
+     * CRC of a followed by b.
+     *
+     * @param crc  CRC so far (RC_CRC8_INIT to start)
+     * @param data Data buffer
+     * @param len  Length of data
+     * @return Updated CRC
+     */
+    uint8_t rc_crc8_update(uint8_t crc, const uint8_t *data, size_t len);
+
+    /**
+     * @brief Continue a CRC-16 over more data
+     *
+     * @param crc  CRC so far (RC_CRC16_INIT to start)
+     * @param data Data buffer
+     * @param len  Length of data
+     * @return Updated CRC
+     */
+    uint16_t rc_crc16_update(uint16_t crc, const uint8_t *data, size_t len);
+
+    /**
+     * @brief Copy data and fold it into a CRC-8 in the same pass
+     *
+     * @param crc CRC so far
+     * @param dst Destination (may not overlap src)
+     * @param src Source
+     * @param len Bytes to copy
+     * @return Updated CRC
+     */
+    uint8_t rc_crc8_copy(uint8_t crc, uint8_t *dst, const uint8_t *src, size_t len);
+
+    /**
+     * @brief Copy data and fold it into a CRC-16 in the same pass
+     *
+     * @param crc CRC so far
+     * @param dst Destination (may not overlap src)
+     * @param src Source
+     * @param len Bytes to copy
+     * @return Updated CRC
+     */
+    uint16_t rc_crc16_copy(uint16_t crc, uint8_t *dst, const uint8_t *src, size_t len);
+
+    /**
+     * @brief Continue the protocol CRC over more data
+     *
+     * @param crc  CRC so far (RC_CRC_INIT to start)
+     * @param data Data buffer
+     * @param len  Length of data
+     * @return Updated CRC
+     */
+    static inline rc_crc_t rc_crc_update(rc_crc_t crc, const uint8_t *data, size_t len)
+    {
+#if RC_CRC_WIDTH == 16
+        return rc_crc16_update(crc, data, len);
+#else
+        return rc_crc8_update(crc, data, len);
+#endif
+    }
+
+    /**
+     * @brief Copy data and fold it into the protocol CRC in the same pass
+     *
+     * @param crc CRC so far
+     * @param dst Destination (may not overlap src)
+     * @param src Source
+     * @param len Bytes to copy
+     * @return Updated CRC
+     */
+    static inline rc_crc_t rc_crc_copy(rc_crc_t crc, uint8_t *dst, const uint8_t *src, size_t len)
+    {
+#if RC_CRC_WIDTH == 16
+        return rc_crc16_copy(crc, dst, src, len);
+#else
+        return rc_crc8_copy(crc, dst, src, len);
+#endif
+    }
+
+    /* Individual backends, always available. Used by bench/crc_bench.c. */
+    uint8_t rc_crc8_bitwise(const uint8_t *data, size_t len);
+    uint8_t rc_crc8_table(const uint8_t *data, size_t len);
+    uint16_t rc_crc16_bitwise(const uint8_t *data, size_t len);
+    uint16_t rc_crc16_table(const uint8_t *data, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
 
-#endif /* CRC_H */
\ No newline at end of file
+#endif /* CRC_H */
@@ -0,0 +1,58 @@
+/**
+* @file fec.h
+ * @brief Reed-Solomon forward error correction
+ *
+ * Shortened RS(n, n - RC_FEC_PARITY) over GF(2^8) (polynomial 0x11D,
+ * generator roots α^0..α^(RC_FEC_PARITY-1)). The last RC_FEC_PARITY bytes
+ * of a codeword are parity over the bytes before them; up to
+ * RC_FEC_PARITY / 2 damaged bytes anywhere in it are corrected. Used on
+ * whole 32-byte frames with RC_ENABLE_FEC.
+ *
+ * Encoding is one table-driven LFSR pass. Decoding computes the syndromes
+ * in one pass and returns straight away for a clean codeword, the common
+ * case; only a damaged one runs Berlekamp-Massey, a Chien search over the
+ * codeword's own positions and Forney.
+ */
+
+#ifndef FEC_H
+#define FEC_H
+
+#include <stdint.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /** Damaged bytes a codeword can lose and still be corrected */
+    #define RC_FEC_CORRECTABLE          (RC_FEC_PARITY / 2)
+
+    /** rc_fec_decode() result for a codeword with too many damaged bytes */
+    #define RC_FEC_UNCORRECTABLE        (-1)
+
+    /**
+     * @brief Compute the parity bytes of a codeword
+     *
+     * @param codeword Data in the first len - RC_FEC_PARITY bytes, parity
+     *                 written to the rest
+     * @param len      Codeword length, RC_FEC_PARITY + 1 to 255 bytes
+     */
+    void rc_fec_encode(uint8_t *codeword, uint8_t len);
+
+    /**
+     * @brief Check a received codeword and correct it in place
+     *
+     * Parity bytes are corrected too. A codeword it cannot correct is left
+     * untouched.
+     *
+     * @param codeword Received codeword
+     * @param len      Codeword length, as encoded
+     * @return Bytes corrected (0 if clean), or RC_FEC_UNCORRECTABLE
+     */
+    int8_t rc_fec_decode(uint8_t *codeword, uint8_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEC_H */
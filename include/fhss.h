@@ -0,0 +1,83 @@
+/**
+* @file fhss.h
+ * @brief Frequency hopping table generation
+ *
+ * Both ends derive the same hop table from a 32-bit bind ID, so only the
+ * ID (and any blacklist) has to be shared. Blacklisted channels are
+ * replaced slot by slot; the remaining slots keep their channels, which
+ * lets an aircraft still holding the old table catch most frames.
+ */
+
+#ifndef FHSS_H
+#define FHSS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /** Bytes in a channel bitmap covering RF channels 0-125 */
+    #define RC_FHSS_MAP_BYTES           16
+
+    /**
+     * @brief RC_PKT_HOP_MAP payload
+     */
+    typedef struct __attribute__((packed)) {
+        uint8_t blacklist[RC_FHSS_MAP_BYTES];   /* Bit n = RF channel n unusable */
+        uint8_t apply_sequence;                 /* First ground sequence on this table */
+        uint8_t generation;                     /* Table generation (0/1) */
+    } rc_fhss_map_payload_t;
+
+    /**
+     * @brief Per-slot hop statistics
+     */
+    typedef struct {
+        uint8_t channel;            /* RF channel in this slot */
+        uint32_t good;              /* Frames delivered (ground) / received (aircraft) */
+        uint32_t lost;              /* Frames unacknowledged / missed */
+    } rc_fhss_slot_stats_t;
+
+    /**
+     * @brief Build a hop table
+     *
+     * Channels are distinct, within RC_FHSS_CHANNEL_MIN..MAX and at least
+     * RC_FHSS_MIN_SPACING apart from their neighbours where the range
+     * allows it.
+     *
+     * @param channels  Output table, RC_FHSS_HOP_COUNT entries
+     * @param bind_id   Seed shared by both ends
+     * @param blacklist Channel bitmap to avoid, or NULL
+     */
+    void rc_fhss_build_table(uint8_t *channels, uint32_t bind_id, const uint8_t *blacklist);
+
+    /**
+     * @brief Check a channel against a bitmap
+     *
+     * @param map     Channel bitmap (RC_FHSS_MAP_BYTES)
+     * @param channel RF channel
+     * @return true if the channel's bit is set
+     */
+    static inline bool rc_fhss_map_test(const uint8_t *map, uint8_t channel)
+    {
+        return (map[channel >> 3] >> (channel & 7)) & 1;
+    }
+
+    /**
+     * @brief Set a channel's bit in a bitmap
+     *
+     * @param map     Channel bitmap (RC_FHSS_MAP_BYTES)
+     * @param channel RF channel
+     */
+    static inline void rc_fhss_map_set(uint8_t *map, uint8_t channel)
+    {
+        map[channel >> 3] |= (uint8_t)(1u << (channel & 7));
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FHSS_H */
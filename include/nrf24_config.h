@@ -4,6 +4,9 @@
  *
  * Configure SPI peripheral and GPIO pins for your STM32.
  * Change according to your application's hardware connections.
+ *
+ * These are the radio nrf24_init() drives. A second radio on the same MCU
+ * is described by an nrf24_hw_t passed to nrf24_init_hw() instead.
  */
 
 #ifndef NRF24_CONFIG_H
@@ -33,11 +36,15 @@
 #define NRF24_CE_PORT           GPIOB
 #define NRF24_CE_PIN            NRF_CE_Pin
 
+/** IRQ pin (EXTI falling edge, only needed with RC_ENABLE_IRQ) */
+#define NRF24_IRQ_PORT          GPIOB
+#define NRF24_IRQ_PIN           NRF_IRQ_Pin
+
 /*============================================================================*/
 /* Timing Configuration                                                       */
 /*============================================================================*/
 
-/** Timer for microsecond delays */
+/** 1 MHz timer (TDMA slot clock when RC_ENABLE_TDMA is set) */
 #define NRF24_TIM_HANDLE        htim3
 
 /** System tick function for millisecond timing */
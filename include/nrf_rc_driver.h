@@ -11,6 +11,13 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "config.h"
+#include "channel_pack.h"
+#include "fhss.h"
+#include "telemetry_mux.h"
+#include "bulk.h"
+#include "trace.h"
+#include "bind.h"
+#include "clock_sync.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,21 +35,34 @@ typedef enum {
     RC_ERROR_CRC_FAIL,          /* CRC validation failed */
     RC_ERROR_VERSION_MISMATCH,  /* Protocol version mismatch */
     RC_ERROR_HARDWARE,          /* Hardware/SPI error */
-    RC_ERROR_NOT_INITIALIZED    /* Driver not initialized */
+    RC_ERROR_NOT_INITIALIZED,   /* Driver not initialized */
+    RC_ERROR_BUSY               /* Previous transmission still in flight */
 } rc_status_t;
 
 /*============================================================================*/
 /* Hardware Configuration                                                     */
 /*============================================================================*/
 
+struct nrf24_hw;
+
 /**
  * @brief Hardware configuration
  *
- * All pin/peripheral configuration is in nrf24_config.h.
- * This structure only needs timing function.
+ * The default radio wiring is in nrf24_config.h. Links on further radios
+ * name their SPI handle and pins with an nrf24_hw_t (nrf24.h).
  */
 typedef struct {
     uint32_t (*get_tick_ms)(void);  /* Millisecond tick function */
+    uint32_t (*get_tick_us)(void);  /* Microsecond tick, NULL = get_tick_ms() * 1000 */
+    const struct nrf24_hw *radio;   /* Radio wiring, NULL = nrf24_config.h */
+#if RC_ENABLE_DIVERSITY
+    const struct nrf24_hw *diversity_radio; /* Second receiver, NULL = none */
+#endif
+#if RC_ENABLE_BIND
+    rc_bind_load_t bind_load;       /* Stored bind pair, read by rc_link_init(); NULL = none */
+    rc_bind_save_t bind_save;       /* Keeps a new pair; NULL = forgotten at reset */
+    void *bind_ctx;
+#endif
 } rc_hardware_config_t;
 
 /*============================================================================*/
@@ -56,20 +76,158 @@ typedef struct {
     uint32_t packets_missed;        /* Packets missed (sequence gaps) */
     uint32_t crc_errors;            /* CRC validation failures */
     uint32_t version_mismatches;    /* Protocol version mismatches */
-    uint8_t link_quality;           /* Link quality 0-100% */
+    uint8_t link_quality;           /* Packets received of the last RC_LQ_WINDOW 0-100% */
+    uint8_t rssi;                   /* Signal estimate 0-100 (RC_ENABLE_RSSI) */
+    uint32_t spi_transactions;      /* Total SPI transactions issued */
+    uint8_t spi_per_frame;          /* SPI transactions used by the last frame */
+    uint32_t tdma_uplink_overruns;  /* Uplink slots skipped: radio/SPI still busy */
+    uint32_t tdma_downlink_overruns;/* Downlink slots skipped: radio/SPI still busy */
+    uint32_t rx_ring_overflows;     /* Packets dropped unread: RX ring full */
+    uint32_t profile_switches;      /* Data rate / power changes (RC_ENABLE_LINK_ADAPT) */
+    uint32_t diversity_rx[2];       /* Frames each receiver delivered first (RC_ENABLE_DIVERSITY) */
+    uint32_t diversity_duplicates;  /* Copies dropped: the other receiver had it already */
+    uint32_t tier_keyframes;        /* Full commands sent (RC_ENABLE_TIERED_COMMAND) */
+    uint32_t tier_unsynced;         /* Tiered frames dropped before the first keyframe */
+    uint32_t fec_corrected;         /* Frames repaired by FEC (RC_ENABLE_FEC) */
+    uint32_t fec_uncorrectable;     /* Frames dropped: too damaged to repair */
+    uint32_t no_ack_repeats;        /* Extra copies of no-ACK commands sent (RC_ENABLE_NO_ACK) */
+    uint32_t no_ack_duplicates;     /* Copies dropped: the frame was read already */
+    uint32_t trace_lost;            /* Trace records overwritten unread (RC_ENABLE_TRACE) */
+    uint32_t reconnects;            /* Times the link came back after a loss */
+    uint32_t reconnect_ms;          /* Last one: last frame before the loss to the first after */
+    uint32_t reconnect_max_ms;      /* Longest of those */
+    uint32_t sync_samples;          /* Echoes matched to a timed ping (RC_ENABLE_CLOCK_SYNC) */
+    uint32_t sync_rtt_last_us;      /* Round trip of the last ping ACKed */
+    uint32_t sync_rtt_us;           /* Shortest of the last RC_SYNC_WINDOW */
+    int32_t sync_offset_us;         /* Its offset: aircraft tick_us minus ground tick_us */
 } rc_stats_t;
 #endif
 
+#if RC_ENABLE_LATENCY_STATS
+/**
+ * @brief Hot-path stages timed by the latency histograms
+ */
+typedef enum {
+    RC_LATENCY_ENCODE = 0,      /* Header, payload copy and CRC */
+    RC_LATENCY_SPI_UPLOAD,      /* W_TX_PAYLOAD until CE pulse */
+    RC_LATENCY_AIR,             /* Upload done until TX_DS */
+    RC_LATENCY_RX_QUEUE,        /* RX_DR until decode starts */
+    RC_LATENCY_DECODE,          /* Decode start until the payload is handed over */
+    RC_LATENCY_STAGE_COUNT
+} rc_latency_stage_t;
+
+/**
+ * @brief Duration histogram of one stage
+ */
+typedef struct {
+    uint32_t count;                         /* Samples recorded */
+    uint32_t min_us;                        /* Shortest sample */
+    uint32_t max_us;                        /* Longest sample */
+    uint32_t total_us;                      /* Sum, for the mean */
+    uint32_t buckets[RC_LATENCY_BUCKETS];   /* See RC_LATENCY_BUCKETS */
+} rc_latency_hist_t;
+
+typedef struct {
+    rc_latency_hist_t stage[RC_LATENCY_STAGE_COUNT];
+} rc_latency_stats_t;
+#endif
+
+#if RC_ENABLE_MAILBOX
+/**
+ * @brief Newest command published by the radio IRQ
+ */
+typedef struct {
+    rc_command_payload_t command;   /* Failsafe values if failsafe is set */
+    uint32_t rx_time_ms;            /* get_tick_ms() when it was decoded */
+    uint32_t rx_cycles;             /* Cycle count at the RX interrupt (0 without
+                                     * RC_ENABLE_COMMAND_CALLBACK / RC_ENABLE_PREDICT) */
+    uint8_t sequence;               /* Packet sequence number */
+    bool failsafe;                  /* Nothing heard yet, or the link is lost */
+} rc_command_sample_t;
+#endif
+
 /*============================================================================*/
 /* Driver Handle                                                              */
 /*============================================================================*/
 
 typedef struct rc_link rc_link_t;
 
+/**
+ * @brief Handler for rc_link_process_rx()
+ *
+ * Runs in the caller's context; may call the send functions.
+ *
+ * @param link        Pointer to link handle
+ * @param type        Packet type (rc_packet_type_t)
+ * @param payload     Validated payload
+ * @param payload_len Payload length in bytes
+ * @param ctx         User context passed to rc_link_process_rx()
+ */
+typedef void (*rc_rx_handler_t)(rc_link_t *link, uint8_t type, const void *payload,
+                                uint8_t payload_len, void *ctx);
+
+#if RC_ENABLE_TX_QUEUE
+/**
+ * @brief Completion callback for rc_link_queue_packet()
+ *
+ * Runs in interrupt context, once per queued packet, in queue order.
+ *
+ * @param link     Pointer to link handle
+ * @param type     Packet type (rc_packet_type_t)
+ * @param sequence Sequence number the packet was sent with
+ * @param status   RC_OK (ACKed), RC_ERROR_TIMEOUT (retries exhausted or
+ *                 the radio stalled)
+ * @param ctx      User context from rc_link_set_tx_queue_callback()
+ */
+typedef void (*rc_tx_complete_t)(rc_link_t *link, uint8_t type, uint8_t sequence,
+                                 rc_status_t status, void *ctx);
+#endif
+
+#if RC_ENABLE_SPI_DMA
+/**
+ * @brief Async operation completion callback
+ *
+ * Runs in interrupt context.
+ *
+ * @param link   Pointer to link handle
+ * @param type   Packet type (rc_packet_type_t) of the completed operation
+ * @param status Send: RC_OK, RC_ERROR_TIMEOUT (no ACK) or RC_ERROR_HARDWARE.
+ *               Receive: RC_OK (payload written to the armed buffer)
+ * @param ctx    User context from rc_link_set_async_callback()
+ */
+typedef void (*rc_async_callback_t)(rc_link_t *link, uint8_t type,
+                                    rc_status_t status, void *ctx);
+#endif
+
+#if RC_ENABLE_COMMAND_CALLBACK
+/**
+ * @brief New command callback
+ *
+ * Runs in interrupt context with the radio bus held, once per command
+ * decoded: update outputs and return without calling into the link.
+ *
+ * @param link   Pointer to link handle
+ * @param sample Command with its receive tick, cycle count and sequence
+ * @param ctx    User context from rc_link_set_command_callback()
+ */
+typedef void (*rc_command_callback_t)(rc_link_t *link, const rc_command_sample_t *sample,
+                                      void *ctx);
+#endif
+
 /*============================================================================*/
 /* Initialization                                                             */
 /*============================================================================*/
 
+/**
+ * @brief Get a statically allocated link handle
+ *
+ * rc_link_t is opaque; RC_LINK_INSTANCES handles live inside the driver.
+ *
+ * @param index Handle index (0 to RC_LINK_INSTANCES-1)
+ * @return Handle, or NULL if index is out of range
+ */
+rc_link_t *rc_link_instance(uint8_t index);
+
 /**
  * @brief Initialize RC link
  *
@@ -82,6 +240,11 @@ rc_status_t rc_link_init(rc_link_t *link, const rc_hardware_config_t *hw_config)
 /**
  * @brief Deinitialize RC link
  *
+ * On a multi-link peer this only detaches it: no frame is routed to it
+ * once this returns, so the handle may be reused, and its pipe closes
+ * right away or, if the bus is in use, when the bus is next released. A
+ * host detaches its remaining peers the same way before powering down.
+ *
  * @param link Pointer to link handle
  */
 void rc_link_deinit(rc_link_t *link);
@@ -93,12 +256,27 @@ void rc_link_deinit(rc_link_t *link);
 /**
  * @brief Send RC command to aircraft
  *
+ * With RC_ENABLE_TIERED_COMMAND most frames carry only the sticks and one
+ * aux slot (rc_command_tier_t); the aircraft still receives full commands.
+ *
  * @param link    Pointer to link handle
  * @param command Command payload
  * @return RC_OK if sent successfully
  */
 rc_status_t rc_link_send_command(rc_link_t *link, const rc_command_payload_t *command);
 
+/**
+ * @brief Send bit-packed channels to aircraft
+ *
+ * Sends RC_CHANNELS_COUNT channels (default 16) in one RC_PKT_CHANNELS
+ * frame. Use instead of rc_link_send_command(), not alongside it.
+ *
+ * @param link     Pointer to link handle
+ * @param channels Channel frame
+ * @return RC_OK if sent successfully
+ */
+rc_status_t rc_link_send_channels(rc_link_t *link, const rc_channels_t *channels);
+
 /**
  * @brief Receive telemetry from aircraft
  *
@@ -108,6 +286,19 @@ rc_status_t rc_link_send_command(rc_link_t *link, const rc_command_payload_t *co
  */
 rc_status_t rc_link_receive_telemetry(rc_link_t *link, rc_telemetry_payload_t *telemetry);
 
+/**
+ * @brief Receive one multiplexed telemetry frame into a cache
+ *
+ * Every record in the frame updates its item's latest value and arrival
+ * time; read them back with rc_tlm_cache_get(). Call until it stops
+ * returning RC_OK to drain the queue.
+ *
+ * @param link  Pointer to link handle
+ * @param cache Cache of latest item values
+ * @return RC_OK if a frame was decoded, RC_ERROR_NO_DATA if none available
+ */
+rc_status_t rc_link_receive_telemetry_mux(rc_link_t *link, rc_tlm_cache_t *cache);
+
 /*============================================================================*/
 /* Aircraft API                                                               */
 /*============================================================================*/
@@ -115,7 +306,9 @@ rc_status_t rc_link_receive_telemetry(rc_link_t *link, rc_telemetry_payload_t *t
 /**
  * @brief Receive RC command from ground
  *
- * Returns failsafe values automatically if link is lost.
+ * Returns failsafe values automatically if link is lost. With
+ * RC_ENABLE_MAILBOX this reads the mailbox and returns RC_OK once per new
+ * command, skipping any the IRQ replaced in between.
  *
  * @param link    Pointer to link handle
  * @param command Output buffer for command
@@ -123,6 +316,38 @@ rc_status_t rc_link_receive_telemetry(rc_link_t *link, rc_telemetry_payload_t *t
  */
 rc_status_t rc_link_receive_command(rc_link_t *link, rc_command_payload_t *command);
 
+#if RC_ENABLE_PREDICT
+/**
+ * @brief Command for right now, carried over missed frames
+ *
+ * Does not take commands from the radio: call it when
+ * rc_link_receive_command() (or the mailbox) has nothing new. The newest
+ * command is returned until its next frame is half a period overdue; then
+ * the RC_PREDICT_CHANNELS follow the slope of the last two commands for
+ * up to RC_PREDICT_FRAMES frames and hold. Failsafe values once the link
+ * is lost, as rc_link_receive_command().
+ *
+ * @param link    Pointer to link handle
+ * @param command Output buffer for command
+ * @param missed  Output: frames missed since the newest command (NULL to skip)
+ * @return RC_OK (RC_ERROR_NO_DATA if no command was received yet)
+ */
+rc_status_t rc_link_predict_command(rc_link_t *link, rc_command_payload_t *command,
+                                    uint8_t *missed);
+#endif
+
+/**
+ * @brief Receive bit-packed channels from ground
+ *
+ * Returns failsafe values automatically if link is lost. Channels beyond
+ * the eight held in the failsafe command are set to RC_CHANNEL_CENTER.
+ *
+ * @param link     Pointer to link handle
+ * @param channels Output channel frame
+ * @return RC_OK if received (or failsafe active)
+ */
+rc_status_t rc_link_receive_channels(rc_link_t *link, rc_channels_t *channels);
+
 /**
  * @brief Send telemetry to ground station
  *
@@ -132,6 +357,99 @@ rc_status_t rc_link_receive_command(rc_link_t *link, rc_command_payload_t *comma
  */
 rc_status_t rc_link_send_telemetry(rc_link_t *link, const rc_telemetry_payload_t *telemetry);
 
+/**
+ * @brief Send the due items of a telemetry scheduler to ground
+ *
+ * Packs as many due items as fit into one RC_PKT_TELEMETRY_MUX frame, by
+ * priority, and sends it the way rc_link_send_telemetry() would. Items only
+ * count as sent on RC_OK, so a frame that could not go out is rebuilt on
+ * the next call. With RC_ENABLE_RSSI a registered RC_TLM_RSSI item is
+ * refreshed from the link first.
+ *
+ * @param link Pointer to link handle
+ * @param mux  Telemetry scheduler
+ * @return RC_OK if sent, RC_ERROR_NO_DATA if no item was due
+ */
+rc_status_t rc_link_send_telemetry_mux(rc_link_t *link, rc_tlm_mux_t *mux);
+
+/*============================================================================*/
+/* Zero-Copy API                                                              */
+/*============================================================================*/
+
+/**
+ * @brief Open a frame and get its payload buffer to write into
+ *
+ * The header is built and checksummed here, so the payload length must be
+ * known up front. Fill the buffer directly or with rc_link_tx_write(), then
+ * send it with rc_link_tx_commit(). No other send may run in between.
+ *
+ * Telemetry opened this way is not stamped with the RSSI estimate; set
+ * rssi from rc_link_get_rssi() while filling it in.
+ *
+ * @param link        Pointer to link handle
+ * @param type        Packet type (rc_packet_type_t)
+ * @param payload_len Payload length (max RC_MAX_PAYLOAD_SIZE)
+ * @param payload     Output: payload buffer, payload_len bytes
+ * @return RC_OK if opened, RC_ERROR_BUSY if the last TX is still in flight
+ */
+rc_status_t rc_link_tx_acquire(rc_link_t *link, uint8_t type, uint8_t payload_len,
+                               void **payload);
+
+/**
+ * @brief Append to the open frame, checksumming on the way in
+ *
+ * Bytes go after those already appended. Anything written through the
+ * pointer instead must lie beyond them; it is checksummed at commit.
+ *
+ * @param link Pointer to link handle
+ * @param data Data to append
+ * @param len  Bytes to append
+ * @return RC_OK, RC_ERROR_INVALID_PARAM if no frame is open or it would overflow
+ */
+rc_status_t rc_link_tx_write(rc_link_t *link, const void *data, uint8_t len);
+
+/**
+ * @brief Finish the CRC and send the open frame
+ *
+ * Same transport as the matching copy-based call: staged for the next slot
+ * with TDMA, queued as an ACK payload for telemetry with ACK telemetry.
+ *
+ * @param link Pointer to link handle
+ * @return RC_OK if sent, RC_ERROR_INVALID_PARAM if no frame is open
+ */
+rc_status_t rc_link_tx_commit(rc_link_t *link);
+
+/**
+ * @brief Discard the open frame
+ *
+ * @param link Pointer to link handle
+ */
+void rc_link_tx_abort(rc_link_t *link);
+
+/**
+ * @brief Get a read-only view of the next packet of a type
+ *
+ * The packet is validated where it was received and lent out until
+ * rc_link_rx_release() or the next call, which releases it. Like
+ * rc_link_receive_command(), commands and channels return a view of the
+ * failsafe values (packed, for RC_PKT_CHANNELS) while the link is lost.
+ *
+ * @param link        Pointer to link handle
+ * @param type        Packet type (rc_packet_type_t)
+ * @param payload     Output: payload view
+ * @param payload_len Output: payload length
+ * @return RC_OK if received (or failsafe active), RC_ERROR_NO_DATA if none
+ */
+rc_status_t rc_link_rx_acquire(rc_link_t *link, uint8_t type, const void **payload,
+                               uint8_t *payload_len);
+
+/**
+ * @brief Return the view from rc_link_rx_acquire() to the driver
+ *
+ * @param link Pointer to link handle
+ */
+void rc_link_rx_release(rc_link_t *link);
+
 /*============================================================================*/
 /* Common API                                                                 */
 /*============================================================================*/
@@ -146,6 +464,21 @@ rc_status_t rc_link_send_telemetry(rc_link_t *link, const rc_telemetry_payload_t
  */
 rc_status_t rc_link_update(rc_link_t *link);
 
+/**
+ * @brief Deliver every queued packet, whatever its type
+ *
+ * Drains the radio's RX FIFO (polling mode) and hands each valid packet
+ * in the RX ring to the handler in arrival order. Use this instead of, or
+ * alongside, the typed receive calls when several packet types share the
+ * link. Failsafe substitution only happens in rc_link_receive_command().
+ *
+ * @param link    Pointer to link handle
+ * @param handler Called once per packet
+ * @param ctx     User context passed to the handler
+ * @return Number of packets delivered
+ */
+uint8_t rc_link_process_rx(rc_link_t *link, rc_rx_handler_t handler, void *ctx);
+
 /**
  * @brief Check if link is active
  *
@@ -162,6 +495,43 @@ bool rc_link_is_active(rc_link_t *link);
  */
 uint32_t rc_link_get_time_since_rx(rc_link_t *link);
 
+/**
+ * @brief Get time since last received packet, from rc_hardware_config_t.get_tick_us
+ *
+ * Counted from the RX interrupt (or poll) that found the packet, not
+ * from when it was decoded.
+ *
+ * @param link Pointer to link handle
+ * @return Microseconds since last RX (wraps after 71 minutes), or
+ *         UINT32_MAX if never received
+ */
+uint32_t rc_link_get_time_since_rx_us(rc_link_t *link);
+
+/**
+ * @brief Get link quality over the last RC_LQ_WINDOW expected packets
+ *
+ * Updated on every arrival and, on the aircraft, by rc_link_update() when
+ * commands stop coming.
+ *
+ * @param link Pointer to link handle
+ * @return Packets received 0-100%, 0 before the first packet
+ */
+uint8_t rc_link_get_link_quality(rc_link_t *link);
+
+#if RC_ENABLE_RSSI
+/**
+ * @brief Get the signal strength estimate
+ *
+ * Half from the share of recent packets heard above -64 dBm (RPD), half
+ * from how few retransmits recent sends needed (OBSERVE_TX). The nRF24
+ * has no real RSSI, so treat this as a trend, not a level.
+ *
+ * @param link Pointer to link handle
+ * @return 0 (weak) to 100 (strong)
+ */
+uint8_t rc_link_get_rssi(rc_link_t *link);
+#endif
+
 /**
  * @brief Set failsafe values
  *
@@ -180,6 +550,592 @@ rc_status_t rc_link_set_failsafe(rc_link_t *link, const rc_command_payload_t *fa
  */
 rc_status_t rc_link_get_failsafe(rc_link_t *link, rc_command_payload_t *failsafe);
 
+#if RC_ENABLE_NO_ACK
+/**
+ * @brief Choose whether a packet type is sent without ACKs
+ *
+ * Starts as RC_NO_ACK_TYPES (commands and packed channels). A no-ACK
+ * frame goes out once and its send returns as soon as it has left;
+ * with RC_NO_ACK_REPEATS > 1 copies follow from rc_link_update(). Other
+ * types keep auto-ACK and its retransmits. Only the sending end's set
+ * matters.
+ *
+ * @param link   Pointer to link handle
+ * @param type   rc_packet_type_t
+ * @param no_ack true to send without ACKs, false for auto-ACK
+ * @return RC_OK, or RC_ERROR_INVALID_PARAM
+ */
+rc_status_t rc_link_set_no_ack(rc_link_t *link, uint8_t type, bool no_ack);
+#endif
+
+/**
+ * @brief Air time of one acknowledged frame exchange
+ *
+ * TX settling, the frame itself, RX turnaround and the returning ACK
+ * (carrying telemetry when RC_ENABLE_ACK_TELEMETRY is set), at the
+ * configured data rate. Useful for sizing the command rate. With
+ * RC_ENABLE_FEC it is the frame alone; a no-ACK type (RC_ENABLE_NO_ACK)
+ * also ends with the frame, but is still counted with its ACK here.
+ *
+ * @param link        Pointer to link handle
+ * @param payload_len Payload length in bytes
+ * @return Exchange time in µs, or 0 on invalid parameters
+ */
+uint32_t rc_link_get_airtime_us(rc_link_t *link, uint8_t payload_len);
+
+/**
+ * @brief Verify the radio configuration and restore it if it diverged
+ *
+ * Reads back the registers the driver keeps shadow copies of. If any
+ * differ (typically a radio brownout), rewrites them. Costs a dozen SPI
+ * reads, so call it periodically (e.g. once a second), not every frame.
+ *
+ * @param link Pointer to link handle
+ * @return RC_OK if the radio matches or was restored, RC_ERROR_BUSY if a
+ *         transmission is in flight, RC_ERROR_HARDWARE if it still differs
+ */
+rc_status_t rc_link_check_radio(rc_link_t *link);
+
+/**
+ * @brief Set the link's 5-byte radio address
+ *
+ * Used as TX address and pipe 0 RX address (auto-ACK needs both), so both
+ * ends must use the same one. Defaults to E7E7E7E7E7. For a peer added
+ * with rc_link_add_peer() this moves its RX pipe; pipes 2-5 can only
+ * change address[0].
+ *
+ * @param link    Pointer to link handle
+ * @param address Address (5 bytes, LSB first)
+ * @return RC_OK, RC_ERROR_BUSY if a transmission is in flight, or
+ *         RC_ERROR_INVALID_PARAM if the address clashes with other pipes
+ */
+rc_status_t rc_link_set_address(rc_link_t *link, const uint8_t *address);
+
+#if RC_ENABLE_IRQ
+/**
+ * @brief Service the nRF24 IRQ line
+ *
+ * Call from the EXTI callback of NRF24_IRQ_PIN. Reads and clears STATUS,
+ * fetches a received payload and completes an in-flight transmission.
+ * If the interrupt arrives while the main loop is using SPI, it is
+ * deferred until that transfer finishes. With a diversity receiver, call
+ * it from that radio's IRQ pin too; every call services both.
+ *
+ * @param link Pointer to link handle
+ */
+void rc_link_irq_handler(rc_link_t *link);
+#endif
+
+#if RC_ENABLE_TDMA
+/**
+ * @brief Advance the TDMA slot schedule
+ *
+ * Call from HAL_TIM_PeriodElapsedCallback() for NRF24_TIM_HANDLE. The timer
+ * must count at 1 MHz; rc_link_init() sets its period to half a frame and
+ * starts it. The aircraft realigns the timer to every frame it receives.
+ *
+ * @param link Pointer to link handle
+ */
+void rc_link_tdma_tick(rc_link_t *link);
+#endif
+
+#if RC_ENABLE_TX_QUEUE
+/*============================================================================*/
+/* TX Queue API                                                               */
+/*============================================================================*/
+
+/**
+ * @brief Set the per-packet completion callback for queued sends
+ *
+ * @param link     Pointer to link handle
+ * @param callback Callback (NULL to disable)
+ * @param ctx      User context passed to the callback
+ */
+void rc_link_set_tx_queue_callback(rc_link_t *link, rc_tx_complete_t callback, void *ctx);
+
+/**
+ * @brief Queue a packet for transmission and return immediately
+ *
+ * Uploads the packet into the radio's TX FIFO behind any already queued.
+ * The outcome is reported through the rc_link_set_tx_queue_callback()
+ * callback. If a packet exhausts its retries it is reported failed and the
+ * packets behind it are re-uploaded.
+ *
+ * @param link        Pointer to link handle
+ * @param type        Packet type (rc_packet_type_t)
+ * @param payload     Payload to send
+ * @param payload_len Payload length (max RC_MAX_PAYLOAD_SIZE)
+ * @param sequence    Output: sequence number assigned (may be NULL)
+ * @return RC_OK if queued, RC_ERROR_BUSY if the FIFO is full or a regular
+ *         send is in flight
+ */
+rc_status_t rc_link_queue_packet(rc_link_t *link, uint8_t type, const void *payload,
+                                 uint8_t payload_len, uint8_t *sequence);
+
+/**
+ * @brief Number of packets that can be queued right now
+ *
+ * @param link Pointer to link handle
+ * @return Free TX FIFO slots (0-3)
+ */
+uint8_t rc_link_tx_queue_free(rc_link_t *link);
+#endif
+
+#if RC_ENABLE_MAILBOX
+/*============================================================================*/
+/* Mailbox API                                                                */
+/*============================================================================*/
+
+/**
+ * @brief Read the newest command without waiting on the radio
+ *
+ * Lock-free: if the IRQ publishes mid-copy the read simply retries, and
+ * the IRQ never waits on the reader. Safe at any control loop rate; the
+ * same command is returned until a newer one arrives. Call
+ * rc_link_update() regularly so link loss is noticed.
+ *
+ * @param link   Pointer to link handle
+ * @param sample Output: command, receive time and failsafe state
+ * @return RC_OK (sample->failsafe set while holding failsafe values)
+ */
+rc_status_t rc_link_get_latest_command(rc_link_t *link, rc_command_sample_t *sample);
+
+#if RC_ENABLE_COMMAND_CALLBACK
+/**
+ * @brief Set the new command callback
+ *
+ * @param link     Pointer to link handle
+ * @param callback Callback (NULL to disable)
+ * @param ctx      User context passed to the callback
+ */
+void rc_link_set_command_callback(rc_link_t *link, rc_command_callback_t callback, void *ctx);
+#endif
+
+/**
+ * @brief Number of telemetry frames that can be queued right now
+ *
+ * In mailbox mode telemetry sends go through a ring drained by the IRQ and
+ * return RC_ERROR_BUSY while it is full. Other packet types are sent
+ * directly, as without the mailbox.
+ *
+ * @param link Pointer to link handle
+ * @return Free ring slots (0-RC_MAILBOX_TX_SIZE)
+ */
+uint8_t rc_link_mailbox_tx_free(rc_link_t *link);
+#endif
+
+#if RC_ENABLE_SPI_DMA
+/*============================================================================*/
+/* Async API                                                                  */
+/*============================================================================*/
+
+/**
+ * @brief Set the async completion callback
+ *
+ * @param link     Pointer to link handle
+ * @param callback Callback (NULL to disable)
+ * @param ctx      User context passed to the callback
+ */
+void rc_link_set_async_callback(rc_link_t *link, rc_async_callback_t callback, void *ctx);
+
+/**
+ * @brief Send RC command without blocking on SPI
+ *
+ * The payload is uploaded by DMA; the callback reports the TX outcome.
+ *
+ * @param link    Pointer to link handle
+ * @param command Command payload (copied before return)
+ * @return RC_OK if started, RC_ERROR_BUSY if SPI or the radio is busy
+ */
+rc_status_t rc_link_send_command_async(rc_link_t *link, const rc_command_payload_t *command);
+
+/**
+ * @brief Send telemetry without blocking on SPI
+ *
+ * @param link      Pointer to link handle
+ * @param telemetry Telemetry payload (copied before return)
+ * @return RC_OK if started, RC_ERROR_BUSY if SPI or the radio is busy
+ */
+rc_status_t rc_link_send_telemetry_async(rc_link_t *link, const rc_telemetry_payload_t *telemetry);
+
+/**
+ * @brief Arm a one-shot command receive
+ *
+ * The next valid command is decoded in interrupt context straight into
+ * the buffer, then the callback fires. Failsafe values are not applied;
+ * use rc_link_is_active() to check for link loss.
+ *
+ * @param link    Pointer to link handle
+ * @param command Output buffer (must stay valid until the callback)
+ * @return RC_OK if armed
+ */
+rc_status_t rc_link_receive_command_async(rc_link_t *link, rc_command_payload_t *command);
+
+/**
+ * @brief Arm a one-shot telemetry receive
+ *
+ * @param link      Pointer to link handle
+ * @param telemetry Output buffer (must stay valid until the callback)
+ * @return RC_OK if armed
+ */
+rc_status_t rc_link_receive_telemetry_async(rc_link_t *link, rc_telemetry_payload_t *telemetry);
+
+/**
+ * @brief SPI DMA complete hook
+ *
+ * Call from HAL_SPI_TxCpltCallback() and HAL_SPI_TxRxCpltCallback().
+ *
+ * @param link Pointer to link handle
+ */
+void rc_link_spi_dma_complete(rc_link_t *link);
+
+/**
+ * @brief SPI DMA error hook
+ *
+ * Call from HAL_SPI_ErrorCallback().
+ *
+ * @param link Pointer to link handle
+ */
+void rc_link_spi_dma_error(rc_link_t *link);
+#endif
+
+#if RC_ENABLE_FHSS
+/*============================================================================*/
+/* Frequency Hopping API                                                      */
+/*============================================================================*/
+
+/**
+ * @brief Set the bind ID and rebuild the hop table
+ *
+ * Clears any blacklist. Both ends must use the same ID.
+ *
+ * @param link    Pointer to link handle
+ * @param bind_id Hop table seed
+ * @return RC_OK on success, RC_ERROR_BUSY if SPI is in use
+ */
+rc_status_t rc_link_fhss_set_bind_id(rc_link_t *link, uint32_t bind_id);
+
+/**
+ * @brief Stage a new channel blacklist (ground)
+ *
+ * Builds the next hop table, which takes over RC_FHSS_MAP_LEAD frames
+ * from now if the aircraft has acknowledged it via rc_link_fhss_send_map()
+ * by then. Otherwise it is dropped and the current table stays.
+ *
+ * @param link      Pointer to link handle
+ * @param blacklist Channel bitmap (RC_FHSS_MAP_BYTES, bit n = RF channel n)
+ * @return RC_OK if staged, RC_ERROR_BUSY if a previous one is still pending
+ */
+rc_status_t rc_link_fhss_set_blacklist(rc_link_t *link, const uint8_t *blacklist);
+
+/**
+ * @brief Send the hop map to the aircraft (ground)
+ *
+ * Sends the staged blacklist if there is one, otherwise the blacklist in
+ * use so a restarted aircraft can pick it up again. Send in place of a
+ * command frame.
+ *
+ * @param link Pointer to link handle
+ * @return RC_OK if sent successfully
+ */
+rc_status_t rc_link_fhss_send_map(rc_link_t *link);
+
+/**
+ * @brief Check for a staged blacklist not yet in use
+ *
+ * @param link Pointer to link handle
+ * @return true while rc_link_fhss_send_map() should keep being called
+ */
+bool rc_link_fhss_map_pending(rc_link_t *link);
+
+/**
+ * @brief Get per-slot hop statistics
+ *
+ * Slots whose channel changes with a new blacklist start from zero.
+ *
+ * @param link  Pointer to link handle
+ * @param stats Output array of RC_FHSS_HOP_COUNT entries
+ * @return RC_OK on success
+ */
+rc_status_t rc_link_fhss_get_stats(rc_link_t *link, rc_fhss_slot_stats_t *stats);
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+/*============================================================================*/
+/* Link Adaptation API                                                        */
+/*============================================================================*/
+
+/**
+ * @brief Get the link profile in use
+ *
+ * @param link Pointer to link handle
+ * @return 0 = 250 kbps, 1 = 1 Mbps, 2 = 2 Mbps (all 0 dBm), 3 = 2 Mbps at -6 dBm
+ */
+uint8_t rc_link_adapt_get_profile(rc_link_t *link);
+
+/**
+ * @brief Check for an announced profile switch not yet made
+ *
+ * @param link Pointer to link handle
+ * @return true between staging a switch and its sequence number
+ */
+bool rc_link_adapt_switch_pending(rc_link_t *link);
+
+/**
+ * @brief Get the share of transmission attempts that were ACKed (ground)
+ *
+ * Counts every auto-retransmit, over the last RC_LQ_WINDOW attempts on
+ * the current profile. This is what drives the switching.
+ *
+ * @param link Pointer to link handle
+ * @return Attempt success 0-100%
+ */
+uint8_t rc_link_adapt_get_quality(rc_link_t *link);
+#endif
+
+#if RC_ENABLE_MULTI_LINK
+/*============================================================================*/
+/* Multi-Link API                                                             */
+/*============================================================================*/
+
+/**
+ * @brief Attach a peer to a host's radio on an RX pipe
+ *
+ * The peer is a link of its own - sequencing, failsafe, link quality and
+ * statistics - that shares the host's radio, bus and IRQ. Do not call
+ * rc_link_init() on it; keep forwarding the IRQ to the host. Every send
+ * and receive call works on it as on any link, received frames being
+ * routed to it by pipe. The host itself is the link on pipe 0, addressed
+ * with rc_link_set_address(). Call rc_link_deinit() on a peer to detach
+ * it; deinitializing the host detaches every peer.
+ *
+ * @param host    Link owning the radio (initialized with rc_link_init())
+ * @param pipe    RX pipe (1-5)
+ * @param peer    Uninitialized link handle, e.g. from rc_link_instance()
+ * @param address Peer address (5 bytes). Pipes 2-5 only own address[0];
+ *                bytes 1-4 must match the other peers on pipes 1-5
+ * @param weight  Uplink share for rc_link_next_peer() (0 = skip)
+ * @return RC_OK, RC_ERROR_BUSY if the bus is in use, or
+ *         RC_ERROR_INVALID_PARAM if the pipe is taken or the address clashes
+ */
+rc_status_t rc_link_add_peer(rc_link_t *host, uint8_t pipe, rc_link_t *peer,
+                             const uint8_t *address, uint8_t weight);
+
+/**
+ * @brief Link heard on a pipe
+ *
+ * @param host Link owning the radio
+ * @param pipe RX pipe (0-5); 0 returns the host itself
+ * @return Link, or NULL if no peer is on that pipe
+ */
+rc_link_t *rc_link_get_peer(rc_link_t *host, uint8_t pipe);
+
+/**
+ * @brief Change a link's uplink share
+ *
+ * @param link   Host or peer
+ * @param weight Relative share (1 for plain round-robin, 0 = skip)
+ * @return RC_OK on success
+ */
+rc_status_t rc_link_set_peer_weight(rc_link_t *link, uint8_t weight);
+
+/**
+ * @brief Pick the link whose turn it is to send
+ *
+ * Smooth weighted round-robin over the host and its peers: a peer with
+ * weight 2 gets every other slot against two peers of weight 1, never
+ * two in a row. Call once per uplink slot and send to the result, e.g.
+ * rc_link_send_command(rc_link_next_peer(host), &cmd).
+ *
+ * @param host Link owning the radio
+ * @return Link to send to, or NULL if every weight is 0
+ */
+rc_link_t *rc_link_next_peer(rc_link_t *host);
+#endif
+
+#if RC_ENABLE_BULK
+/*============================================================================*/
+/* Bulk Stream API                                                            */
+/*============================================================================*/
+
+/**
+ * @brief Start sending a buffer to the other end
+ *
+ * Segments go out from rc_link_update(), only in the air time the RC
+ * frames leave free (see RC_ENABLE_BULK), so call it every loop: the
+ * ground sends up to a window, then polls for the selective ACK; the
+ * aircraft sends what each ground grant allows. The buffer is read in
+ * place until the stream is done, failed or cancelled.
+ *
+ * @param link Pointer to link handle
+ * @param data Bytes to send
+ * @param len  Byte count
+ * @return RC_OK, or RC_ERROR_BUSY while a stream is being sent
+ */
+rc_status_t rc_link_bulk_send(rc_link_t *link, const void *data, uint32_t len);
+
+/**
+ * @brief Accept the next stream from the other end into a buffer
+ *
+ * Segments are stored at their offset as they arrive. A stream larger
+ * than the buffer fails at both ends. On the ground this also starts the
+ * grants that pace the aircraft's sending. A sender still waiting on the
+ * final ACK of the stream before is told it completed.
+ *
+ * @param link   Pointer to link handle
+ * @param buffer Destination
+ * @param size   Buffer size
+ * @return RC_OK, or RC_ERROR_BUSY while a stream is being received
+ */
+rc_status_t rc_link_bulk_receive(rc_link_t *link, void *buffer, uint32_t size);
+
+/**
+ * @brief Drop both streams; nothing more is sent or stored
+ *
+ * @param link Pointer to link handle
+ */
+void rc_link_bulk_cancel(rc_link_t *link);
+
+/**
+ * @brief Progress and throughput of the stream being sent
+ *
+ * @param link   Pointer to link handle
+ * @param status Output: state, bytes acknowledged, bytes/s since the start
+ * @return RC_OK on success
+ */
+rc_status_t rc_link_bulk_get_tx_status(rc_link_t *link, rc_bulk_status_t *status);
+
+/**
+ * @brief Progress and throughput of the stream being received
+ *
+ * @param link   Pointer to link handle
+ * @param status Output: state, bytes reassembled in order, bytes/s
+ * @return RC_OK on success
+ */
+rc_status_t rc_link_bulk_get_rx_status(rc_link_t *link, rc_bulk_status_t *status);
+#endif
+
+#if RC_ENABLE_TRACE
+/*============================================================================*/
+/* Trace API                                                                  */
+/*============================================================================*/
+
+/**
+ * @brief Take the oldest trace records in wire order (see trace.h)
+ *
+ * For any byte link: hand the buffer to HAL_UART_Transmit_DMA() and call
+ * again once it completes. Call from the main loop, not from an IRQ.
+ *
+ * @param link   Pointer to link handle
+ * @param buffer Destination
+ * @param size   Buffer size; only whole RC_TRACE_RECORD_SIZE records are written
+ * @return Bytes written, 0 if there are no new records
+ */
+uint16_t rc_link_trace_read(rc_link_t *link, uint8_t *buffer, uint16_t size);
+
+/**
+ * @brief Write the oldest trace records to an ITM stimulus port (SWO)
+ *
+ * Never waits on an empty port: stops when its FIFO is full, and does
+ * nothing while no debugger has the port enabled. Call from the main
+ * loop, not from an IRQ.
+ *
+ * @param link Pointer to link handle
+ * @param port Stimulus port (0-31)
+ * @param max  Most records to write
+ * @return Records written
+ */
+uint16_t rc_link_trace_drain_itm(rc_link_t *link, uint8_t port, uint16_t max);
+#endif
+
+#if RC_ENABLE_BIND
+/*============================================================================*/
+/* Bind API                                                                   */
+/*============================================================================*/
+
+/**
+ * @brief Move to the bind channel and pair with the other end
+ *
+ * The ground offers info every RC_BIND_INTERVAL_MS from rc_link_update()
+ * until the aircraft answers; the aircraft (info = NULL) takes the first
+ * offer it hears, answers it and moves on once the offers stop, after
+ * RC_BIND_SETTLE_MS. Each end then stores the pair through bind_save and
+ * moves to its address and, with FHSS, its hop table. Commands and
+ * telemetry are refused with RC_ERROR_BUSY meanwhile. After
+ * RC_BIND_TIMEOUT_MS the link goes back to the pair it had.
+ *
+ * @param link Pointer to link handle
+ * @param info Ground: pair to hand out (see rc_bind_derive()); aircraft: NULL
+ * @return RC_OK if started, RC_ERROR_BUSY if SPI is in use
+ */
+rc_status_t rc_link_bind_start(rc_link_t *link, const rc_bind_info_t *info);
+
+/**
+ * @brief Leave the bind channel without pairing
+ *
+ * @param link Pointer to link handle
+ * @return RC_OK, RC_ERROR_BUSY if SPI is in use (try again)
+ */
+rc_status_t rc_link_bind_cancel(rc_link_t *link);
+
+/**
+ * @brief Check whether the link is bound, or binding
+ *
+ * @param link Pointer to link handle
+ * @return Bind state
+ */
+rc_bind_state_t rc_link_get_bind_state(rc_link_t *link);
+
+/**
+ * @brief Get the pair the link is on
+ *
+ * @param link Pointer to link handle
+ * @param info Output
+ * @return RC_OK, RC_ERROR_NO_DATA if the link was never bound
+ */
+rc_status_t rc_link_get_bind_info(rc_link_t *link, rc_bind_info_t *info);
+#endif
+
+#if RC_ENABLE_CLOCK_SYNC
+/*============================================================================*/
+/* Clock Sync API                                                             */
+/*============================================================================*/
+
+/**
+ * @brief Send a clock sync ping to the aircraft (ground)
+ *
+ * Send in place of a command frame. The aircraft's echo comes back with
+ * the next telemetry (or, with ACK telemetry, on the next ACK) and is
+ * taken in by rc_link_update(). A ping that is not ACKed, or whose echo
+ * is lost, gives no sample.
+ *
+ * @param link Pointer to link handle
+ * @return RC_OK if sent, RC_ERROR_BUSY if the radio is in use
+ */
+rc_status_t rc_link_sync_ping(rc_link_t *link);
+
+/**
+ * @brief Check whether a ping is due (ground)
+ *
+ * @param link Pointer to link handle
+ * @return true if RC_SYNC_INTERVAL_MS has passed since the last ping sent
+ */
+bool rc_link_sync_pending(rc_link_t *link);
+
+/**
+ * @brief Get the round trip and clock offset estimate (ground)
+ *
+ * aircraft tick_us = ground tick_us + offset, as of the sample with the
+ * shortest round trip among the last RC_SYNC_WINDOW.
+ *
+ * @param link      Pointer to link handle
+ * @param rtt_us    Round trip of that sample (may be NULL)
+ * @param offset_us Offset (may be NULL)
+ * @return RC_OK, RC_ERROR_NO_DATA before the first sample
+ */
+rc_status_t rc_link_get_clock_sync(rc_link_t *link, uint32_t *rtt_us, int32_t *offset_us);
+#endif
+
 /*============================================================================*/
 /* Statistics API                                                             */
 /*============================================================================*/
@@ -202,6 +1158,36 @@ rc_status_t rc_link_get_stats(rc_link_t *link, rc_stats_t *stats);
 void rc_link_reset_stats(rc_link_t *link);
 #endif
 
+#if RC_ENABLE_LATENCY_STATS
+/**
+ * @brief Get per-stage latency histograms
+ *
+ * @param link  Pointer to link handle
+ * @param stats Output buffer
+ * @return RC_OK on success
+ */
+rc_status_t rc_link_get_latency_stats(rc_link_t *link, rc_latency_stats_t *stats);
+
+/**
+ * @brief Reset latency histograms
+ *
+ * @param link Pointer to link handle
+ */
+void rc_link_reset_latency_stats(rc_link_t *link);
+
+/**
+ * @brief Estimate a percentile from a histogram
+ *
+ * Resolution is one bucket: returns the upper edge of the bucket holding
+ * the percentile, capped at the largest sample seen.
+ *
+ * @param hist    Stage histogram
+ * @param percent Percentile (1-100, e.g. 99)
+ * @return Latency in µs (0 if no samples)
+ */
+uint32_t rc_latency_percentile_us(const rc_latency_hist_t *hist, uint8_t percent);
+#endif
+
 /*============================================================================*/
 /* Logging                                                                    */
 /*============================================================================*/
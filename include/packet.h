@@ -5,10 +5,15 @@
  * Packet structure:
  * ┌─────────────┬──────────────────────┬────────┐
  * │   Header    │       Payload        │  CRC   │
- * │   5 bytes   │     0-26 bytes       │ 1 byte │
+ * │   5 bytes   │     0-26 bytes       │ 1-2 B  │
  * └─────────────┴──────────────────────┴────────┘
  *      ↓                  ↓                ↓
  *   Metadata         Actual data       Validation
+ *
+ * Fixed-length frames always occupy 32 bytes with the CRC in the last byte,
+ * or followed by RC_FEC_PARITY Reed-Solomon bytes with RC_ENABLE_FEC. With
+ * dynamic payloads the CRC follows the payload directly and the frame is
+ * only RC_PACKET_WIRE_LEN(payload_len) bytes long.
  */
 
 #ifndef PACKET_H
@@ -32,9 +37,39 @@ extern "C" {
         RC_PKT_COMMAND   = 0x01,    /* Ground → Aircraft: RC commands */
         RC_PKT_TELEMETRY = 0x02,    /* Aircraft → Ground: Telemetry */
         RC_PKT_ACK       = 0x03,    /* Acknowledgment (future use) */
-        RC_PKT_HEARTBEAT = 0x04     /* Keep-alive (future use) */
+        RC_PKT_HEARTBEAT = 0x04,    /* Clock sync ping / echo (clock_sync.h) */
+        RC_PKT_CHANNELS  = 0x05,    /* Ground → Aircraft: bit-packed RC channels */
+        RC_PKT_HOP_MAP   = 0x06,    /* Ground → Aircraft: FHSS channel blacklist */
+        RC_PKT_TELEMETRY_MUX = 0x07,/* Aircraft → Ground: multiplexed telemetry records */
+        RC_PKT_BULK      = 0x08,    /* Either way: bulk stream segment or ACK (bulk.h) */
+        RC_PKT_BIND      = 0x09     /* Either way, bind channel only: bind pair (bind.h) */
     } rc_packet_type_t;
 
+    /** Application payloads (payload_schema.h), RC_PKT_USER_COUNT each way */
+    #define RC_PKT_USER_UP              0x10    /* Ground → aircraft */
+    #define RC_PKT_USER_DOWN            0x18    /* Aircraft → ground */
+    #define RC_PKT_USER_COUNT           8
+
+    #define RC_PKT_IS_USER_UP(type)     ((type) >= RC_PKT_USER_UP && \
+                                         (type) < RC_PKT_USER_UP + RC_PKT_USER_COUNT)
+    #define RC_PKT_IS_USER_DOWN(type)   ((type) >= RC_PKT_USER_DOWN && \
+                                         (type) < RC_PKT_USER_DOWN + RC_PKT_USER_COUNT)
+
+    /*============================================================================*/
+    /* Header Flags                                                               */
+    /*============================================================================*/
+
+    /** Hop table generation the sender is using (FHSS) */
+    #define RC_FLAG_HOP_GEN             0x01
+
+    /** Link profile the sender is on, or switching to (RC_ENABLE_LINK_ADAPT) */
+    #define RC_FLAG_PROFILE_MASK        0x06
+    #define RC_FLAG_PROFILE_SHIFT       1
+
+    /** Packets left before the sender switches profile (0 = none pending) */
+    #define RC_FLAG_SWITCH_MASK         0x38
+    #define RC_FLAG_SWITCH_SHIFT        3
+
     /*============================================================================*/
     /* Packet Structure                                                           */
     /*============================================================================*/
@@ -46,7 +81,7 @@ extern "C" {
         uint8_t version;            /* Protocol version */
         uint8_t type;               /* Packet type */
         uint8_t sequence;           /* Sequence number (wraps at 255) */
-        uint8_t flags;              /* Status flags (reserved) */
+        uint8_t flags;              /* RC_FLAG_* bits */
         uint8_t payload_len;        /* Payload length in bytes */
     } rc_packet_header_t;
 
@@ -55,10 +90,19 @@ extern "C" {
      */
     typedef struct __attribute__((packed)) {
         rc_packet_header_t header;              /* 5 bytes */
-        uint8_t payload[RC_MAX_PAYLOAD_SIZE];   /* 26 bytes */
-        uint8_t crc8;                           /* 1 byte */
+        uint8_t payload[RC_MAX_PAYLOAD_SIZE];   /* 26 bytes (25 with CRC-16) */
+        uint8_t crc[RC_CRC_SIZE];               /* Little-endian */
+#if RC_FEC_SIZE > 0
+        uint8_t fec[RC_FEC_SIZE];               /* Reed-Solomon parity over bytes 0.. */
+#endif
     } rc_packet_t;
 
+    /** Header + CRC bytes framing every payload */
+    #define RC_PACKET_OVERHEAD          (sizeof(rc_packet_header_t) + RC_CRC_SIZE)
+
+    /** On-air length of a dynamic-length frame */
+    #define RC_PACKET_WIRE_LEN(payload_len) (RC_PACKET_OVERHEAD + (payload_len))
+
     /* Compile-time validation */
     _Static_assert(sizeof(rc_packet_t) == 32, "Packet must be exactly 32 bytes");
 
@@ -0,0 +1,244 @@
+/**
+* @file payload_schema.h
+ * @brief Application payloads generated from one X-macro definition
+ *
+ * A payload is a list of fields, each a C type and a width in bits; the
+ * schema lists the payloads with their packet types:
+ *
+ *   #define GIMBAL_FIELDS(X) \
+ *       X(uint16_t, pan,  12) \
+ *       X(uint16_t, tilt, 12) \
+ *       X(int8_t,   trim,  5)
+ *
+ *   #define APP_PAYLOADS(P) \
+ *       P(gimbal, RC_PKT_USER_UP + 0,   GIMBAL_FIELDS) \
+ *       P(esc,    RC_PKT_USER_DOWN + 0, ESC_FIELDS)
+ *
+ *   RC_SCHEMA_DEFINE(APP_PAYLOADS)
+ *   RC_SCHEMA_DISPATCH(app, APP_PAYLOADS)
+ *
+ * For each payload, RC_SCHEMA_DEFINE emits:
+ *   - gimbal_t              plain struct the application fills in
+ *   - gimbal_type           packet type, checked to be in a user range
+ *   - gimbal_bits / _size   wire width, checked against RC_MAX_PAYLOAD_SIZE
+ *   - gimbal_encode/decode  bit-packed codec, LSB first, fully unrolled
+ *   - gimbal_send/receive   zero-copy send and typed receive on a link
+ *
+ * RC_SCHEMA_DISPATCH emits app_handlers_t, one callback per payload, and
+ * app_dispatch(), an rc_rx_handler_t for rc_link_process_rx() that decodes
+ * onto the stack and calls the payload's callback. Two payloads sharing a
+ * type fail to compile there.
+ *
+ * Fields are integer types or bool, 1 to 32 bits and no wider than their
+ * type. Values are masked to their width, not clamped; signed fields are
+ * two's complement on the wire and sign-extended on decode. The wire
+ * format is the field order, so append fields and keep the widths to stay
+ * compatible; a receiver rejects a length other than its own.
+ *
+ * Uplink payloads take RC_PKT_USER_UP.., downlink RC_PKT_USER_DOWN..,
+ * which decides the transport like for the core types (ACK payloads with
+ * RC_ENABLE_ACK_TELEMETRY, the aircraft slot with TDMA).
+ */
+
+#ifndef PAYLOAD_SCHEMA_H
+#define PAYLOAD_SCHEMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf_rc_driver.h"
+#include "packet.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*========================================================================*/
+    /* Field Helpers                                                          */
+    /*========================================================================*/
+
+    /** Low bits set */
+    #define RC_SCHEMA_MASK(bits)        ((uint32_t)(0xFFFFFFFFUL >> (32 - (bits))))
+
+    /** Sign bit of a field */
+    #define RC_SCHEMA_SIGN(bits)        ((uint32_t)1 << ((bits) - 1))
+
+    /** Written as > so unsigned types do not trip -Wtype-limits */
+    #define RC_SCHEMA_UNSIGNED(type)    ((type)((type)0 - 1) > (type)0)
+
+    #define RC_SCHEMA_FIELD_DECL(type, field, bits)     type field;
+
+    #define RC_SCHEMA_FIELD_BITS(type, field, bits)     + (bits)
+
+    #define RC_SCHEMA_FIELD_CHECK(type, field, bits) \
+        _Static_assert((type)1 / 2 == 0, "schema field " #field " is not an integer"); \
+        _Static_assert((bits) >= 1 && (bits) <= 32 && (bits) <= 8 * sizeof(type), \
+                       "schema field " #field " width out of range");
+
+    /* acc holds fewer than 8 bits between fields, so 64 bits never overflow */
+    #define RC_SCHEMA_FIELD_ENCODE(type, field, bits) \
+        acc |= (uint64_t)((uint32_t)in->field & RC_SCHEMA_MASK(bits)) << fill; \
+        fill += (bits); \
+        while (fill >= 8) { \
+            *out++ = (uint8_t)acc; \
+            acc >>= 8; \
+            fill -= 8; \
+        }
+
+    #define RC_SCHEMA_FIELD_DECODE(type, field, bits) \
+        while (fill < (bits)) { \
+            acc |= (uint64_t)*in++ << fill; \
+            fill += 8; \
+        } \
+        value = (uint32_t)acc & RC_SCHEMA_MASK(bits); \
+        acc >>= (bits); \
+        fill -= (bits); \
+        out->field = RC_SCHEMA_UNSIGNED(type) ? (type)value : \
+            (type)((int64_t)(value ^ RC_SCHEMA_SIGN(bits)) - (int64_t)RC_SCHEMA_SIGN(bits));
+
+    /*========================================================================*/
+    /* Payloads                                                               */
+    /*========================================================================*/
+
+    #define RC_SCHEMA_PAYLOAD(name, id, FIELDS) \
+        typedef struct { \
+            FIELDS(RC_SCHEMA_FIELD_DECL) \
+        } name##_t; \
+        \
+        enum { \
+            name##_type = (id), \
+            name##_bits = 0 FIELDS(RC_SCHEMA_FIELD_BITS), \
+            name##_size = (name##_bits + 7) / 8 \
+        }; \
+        \
+        FIELDS(RC_SCHEMA_FIELD_CHECK) \
+        _Static_assert(RC_PKT_IS_USER_UP(id) || RC_PKT_IS_USER_DOWN(id), \
+                       #name " type is outside RC_PKT_USER_UP/DOWN"); \
+        _Static_assert(name##_size <= RC_MAX_PAYLOAD_SIZE, #name " exceeds max payload size"); \
+        \
+        /** Pack into name##_size bytes */ \
+        static inline void name##_encode(const name##_t *in, uint8_t *out) \
+        { \
+            uint64_t acc = 0; \
+            uint8_t fill = 0; \
+            FIELDS(RC_SCHEMA_FIELD_ENCODE) \
+            if (fill > 0) { \
+                *out = (uint8_t)acc; \
+            } \
+        } \
+        \
+        /** Unpack name##_size bytes */ \
+        static inline void name##_decode(const uint8_t *in, name##_t *out) \
+        { \
+            uint64_t acc = 0; \
+            uint8_t fill = 0; \
+            uint32_t value; \
+            FIELDS(RC_SCHEMA_FIELD_DECODE) \
+            (void)acc; \
+            (void)fill; \
+        } \
+        \
+        /** Encode straight into the TX frame; RC_ERROR_BUSY like the other sends */ \
+        static inline rc_status_t name##_send(rc_link_t *link, const name##_t *in) \
+        { \
+            void *payload; \
+            \
+            if (!in) { \
+                return RC_ERROR_INVALID_PARAM; \
+            } \
+            \
+            rc_status_t status = rc_link_tx_acquire(link, name##_type, name##_size, &payload); \
+            if (status != RC_OK) { \
+                return status; \
+            } \
+            \
+            name##_encode(in, (uint8_t *)payload); \
+            return rc_link_tx_commit(link); \
+        } \
+        \
+        /** Decode the next one; RC_ERROR_VERSION_MISMATCH (and dropped) if the length differs */ \
+        static inline rc_status_t name##_receive(rc_link_t *link, name##_t *out) \
+        { \
+            const void *payload; \
+            uint8_t payload_len; \
+            \
+            if (!out) { \
+                return RC_ERROR_INVALID_PARAM; \
+            } \
+            \
+            rc_status_t status = rc_link_rx_acquire(link, name##_type, &payload, &payload_len); \
+            if (status != RC_OK) { \
+                return status; \
+            } \
+            \
+            if (payload_len == name##_size) { \
+                name##_decode((const uint8_t *)payload, out); \
+            } else { \
+                status = RC_ERROR_VERSION_MISMATCH; \
+            } \
+            rc_link_rx_release(link); \
+            \
+            return status; \
+        }
+
+    /**
+     * @brief Emit structs, type IDs, sizes and codecs for every payload
+     *
+     * @param LIST Schema macro taking P(name, id, FIELDS)
+     */
+    #define RC_SCHEMA_DEFINE(LIST)      LIST(RC_SCHEMA_PAYLOAD)
+
+    /*========================================================================*/
+    /* RX Dispatch                                                            */
+    /*========================================================================*/
+
+    #define RC_SCHEMA_HANDLER(name, id, FIELDS) \
+        void (*name)(rc_link_t *link, const name##_t *msg, void *ctx);
+
+    #define RC_SCHEMA_CASE(name, id, FIELDS) \
+        case name##_type: \
+            if (payload_len == name##_size && handlers->name) { \
+                name##_t msg; \
+                name##_decode((const uint8_t *)payload, &msg); \
+                handlers->name(link, &msg, handlers->ctx); \
+                return; \
+            } \
+            break;
+
+    /**
+     * @brief Emit prefix##_handlers_t and prefix##_dispatch() for a schema
+     *
+     * Pass a prefix##_handlers_t as the context of rc_link_process_rx().
+     * Handlers left NULL, other packet types (core ones included) and
+     * payloads of the wrong length go to fallback, if set, undecoded.
+     *
+     * @param prefix Name of the table and dispatcher
+     * @param LIST   Schema given to RC_SCHEMA_DEFINE()
+     */
+    #define RC_SCHEMA_DISPATCH(prefix, LIST) \
+        typedef struct { \
+            LIST(RC_SCHEMA_HANDLER) \
+            rc_rx_handler_t fallback;   /* Anything not decoded above */ \
+            void *ctx;                  /* Passed to every handler */ \
+        } prefix##_handlers_t; \
+        \
+        static inline void prefix##_dispatch(rc_link_t *link, uint8_t type, const void *payload, \
+                                             uint8_t payload_len, void *ctx) \
+        { \
+            const prefix##_handlers_t *handlers = (const prefix##_handlers_t *)ctx; \
+            \
+            switch (type) { \
+                LIST(RC_SCHEMA_CASE) \
+                default: \
+                    break; \
+            } \
+            \
+            if (handlers->fallback) { \
+                handlers->fallback(link, type, payload, payload_len, handlers->ctx); \
+            } \
+        }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PAYLOAD_SCHEMA_H */
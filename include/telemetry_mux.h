@@ -0,0 +1,203 @@
+/**
+* @file telemetry_mux.h
+ * @brief Priority-scheduled multiplexed telemetry
+ *
+ * Instead of one fixed rc_telemetry_payload_t, the aircraft registers
+ * typed items, each with a target rate and a priority. Every downlink
+ * frame (RC_PKT_TELEMETRY_MUX) carries as many due items as fit, as TLV
+ * records:
+ *
+ *   ┌──────┬──────┬────────────┐
+ *   │  id  │ len  │ value      │  ... repeated to the end of the payload
+ *   │ 1 B  │ 1 B  │ len bytes  │
+ *   └──────┴──────┴────────────┘
+ *
+ * Values are little-endian. The ground decodes the records into a cache of
+ * the latest value of each item and when it arrived, so fast items (current
+ * at 50 Hz) and slow ones (GPS satellites at 1 Hz) share one link budget.
+ */
+
+#ifndef TELEMETRY_MUX_H
+#define TELEMETRY_MUX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /** Bytes a record adds in front of its value */
+    #define RC_TLM_RECORD_HEADER        2
+
+    /**
+     * @brief Well-known item IDs
+     *
+     * Sizes are what the ground expects; IDs from RC_TLM_USER up are free
+     * for the application.
+     */
+    typedef enum {
+        RC_TLM_BATTERY_MV  = 0x01,  /* uint16_t, battery (mV) */
+        RC_TLM_CURRENT_MA  = 0x02,  /* uint16_t, current (mA) */
+        RC_TLM_GPS_POS     = 0x03,  /* int32_t lat, lon (* 1e7) */
+        RC_TLM_GPS_ALT     = 0x04,  /* int16_t, altitude (m) */
+        RC_TLM_GROUNDSPEED = 0x05,  /* uint16_t, speed (cm/s) */
+        RC_TLM_GPS_SATS    = 0x06,  /* uint8_t, satellite count */
+        RC_TLM_HEADING     = 0x07,  /* int16_t, heading (deg*10) */
+        RC_TLM_FLIGHT_MODE = 0x08,  /* uint8_t, flight mode */
+        RC_TLM_RSSI        = 0x09,  /* uint8_t, 0-100 (set by RC_ENABLE_RSSI) */
+        RC_TLM_ERROR_FLAGS = 0x0A,  /* uint8_t, error bits */
+        RC_TLM_ATTITUDE    = 0x0B,  /* int16_t roll, pitch, yaw (deg*10) */
+        RC_TLM_VARIO       = 0x0C,  /* int16_t, climb rate (cm/s) */
+        RC_TLM_USER        = 0x80   /* First application-defined ID */
+    } rc_tlm_id_t;
+
+    /*============================================================================*/
+    /* Aircraft Side                                                              */
+    /*============================================================================*/
+
+    /**
+     * @brief One registered item
+     */
+    typedef struct {
+        uint8_t id;                 /* rc_tlm_id_t or application ID */
+        uint8_t len;                /* Value size in bytes */
+        uint8_t priority;           /* Higher goes first when items compete */
+        bool valid;                 /* A value has been set */
+        bool sent;                  /* Sent at least once, due_ms is set */
+        uint16_t period_ms;         /* 1000 / target rate */
+        uint32_t due_ms;            /* Tick the next send is due at */
+        uint8_t data[RC_TLM_MAX_ITEM_SIZE];
+    } rc_tlm_item_t;
+
+    /**
+     * @brief Item registry and scheduler
+     */
+    typedef struct {
+        rc_tlm_item_t items[RC_TLM_MAX_ITEMS];
+        uint8_t count;
+        uint32_t built;             /* Items in the last built frame (bit per index) */
+    } rc_tlm_mux_t;
+
+    /**
+     * @brief Clear the registry
+     *
+     * @param mux Scheduler
+     */
+    void rc_tlm_mux_init(rc_tlm_mux_t *mux);
+
+    /**
+     * @brief Register an item
+     *
+     * The item is not sent until rc_tlm_set() gives it a value.
+     *
+     * @param mux      Scheduler
+     * @param id       Item ID, unique within the registry
+     * @param len      Value size, 1-RC_TLM_MAX_ITEM_SIZE bytes
+     * @param rate_hz  Target update rate, 1-1000 Hz
+     * @param priority Higher wins when more items are due than fit a frame
+     * @return true if registered, false if full, duplicate or out of range
+     */
+    bool rc_tlm_register(rc_tlm_mux_t *mux, uint8_t id, uint8_t len,
+                         uint16_t rate_hz, uint8_t priority);
+
+    /**
+     * @brief Update an item's value
+     *
+     * The value is held and resent at the item's rate until the next update.
+     *
+     * @param mux  Scheduler
+     * @param id   Registered item ID
+     * @param data Value, the registered length
+     * @return true if updated, false if the ID is not registered
+     */
+    bool rc_tlm_set(rc_tlm_mux_t *mux, uint8_t id, const void *data);
+
+    /**
+     * @brief Pack the due items into one frame payload
+     *
+     * Due items go in by priority, then by how late they are; an item that
+     * does not fit leaves room for smaller ones behind it. Nothing is marked
+     * sent until rc_tlm_mux_commit(), so a frame the link could not take is
+     * simply built again.
+     *
+     * @param mux     Scheduler
+     * @param now_ms  Current tick
+     * @param out     Payload buffer
+     * @param max_len Buffer size (RC_MAX_PAYLOAD_SIZE for one frame)
+     * @return Bytes written, 0 if nothing is due
+     */
+    uint8_t rc_tlm_mux_build(rc_tlm_mux_t *mux, uint32_t now_ms, uint8_t *out, uint8_t max_len);
+
+    /**
+     * @brief Mark the items of the last built frame as sent
+     *
+     * Each moves on by its period; one that fell more than a period behind
+     * restarts from now rather than bursting to catch up.
+     *
+     * @param mux    Scheduler
+     * @param now_ms Current tick
+     */
+    void rc_tlm_mux_commit(rc_tlm_mux_t *mux, uint32_t now_ms);
+
+    /*============================================================================*/
+    /* Ground Side                                                                */
+    /*============================================================================*/
+
+    /**
+     * @brief Latest value of one item
+     */
+    typedef struct {
+        uint8_t id;
+        uint8_t len;
+        uint32_t time_ms;           /* Tick the value arrived at */
+        uint32_t updates;           /* Records received */
+        uint8_t data[RC_TLM_MAX_ITEM_SIZE];
+    } rc_tlm_value_t;
+
+    /**
+     * @brief Cache of received items, filled in arrival order
+     */
+    typedef struct {
+        rc_tlm_value_t values[RC_TLM_MAX_ITEMS];
+        uint8_t count;
+        uint32_t dropped;           /* Records with no free slot or too long */
+        uint32_t malformed;         /* Payloads that ended mid-record */
+    } rc_tlm_cache_t;
+
+    /**
+     * @brief Clear the cache
+     *
+     * @param cache Cache
+     */
+    void rc_tlm_cache_init(rc_tlm_cache_t *cache);
+
+    /**
+     * @brief Decode one RC_PKT_TELEMETRY_MUX payload into the cache
+     *
+     * Records before a malformed one are kept.
+     *
+     * @param cache   Cache
+     * @param payload Frame payload
+     * @param len     Payload length
+     * @param now_ms  Current tick, stored as the values' arrival time
+     * @return Records decoded
+     */
+    uint8_t rc_tlm_cache_decode(rc_tlm_cache_t *cache, const uint8_t *payload,
+                                uint8_t len, uint32_t now_ms);
+
+    /**
+     * @brief Look up an item
+     *
+     * @param cache Cache
+     * @param id    Item ID
+     * @return Latest value, NULL if never received
+     */
+    const rc_tlm_value_t *rc_tlm_cache_get(const rc_tlm_cache_t *cache, uint8_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_MUX_H */
@@ -0,0 +1,153 @@
+/**
+* @file trace.h
+ * @brief Binary packet trace records and their RAM ring
+ *
+ * Each link event is one 8-byte record, two little-endian words:
+ *
+ *   time ┌──────────────────────────────────────────┐
+ *        │ DWT cycle count (wraps, ~60 s at 72 MHz) │
+ *        └──────────────────────────────────────────┘
+ *   info ┌───────┬────────┬──────┬───────┬──────────┬─────────┐
+ *        │ event │ status │ type │ count │ sequence │ channel │
+ *        │ 4 b   │ 4 b    │ 4 b  │ 4 b   │ 8 b      │ 8 b     │
+ *        └───────┴────────┴──────┴───────┴──────────┴─────────┘
+ *
+ * status is an rc_status_t, type the packet type (RC_TRACE_TYPE_USER
+ * for any schema payload) and channel the RF channel at the time. count depends on the event (rc_trace_event_t).
+ * The ring is filled from the link's hot paths, main loop and IRQ alike,
+ * and read in order from one context (rc_trace_read()). The event field
+ * is never 0, so a decoder can resynchronise on a byte stream.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /** Bytes per record on the wire */
+    #define RC_TRACE_RECORD_SIZE        8
+
+    /** type of every payload_schema.h type, which do not fit 4 bits */
+    #define RC_TRACE_TYPE_USER          0x0F
+
+    /** count when the build does not know it (retries without RSSI / LINK_ADAPT) */
+    #define RC_TRACE_COUNT_UNKNOWN      0x0F
+
+    /**
+     * @brief What a record is about
+     */
+    typedef enum {
+        RC_TRACE_NONE = 0,          /* Never recorded */
+        RC_TRACE_TX,                /* Frame sent: RC_OK or RC_ERROR_TIMEOUT, count = retransmits */
+        RC_TRACE_RX,                /* Frame read: count = frames missed before it (to 15) */
+        RC_TRACE_RX_DROP,           /* Frame rejected: CRC_FAIL or VERSION_MISMATCH, as received */
+        RC_TRACE_MODE,              /* Link profile switched: count = new profile */
+        RC_TRACE_FAILSAFE,          /* RC_ERROR_TIMEOUT entering failsafe, RC_OK leaving it */
+        RC_TRACE_EVENT_COUNT
+    } rc_trace_event_t;
+
+    /** Fields of rc_trace_record_t.info */
+    #define RC_TRACE_EVENT(info)        ((uint8_t)((info) & 0x0F))
+    #define RC_TRACE_STATUS(info)       ((uint8_t)(((info) >> 4) & 0x0F))
+    #define RC_TRACE_TYPE(info)         ((uint8_t)(((info) >> 8) & 0x0F))
+    #define RC_TRACE_COUNT(info)        ((uint8_t)(((info) >> 12) & 0x0F))
+    #define RC_TRACE_SEQUENCE(info)     ((uint8_t)((info) >> 16))
+    #define RC_TRACE_CHANNEL(info)      ((uint8_t)((info) >> 24))
+
+    /**
+     * @brief One trace record
+     */
+    typedef struct {
+        uint32_t time;              /* DWT cycle count */
+        uint32_t info;              /* See RC_TRACE_EVENT() ... RC_TRACE_CHANNEL() */
+    } rc_trace_record_t;
+
+    /**
+     * @brief Ring of the newest RC_TRACE_SIZE records
+     */
+    typedef struct {
+        rc_trace_record_t records[RC_TRACE_SIZE];
+        atomic_uint head;           /* Free-running: records reserved */
+        uint32_t tail;              /* Free-running: records read */
+        uint32_t lost;              /* Overwritten before they were read */
+    } rc_trace_t;
+
+    /**
+     * @brief Append a record, overwriting the oldest if the ring is full
+     *
+     * Safe from the main loop and IRQs at once: each writer reserves its
+     * own slot.
+     *
+     * @param trace    Ring
+     * @param time     DWT cycle count
+     * @param event    rc_trace_event_t
+     * @param status   rc_status_t
+     * @param type     Packet type
+     * @param count    Event detail, 0-15
+     * @param sequence Packet sequence number
+     * @param channel  RF channel
+     */
+    static inline void rc_trace_record(rc_trace_t *trace, uint32_t time, uint8_t event,
+                                       uint8_t status, uint8_t type, uint8_t count,
+                                       uint8_t sequence, uint8_t channel)
+    {
+        unsigned slot = atomic_fetch_add_explicit(&trace->head, 1U, memory_order_relaxed);
+        rc_trace_record_t *record = &trace->records[slot & (RC_TRACE_SIZE - 1)];
+
+        record->time = time;
+        record->info = (uint32_t)(event & 0x0F) | (uint32_t)(status & 0x0F) << 4 |
+                       (uint32_t)(type < 0x10 ? type : RC_TRACE_TYPE_USER) << 8 |
+                       (uint32_t)(count & 0x0F) << 12 |
+                       (uint32_t)sequence << 16 | (uint32_t)channel << 24;
+    }
+
+    /**
+     * @brief Take the oldest records
+     *
+     * From one context only, and not from an IRQ that can preempt one
+     * recording: a record being written would be read half done.
+     *
+     * @param trace Ring
+     * @param out   Records, oldest first
+     * @param max   Room in out
+     * @return Records taken
+     */
+    uint16_t rc_trace_read(rc_trace_t *trace, rc_trace_record_t *out, uint16_t max);
+
+    /**
+     * @brief Write a record in wire order
+     *
+     * @param record Record
+     * @param out    RC_TRACE_RECORD_SIZE bytes
+     */
+    void rc_trace_pack(const rc_trace_record_t *record, uint8_t *out);
+
+    /**
+     * @brief Read a record in wire order
+     *
+     * @param in     RC_TRACE_RECORD_SIZE bytes
+     * @param record Filled in
+     * @return true if it can be a record (known event)
+     */
+    bool rc_trace_unpack(const uint8_t *in, rc_trace_record_t *record);
+
+    /**
+     * @brief Short name of an event, for decoders
+     *
+     * @param event rc_trace_event_t
+     * @return Name, "?" if unknown
+     */
+    const char *rc_trace_event_name(uint8_t event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_H */
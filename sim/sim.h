@@ -0,0 +1,188 @@
+/**
+ * @file sim.h
+ * @brief Host simulation of the nRF24 radios and the air between them
+ *
+ * The driver is compiled unchanged against sim/stm32f1xx_hal_conf.h. Its
+ * HAL_SPI / HAL_GPIO calls land on the currently selected simulated radio;
+ * the DWT cycle counter and HAL_GetTick() follow a virtual clock that only
+ * moves when the firmware spends time (SPI bytes, delays, sim_advance_us()).
+ *
+ * Radios wired through the nrf24_config.h defaults share one hspi1 / GPIO
+ * set, exactly like one radio per firmware image, so the caller selects a
+ * radio with sim_select() before calling into the link that owns it. IRQ
+ * and SPI DMA callbacks are raised with their radio selected. A radio bound
+ * to sim_spi_bus() / sim_gpio_port() (an nrf24_hw_t) is always reached
+ * through those, whatever is selected, so one link can drive two radios.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================*/
+/* Constants                                                                  */
+/*============================================================================*/
+
+/** Radios that can share the simulated air */
+#define SIM_MAX_RADIOS          4
+
+/** Simulated core clock (DWT cycles per second) */
+#define SIM_CORE_CLOCK_HZ       72000000UL
+
+/** SPI clock: one byte costs 8 bits at this rate */
+#define SIM_SPI_CLOCK_HZ        8000000UL
+
+/*============================================================================*/
+/* Types                                                                      */
+/*============================================================================*/
+
+/**
+ * @brief Channel model between two radios
+ *
+ * Two-state Gilbert-Elliott loss (good/bad), applied per frame and per ACK
+ * in both directions. On top of that, frames fade out as the received
+ * power nears the sensitivity of the sender's data rate (datasheet: -94,
+ * -85 and -82 dBm at 250 kbps, 1 and 2 Mbps). Every radio listening on a
+ * frame's address draws its own loss; the good/bad state is shared.
+ */
+typedef struct {
+    double loss;            /* Frame loss probability in the good state */
+    double burst_enter;     /* Per-frame probability good → bad */
+    double burst_exit;      /* Per-frame probability bad → good */
+    double burst_loss;      /* Frame loss probability in the bad state */
+    double corrupt;         /* Probability a delivered frame has a bit flip the
+                             * radio's own CRC missed (exercises the link CRC) */
+    double errors;          /* Probability a frame arrives with damaged bytes; a
+                             * receiver with its CRC on drops it, one without
+                             * takes it as is (exercises RC_ENABLE_FEC) */
+    uint8_t error_bytes;    /* Bytes damaged per such frame (0 counts as 1) */
+    uint32_t latency_us;    /* Extra one-way delay per frame */
+    int8_t signal_dbm;      /* Received power at 0 dBm TX (6 dB less per lower
+                             * power step); RPD reads 1 at >= -64 dBm */
+} sim_channel_t;
+
+/**
+ * @brief Channel counters since the last sim_reset()
+ */
+typedef struct {
+    uint32_t frames;        /* Frames put on air (data and ACK) */
+    uint32_t lost;          /* Dropped by the loss model */
+    uint32_t corrupted;     /* Delivered with an injected bit flip */
+    uint32_t errored;       /* Arrived with damaged bytes (errors model) */
+    uint32_t retransmits;   /* Auto-retransmit attempts */
+    uint32_t max_rt;        /* MAX_RT events */
+} sim_channel_stats_t;
+
+/** IRQ line handler (falling edge), called with its radio selected */
+typedef void (*sim_irq_handler_t)(void *ctx);
+
+/*============================================================================*/
+/* Simulation Control                                                         */
+/*============================================================================*/
+
+/**
+ * @brief Reset the clock, every radio and the channel
+ *
+ * @param radios Number of radios to power (1-SIM_MAX_RADIOS)
+ * @param seed   Channel model random seed
+ */
+void sim_reset(uint8_t radios, uint32_t seed);
+
+/**
+ * @brief Select the radio that HAL SPI/GPIO calls talk to
+ *
+ * @param radio Radio index
+ */
+void sim_select(uint8_t radio);
+
+/**
+ * @brief Currently selected radio
+ *
+ * @return Radio index
+ */
+uint8_t sim_selected(void);
+
+/**
+ * @brief Current virtual time
+ *
+ * @return Nanoseconds since sim_reset()
+ */
+uint64_t sim_time_ns(void);
+
+/**
+ * @brief Current virtual time in microseconds
+ *
+ * @return Microseconds since sim_reset()
+ */
+uint64_t sim_time_us(void);
+
+/**
+ * @brief Let virtual time pass, running radio events and IRQs on the way
+ *
+ * @param us Microseconds to advance
+ */
+void sim_advance_us(uint32_t us);
+
+/**
+ * @brief Advance virtual time in nanoseconds
+ *
+ * @param ns Nanoseconds to advance
+ */
+void sim_advance_ns(uint64_t ns);
+
+/*============================================================================*/
+/* Radio / Channel                                                            */
+/*============================================================================*/
+
+/**
+ * @brief Route a radio's IRQ pin to a handler
+ *
+ * @param radio   Radio index
+ * @param handler Handler (NULL to disconnect)
+ * @param ctx     Passed to the handler
+ */
+void sim_radio_set_irq(uint8_t radio, sim_irq_handler_t handler, void *ctx);
+
+/**
+ * @brief Replace the channel model
+ *
+ * @param channel New model (applies from the next frame)
+ */
+void sim_channel_set(const sim_channel_t *channel);
+
+/**
+ * @brief Read the channel counters
+ *
+ * @param stats Output buffer
+ */
+void sim_channel_get_stats(sim_channel_stats_t *stats);
+
+/**
+ * @brief Default channel: lossless, no delay, strong signal
+ *
+ * @return Channel model
+ */
+sim_channel_t sim_channel_clean(void);
+
+/*============================================================================*/
+/* Internal (sim_hal.c <-> sim_radio.c)                                       */
+/*============================================================================*/
+
+void sim_radio_reset(uint8_t radios, uint32_t seed);
+void sim_radio_spi(uint8_t radio, const uint8_t *tx, uint8_t *rx, uint16_t len);
+void sim_radio_set_ce(uint8_t radio, bool high);
+uint64_t sim_radio_next_event(void);
+void sim_radio_run_events(uint64_t now_ns);
+void sim_radio_service_irqs(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_H */
@@ -0,0 +1,407 @@
+/**
+ * @file sim_hal.c
+ * @brief Virtual clock and HAL calls for the host simulation
+ */
+
+#include "sim.h"
+#include "stm32f1xx_hal.h"
+#include <string.h>
+
+/*============================================================================*/
+/* Private Constants                                                          */
+/*============================================================================*/
+
+/** Virtual time one DWT access costs (a handful of cycles) */
+#define SIM_DWT_ACCESS_NS       100U
+
+/** Virtual time per SPI byte */
+#define SIM_SPI_BYTE_NS         (8U * 1000000000U / SIM_SPI_CLOCK_HZ)
+
+/*============================================================================*/
+/* Private Types                                                              */
+/*============================================================================*/
+
+/**
+ * @brief SPI DMA transfer waiting for its completion callback
+ */
+typedef struct {
+    bool pending;
+    bool rx;                /* TransmitReceive (else Transmit) */
+    SPI_HandleTypeDef *hspi;    /* Handle the transfer was started on */
+    uint64_t done_ns;
+} sim_dma_t;
+
+/**
+ * @brief Timer of one MCU, counting at 1 MHz
+ */
+typedef struct {
+    bool running;
+    bool in_callback;       /* Update handler still running */
+    uint32_t arr;           /* Auto-reload: the counter wraps after arr */
+    uint32_t count;         /* Counter while stopped */
+    int64_t start_ns;       /* When the counter last read 0 (running) */
+    TIM_HandleTypeDef *htim;    /* Handle the timer was started on */
+} sim_tim_t;
+
+/*============================================================================*/
+/* Private Variables                                                          */
+/*============================================================================*/
+
+/* Peripherals named by nrf24_config.h */
+SPI_HandleTypeDef hspi1;
+TIM_HandleTypeDef htim3;
+GPIO_TypeDef sim_gpiob;
+
+/* Dedicated wiring: id = radio index + 1 (0 follows sim_select()) */
+static SPI_HandleTypeDef sim_spi[SIM_MAX_RADIOS] = { {1}, {2}, {3}, {4} };
+static GPIO_TypeDef sim_gpio[SIM_MAX_RADIOS] = { {1}, {2}, {3}, {4} };
+_Static_assert(SIM_MAX_RADIOS == 4, "Extend the sim_spi / sim_gpio initializers");
+
+uint32_t SystemCoreClock = SIM_CORE_CLOCK_HZ;
+
+static uint64_t sim_now_ns;
+static uint8_t sim_current;
+static sim_dma_t sim_dma[SIM_MAX_RADIOS];
+static sim_tim_t sim_tim[SIM_MAX_RADIOS];
+
+static CoreDebug_Type sim_core_debug_regs;
+static DWT_Type sim_dwt_regs;
+static ITM_Type sim_itm_regs;
+
+/*============================================================================*/
+/* Private Function Prototypes                                                */
+/*============================================================================*/
+
+static void sim_run_dma(uint64_t now_ns);
+static uint64_t sim_tim_period_ns(const sim_tim_t *tim);
+static void sim_run_tims(uint64_t now_ns);
+static uint8_t sim_route(uint32_t id);
+
+/*============================================================================*/
+/* Simulation Control                                                         */
+/*============================================================================*/
+
+void sim_reset(uint8_t radios, uint32_t seed)
+{
+    sim_now_ns = 0;
+    sim_current = 0;
+    memset(sim_dma, 0, sizeof(sim_dma));
+    memset(sim_tim, 0, sizeof(sim_tim));
+    memset(&sim_core_debug_regs, 0, sizeof(sim_core_debug_regs));
+    memset(&sim_dwt_regs, 0, sizeof(sim_dwt_regs));
+
+    sim_radio_reset(radios, seed);
+}
+
+void sim_select(uint8_t radio)
+{
+    if (radio < SIM_MAX_RADIOS) {
+        sim_current = radio;
+    }
+}
+
+uint8_t sim_selected(void)
+{
+    return sim_current;
+}
+
+uint64_t sim_time_ns(void)
+{
+    return sim_now_ns;
+}
+
+uint64_t sim_time_us(void)
+{
+    return sim_now_ns / 1000U;
+}
+
+void sim_advance_us(uint32_t us)
+{
+    sim_advance_ns((uint64_t)us * 1000U);
+}
+
+void sim_advance_ns(uint64_t ns)
+{
+    uint64_t target = sim_now_ns + ns;
+
+    /* Callbacks below run driver code, which advances the clock again from
+     * inside this loop; per-radio IRQ guards keep that from recursing */
+    for (;;) {
+        uint64_t next = sim_radio_next_event();
+
+        for (uint8_t i = 0; i < SIM_MAX_RADIOS; i++) {
+            if (sim_dma[i].pending && sim_dma[i].done_ns < next) {
+                next = sim_dma[i].done_ns;
+            }
+
+            const sim_tim_t *tim = &sim_tim[i];
+            if (tim->running && !tim->in_callback) {
+                uint64_t update_ns = (uint64_t)(tim->start_ns + (int64_t)sim_tim_period_ns(tim));
+                if (update_ns < next) {
+                    next = update_ns;
+                }
+            }
+        }
+
+        if (next > target) {
+            break;
+        }
+
+        if (next > sim_now_ns) {
+            sim_now_ns = next;
+        }
+
+        sim_radio_run_events(sim_now_ns);
+        sim_run_dma(sim_now_ns);
+        sim_run_tims(sim_now_ns);
+        sim_radio_service_irqs();
+
+        /* Handlers spend time too; never run the clock backwards */
+        if (sim_now_ns > target) {
+            target = sim_now_ns;
+        }
+    }
+
+    sim_now_ns = target;
+}
+
+static void sim_run_dma(uint64_t now_ns)
+{
+    for (uint8_t i = 0; i < SIM_MAX_RADIOS; i++) {
+        if (!sim_dma[i].pending || sim_dma[i].done_ns > now_ns) {
+            continue;
+        }
+
+        sim_dma[i].pending = false;
+
+        uint8_t saved = sim_current;
+        sim_current = i;
+        if (sim_dma[i].rx) {
+            HAL_SPI_TxRxCpltCallback(sim_dma[i].hspi);
+        } else {
+            HAL_SPI_TxCpltCallback(sim_dma[i].hspi);
+        }
+        sim_current = saved;
+    }
+}
+
+static uint64_t sim_tim_period_ns(const sim_tim_t *tim)
+{
+    return ((uint64_t)tim->arr + 1U) * 1000U;
+}
+
+static void sim_run_tims(uint64_t now_ns)
+{
+    for (uint8_t i = 0; i < SIM_MAX_RADIOS; i++) {
+        sim_tim_t *tim = &sim_tim[i];
+
+        if (!tim->running || tim->in_callback ||
+            tim->start_ns + (int64_t)sim_tim_period_ns(tim) > (int64_t)now_ns) {
+            continue;
+        }
+
+        tim->start_ns += (int64_t)sim_tim_period_ns(tim);
+
+        tim->in_callback = true;
+        uint8_t saved = sim_current;
+        sim_current = i;
+        HAL_TIM_PeriodElapsedCallback(tim->htim);
+        sim_current = saved;
+        tim->in_callback = false;
+
+        /* A handler that outlasted the period missed those updates */
+        while (tim->start_ns + (int64_t)sim_tim_period_ns(tim) <= (int64_t)sim_now_ns) {
+            tim->start_ns += (int64_t)sim_tim_period_ns(tim);
+        }
+    }
+}
+
+static uint8_t sim_route(uint32_t id)
+{
+    return id ? (uint8_t)(id - 1) : sim_current;
+}
+
+/*============================================================================*/
+/* HAL Tick                                                                   */
+/*============================================================================*/
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(sim_now_ns / 1000000U);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    sim_advance_ns((uint64_t)Delay * 1000000U);
+}
+
+/*============================================================================*/
+/* Core Debug / DWT                                                           */
+/*============================================================================*/
+
+CoreDebug_Type *sim_core_debug(void)
+{
+    return &sim_core_debug_regs;
+}
+
+DWT_Type *sim_dwt(void)
+{
+    sim_advance_ns(SIM_DWT_ACCESS_NS);
+
+    sim_dwt_regs.CYCCNT = (uint32_t)(sim_now_ns * (SIM_CORE_CLOCK_HZ / 1000000U) / 1000U);
+
+    return &sim_dwt_regs;
+}
+
+ITM_Type *sim_itm(void)
+{
+    return &sim_itm_regs;
+}
+
+/*============================================================================*/
+/* GPIO / SPI                                                                 */
+/*============================================================================*/
+
+SPI_HandleTypeDef *sim_spi_bus(uint8_t radio)
+{
+    return (radio < SIM_MAX_RADIOS) ? &sim_spi[radio] : NULL;
+}
+
+GPIO_TypeDef *sim_gpio_port(uint8_t radio)
+{
+    return (radio < SIM_MAX_RADIOS) ? &sim_gpio[radio] : NULL;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    /* CSN framing is implicit: one HAL_SPI call is one command */
+    if (GPIO_Pin == NRF_CE_Pin) {
+        sim_radio_set_ce(sim_route(GPIOx->id), PinState == GPIO_PIN_SET);
+    }
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                                          uint8_t *pRxData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+
+    if (!pTxData || !pRxData || Size == 0) {
+        return HAL_ERROR;
+    }
+
+    sim_radio_spi(sim_route(hspi->id), pTxData, pRxData, Size);
+    sim_advance_ns((uint64_t)Size * SIM_SPI_BYTE_NS);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size)
+{
+    uint8_t radio = sim_route(hspi->id);
+
+    if (!pData || Size == 0 || sim_dma[radio].pending) {
+        return HAL_ERROR;
+    }
+
+    uint8_t discard[33];
+    sim_radio_spi(radio, pData, discard, Size > sizeof(discard) ? sizeof(discard) : Size);
+
+    sim_dma[radio].pending = true;
+    sim_dma[radio].rx = false;
+    sim_dma[radio].hspi = hspi;
+    sim_dma[radio].done_ns = sim_now_ns + (uint64_t)Size * SIM_SPI_BYTE_NS;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                                              uint8_t *pRxData, uint16_t Size)
+{
+    uint8_t radio = sim_route(hspi->id);
+
+    if (!pTxData || !pRxData || Size == 0 || sim_dma[radio].pending) {
+        return HAL_ERROR;
+    }
+
+    sim_radio_spi(radio, pTxData, pRxData, Size);
+
+    sim_dma[radio].pending = true;
+    sim_dma[radio].rx = true;
+    sim_dma[radio].hspi = hspi;
+    sim_dma[radio].done_ns = sim_now_ns + (uint64_t)Size * SIM_SPI_BYTE_NS;
+
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+}
+
+__attribute__((weak)) void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+}
+
+__attribute__((weak)) void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+}
+
+/*============================================================================*/
+/* Timers                                                                     */
+/*============================================================================*/
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+    sim_tim_t *tim = &sim_tim[sim_route(htim->id)];
+
+    if (!tim->running) {
+        tim->running = true;
+        tim->htim = htim;
+        tim->start_ns = (int64_t)sim_now_ns - (int64_t)tim->count * 1000;
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+    sim_tim_t *tim = &sim_tim[sim_route(htim->id)];
+
+    if (tim->running) {
+        tim->count = sim_tim_get_counter(htim);
+        tim->running = false;
+    }
+
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+void sim_tim_set_autoreload(TIM_HandleTypeDef *htim, uint32_t arr)
+{
+    sim_tim[sim_route(htim->id)].arr = arr;
+}
+
+void sim_tim_set_counter(TIM_HandleTypeDef *htim, uint32_t count)
+{
+    sim_tim_t *tim = &sim_tim[sim_route(htim->id)];
+
+    tim->count = count;
+    tim->start_ns = (int64_t)sim_now_ns - (int64_t)count * 1000;
+}
+
+uint32_t sim_tim_get_counter(TIM_HandleTypeDef *htim)
+{
+    const sim_tim_t *tim = &sim_tim[sim_route(htim->id)];
+
+    if (!tim->running) {
+        return tim->count;
+    }
+
+    return (uint32_t)((((int64_t)sim_now_ns - tim->start_ns) / 1000) % ((int64_t)tim->arr + 1));
+}
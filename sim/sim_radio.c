@@ -0,0 +1,834 @@
+/**
+ * @file sim_radio.c
+ * @brief nRF24L01+ model and channel model for the host simulation
+ *
+ * Models what the driver relies on: the register file, 3-deep TX/RX FIFOs,
+ * PTX/PRX modes driven by CONFIG and CE, Enhanced ShockBurst auto-ACK with
+ * ACK payloads, PID duplicate filtering, auto-retransmit (ARD/ARC), MAX_RT,
+ * OBSERVE_TX, RPD and the IRQ line. Air time follows the datasheet frame
+ * format at the configured data rate.
+ */
+
+#include "sim.h"
+#include "nrf24_registers.h"
+#include <string.h>
+
+/*============================================================================*/
+/* Private Constants                                                          */
+/*============================================================================*/
+
+#define SIM_FIFO_DEPTH          3
+#define SIM_REG_COUNT           0x20
+#define SIM_ADDR_WIDTH          5
+#define SIM_PIPE_COUNT          6
+
+/** Tstby2a / Trx2tx: PLL settling before every frame and ACK */
+#define SIM_SETTLE_NS           130000U
+
+#define SIM_CMD_W_TX_NOACK      0xB0
+#define SIM_CMD_REUSE_TX_PL     0xE3
+
+#define SIM_CONFIG_CRCO         (1 << 2)
+#define SIM_CONFIG_EN_CRC       (1 << 3)
+#define SIM_CONFIG_IRQ_MASKS    0x70
+#define SIM_STATUS_FLAGS        (NRF24_STATUS_RX_DR | NRF24_STATUS_TX_DS | NRF24_STATUS_MAX_RT)
+
+/** Received power at which RPD reads 1 */
+#define SIM_RPD_THRESHOLD_DBM   (-64)
+
+/** Receiver sensitivity per data rate */
+#define SIM_SENS_250K_DBM       (-94)
+#define SIM_SENS_1M_DBM         (-85)
+#define SIM_SENS_2M_DBM         (-82)
+
+/** Loss ramps from none to total over this many dB around sensitivity */
+#define SIM_FADE_DB             6
+
+/*============================================================================*/
+/* Private Types                                                              */
+/*============================================================================*/
+
+/**
+ * @brief FIFO entry
+ */
+typedef struct {
+    uint8_t data[32];
+    uint8_t len;
+    uint8_t pipe;           /* RX: pipe received on; TX: ACK payload pipe */
+    bool no_ack;            /* W_TX_PAYLOAD_NOACK */
+    bool ack_payload;       /* W_ACK_PAYLOAD entry */
+} sim_frame_t;
+
+typedef struct {
+    sim_frame_t slot[SIM_FIFO_DEPTH];
+    uint8_t head;
+    uint8_t count;
+} sim_fifo_t;
+
+/**
+ * @brief Where an Enhanced ShockBurst transaction is
+ */
+typedef enum {
+    SIM_TX_IDLE,            /* Standby, nothing on air */
+    SIM_TX_FRAME,           /* Event = end of the data frame */
+    SIM_TX_ACK              /* Event = end of the ACK window */
+} sim_tx_state_t;
+
+typedef struct {
+    bool present;
+    uint8_t regs[SIM_REG_COUNT];
+    uint8_t rx_addr_p0[SIM_ADDR_WIDTH];
+    uint8_t rx_addr_p1[SIM_ADDR_WIDTH];
+    uint8_t tx_addr[SIM_ADDR_WIDTH];
+    sim_fifo_t tx_fifo;
+    sim_fifo_t rx_fifo;
+
+    /* CE and the PTX engine */
+    bool ce;
+    bool ce_pulse;          /* CE rose in PTX: one payload is due */
+    sim_tx_state_t tx_state;
+    uint64_t tx_event_ns;
+    uint64_t tx_frame_end_ns;
+    uint8_t tx_attempt;
+    bool ack_ok;            /* ACK made it back this attempt */
+    bool ack_has_payload;
+    sim_frame_t ack_frame;
+    uint8_t pid;
+
+    /* PRX duplicate filter, per pipe */
+    bool last_valid[SIM_PIPE_COUNT];
+    uint8_t last_pid[SIM_PIPE_COUNT];
+    uint16_t last_sum[SIM_PIPE_COUNT];
+    bool last_ack_held[SIM_PIPE_COUNT];         /* Sent until a new PID shows the PTX got it */
+    sim_frame_t last_ack[SIM_PIPE_COUNT];
+
+    /* IRQ pin */
+    sim_irq_handler_t irq_handler;
+    void *irq_ctx;
+    bool irq_line;          /* Asserted (pin low) */
+    bool irq_edge;          /* Falling edge not yet serviced */
+    bool in_irq;
+} sim_radio_t;
+
+/*============================================================================*/
+/* Private Variables                                                          */
+/*============================================================================*/
+
+static sim_radio_t radios[SIM_MAX_RADIOS];
+static sim_channel_t channel;
+static sim_channel_stats_t channel_stats;
+static bool channel_bad;
+static uint32_t rng_state;
+
+/*============================================================================*/
+/* Private Function Prototypes                                                */
+/*============================================================================*/
+
+static uint32_t rng_next(void);
+static double rng_unit(void);
+static int rx_power_dbm(const sim_radio_t *tx);
+static bool channel_drops(const sim_radio_t *tx);
+static uint8_t reg_read(const sim_radio_t *r, uint8_t reg);
+static void reg_write(sim_radio_t *r, uint8_t reg, const uint8_t *data, uint8_t len);
+static uint8_t status_byte(const sim_radio_t *r);
+static bool fifo_push(sim_fifo_t *fifo, const sim_frame_t *frame);
+static sim_frame_t *fifo_head(sim_fifo_t *fifo);
+static void fifo_pop(sim_fifo_t *fifo);
+static bool is_ptx(const sim_radio_t *r);
+static bool is_listening(const sim_radio_t *r);
+static bool crc_enabled(const sim_radio_t *r);
+static uint64_t airtime_ns(const sim_radio_t *r, uint8_t len);
+static void tx_kick(sim_radio_t *r, uint64_t now_ns);
+static void tx_start_attempt(sim_radio_t *r, uint64_t start_ns);
+static void tx_frame_end(sim_radio_t *r, uint64_t now_ns);
+static void tx_ack_end(sim_radio_t *r, uint64_t now_ns);
+static void tx_finish(sim_radio_t *r);
+static sim_radio_t *find_receiver(const sim_radio_t *r, const sim_radio_t *after, uint8_t *pipe);
+static bool rx_accept(sim_radio_t *q, uint8_t pipe, const sim_frame_t *frame,
+                      uint8_t pid, bool want_ack, sim_frame_t *ack);
+static void irq_update(sim_radio_t *r);
+
+/*============================================================================*/
+/* Random Numbers / Channel Model                                             */
+/*============================================================================*/
+
+static uint32_t rng_next(void)
+{
+    /* xorshift32 */
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng_state = x;
+    return x;
+}
+
+static double rng_unit(void)
+{
+    return (double)rng_next() / 4294967296.0;
+}
+
+static int rx_power_dbm(const sim_radio_t *tx)
+{
+    uint8_t power = (tx->regs[NRF24_REG_RF_SETUP] >> NRF24_RF_SETUP_PWR) & 0x03;
+    return channel.signal_dbm - 6 * (3 - power);
+}
+
+static bool channel_drops(const sim_radio_t *tx)
+{
+    /* Gilbert-Elliott: move between states, then lose by state */
+    if (channel_bad) {
+        if (rng_unit() < channel.burst_exit) {
+            channel_bad = false;
+        }
+    } else if (rng_unit() < channel.burst_enter) {
+        channel_bad = true;
+    }
+
+    channel_stats.frames++;
+
+    uint8_t rf_setup = tx->regs[NRF24_REG_RF_SETUP];
+    int sensitivity = SIM_SENS_1M_DBM;
+    if (rf_setup & (1 << NRF24_RF_SETUP_DR_LOW)) {
+        sensitivity = SIM_SENS_250K_DBM;
+    } else if (rf_setup & (1 << NRF24_RF_SETUP_DR_HIGH)) {
+        sensitivity = SIM_SENS_2M_DBM;
+    }
+
+    int margin = rx_power_dbm(tx) - sensitivity + SIM_FADE_DB / 2;
+    double fade = margin <= 0 ? 1.0 :
+                  margin >= SIM_FADE_DB ? 0.0 : 1.0 - (double)margin / SIM_FADE_DB;
+
+    double loss = channel_bad ? channel.burst_loss : channel.loss;
+    loss = 1.0 - (1.0 - loss) * (1.0 - fade);
+    if (rng_unit() < loss) {
+        channel_stats.lost++;
+        return true;
+    }
+
+    return false;
+}
+
+sim_channel_t sim_channel_clean(void)
+{
+    sim_channel_t clean;
+    memset(&clean, 0, sizeof(clean));
+    clean.burst_exit = 1.0;
+    clean.signal_dbm = -40;
+    return clean;
+}
+
+void sim_channel_set(const sim_channel_t *model)
+{
+    if (model) {
+        channel = *model;
+    }
+}
+
+void sim_channel_get_stats(sim_channel_stats_t *stats)
+{
+    if (stats) {
+        *stats = channel_stats;
+    }
+}
+
+/*============================================================================*/
+/* Reset / Pins                                                               */
+/*============================================================================*/
+
+void sim_radio_reset(uint8_t count, uint32_t seed)
+{
+    memset(radios, 0, sizeof(radios));
+    memset(&channel_stats, 0, sizeof(channel_stats));
+    channel = sim_channel_clean();
+    channel_bad = false;
+    rng_state = seed ? seed : 0x2545F491U;
+
+    if (count > SIM_MAX_RADIOS) {
+        count = SIM_MAX_RADIOS;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        sim_radio_t *r = &radios[i];
+
+        /* Datasheet reset values */
+        r->present = true;
+        r->regs[NRF24_REG_CONFIG] = NRF24_CONFIG_CRC_EN;
+        r->regs[NRF24_REG_EN_AA] = 0x3F;
+        r->regs[NRF24_REG_EN_RXADDR] = 0x03;
+        r->regs[NRF24_REG_SETUP_AW] = 0x03;
+        r->regs[NRF24_REG_SETUP_RETR] = 0x03;
+        r->regs[NRF24_REG_RF_CH] = 0x02;
+        r->regs[NRF24_REG_RF_SETUP] = 0x0E;
+        memset(r->rx_addr_p0, 0xE7, SIM_ADDR_WIDTH);
+        memset(r->rx_addr_p1, 0xC2, SIM_ADDR_WIDTH);
+        for (uint8_t p = 2; p < SIM_PIPE_COUNT; p++) {
+            r->regs[NRF24_REG_RX_ADDR_P2 + p - 2] = (uint8_t)(0xC1 + p);
+        }
+        memset(r->tx_addr, 0xE7, SIM_ADDR_WIDTH);
+    }
+}
+
+void sim_radio_set_irq(uint8_t radio, sim_irq_handler_t handler, void *ctx)
+{
+    if (radio >= SIM_MAX_RADIOS) {
+        return;
+    }
+
+    radios[radio].irq_handler = handler;
+    radios[radio].irq_ctx = ctx;
+}
+
+void sim_radio_set_ce(uint8_t radio, bool high)
+{
+    if (radio >= SIM_MAX_RADIOS || !radios[radio].present) {
+        return;
+    }
+
+    sim_radio_t *r = &radios[radio];
+
+    if (high && !r->ce && is_ptx(r)) {
+        r->ce_pulse = true;
+    }
+    r->ce = high;
+
+    tx_kick(r, sim_time_ns());
+}
+
+/*============================================================================*/
+/* Registers / SPI                                                            */
+/*============================================================================*/
+
+static uint8_t status_byte(const sim_radio_t *r)
+{
+    uint8_t status = r->regs[NRF24_REG_STATUS] & SIM_STATUS_FLAGS;
+
+    if (r->rx_fifo.count > 0) {
+        status |= (uint8_t)(r->rx_fifo.slot[r->rx_fifo.head].pipe << NRF24_STATUS_RX_P_NO_SHIFT);
+    } else {
+        status |= (uint8_t)(NRF24_RX_P_NO_EMPTY << NRF24_STATUS_RX_P_NO_SHIFT);
+    }
+
+    if (r->tx_fifo.count == SIM_FIFO_DEPTH) {
+        status |= 0x01;  /* TX_FULL */
+    }
+
+    return status;
+}
+
+static uint8_t reg_read(const sim_radio_t *r, uint8_t reg)
+{
+    switch (reg) {
+        case NRF24_REG_STATUS:
+            return status_byte(r);
+
+        case NRF24_REG_FIFO_STATUS: {
+            uint8_t fifo = 0;
+            if (r->rx_fifo.count == 0)              fifo |= NRF24_FIFO_RX_EMPTY;
+            if (r->rx_fifo.count == SIM_FIFO_DEPTH) fifo |= NRF24_FIFO_RX_FULL;
+            if (r->tx_fifo.count == 0)              fifo |= NRF24_FIFO_TX_EMPTY;
+            if (r->tx_fifo.count == SIM_FIFO_DEPTH) fifo |= NRF24_FIFO_TX_FULL;
+            return fifo;
+        }
+
+        default:
+            return r->regs[reg];
+    }
+}
+
+static void reg_write(sim_radio_t *r, uint8_t reg, const uint8_t *data, uint8_t len)
+{
+    if (len == 0) {
+        return;
+    }
+
+    switch (reg) {
+        case NRF24_REG_STATUS:
+            /* Write 1 to clear */
+            r->regs[reg] &= (uint8_t)~(data[0] & SIM_STATUS_FLAGS);
+            break;
+
+        case NRF24_REG_RX_ADDR_P0:
+            memcpy(r->rx_addr_p0, data, len < SIM_ADDR_WIDTH ? len : SIM_ADDR_WIDTH);
+            break;
+
+        case NRF24_REG_RX_ADDR_P1:
+            memcpy(r->rx_addr_p1, data, len < SIM_ADDR_WIDTH ? len : SIM_ADDR_WIDTH);
+            break;
+
+        case NRF24_REG_TX_ADDR:
+            memcpy(r->tx_addr, data, len < SIM_ADDR_WIDTH ? len : SIM_ADDR_WIDTH);
+            break;
+
+        case NRF24_REG_RF_CH:
+            r->regs[reg] = data[0] & 0x7F;
+            r->regs[NRF24_REG_OBSERVE_TX] &= 0x0F;  /* Clears PLOS_CNT */
+            break;
+
+        case NRF24_REG_OBSERVE_TX:
+        case NRF24_REG_RPD:
+        case NRF24_REG_FIFO_STATUS:
+            break;  /* Read-only */
+
+        default:
+            if (reg < SIM_REG_COUNT) {
+                r->regs[reg] = data[0];
+            }
+            break;
+    }
+}
+
+void sim_radio_spi(uint8_t radio, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    memset(rx, 0, len);
+
+    if (radio >= SIM_MAX_RADIOS || !radios[radio].present) {
+        return;  /* Nothing on the bus reads back zeros */
+    }
+
+    sim_radio_t *r = &radios[radio];
+    uint8_t cmd = tx[0];
+    uint8_t n = (uint8_t)((len - 1) > 32 ? 32 : (len - 1));
+    const uint8_t *in = &tx[1];
+    uint8_t *out = &rx[1];
+
+    rx[0] = status_byte(r);
+
+    if ((cmd & 0xE0) == NRF24_CMD_R_REGISTER) {
+        uint8_t reg = cmd & 0x1F;
+        if (reg == NRF24_REG_RX_ADDR_P0 || reg == NRF24_REG_RX_ADDR_P1 || reg == NRF24_REG_TX_ADDR) {
+            const uint8_t *addr = (reg == NRF24_REG_TX_ADDR) ? r->tx_addr :
+                                  (reg == NRF24_REG_RX_ADDR_P0) ? r->rx_addr_p0 : r->rx_addr_p1;
+            memcpy(out, addr, n < SIM_ADDR_WIDTH ? n : SIM_ADDR_WIDTH);
+        } else if (n > 0) {
+            out[0] = reg_read(r, reg);
+        }
+    } else if ((cmd & 0xE0) == NRF24_CMD_W_REGISTER) {
+        reg_write(r, cmd & 0x1F, in, n);
+    } else if (cmd == NRF24_CMD_R_RX_PAYLOAD) {
+        sim_frame_t *head = fifo_head(&r->rx_fifo);
+        if (head) {
+            memcpy(out, head->data, n < head->len ? n : head->len);
+            fifo_pop(&r->rx_fifo);
+        }
+    } else if (cmd == NRF24_CMD_R_RX_PL_WID) {
+        sim_frame_t *head = fifo_head(&r->rx_fifo);
+        if (n > 0) {
+            out[0] = head ? head->len : 0;
+        }
+    } else if (cmd == NRF24_CMD_W_TX_PAYLOAD || cmd == SIM_CMD_W_TX_NOACK) {
+        sim_frame_t frame;
+        memset(&frame, 0, sizeof(frame));
+        memcpy(frame.data, in, n);
+        frame.len = n;
+        frame.no_ack = (cmd == SIM_CMD_W_TX_NOACK) &&
+                       (r->regs[NRF24_REG_FEATURE] & NRF24_FEATURE_EN_DYN_ACK);
+        fifo_push(&r->tx_fifo, &frame);
+    } else if ((cmd & 0xF8) == NRF24_CMD_W_ACK_PAYLOAD) {
+        sim_frame_t frame;
+        memset(&frame, 0, sizeof(frame));
+        memcpy(frame.data, in, n);
+        frame.len = n;
+        frame.pipe = cmd & 0x07;
+        frame.ack_payload = true;
+        fifo_push(&r->tx_fifo, &frame);
+    } else if (cmd == NRF24_CMD_FLUSH_TX) {
+        r->tx_fifo.count = 0;
+        memset(r->last_ack_held, 0, sizeof(r->last_ack_held));
+        r->tx_state = SIM_TX_IDLE;  /* Aborts anything on air */
+    } else if (cmd == NRF24_CMD_FLUSH_RX) {
+        r->rx_fifo.count = 0;
+    }
+    /* NOP, REUSE_TX_PL and unknown commands only clock out STATUS */
+
+    irq_update(r);
+    tx_kick(r, sim_time_ns());
+}
+
+/*============================================================================*/
+/* FIFOs                                                                      */
+/*============================================================================*/
+
+static bool fifo_push(sim_fifo_t *fifo, const sim_frame_t *frame)
+{
+    if (fifo->count == SIM_FIFO_DEPTH) {
+        return false;
+    }
+
+    fifo->slot[(fifo->head + fifo->count) % SIM_FIFO_DEPTH] = *frame;
+    fifo->count++;
+    return true;
+}
+
+static sim_frame_t *fifo_head(sim_fifo_t *fifo)
+{
+    return fifo->count ? &fifo->slot[fifo->head] : NULL;
+}
+
+static void fifo_pop(sim_fifo_t *fifo)
+{
+    if (fifo->count) {
+        fifo->head = (fifo->head + 1) % SIM_FIFO_DEPTH;
+        fifo->count--;
+    }
+}
+
+/*============================================================================*/
+/* Enhanced ShockBurst                                                        */
+/*============================================================================*/
+
+static bool is_ptx(const sim_radio_t *r)
+{
+    uint8_t config = r->regs[NRF24_REG_CONFIG];
+    return (config & NRF24_CONFIG_PWR_UP) && !(config & NRF24_CONFIG_PRIM_RX);
+}
+
+static bool is_listening(const sim_radio_t *r)
+{
+    uint8_t config = r->regs[NRF24_REG_CONFIG];
+    return r->present && r->ce && (config & NRF24_CONFIG_PWR_UP) &&
+           (config & NRF24_CONFIG_PRIM_RX) && r->tx_state == SIM_TX_IDLE;
+}
+
+static bool crc_enabled(const sim_radio_t *r)
+{
+    /* Any auto-ACK pipe forces EN_CRC high */
+    return (r->regs[NRF24_REG_CONFIG] & SIM_CONFIG_EN_CRC) || r->regs[NRF24_REG_EN_AA] != 0;
+}
+
+static uint64_t airtime_ns(const sim_radio_t *r, uint8_t len)
+{
+    /* Preamble + address + 9-bit packet control field + payload + CRC */
+    uint8_t crc_bytes = !crc_enabled(r) ? 0 :
+                        (r->regs[NRF24_REG_CONFIG] & SIM_CONFIG_CRCO) ? 2 : 1;
+    uint64_t bits = 8U + 8U * SIM_ADDR_WIDTH + 9U + 8U * len + 8U * crc_bytes;
+    uint8_t rf_setup = r->regs[NRF24_REG_RF_SETUP];
+
+    if (rf_setup & (1 << NRF24_RF_SETUP_DR_LOW)) {
+        return bits * 4000U;   /* 250 kbps */
+    }
+    if (rf_setup & (1 << NRF24_RF_SETUP_DR_HIGH)) {
+        return bits * 500U;    /* 2 Mbps */
+    }
+    return bits * 1000U;       /* 1 Mbps */
+}
+
+static void tx_kick(sim_radio_t *r, uint64_t now_ns)
+{
+    if (r->tx_state != SIM_TX_IDLE || !is_ptx(r) ||
+        (r->regs[NRF24_REG_STATUS] & NRF24_STATUS_MAX_RT)) {
+        return;  /* Busy, not a PTX, or stalled until MAX_RT is cleared */
+    }
+
+    sim_frame_t *head = fifo_head(&r->tx_fifo);
+    if (!head || head->ack_payload || !(r->ce || r->ce_pulse)) {
+        return;
+    }
+
+    r->ce_pulse = false;
+    r->pid = (r->pid + 1) & 0x03;
+    r->tx_attempt = 0;
+    r->regs[NRF24_REG_OBSERVE_TX] &= 0xF0;  /* ARC_CNT restarts per payload */
+
+    tx_start_attempt(r, now_ns);
+}
+
+static void tx_start_attempt(sim_radio_t *r, uint64_t start_ns)
+{
+    r->tx_state = SIM_TX_FRAME;
+    r->tx_frame_end_ns = start_ns + SIM_SETTLE_NS + airtime_ns(r, fifo_head(&r->tx_fifo)->len);
+    r->tx_event_ns = r->tx_frame_end_ns + (uint64_t)channel.latency_us * 1000U;
+}
+
+static void tx_frame_end(sim_radio_t *r, uint64_t now_ns)
+{
+    sim_frame_t *frame = fifo_head(&r->tx_fifo);
+    bool want_ack = (r->regs[NRF24_REG_EN_AA] & 0x01) && !frame->no_ack;
+
+    r->ack_ok = false;
+    r->ack_has_payload = false;
+
+    /* Every radio listening on the address hears the frame, each through
+     * its own loss draw; two receivers answering at once collide */
+    uint8_t pipe = 0;
+    sim_radio_t *acker = NULL;
+    uint8_t acks = 0;
+    sim_frame_t ack;
+
+    for (sim_radio_t *q = find_receiver(r, NULL, &pipe); q; q = find_receiver(r, q, &pipe)) {
+        if (channel_drops(r)) {
+            continue;
+        }
+
+        q->regs[NRF24_REG_RPD] = (rx_power_dbm(r) >= SIM_RPD_THRESHOLD_DBM) ? 1 : 0;
+        if (rx_accept(q, pipe, frame, r->pid, want_ack, &ack)) {
+            r->ack_frame = ack;
+            acker = q;
+            acks++;
+        }
+    }
+
+    if (!want_ack) {
+        tx_finish(r);
+        return;
+    }
+
+    uint8_t ack_len = 0;
+    if (acks == 1) {
+        r->ack_has_payload = r->ack_frame.len > 0;
+        ack_len = r->ack_frame.len;
+        r->ack_ok = !channel_drops(acker);
+    }
+
+    r->tx_state = SIM_TX_ACK;
+    r->tx_event_ns = now_ns + SIM_SETTLE_NS + airtime_ns(r, ack_len) +
+                     (uint64_t)channel.latency_us * 1000U;
+}
+
+static void tx_ack_end(sim_radio_t *r, uint64_t now_ns)
+{
+    if (r->ack_ok) {
+        if (r->ack_has_payload && fifo_push(&r->rx_fifo, &r->ack_frame)) {
+            r->regs[NRF24_REG_STATUS] |= NRF24_STATUS_RX_DR;
+        }
+        tx_finish(r);
+        return;
+    }
+
+    uint8_t retr = r->regs[NRF24_REG_SETUP_RETR];
+    uint8_t arc = retr & 0x0F;
+
+    if (r->tx_attempt < arc) {
+        /* ARD counts from the end of the last frame */
+        uint64_t ard_ns = (uint64_t)(((retr >> 4) & 0x0F) + 1) * 250000U;
+        uint64_t start = r->tx_frame_end_ns + ard_ns;
+
+        r->tx_attempt++;
+        r->regs[NRF24_REG_OBSERVE_TX] = (uint8_t)((r->regs[NRF24_REG_OBSERVE_TX] & 0xF0) | r->tx_attempt);
+        channel_stats.retransmits++;
+
+        tx_start_attempt(r, start > now_ns ? start : now_ns);
+        return;
+    }
+
+    /* Payload stays in the FIFO until flushed */
+    uint8_t plos = (uint8_t)(r->regs[NRF24_REG_OBSERVE_TX] >> 4);
+    if (plos < 15) {
+        plos++;
+    }
+    r->regs[NRF24_REG_OBSERVE_TX] = (uint8_t)((plos << 4) | (r->regs[NRF24_REG_OBSERVE_TX] & 0x0F));
+    r->regs[NRF24_REG_STATUS] |= NRF24_STATUS_MAX_RT;
+    r->tx_state = SIM_TX_IDLE;
+    channel_stats.max_rt++;
+}
+
+static void tx_finish(sim_radio_t *r)
+{
+    fifo_pop(&r->tx_fifo);
+    r->regs[NRF24_REG_STATUS] |= NRF24_STATUS_TX_DS;
+    r->tx_state = SIM_TX_IDLE;
+}
+
+static sim_radio_t *find_receiver(const sim_radio_t *r, const sim_radio_t *after, uint8_t *pipe)
+{
+    uint8_t rate_mask = (1 << NRF24_RF_SETUP_DR_LOW) | (1 << NRF24_RF_SETUP_DR_HIGH);
+
+    for (uint8_t i = after ? (uint8_t)(after - radios + 1) : 0; i < SIM_MAX_RADIOS; i++) {
+        sim_radio_t *q = &radios[i];
+
+        if (q == r || !is_listening(q) ||
+            q->regs[NRF24_REG_RF_CH] != r->regs[NRF24_REG_RF_CH] ||
+            (q->regs[NRF24_REG_RF_SETUP] & rate_mask) != (r->regs[NRF24_REG_RF_SETUP] & rate_mask)) {
+            continue;
+        }
+
+        uint8_t en = q->regs[NRF24_REG_EN_RXADDR];
+        if ((en & 0x01) && memcmp(q->rx_addr_p0, r->tx_addr, SIM_ADDR_WIDTH) == 0) {
+            *pipe = 0;
+            return q;
+        }
+
+        /* Pipes 2-5 match their own LSB on top of the pipe 1 address */
+        if (memcmp(&q->rx_addr_p1[1], &r->tx_addr[1], SIM_ADDR_WIDTH - 1) != 0) {
+            continue;
+        }
+        for (uint8_t p = 1; p < SIM_PIPE_COUNT; p++) {
+            uint8_t lsb = (p == 1) ? q->rx_addr_p1[0] : q->regs[NRF24_REG_RX_ADDR_P2 + p - 2];
+            if ((en & (1 << p)) && lsb == r->tx_addr[0]) {
+                *pipe = p;
+                return q;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static bool rx_accept(sim_radio_t *q, uint8_t pipe, const sim_frame_t *frame,
+                      uint8_t pid, bool want_ack, sim_frame_t *ack)
+{
+    bool dynamic = (q->regs[NRF24_REG_FEATURE] & NRF24_FEATURE_EN_DPL) &&
+                   (q->regs[NRF24_REG_DYNPD] & (1 << pipe));
+    bool auto_ack = want_ack && (q->regs[NRF24_REG_EN_AA] & (1 << pipe));
+
+    /* A static-width receiver checks CRC over the wrong span */
+    if (!dynamic && frame->len != q->regs[NRF24_REG_RX_PW_P0 + pipe]) {
+        return false;
+    }
+
+    /* Damaged on air: the radio's CRC catches it, or it goes up as is */
+    bool damaged = channel.errors > 0 && frame->len > 0 && rng_unit() < channel.errors;
+    if (damaged) {
+        channel_stats.errored++;
+        if (crc_enabled(q)) {
+            return false;
+        }
+    }
+
+    uint16_t sum = 0;
+    for (uint8_t i = 0; i < frame->len; i++) {
+        sum = (uint16_t)((sum << 1 | sum >> 15) ^ frame->data[i]);
+    }
+
+    /* Retransmission of a frame already stored: ACK it, keep one copy */
+    bool duplicate = auto_ack && q->last_valid[pipe] &&
+                     q->last_pid[pipe] == pid && q->last_sum[pipe] == sum;
+
+    if (!duplicate) {
+        if (q->rx_fifo.count == SIM_FIFO_DEPTH) {
+            return false;  /* No room: no ACK either */
+        }
+
+        sim_frame_t copy = *frame;
+        copy.pipe = pipe;
+
+        if (rng_unit() < channel.corrupt && copy.len > 0) {
+            uint32_t bit = rng_next() % (uint32_t)(copy.len * 8U);
+            copy.data[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+            channel_stats.corrupted++;
+        }
+
+        for (uint8_t i = 0; damaged && i < (channel.error_bytes ? channel.error_bytes : 1); i++) {
+            copy.data[rng_next() % copy.len] ^= (uint8_t)(1U + rng_next() % 255U);
+        }
+
+        fifo_push(&q->rx_fifo, &copy);
+        q->regs[NRF24_REG_STATUS] |= NRF24_STATUS_RX_DR;
+
+        if (auto_ack) {
+            q->last_valid[pipe] = true;
+            q->last_pid[pipe] = pid;
+            q->last_sum[pipe] = sum;
+        }
+    }
+
+    irq_update(q);
+
+    if (!auto_ack) {
+        return false;
+    }
+
+    /* A retransmission means our ACK was lost: the same payload goes again */
+    if (duplicate && q->last_ack_held[pipe]) {
+        *ack = q->last_ack[pipe];
+        return true;
+    }
+
+    /* ACK payload for this pipe rides along and leaves the FIFO */
+    memset(ack, 0, sizeof(*ack));
+    q->last_ack_held[pipe] = false;
+    sim_frame_t *head = fifo_head(&q->tx_fifo);
+    if ((q->regs[NRF24_REG_FEATURE] & NRF24_FEATURE_EN_ACK_PAY) &&
+        head && head->ack_payload && head->pipe == pipe) {
+        *ack = *head;
+        ack->ack_payload = false;
+        fifo_pop(&q->tx_fifo);
+        q->last_ack[pipe] = *ack;
+        q->last_ack_held[pipe] = true;
+
+        /* A PRX reports the payload sent with TX_DS (here from the start
+         * of the ACK, not its end) */
+        q->regs[NRF24_REG_STATUS] |= NRF24_STATUS_TX_DS;
+        irq_update(q);
+    }
+
+    return true;
+}
+
+/*============================================================================*/
+/* Event Loop / IRQ                                                           */
+/*============================================================================*/
+
+uint64_t sim_radio_next_event(void)
+{
+    uint64_t next = UINT64_MAX;
+
+    for (uint8_t i = 0; i < SIM_MAX_RADIOS; i++) {
+        if (radios[i].tx_state != SIM_TX_IDLE && radios[i].tx_event_ns < next) {
+            next = radios[i].tx_event_ns;
+        }
+    }
+
+    return next;
+}
+
+void sim_radio_run_events(uint64_t now_ns)
+{
+    for (uint8_t i = 0; i < SIM_MAX_RADIOS; i++) {
+        sim_radio_t *r = &radios[i];
+
+        if (r->tx_state == SIM_TX_IDLE || r->tx_event_ns > now_ns) {
+            continue;
+        }
+
+        if (r->tx_state == SIM_TX_FRAME) {
+            tx_frame_end(r, now_ns);
+        } else {
+            tx_ack_end(r, now_ns);
+        }
+
+        irq_update(r);
+
+        /* CE still high: next queued payload goes straight out */
+        tx_kick(r, now_ns);
+    }
+}
+
+static void irq_update(sim_radio_t *r)
+{
+    uint8_t masked = r->regs[NRF24_REG_CONFIG] & SIM_CONFIG_IRQ_MASKS;
+    bool line = (r->regs[NRF24_REG_STATUS] & SIM_STATUS_FLAGS & ~masked) != 0;
+
+    if (line && !r->irq_line) {
+        r->irq_edge = true;  /* EXTI pending bit */
+    }
+    r->irq_line = line;
+}
+
+void sim_radio_service_irqs(void)
+{
+    bool again = true;
+
+    while (again) {
+        again = false;
+
+        for (uint8_t i = 0; i < SIM_MAX_RADIOS; i++) {
+            sim_radio_t *r = &radios[i];
+
+            if (!r->irq_edge || !r->irq_handler || r->in_irq) {
+                continue;
+            }
+
+            r->irq_edge = false;
+            r->in_irq = true;
+
+            uint8_t saved = sim_selected();
+            sim_select(i);
+            r->irq_handler(r->irq_ctx);
+            sim_select(saved);
+
+            r->in_irq = false;
+            again = true;
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/**
+ * @file stm32f1xx_hal_conf.h
+ * @brief Host simulation stand-in for the CubeMX HAL configuration
+ *
+ * Pulled in by drivers/include/stm32f1xx_hal.h when sim/ is on the include
+ * path. Provides just the HAL types, registers and calls the driver uses;
+ * sim_hal.c implements them against the simulated radios (see sim.h).
+ */
+
+#ifndef STM32F1XX_HAL_CONF_H
+#define STM32F1XX_HAL_CONF_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __IO volatile
+
+/*============================================================================*/
+/* HAL Types                                                                  */
+/*============================================================================*/
+
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct {
+    uint32_t id;
+} SPI_HandleTypeDef;
+
+typedef struct {
+    uint32_t id;
+} TIM_HandleTypeDef;
+
+typedef struct {
+    uint32_t id;
+} GPIO_TypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0U,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+/*============================================================================*/
+/* Pins (CubeMX main.h labels used by nrf24_config.h)                         */
+/*============================================================================*/
+
+extern GPIO_TypeDef sim_gpiob;
+
+#define GPIOB                   (&sim_gpiob)
+#define SPI1_CSN_NRF_Pin        ((uint16_t)0x0001)
+#define NRF_CE_Pin              ((uint16_t)0x0002)
+#define NRF_IRQ_Pin             ((uint16_t)0x0004)
+
+/**
+ * Bus and port wired to one radio for good (nrf24_hw_t of a second nRF24
+ * on the same MCU). hspi1 / GPIOB reach whichever radio sim_select() picked;
+ * these always reach their own, with the same pin numbers as above.
+ */
+SPI_HandleTypeDef *sim_spi_bus(uint8_t radio);
+GPIO_TypeDef *sim_gpio_port(uint8_t radio);
+
+/*============================================================================*/
+/* Core Debug / DWT                                                           */
+/*============================================================================*/
+
+typedef struct {
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+CoreDebug_Type *sim_core_debug(void);
+DWT_Type *sim_dwt(void);
+
+/* Every DWT access lets a few cycles pass, so busy-wait loops terminate */
+#define CoreDebug               (sim_core_debug())
+#define DWT                     (sim_dwt())
+
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+
+/* ITM: no debugger, so tracing is never enabled and nothing hits the wire */
+typedef struct {
+    union {
+        __IO uint8_t u8;
+        __IO uint16_t u16;
+        __IO uint32_t u32;
+    } PORT[32];
+    uint32_t RESERVED0[864];
+    __IO uint32_t TER;
+    uint32_t RESERVED1[15];
+    __IO uint32_t TPR;
+    uint32_t RESERVED2[15];
+    __IO uint32_t TCR;
+} ITM_Type;
+
+ITM_Type *sim_itm(void);
+
+#define ITM                     (sim_itm())
+
+#define ITM_TCR_ITMENA_Msk          (1UL << 0)
+
+extern uint32_t SystemCoreClock;
+
+/*============================================================================*/
+/* Peripheral Calls                                                           */
+/*============================================================================*/
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                                          uint8_t *pRxData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                                              uint8_t *pRxData, uint16_t Size);
+
+/* DMA completions land here with the owning radio selected (weak defaults) */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi);
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi);
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi);
+
+/* One 1 MHz timer per MCU; htim3 follows sim_select() like hspi1. Updates
+ * land here with the owning radio selected (weak default) */
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
+void sim_tim_set_autoreload(TIM_HandleTypeDef *htim, uint32_t arr);
+void sim_tim_set_counter(TIM_HandleTypeDef *htim, uint32_t count);
+uint32_t sim_tim_get_counter(TIM_HandleTypeDef *htim);
+
+#define __HAL_TIM_SET_AUTORELOAD(h, v)  sim_tim_set_autoreload((h), (v))
+#define __HAL_TIM_SET_COUNTER(h, v)     sim_tim_set_counter((h), (v))
+#define __HAL_TIM_GET_COUNTER(h)        sim_tim_get_counter(h)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32F1XX_HAL_CONF_H */
@@ -0,0 +1,72 @@
+/**
+* @file bind.c
+ * @brief Bind pair derivation and checks
+ */
+
+#include "bind.h"
+#include <string.h>
+
+/* Salts for the address and seed streams, so they are unrelated */
+#define BIND_ADDRESS_SALT   0x811C9DC5UL
+#define BIND_SEED_SALT      0x6A09E667UL
+
+static const uint8_t default_address[RC_BIND_ADDRESS_SIZE] = RC_RF_ADDRESS;
+static const uint8_t bind_address[RC_BIND_ADDRESS_SIZE] = RC_BIND_ADDRESS;
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+static uint32_t bind_hash(uint32_t hash, const uint8_t *data, uint8_t len)
+{
+    /* FNV-1a */
+    for (uint8_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 0x01000193UL;
+    }
+
+    return hash;
+}
+
+static bool bind_byte_ok(uint8_t b)
+{
+    /* Alternating bits look like the preamble, flat ones like no signal */
+    return b != 0x00 && b != 0x55 && b != 0xAA && b != 0xFF;
+}
+
+/*============================================================================*/
+/* Pairs                                                                      */
+/*============================================================================*/
+
+void rc_bind_derive(const uint8_t *uid, uint8_t len, rc_bind_info_t *info)
+{
+    uint32_t hash = bind_hash(BIND_ADDRESS_SALT, uid, len);
+
+    for (uint8_t i = 0; i < RC_BIND_ADDRESS_SIZE; i++) {
+        /* Re-mix per byte; a rejected byte just takes the next round */
+        do {
+            hash = bind_hash(hash, &i, 1);
+            info->address[i] = (uint8_t)(hash >> 24);
+        } while (!bind_byte_ok(info->address[i]));
+    }
+
+    /* One byte off is enough to be neither of the shared addresses */
+    if (memcmp(info->address, default_address, RC_BIND_ADDRESS_SIZE) == 0 ||
+        memcmp(info->address, bind_address, RC_BIND_ADDRESS_SIZE) == 0) {
+        info->address[0] ^= 0x01;
+    }
+
+    info->hop_seed = bind_hash(BIND_SEED_SALT, uid, len);
+}
+
+bool rc_bind_valid(const rc_bind_info_t *info)
+{
+    for (uint8_t i = 0; i < RC_BIND_ADDRESS_SIZE; i++) {
+        if (!bind_byte_ok(info->address[i])) {
+            return false;
+        }
+    }
+
+    return memcmp(info->address, default_address, RC_BIND_ADDRESS_SIZE) != 0 &&
+           memcmp(info->address, bind_address, RC_BIND_ADDRESS_SIZE) != 0;
+}
@@ -0,0 +1,325 @@
+/**
+* @file bulk.c
+ * @brief Bulk stream segmentation, reassembly and selective-repeat ARQ
+ */
+
+#include "bulk.h"
+#include <string.h>
+
+/** Bits of a window bitmap */
+#define RC_BULK_WINDOW_MASK     (0xFFFFFFFFUL >> (32 - RC_BULK_WINDOW))
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+static uint32_t bulk_rate(uint32_t bytes, uint32_t elapsed_ms)
+{
+    return elapsed_ms ? (uint32_t)((uint64_t)bytes * 1000U / elapsed_ms) : 0;
+}
+
+/* Segments from base the window covers, up to the end of the stream */
+static uint32_t bulk_span(const rc_bulk_tx_t *tx)
+{
+    uint32_t left = tx->count - tx->base;
+
+    return left < RC_BULK_WINDOW ? left : RC_BULK_WINDOW;
+}
+
+/* Offset from base of the next segment to send: lowest first, so the ones
+ * an ACK reported missing go before new ones. -1 if none */
+static int8_t bulk_pick(const rc_bulk_tx_t *tx)
+{
+    uint32_t busy = tx->acked | tx->round;
+    uint32_t span = bulk_span(tx);
+
+    for (uint8_t i = 0; i < span; i++) {
+        if (!(busy & (1UL << i))) {
+            return (int8_t)i;
+        }
+    }
+
+    return -1;
+}
+
+/*============================================================================*/
+/* Sender                                                                     */
+/*============================================================================*/
+
+void rc_bulk_tx_start(rc_bulk_tx_t *tx, const uint8_t *data, uint32_t len, uint32_t now_ms)
+{
+    uint8_t stream = (uint8_t)(tx->stream + 1);
+
+    memset(tx, 0, sizeof(*tx));
+    tx->stream = stream;
+    tx->data = data;
+    tx->len = len;
+    tx->count = len ? (len + RC_BULK_SEGMENT_SIZE - 1) / RC_BULK_SEGMENT_SIZE : 1;
+    tx->state = RC_BULK_ACTIVE;
+    tx->start_ms = now_ms;
+}
+
+bool rc_bulk_tx_ready(const rc_bulk_tx_t *tx)
+{
+    return tx->state == RC_BULK_ACTIVE && bulk_pick(tx) >= 0;
+}
+
+uint8_t rc_bulk_tx_build(rc_bulk_tx_t *tx, uint8_t *out, bool poll)
+{
+    int8_t i = (tx->state == RC_BULK_ACTIVE) ? bulk_pick(tx) : -1;
+    if (i < 0) {
+        return 0;
+    }
+
+    uint32_t segment = tx->base + (uint32_t)i;
+    uint32_t offset = segment * RC_BULK_SEGMENT_SIZE;
+    uint32_t n = tx->len - offset;
+    if (n > RC_BULK_SEGMENT_SIZE) {
+        n = RC_BULK_SEGMENT_SIZE;
+    }
+
+    tx->round |= 1UL << i;
+    tx->sent++;
+    if (segment < tx->next) {
+        tx->resent++;
+    } else {
+        tx->next = segment + 1;
+    }
+
+    /* The last one before the sender has to wait asks for the ACK */
+    uint8_t flags = 0;
+    if (poll || bulk_pick(tx) < 0) {
+        flags |= RC_BULK_POLL;
+    }
+    if (segment == tx->count - 1) {
+        flags |= RC_BULK_FIN;
+    }
+
+    out[0] = flags;
+    out[1] = tx->stream;
+    out[2] = (uint8_t)segment;
+    if (n > 0) {
+        memcpy(&out[RC_BULK_DATA_HEADER], tx->data + offset, n);
+    }
+
+    return (uint8_t)(RC_BULK_DATA_HEADER + n);
+}
+
+uint8_t rc_bulk_tx_on_ack(rc_bulk_tx_t *tx, const uint8_t *payload, uint8_t len,
+                          uint32_t now_ms)
+{
+    if (len < RC_BULK_ACK_LEN || !(payload[0] & RC_BULK_ACK) || tx->state != RC_BULK_ACTIVE) {
+        return 0;
+    }
+
+    uint8_t grant = payload[7];
+
+    /* Receiver has not heard this stream yet, or finished it and moved on */
+    if (payload[0] & RC_BULK_OPEN) {
+        if ((payload[0] & RC_BULK_CLOSED) && payload[1] == tx->stream &&
+            payload[2] == (uint8_t)tx->count && tx->next == tx->count) {
+            tx->base = tx->count;
+            tx->state = RC_BULK_DONE;
+            tx->end_ms = now_ms;
+        }
+        return grant;
+    }
+
+    if (payload[1] != tx->stream) {
+        return 0;       /* About an earlier stream */
+    }
+
+    if (payload[0] & RC_BULK_ABORT) {
+        tx->state = RC_BULK_FAILED;
+        tx->end_ms = now_ms;
+        return 0;
+    }
+
+    /* The receiver's base never passes what was sent */
+    uint8_t delta = (uint8_t)(payload[2] - (uint8_t)tx->base);
+    if (delta > tx->next - tx->base) {
+        return 0;
+    }
+
+    uint32_t mask = (uint32_t)payload[3] | ((uint32_t)payload[4] << 8) |
+                    ((uint32_t)payload[5] << 16) | ((uint32_t)payload[6] << 24);
+
+    tx->base += delta;
+    tx->acked = mask & RC_BULK_WINDOW_MASK;
+    tx->round = 0;  /* Whatever it lacks was lost; ready again */
+
+    if (tx->base == tx->count) {
+        tx->state = RC_BULK_DONE;
+        tx->end_ms = now_ms;
+    }
+
+    return grant;
+}
+
+void rc_bulk_tx_timeout(rc_bulk_tx_t *tx)
+{
+    tx->round = 0;
+}
+
+void rc_bulk_tx_status(const rc_bulk_tx_t *tx, uint32_t now_ms, rc_bulk_status_t *status)
+{
+    memset(status, 0, sizeof(*status));
+    status->state = tx->state;
+
+    if (tx->state == RC_BULK_IDLE) {
+        return;
+    }
+
+    uint64_t acked = (uint64_t)tx->base * RC_BULK_SEGMENT_SIZE;
+
+    status->total = tx->len;
+    status->bytes = acked < tx->len ? (uint32_t)acked : tx->len;
+    status->elapsed_ms = (tx->state == RC_BULK_ACTIVE ? now_ms : tx->end_ms) - tx->start_ms;
+    status->bytes_per_s = bulk_rate(status->bytes, status->elapsed_ms);
+    status->segments = tx->sent;
+    status->repeats = tx->resent;
+}
+
+/*============================================================================*/
+/* Receiver                                                                   */
+/*============================================================================*/
+
+void rc_bulk_rx_start(rc_bulk_rx_t *rx, uint8_t *buffer, uint32_t size)
+{
+    uint8_t stream = rx->stream;
+    bool retired = rx->bound || rx->retired;
+    bool closed = rx->bound ? rx->state == RC_BULK_DONE : rx->closed;
+    uint8_t closed_base = rx->bound ? (uint8_t)rx->base : rx->closed_base;
+
+    memset(rx, 0, sizeof(*rx));
+    rx->buffer = buffer;
+    rx->size = size;
+    rx->stream = stream;
+    rx->retired = retired;
+    rx->closed = closed;
+    rx->closed_base = closed_base;
+    rx->state = RC_BULK_ACTIVE;
+}
+
+bool rc_bulk_rx_on_data(rc_bulk_rx_t *rx, const uint8_t *payload, uint8_t len,
+                        uint32_t now_ms)
+{
+    if (len < RC_BULK_DATA_HEADER || (payload[0] & RC_BULK_ACK) || rx->state == RC_BULK_IDLE) {
+        return false;
+    }
+
+    uint8_t flags = payload[0];
+    bool poll = (flags & RC_BULK_POLL) != 0;
+
+    if (!rx->bound) {
+        if (rx->retired && payload[1] == rx->stream) {
+            return poll && rx->closed;  /* Leftover of the stream received before */
+        }
+        rx->bound = true;
+        rx->stream = payload[1];
+        rx->start_ms = now_ms;
+    } else if (payload[1] != rx->stream) {
+        return false;
+    }
+
+    if (rx->state != RC_BULK_ACTIVE) {
+        rx->duplicates++;
+        return poll;        /* Answered so the sender finishes too */
+    }
+
+    /* Behind base: stored already, the ACK saying so was lost */
+    uint8_t off = (uint8_t)(payload[2] - (uint8_t)rx->base);
+    if (off >= RC_BULK_WINDOW) {
+        rx->duplicates++;
+        return poll;
+    }
+
+    uint32_t segment = rx->base + off;
+    uint8_t n = (uint8_t)(len - RC_BULK_DATA_HEADER);
+    bool fin = (flags & RC_BULK_FIN) != 0;
+
+    /* Only the last segment is short, and there is only one last segment */
+    if ((!fin && n != RC_BULK_SEGMENT_SIZE) ||
+        (rx->count && (segment >= rx->count || (fin && segment != rx->count - 1)))) {
+        return poll;
+    }
+
+    if ((uint64_t)segment * RC_BULK_SEGMENT_SIZE + n > rx->size) {
+        rx->state = RC_BULK_FAILED;
+        rx->end_ms = now_ms;
+        return true;        /* The ACK tells the sender to stop */
+    }
+
+    if (rx->mask & (1UL << off)) {
+        rx->duplicates++;
+        return poll;
+    }
+
+    memcpy(rx->buffer + segment * RC_BULK_SEGMENT_SIZE, &payload[RC_BULK_DATA_HEADER], n);
+    rx->mask |= 1UL << off;
+    rx->stored++;
+
+    if (fin) {
+        rx->count = segment + 1;
+        rx->len = segment * RC_BULK_SEGMENT_SIZE + n;
+    }
+
+    while (rx->mask & 1U) {
+        rx->mask >>= 1;
+        rx->base++;
+    }
+
+    if (rx->count && rx->base == rx->count) {
+        rx->state = RC_BULK_DONE;
+        rx->end_ms = now_ms;
+    }
+
+    return poll;
+}
+
+uint8_t rc_bulk_rx_build_ack(const rc_bulk_rx_t *rx, uint8_t *out, uint8_t grant)
+{
+    uint8_t flags = RC_BULK_ACK;
+    uint8_t base = (uint8_t)rx->base;
+
+    if (!rx->bound) {
+        flags |= RC_BULK_OPEN;
+        if (rx->closed) {
+            flags |= RC_BULK_CLOSED;
+            base = rx->closed_base;
+        }
+    }
+    if (rx->state == RC_BULK_FAILED) {
+        flags |= RC_BULK_ABORT;
+    }
+
+    out[0] = flags;
+    out[1] = rx->stream;
+    out[2] = base;
+    out[3] = (uint8_t)rx->mask;
+    out[4] = (uint8_t)(rx->mask >> 8);
+    out[5] = (uint8_t)(rx->mask >> 16);
+    out[6] = (uint8_t)(rx->mask >> 24);
+    out[7] = grant;
+
+    return RC_BULK_ACK_LEN;
+}
+
+void rc_bulk_rx_status(const rc_bulk_rx_t *rx, uint32_t now_ms, rc_bulk_status_t *status)
+{
+    memset(status, 0, sizeof(*status));
+    status->state = rx->state;
+
+    if (!rx->bound) {
+        return;
+    }
+
+    uint64_t in_order = (uint64_t)rx->base * RC_BULK_SEGMENT_SIZE;
+
+    status->total = rx->count ? rx->len : 0;
+    status->bytes = (rx->count && rx->base == rx->count) ? rx->len : (uint32_t)in_order;
+    status->elapsed_ms = (rx->state == RC_BULK_ACTIVE ? now_ms : rx->end_ms) - rx->start_ms;
+    status->bytes_per_s = bulk_rate(status->bytes, status->elapsed_ms);
+    status->segments = rx->stored;
+    status->repeats = rx->duplicates;
+}
@@ -0,0 +1,103 @@
+/**
+* @file channel_pack.c
+ * @brief Bit-packed RC channel encoding
+ */
+
+#include "channel_pack.h"
+
+/*
+ * Both directions run a 32-bit accumulator instead of addressing individual
+ * bits: each channel is OR-ed in with one shift and whole bytes are flushed
+ * as they fill. At most 7 + 11 bits are ever held, so nothing overflows.
+ */
+
+static void pack_bits(uint8_t *out, const uint16_t *channels, uint8_t count,
+                      uint8_t bits)
+{
+    uint32_t acc = 0;
+    uint8_t acc_bits = 0;
+    uint8_t drop = 11 - bits;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t value = channels[i];
+        if (value > RC_CHANNEL_MAX) {
+            value = RC_CHANNEL_MAX;
+        }
+
+        acc |= (uint32_t)(value >> drop) << acc_bits;
+        acc_bits += bits;
+
+        while (acc_bits >= 8) {
+            *out++ = (uint8_t)acc;
+            acc >>= 8;
+            acc_bits -= 8;
+        }
+    }
+
+    if (acc_bits > 0) {
+        *out = (uint8_t)acc;
+    }
+}
+
+static void unpack_bits(uint16_t *channels, const uint8_t *in, uint8_t count,
+                        uint8_t bits)
+{
+    uint32_t acc = 0;
+    uint8_t acc_bits = 0;
+    uint8_t drop = 11 - bits;
+    uint32_t mask = (1u << bits) - 1;
+
+    for (uint8_t i = 0; i < count; i++) {
+        while (acc_bits < bits) {
+            acc |= (uint32_t)*in++ << acc_bits;
+            acc_bits += 8;
+        }
+
+        channels[i] = (uint16_t)((acc & mask) << drop);
+        acc >>= bits;
+        acc_bits -= bits;
+    }
+}
+
+void rc_channels_pack_11bit(uint8_t *out, const uint16_t *channels, uint8_t count)
+{
+    pack_bits(out, channels, count, 11);
+}
+
+void rc_channels_unpack_11bit(uint16_t *channels, const uint8_t *in, uint8_t count)
+{
+    unpack_bits(channels, in, count, 11);
+}
+
+void rc_channels_pack_10bit(uint8_t *out, const uint16_t *channels, uint8_t count)
+{
+    pack_bits(out, channels, count, 10);
+}
+
+void rc_channels_unpack_10bit(uint16_t *channels, const uint8_t *in, uint8_t count)
+{
+    unpack_bits(channels, in, count, 10);
+}
+
+void rc_channels_encode(const rc_channels_t *channels, rc_channels_payload_t *payload)
+{
+    rc_channels_pack_11bit(payload->channels, channels->channels, RC_CHANNELS_HIRES);
+#if RC_CHANNELS_LORES > 0
+    rc_channels_pack_10bit(&payload->channels[RC_CHANNEL_PACKED_BYTES(RC_CHANNELS_HIRES, 11)],
+                           &channels->channels[RC_CHANNELS_HIRES], RC_CHANNELS_LORES);
+#endif
+    payload->switches = channels->switches;
+    payload->mode = channels->mode;
+}
+
+void rc_channels_decode(const rc_channels_payload_t *payload, rc_channels_t *channels)
+{
+    rc_channels_unpack_11bit(channels->channels, payload->channels, RC_CHANNELS_HIRES);
+#if RC_CHANNELS_LORES > 0
+    rc_channels_unpack_10bit(&channels->channels[RC_CHANNELS_HIRES],
+                             &payload->channels[RC_CHANNEL_PACKED_BYTES(RC_CHANNELS_HIRES, 11)],
+                             RC_CHANNELS_LORES);
+#endif
+    channels->switches = payload->switches;
+    channels->mode = payload->mode;
+}
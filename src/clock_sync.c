@@ -0,0 +1,49 @@
+/**
+* @file clock_sync.c
+ * @brief Round-trip filter for clock sync
+ */
+
+#include "clock_sync.h"
+#include <string.h>
+
+/*============================================================================*/
+/* Filter                                                                     */
+/*============================================================================*/
+
+void rc_sync_reset(rc_sync_filter_t *filter)
+{
+    memset(filter, 0, sizeof(*filter));
+}
+
+void rc_sync_add(rc_sync_filter_t *filter, uint32_t rtt_us, int32_t offset_us)
+{
+    filter->rtt_us[filter->next] = rtt_us;
+    filter->offset_us[filter->next] = offset_us;
+    filter->next = (uint8_t)((filter->next + 1) % RC_SYNC_WINDOW);
+
+    if (filter->count < RC_SYNC_WINDOW) {
+        filter->count++;
+    }
+}
+
+bool rc_sync_estimate(const rc_sync_filter_t *filter, uint32_t *rtt_us, int32_t *offset_us)
+{
+    if (filter->count == 0) {
+        return false;
+    }
+
+    /* Newest first, so a tie keeps the newer sample */
+    uint8_t best = (uint8_t)((filter->next + RC_SYNC_WINDOW - 1) % RC_SYNC_WINDOW);
+
+    for (uint8_t age = 1; age < filter->count; age++) {
+        uint8_t i = (uint8_t)((filter->next + RC_SYNC_WINDOW - 1 - age) % RC_SYNC_WINDOW);
+
+        if (filter->rtt_us[i] < filter->rtt_us[best]) {
+            best = i;
+        }
+    }
+
+    *rtt_us = filter->rtt_us[best];
+    *offset_us = filter->offset_us[best];
+    return true;
+}
@@ -0,0 +1,271 @@
+/**
+* @file fec.c
+ * @brief Reed-Solomon forward error correction
+ */
+
+#include "fec.h"
+#include <string.h>
+
+/* Field generator polynomial: x^8 + x^4 + x^3 + x^2 + 1 */
+#define GF_POLYNOMIAL   0x11D
+
+/*============================================================================*/
+/* Lookup Tables                                                              */
+/*============================================================================*/
+
+/* α^i for i = 0..509, so the sum of two logs needs no reduction */
+static const uint8_t gf_exp[510] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8,
+    0xCD, 0x87, 0x13, 0x26, 0x4C, 0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9,
+    0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x9D, 0x27, 0x4E, 0x9C,
+    0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23,
+    0x46, 0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2,
+    0xB9, 0x6F, 0xDE, 0xA1, 0x5F, 0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC,
+    0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0xFD, 0xE7, 0xD3, 0xBB,
+    0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2,
+    0xD9, 0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68,
+    0xD0, 0xBD, 0x67, 0xCE, 0x81, 0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93,
+    0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC, 0x85, 0x17, 0x2E, 0x5C,
+    0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54,
+    0xA8, 0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72,
+    0xE4, 0xD5, 0xB7, 0x73, 0xE6, 0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E,
+    0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF, 0xE3, 0xDB, 0xAB, 0x4B,
+    0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41,
+    0x82, 0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0,
+    0xDD, 0xA7, 0x53, 0xA6, 0x51, 0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF,
+    0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09, 0x12, 0x24, 0x48, 0x90,
+    0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16,
+    0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8,
+    0xAD, 0x47, 0x8E, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D,
+    0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26, 0x4C, 0x98, 0x2D, 0x5A, 0xB4,
+    0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x9D,
+    0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE,
+    0xC1, 0x9F, 0x23, 0x46, 0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D,
+    0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1, 0x5F, 0xBE, 0x61, 0xC2, 0x99,
+    0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0xFD,
+    0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B,
+    0xB6, 0x71, 0xE2, 0xD9, 0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D,
+    0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE, 0x81, 0x1F, 0x3E, 0x7C, 0xF8,
+    0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC, 0x85,
+    0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84,
+    0x15, 0x2A, 0x54, 0xA8, 0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49,
+    0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73, 0xE6, 0xD1, 0xBF, 0x63, 0xC6,
+    0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF, 0xE3,
+    0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5,
+    0x57, 0xAE, 0x41, 0x82, 0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C,
+    0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6, 0x51, 0xA2, 0x59, 0xB2, 0x79,
+    0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09, 0x12,
+    0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB,
+    0x8B, 0x0B, 0x16, 0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B,
+    0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E
+};
+
+/* log_α(x); gf_log[0] is unused */
+static const uint8_t gf_log[256] = {
+    0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1A, 0xC6, 0x03, 0xDF, 0x33, 0xEE,
+    0x1B, 0x68, 0xC7, 0x4B, 0x04, 0x64, 0xE0, 0x0E, 0x34, 0x8D, 0xEF, 0x81,
+    0x1C, 0xC1, 0x69, 0xF8, 0xC8, 0x08, 0x4C, 0x71, 0x05, 0x8A, 0x65, 0x2F,
+    0xE1, 0x24, 0x0F, 0x21, 0x35, 0x93, 0x8E, 0xDA, 0xF0, 0x12, 0x82, 0x45,
+    0x1D, 0xB5, 0xC2, 0x7D, 0x6A, 0x27, 0xF9, 0xB9, 0xC9, 0x9A, 0x09, 0x78,
+    0x4D, 0xE4, 0x72, 0xA6, 0x06, 0xBF, 0x8B, 0x62, 0x66, 0xDD, 0x30, 0xFD,
+    0xE2, 0x98, 0x25, 0xB3, 0x10, 0x91, 0x22, 0x88, 0x36, 0xD0, 0x94, 0xCE,
+    0x8F, 0x96, 0xDB, 0xBD, 0xF1, 0xD2, 0x13, 0x5C, 0x83, 0x38, 0x46, 0x40,
+    0x1E, 0x42, 0xB6, 0xA3, 0xC3, 0x48, 0x7E, 0x6E, 0x6B, 0x3A, 0x28, 0x54,
+    0xFA, 0x85, 0xBA, 0x3D, 0xCA, 0x5E, 0x9B, 0x9F, 0x0A, 0x15, 0x79, 0x2B,
+    0x4E, 0xD4, 0xE5, 0xAC, 0x73, 0xF3, 0xA7, 0x57, 0x07, 0x70, 0xC0, 0xF7,
+    0x8C, 0x80, 0x63, 0x0D, 0x67, 0x4A, 0xDE, 0xED, 0x31, 0xC5, 0xFE, 0x18,
+    0xE3, 0xA5, 0x99, 0x77, 0x26, 0xB8, 0xB4, 0x7C, 0x11, 0x44, 0x92, 0xD9,
+    0x23, 0x20, 0x89, 0x2E, 0x37, 0x3F, 0xD1, 0x5B, 0x95, 0xBC, 0xCF, 0xCD,
+    0x90, 0x87, 0x97, 0xB2, 0xDC, 0xFC, 0xBE, 0x61, 0xF2, 0x56, 0xD3, 0xAB,
+    0x14, 0x2A, 0x5D, 0x9E, 0x84, 0x3C, 0x39, 0x53, 0x47, 0x6D, 0x41, 0xA2,
+    0x1F, 0x2D, 0x43, 0xD8, 0xB7, 0x7B, 0xA4, 0x76, 0xC4, 0x17, 0x49, 0xEC,
+    0x7F, 0x0C, 0x6F, 0xF6, 0x6C, 0xA1, 0x3B, 0x52, 0x29, 0x9D, 0x55, 0xAA,
+    0xFB, 0x60, 0x86, 0xB1, 0xBB, 0xCC, 0x3E, 0x5A, 0xCB, 0x59, 0x5F, 0xB0,
+    0x9C, 0xA9, 0xA0, 0x51, 0x0B, 0xF5, 0x16, 0xEB, 0x7A, 0x75, 0x2C, 0xD7,
+    0x4F, 0xAE, 0xD5, 0xE9, 0xE6, 0xE7, 0xAD, 0xE8, 0x74, 0xD6, 0xF4, 0xEA,
+    0xA8, 0x50, 0x58, 0xAF
+};
+
+/* log_α of the generator coefficients below the leading 1, highest first */
+#if RC_FEC_PARITY == 2
+static const uint8_t gen_log[RC_FEC_PARITY] = { 0x19, 0x01 };
+#else
+static const uint8_t gen_log[RC_FEC_PARITY] = { 0x4B, 0xF9, 0x4E, 0x06 };
+#endif
+
+/*============================================================================*/
+/* Field Arithmetic                                                           */
+/*============================================================================*/
+
+static inline uint8_t gf_mul(uint8_t a, uint8_t b)
+{
+    return (a && b) ? gf_exp[gf_log[a] + gf_log[b]] : 0;
+}
+
+static inline uint8_t gf_div(uint8_t a, uint8_t b)
+{
+    /* b != 0 */
+    return a ? gf_exp[gf_log[a] + 255 - gf_log[b]] : 0;
+}
+
+/* p(α^-e) for p of the given degree, coefficients lowest first */
+static uint8_t gf_eval_inverse(const uint8_t *p, uint8_t degree, uint8_t e)
+{
+    uint8_t sum = p[0];
+    uint16_t step = (uint16_t)(255 - e) % 255;
+    uint16_t power = 0;
+
+    for (uint8_t i = 1; i <= degree; i++) {
+        power = (uint16_t)((power + step) % 255);
+        if (p[i]) {
+            sum ^= gf_exp[gf_log[p[i]] + power];
+        }
+    }
+
+    return sum;
+}
+
+/*============================================================================*/
+/* Public API                                                                 */
+/*============================================================================*/
+
+void rc_fec_encode(uint8_t *codeword, uint8_t len)
+{
+    uint8_t data_len = (uint8_t)(len - RC_FEC_PARITY);
+    uint8_t *parity = codeword + data_len;
+
+    memset(parity, 0, RC_FEC_PARITY);
+
+    /* Remainder of data(x) * x^P / g(x), parity[0] highest degree */
+    for (uint8_t i = 0; i < data_len; i++) {
+        uint8_t feedback = codeword[i] ^ parity[0];
+
+        memmove(parity, parity + 1, RC_FEC_PARITY - 1);
+        parity[RC_FEC_PARITY - 1] = 0;
+
+        if (feedback) {
+            uint8_t log_fb = gf_log[feedback];
+            for (uint8_t j = 0; j < RC_FEC_PARITY; j++) {
+                parity[j] ^= gf_exp[log_fb + gen_log[j]];
+            }
+        }
+    }
+}
+
+int8_t rc_fec_decode(uint8_t *codeword, uint8_t len)
+{
+    /* Syndromes S_j = c(α^j), codeword[0] highest degree */
+    uint8_t syndrome[RC_FEC_PARITY] = {0};
+    uint8_t damaged = 0;
+
+    for (uint8_t i = 0; i < len; i++) {
+        uint8_t c = codeword[i];
+        syndrome[0] ^= c;
+        for (uint8_t j = 1; j < RC_FEC_PARITY; j++) {
+            uint8_t s = syndrome[j];
+            syndrome[j] = (s ? gf_exp[gf_log[s] + j] : 0) ^ c;
+        }
+    }
+
+    for (uint8_t j = 0; j < RC_FEC_PARITY; j++) {
+        damaged |= syndrome[j];
+    }
+
+    if (!damaged) {
+        return 0;
+    }
+
+    /* Berlekamp-Massey: error locator Λ(x), lowest coefficient first */
+    uint8_t lambda[RC_FEC_PARITY + 1] = {1};
+    uint8_t prev[RC_FEC_PARITY + 1] = {1};
+    uint8_t errors = 0;
+    uint8_t shift = 1;
+    uint8_t prev_discrepancy = 1;
+
+    for (uint8_t n = 0; n < RC_FEC_PARITY; n++) {
+        uint8_t discrepancy = syndrome[n];
+        for (uint8_t i = 1; i <= errors; i++) {
+            discrepancy ^= gf_mul(lambda[i], syndrome[n - i]);
+        }
+
+        if (!discrepancy) {
+            shift++;
+            continue;
+        }
+
+        uint8_t scale = gf_div(discrepancy, prev_discrepancy);
+        uint8_t saved[RC_FEC_PARITY + 1];
+        memcpy(saved, lambda, sizeof(saved));
+
+        for (uint8_t i = 0; i + shift <= RC_FEC_PARITY; i++) {
+            lambda[i + shift] ^= gf_mul(scale, prev[i]);
+        }
+
+        if (2 * errors <= n) {
+            errors = (uint8_t)(n + 1 - errors);
+            memcpy(prev, saved, sizeof(prev));
+            prev_discrepancy = discrepancy;
+            shift = 1;
+        } else {
+            shift++;
+        }
+    }
+
+    if (errors > RC_FEC_CORRECTABLE) {
+        return RC_FEC_UNCORRECTABLE;
+    }
+
+    /* Error evaluator Ω(x) = S(x) Λ(x) mod x^P */
+    uint8_t omega[RC_FEC_PARITY];
+    for (uint8_t k = 0; k < RC_FEC_PARITY; k++) {
+        omega[k] = 0;
+        for (uint8_t i = 0; i <= k && i <= errors; i++) {
+            omega[k] ^= gf_mul(lambda[i], syndrome[k - i]);
+        }
+    }
+
+    /* Formal derivative Λ'(x): odd terms only in characteristic 2 */
+    uint8_t derivative[RC_FEC_PARITY] = {0};
+    for (uint8_t i = 1; i <= errors; i += 2) {
+        derivative[i - 1] = lambda[i];
+    }
+
+    /* Chien search over the codeword's own positions only: a root in the
+     * shortened-away part means more damage than the code can locate */
+    uint8_t position[RC_FEC_CORRECTABLE];
+    uint8_t magnitude[RC_FEC_CORRECTABLE];
+    uint8_t found = 0;
+
+    for (uint8_t i = 0; i < len; i++) {
+        uint8_t degree = (uint8_t)(len - 1 - i);
+
+        if (gf_eval_inverse(lambda, errors, degree) != 0) {
+            continue;
+        }
+
+        if (found == errors) {
+            return RC_FEC_UNCORRECTABLE;
+        }
+
+        /* Forney with first root α^0: e = X Ω(X^-1) / Λ'(X^-1), X = α^degree */
+        uint8_t num = gf_eval_inverse(omega, RC_FEC_PARITY - 1, degree);
+        uint8_t den = gf_eval_inverse(derivative, RC_FEC_PARITY - 1, degree);
+        if (!den) {
+            return RC_FEC_UNCORRECTABLE;
+        }
+
+        position[found] = i;
+        magnitude[found] = gf_mul(gf_div(num, den), gf_exp[degree]);
+        found++;
+    }
+
+    if (found != errors) {
+        return RC_FEC_UNCORRECTABLE;
+    }
+
+    for (uint8_t k = 0; k < found; k++) {
+        codeword[position[k]] ^= magnitude[k];
+    }
+
+    return (int8_t)found;
+}
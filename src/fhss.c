@@ -0,0 +1,99 @@
+/**
+* @file fhss.c
+ * @brief Frequency hopping table generation
+ */
+
+#include "fhss.h"
+#include <string.h>
+
+#define FHSS_SPAN   (RC_FHSS_CHANNEL_MAX - RC_FHSS_CHANNEL_MIN + 1)
+
+/* Salt for the blacklist substitution stream, keeps it apart from the base */
+#define FHSS_SUBST_SALT     0x9E3779B9UL
+
+static uint32_t fhss_random(uint32_t *state)
+{
+    /* xorshift32 - identical on every platform, state never reaches 0 */
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static bool fhss_spaced(uint8_t channel, int16_t neighbour)
+{
+    if (neighbour < 0) {
+        return true;
+    }
+
+    int16_t distance = (int16_t)channel - neighbour;
+    return distance >= RC_FHSS_MIN_SPACING || distance <= -RC_FHSS_MIN_SPACING;
+}
+
+/*
+ * Probe linearly from a random start for a channel not in 'excluded' and
+ * spaced from both neighbours. Relax the spacing, then the exclusion,
+ * rather than fail: a table entry is always produced.
+ */
+static uint8_t fhss_pick(uint32_t *state, const uint8_t *excluded,
+                         int16_t prev, int16_t next)
+{
+    uint8_t start = (uint8_t)(fhss_random(state) % FHSS_SPAN);
+
+    for (uint8_t pass = 0; pass < 3; pass++) {
+        for (uint8_t i = 0; i < FHSS_SPAN; i++) {
+            uint8_t channel = RC_FHSS_CHANNEL_MIN + (uint8_t)((start + i) % FHSS_SPAN);
+
+            if (pass < 2 && rc_fhss_map_test(excluded, channel)) {
+                continue;
+            }
+            if (pass == 0 && !(fhss_spaced(channel, prev) && fhss_spaced(channel, next))) {
+                continue;
+            }
+
+            return channel;
+        }
+    }
+
+    return RC_FHSS_CHANNEL_MIN;  /* Not reached */
+}
+
+void rc_fhss_build_table(uint8_t *channels, uint32_t bind_id, const uint8_t *blacklist)
+{
+    uint8_t used[RC_FHSS_MAP_BYTES];
+    memset(used, 0, sizeof(used));
+
+    /* Base table from the bind ID alone */
+    uint32_t state = bind_id ? bind_id : 1;
+
+    for (uint8_t slot = 0; slot < RC_FHSS_HOP_COUNT; slot++) {
+        int16_t prev = slot ? channels[slot - 1] : -1;
+        channels[slot] = fhss_pick(&state, used, prev, -1);
+        rc_fhss_map_set(used, channels[slot]);
+    }
+
+    if (!blacklist) {
+        return;
+    }
+
+    /* Substitute blacklisted slots only, in slot order */
+    uint8_t excluded[RC_FHSS_MAP_BYTES];
+    for (uint8_t i = 0; i < RC_FHSS_MAP_BYTES; i++) {
+        excluded[i] = used[i] | blacklist[i];
+    }
+
+    state = (bind_id ^ FHSS_SUBST_SALT) ? (bind_id ^ FHSS_SUBST_SALT) : 1;
+
+    for (uint8_t slot = 0; slot < RC_FHSS_HOP_COUNT; slot++) {
+        if (!rc_fhss_map_test(blacklist, channels[slot])) {
+            continue;
+        }
+
+        int16_t prev = slot ? channels[slot - 1] : -1;
+        int16_t next = (slot + 1 < RC_FHSS_HOP_COUNT) ? channels[slot + 1] : -1;
+        channels[slot] = fhss_pick(&state, excluded, prev, next);
+        rc_fhss_map_set(excluded, channels[slot]);
+    }
+}
@@ -6,9 +6,119 @@
 #include "nrf_rc_driver.h"
 #include "packet.h"
 #include "crc.h"
+#if RC_ENABLE_FEC
+#include "fec.h"
+#endif
 #include "../drivers/include/nrf24.h"
+#include <stddef.h>
 #include <string.h>
 
+#if RC_ENABLE_IRQ
+#include <stdatomic.h>
+#endif
+
+#if RC_ENABLE_TDMA || RC_ENABLE_TRACE
+#include "nrf24_config.h"
+#endif
+
+/*============================================================================*/
+/* Private Constants                                                          */
+/*============================================================================*/
+
+/** Give up on a TX completion IRQ after this long (matches nrf24_transmit) */
+#define RC_IRQ_TX_TIMEOUT_MS    10
+
+/** Frames are trimmed to header + payload + CRC (ACK payloads need DPL) */
+#define RC_DYNAMIC_FRAMES       (RC_ENABLE_DYNAMIC_PAYLOAD || RC_ENABLE_ACK_TELEMETRY)
+
+/** Commands go out more than once (RC_NO_ACK_REPEATS) */
+#define RC_NO_ACK_REPEAT        (RC_ENABLE_NO_ACK && RC_NO_ACK_REPEATS > 1)
+
+/** Some frames go out as W_TX_PAYLOAD_NOACK (needs EN_DYN_ACK) */
+#define RC_TX_NO_ACK            (RC_ENABLE_NO_ACK || RC_ENABLE_BULK)
+
+/** The IRQ stamps commands with the cycle count they arrived at */
+#define RC_RX_STAMP             (RC_ENABLE_MAILBOX && (RC_ENABLE_COMMAND_CALLBACK || RC_ENABLE_PREDICT))
+
+/** Bits of a link-quality history window */
+#define RC_LQ_MASK              (0xFFFFFFFFUL >> (32 - RC_LQ_WINDOW))
+
+/** RX frame pool: a full ring, a FIFO drain, the RX view and a frame being unpacked */
+#define RC_RX_POOL_SIZE         (RC_RX_RING_SIZE + NRF24_FIFO_DEPTH + 2)
+
+/** rx_held when no frame is lent out */
+#define RC_RX_NONE              0xFF
+
+#if RC_ENABLE_LINK_ADAPT
+/** Entries of adapt_profiles[] (must fit RC_FLAG_PROFILE_MASK) */
+#define RC_ADAPT_PROFILES       4
+
+/** Profile both ends boot into and fall back to: 250 kbps */
+#define RC_ADAPT_HOME           0
+
+/** Hold after a failed step-up doubles up to 2^this times RC_ADAPT_HOLD_MS */
+#define RC_ADAPT_MAX_BACKOFF    4
+#endif
+
+#if RC_ENABLE_DIVERSITY
+/** Frames the diversity combiner remembers, by sequence (power of two) */
+#define RC_DIV_SLOTS            16
+#endif
+
+#if RC_ENABLE_BULK
+/** Gaps the ground acknowledges a finished pull in again, in case the ACK is lost */
+#define RC_BULK_LINGER          8
+#endif
+
+#if RC_ENABLE_TIERED_COMMAND
+/** Aux slots of a tiered command: the channels after the sticks, then switches/mode */
+#define RC_TIER_SLOTS           (RC_COMMAND_CHANNELS - RC_TIER_STICKS + 1)
+#define RC_TIER_SLOT_SWITCHES   (RC_TIER_SLOTS - 1)
+
+/** tier_pending_slot of a full command */
+#define RC_TIER_KEYFRAME        0xFF
+#endif
+
+/* Latency stamps - expand to nothing without RC_ENABLE_LATENCY_STATS */
+#if RC_ENABLE_LATENCY_STATS
+#define LATENCY_MARK(var)               uint32_t var = nrf24_cycle_count()
+#define LATENCY_RECORD(link, stage, t0) latency_record((link), (stage), (t0))
+#define LATENCY_RX_READY(link)          ((link)->lat_rx_ready = nrf24_cycle_count())
+#define LATENCY_TX_START(link)          ((link)->lat_tx_mark = nrf24_cycle_count())
+#define LATENCY_TX_UPLOADED(link)       latency_tx_uploaded(link)
+#else
+#define LATENCY_MARK(var)               ((void)0)
+#define LATENCY_RECORD(link, stage, t0) ((void)0)
+#define LATENCY_RX_READY(link)          ((void)0)
+#define LATENCY_TX_START(link)          ((void)0)
+#define LATENCY_TX_UPLOADED(link)       ((void)0)
+#endif
+
+/* Trace records - expand to nothing without RC_ENABLE_TRACE */
+#if RC_ENABLE_TRACE
+#define TRACE_RECORD(link, event, status, type, count, seq)                     \
+    rc_trace_record(&(link)->trace, nrf24_cycle_count(), (event), (uint8_t)(status), \
+                    (type), (count), (seq), (link)->radio->channel)
+#else
+#define TRACE_RECORD(link, event, status, type, count, seq) ((void)0)
+#endif
+
+/* Retransmits for a TX record, where the build reads them anyway; a
+ * frame that hit MAX_RT used them all */
+#if RC_ENABLE_RSSI || RC_ENABLE_LINK_ADAPT
+#define TRACE_RETRIES(retries)          ((retries) < RC_AUTO_RETRANSMIT_COUNT ? (retries) \
+                                                                          : RC_AUTO_RETRANSMIT_COUNT)
+#else
+#define TRACE_RETRIES(retries)          RC_TRACE_COUNT_UNKNOWN
+#endif
+
+/* On the bind channel - always false without RC_ENABLE_BIND */
+#if RC_ENABLE_BIND
+#define BIND_RUNNING(link)              ((link)->bind_state == RC_BIND_RUNNING)
+#else
+#define BIND_RUNNING(link)              false
+#endif
+
 /*============================================================================*/
 /* Private Types                                                              */
 /*============================================================================*/
@@ -21,6 +131,74 @@ typedef enum {
     RC_ROLE_AIRCRAFT    /* Aircraft */
 } rc_role_t;
 
+#if RC_ENABLE_TDMA
+/**
+ * @brief Frame waiting for its TDMA slot
+ */
+typedef struct {
+    uint8_t type;
+    uint8_t len;                    /* 0 = empty */
+    uint8_t payload[RC_MAX_PAYLOAD_SIZE];
+} rc_tdma_frame_t;
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+/**
+ * @brief Rung of the link adaptation ladder
+ */
+typedef struct {
+    nrf24_data_rate_t rate;
+    nrf24_tx_power_t power;
+    uint8_t retransmit_delay;       /* Minimum ARD, room for a full ACK payload */
+} rc_adapt_profile_t;
+#endif
+
+#if RC_ENABLE_MAILBOX
+/**
+ * @brief Telemetry frame queued by the control loop for the IRQ
+ */
+typedef struct {
+    uint8_t type;
+    uint8_t len;
+    uint8_t payload[RC_MAX_PAYLOAD_SIZE];
+} rc_mailbox_frame_t;
+#endif
+
+#if RC_ENABLE_DIVERSITY
+/**
+ * @brief Frame the diversity combiner has let through
+ */
+typedef struct {
+    bool used;
+    uint8_t sequence;
+    rc_crc_t crc;                   /* Tells a resent sequence from a copy */
+} rc_div_slot_t;
+#endif
+
+#if RC_ENABLE_CLOCK_SYNC
+/**
+ * @brief Where the ground's last ping is
+ */
+typedef enum {
+    RC_SYNC_IDLE,       /* Nothing to time */
+    RC_SYNC_ARMED,      /* Encoded, stamped as it goes to the radio */
+    RC_SYNC_SENT,       /* Waiting for its ACK */
+    RC_SYNC_ACKED       /* Round trip known, waiting for the echo */
+} rc_sync_state_t;
+#endif
+
+#if RC_ENABLE_TX_QUEUE
+/**
+ * @brief Packet sitting in the radio's TX FIFO
+ */
+typedef struct {
+    uint8_t type;
+    uint8_t sequence;
+    uint8_t len;                    /* Bytes on air */
+    rc_packet_t frame;              /* Kept for re-upload after MAX_RT */
+} rc_txq_entry_t;
+#endif
+
 /**
  * @brief Link state
  */
@@ -28,6 +206,7 @@ struct rc_link {
     /* Hardware */
     rc_hardware_config_t hw;
     nrf24_t nrf24;
+    nrf24_t *radio;             /* &nrf24, or the host's radio for a peer */
 
     /* Protocol state */
     rc_role_t role;
@@ -39,37 +218,538 @@ struct rc_link {
 
     /* Link state */
     uint32_t last_rx_time;
+    uint32_t last_rx_us;        /* The same frame, from tick_us() */
     bool link_active;
     uint8_t consecutive_missed;
+#if RC_ENABLE_STATISTICS
+    uint32_t loss_rx_time;      /* last_rx_time when the link was lost */
+    bool loss_pending;          /* Lost, reconnect not counted yet */
+#endif
 
     /* Failsafe */
     rc_command_payload_t failsafe_command;
+    rc_channels_payload_t failsafe_channels;    /* failsafe_command packed, for RX views */
     bool failsafe_active;
 
+    /* Link quality - bit 0 is the newest expected packet, set if it arrived */
+    uint32_t lq_window;
+    uint8_t lq_filled;          /* Valid bits in lq_window */
+    uint8_t lq_aged;            /* Misses counted by silence since the last arrival */
+    uint8_t link_quality;       /* 0-100 */
+
+#if RC_ENABLE_RSSI
+    /* Signal estimate */
+    uint32_t rpd_window;        /* Bit per RX drain, set if RPD was high */
+    uint8_t rpd_filled;
+    uint8_t rpd_percent;
+    uint16_t arc_avg;           /* Retransmits per send x16, moving average */
+    bool arc_valid;
+    uint8_t rssi;               /* 0-100 */
+#endif
+
     /* Buffers */
     rc_packet_t tx_packet;
-    rc_packet_t rx_packet;
+    uint8_t tx_len;             /* Bytes of tx_packet to put on air */
+    const rc_packet_t *rx_packet;   /* Frame being decoded, validated in place */
+    uint8_t rx_len;
+    uint32_t rx_us;             /* tick_us() at the RX_DR that brought it */
+
+    /* Zero-copy send - frame opened by rc_link_tx_acquire() */
+    uint8_t *tx_open;           /* Payload being written, NULL if none */
+    uint8_t tx_open_type;
+    uint8_t tx_open_len;        /* Payload length announced at acquire */
+    uint8_t tx_open_fill;       /* Payload bytes already in tx_open_crc */
+    rc_crc_t tx_open_crc;       /* Header CRC, then each write folded in */
+
+    /* RX ring - whole FIFO drains, taken by type (bus held with RC_ENABLE_IRQ).
+     * Entries index rx_pool, so frames are read, validated and handed out
+     * without moving */
+    rc_packet_t rx_pool[RC_RX_POOL_SIZE];
+    uint8_t rx_pool_len[RC_RX_POOL_SIZE];
+    uint32_t rx_pool_us[RC_RX_POOL_SIZE];   /* rx_ready_us of each entry */
+    bool rx_pool_used[RC_RX_POOL_SIZE]; /* In the ring or lent out */
+    uint8_t rx_ring[RC_RX_RING_SIZE];   /* Pool indices */
+    uint8_t rx_ring_head;       /* Oldest entry */
+    uint8_t rx_ring_count;
+    uint8_t rx_held;            /* Pool entry lent by rc_link_rx_acquire(), or RC_RX_NONE */
+    uint32_t rx_ready_us;       /* tick_us() at the last RX_DR serviced */
+
+#if RC_ENABLE_IRQ
+    /* Interrupt-driven operation */
+    atomic_flag bus_lock;           /* Held by whoever is using SPI */
+    volatile bool irq_deferred;     /* IRQ arrived while the bus was held */
+    uint32_t tx_start_time;         /* Tick of the last started TX */
+#endif
+#if RC_ENABLE_REPLY_WINDOW
+    uint32_t reply_until_us;        /* Ground sends held until then (tick_us) */
+#endif
+
+#if RC_ENABLE_SPI_DMA
+    /* Async operations */
+    rc_async_callback_t async_callback;
+    void *async_ctx;
+    volatile bool async_tx_active;  /* In-flight TX came from an async send */
+    uint8_t async_tx_type;          /* Packet type of that TX */
+    void *volatile async_rx_buffer; /* Armed receive destination */
+    volatile uint8_t async_rx_type; /* Packet type the armed receive wants */
+#endif
+
+#if RC_ENABLE_TX_QUEUE
+    /* Pipelined sends - mirrors the TX FIFO, oldest first (bus held) */
+    rc_txq_entry_t txq[NRF24_FIFO_DEPTH];
+    uint8_t txq_head;
+    uint8_t txq_count;
+    rc_tx_complete_t txq_callback;
+    void *txq_ctx;
+#endif
+
+#if RC_ENABLE_MAILBOX
+    /* Control loop mailbox - newest command published by the IRQ under a
+     * seqlock, telemetry queued the other way (SPSC) */
+    atomic_uint mb_seq;                 /* Odd while the IRQ is writing */
+    rc_command_payload_t mb_command;
+    uint32_t mb_rx_time;                /* Tick the command was decoded */
+    uint8_t mb_sequence;
+    uint32_t mb_count;                  /* Commands published */
+    uint32_t mb_seen;                   /* mb_count last returned by rc_link_receive_command() */
+#if RC_RX_STAMP
+    uint32_t mb_irq_cycles;             /* Cycle count of the last RX interrupt */
+    uint32_t mb_rx_cycles;              /* ... of the one mb_command arrived with */
+#endif
+#if RC_ENABLE_COMMAND_CALLBACK
+    rc_command_callback_t command_callback;
+    void *command_ctx;
+#endif
+    rc_mailbox_frame_t mb_tx[RC_MAILBOX_TX_SIZE];
+    atomic_uchar mb_tx_head;            /* Free-running, written by the main loop */
+    atomic_uchar mb_tx_tail;            /* Free-running, written with the bus held */
+#endif
+
+#if RC_ENABLE_MULTI_LINK
+    /* Multi-link - peers borrow the host's radio, bus lock and IRQ */
+    rc_link_t *host;                /* Owner of the radio, itself if not a peer */
+    rc_link_t *pipe_link[NRF24_PIPE_COUNT]; /* Host: link per RX pipe; [0] follows TX_ADDR */
+    rc_link_t *tx_link;             /* Host: link whose frame is on air */
+#if RC_ENABLE_IRQ
+    uint8_t pipe_close;             /* Host: pipes of detached peers, closed on bus release */
+#endif
+    uint8_t pipe;                   /* RX pipe this link is heard on */
+    uint8_t address[5];             /* RX address (TX_ADDR while sending) */
+    uint8_t peer_weight;            /* Uplink share, 0 = skipped by rc_link_next_peer() */
+    int16_t peer_credit;            /* Smooth weighted round-robin balance */
+#endif
+
+#if RC_ENABLE_DIVERSITY
+    /* Diversity - receive-only second radio, copies combined by sequence */
+    nrf24_t diversity;              /* initialized while in use */
+    rc_div_slot_t div_slots[RC_DIV_SLOTS];  /* Indexed by sequence */
+#endif
+
+#if RC_ENABLE_NO_ACK
+    /* No-ACK sends - types sent once, copies resent by rc_link_update() */
+    uint32_t no_ack_types;              /* Bit per rc_packet_type_t */
+    rc_crc_t rx_last_crc;               /* CRC of the frame at rx_sequence_last */
+#if RC_NO_ACK_REPEAT
+    rc_packet_t repeat_frame;           /* Ground: last no-ACK command as sent */
+    uint8_t repeat_len;
+    uint8_t repeat_left;                /* Copies still to send */
+    uint32_t repeat_time;               /* Tick the last copy went out */
+#endif
+#endif
+
+#if RC_ENABLE_BULK
+    /* Bulk streams - both ends time their frames from the last command */
+    rc_bulk_tx_t bulk_tx;
+    rc_bulk_rx_t bulk_rx;
+    bool bulk_anchored;                 /* A command went out / came in */
+    uint32_t bulk_anchor;               /* Tick it did */
+    uint32_t bulk_air_us;               /* Air booked since bulk_anchor */
+    bool bulk_turn_rx;                  /* Ground: this gap is the pull's */
+    bool bulk_waiting;                  /* Ground: a poll or grant awaits its answer */
+    uint32_t bulk_wait_time;            /* Ground: tick the wait started or was fed */
+    bool bulk_ack_owed;                 /* The other end polled */
+    uint8_t bulk_linger;                /* Ground: gaps left to re-ACK a finished pull */
+    uint8_t bulk_grant;                 /* Aircraft: segments the ground allowed */
+#endif
+
+#if RC_ENABLE_TIERED_COMMAND
+    /* Tiered commands - the ground tracks what the aircraft has ACKed */
+    rc_command_payload_t tier_acked;    /* Ground: state the aircraft holds */
+    rc_command_payload_t tier_sent;     /* Ground: command of the frame in flight */
+    bool tier_synced;                   /* Ground: a keyframe was ACKed */
+    volatile bool tier_pending;         /* Ground: tier_sent awaits TX_DS / MAX_RT */
+    uint8_t tier_pending_seq;           /* Its header sequence */
+    uint8_t tier_pending_slot;          /* Slot it carries, or RC_TIER_KEYFRAME */
+    uint8_t tier_cursor;                /* Ground: next slot in turn */
+    uint8_t tier_since_key;             /* Ground: frames since the last keyframe */
+    rc_command_payload_t tier_rx;       /* Aircraft: command rebuilt so far */
+    bool tier_rx_valid;                 /* Aircraft: a keyframe arrived */
+#endif
+
+#if RC_ENABLE_TDMA
+    /* Slot scheduler - send calls stage, rc_link_tdma_tick() transmits */
+    rc_tdma_frame_t tdma_staged[2];     /* Double buffer written by the main loop */
+    volatile uint8_t tdma_staged_idx;   /* Buffer last published */
+    volatile bool tdma_staged_ready;    /* tdma_staged[idx] not sent yet */
+    rc_tdma_frame_t tdma_repeat;        /* Ground: last command, resent when idle */
+    bool tdma_in_slot;                  /* encode_and_send() called by a slot */
+    bool tdma_downlink;                 /* Next tick opens the downlink half */
+    uint8_t tdma_frame;                 /* Frame counter (ground sequence) */
+    uint8_t tdma_downlink_seq;          /* Aircraft: telemetry frames sent */
+    volatile bool tdma_rx_frame;        /* Aircraft: heard the ground this frame */
+#endif
+
+#if RC_ENABLE_FHSS
+    /* Frequency hopping - tables indexed by generation */
+    uint32_t fhss_bind_id;
+    uint8_t hop_table[2][RC_FHSS_HOP_COUNT];
+    uint8_t hop_blacklist[2][RC_FHSS_MAP_BYTES];
+    uint8_t hop_valid;              /* Bit per generation with a built table */
+    uint8_t hop_gen;                /* Generation in use */
+    uint8_t hop_slot;               /* Slot currently tuned */
+    uint8_t hop_tx_channel;         /* Channel tx_packet was encoded for */
+    bool hop_staged;                /* Other generation takes over at hop_apply_seq */
+    volatile bool hop_staged_acked; /* Ground: aircraft has the staged map */
+    uint8_t hop_apply_seq;
+    rc_fhss_slot_stats_t hop_stats[RC_FHSS_HOP_COUNT];
+
+    /* Aircraft hop timing */
+    bool hop_synced;                /* Following the ground's sequence */
+    bool hop_pending;               /* Hop to hop_expected's channel is due */
+    uint8_t hop_expected;           /* Next ground sequence expected */
+    uint8_t hop_missed;             /* Consecutive flywheel hops */
+    uint8_t hop_scan;               /* Slot dwelt on while resyncing */
+    uint32_t hop_rx_time;           /* Anchor of the current frame */
+    uint32_t hop_dwell_start;
+#if RC_ENABLE_REACQUIRE
+    uint32_t hop_heard;             /* Last valid ground frame */
+#endif
+#endif
+
+#if RC_ENABLE_BIND
+    /* Binding */
+    rc_bind_state_t bind_state;
+    rc_bind_state_t bind_prev;      /* Returned to on cancel or timeout */
+    rc_bind_info_t bind_info;       /* Pair in use while bound */
+    rc_bind_info_t bind_offer;      /* Ground: pair offered; aircraft: pair taken */
+    bool bind_heard;                /* Ground: answered; aircraft: offer taken */
+    bool bind_reply;                /* Aircraft: answer due */
+    uint32_t bind_start;
+    uint32_t bind_last;             /* Ground: last offer sent; aircraft: last heard */
+#endif
+
+#if RC_ENABLE_CLOCK_SYNC
+    /* Clock sync */
+    rc_sync_state_t sync_state;     /* Ground */
+    uint8_t sync_id;                /* Ground: last ping; aircraft: last echoed */
+    uint32_t sync_t1;               /* Ground: tick_us() as the ping went to the radio */
+    uint32_t sync_rtt;              /* Ground: from there to its ACK */
+    uint32_t sync_last;             /* Ground: tick of the last ping sent */
+    rc_sync_filter_t sync_filter;   /* Ground */
+    rc_sync_payload_t sync_echo;    /* Aircraft: next echo */
+    bool sync_heard;                /* Aircraft: sync_id is meaningful */
+    bool sync_reply;                /* Aircraft: echo due */
+#if RC_ENABLE_ACK_TELEMETRY
+    bool sync_on_ack;               /* Aircraft: echo waiting in the ACK payload */
+    uint32_t sync_ack_us;           /* Aircraft: when it was queued */
+#endif
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+    /* Link adaptation - indices into adapt_profiles[] */
+    uint8_t adapt_profile;          /* Profile in use */
+    uint8_t adapt_radio;            /* Profile the radio is set up for */
+    bool adapt_staged;              /* adapt_target takes over at adapt_apply_seq */
+    volatile bool adapt_staged_acked; /* Ground: aircraft has heard the announcement */
+    uint8_t adapt_target;
+    uint8_t adapt_apply_seq;
+    uint32_t adapt_window;          /* Ground: bit per TX attempt, set if ACKed */
+    uint8_t adapt_filled;
+    uint8_t adapt_quality;          /* 0-100 */
+    bool adapt_rx_valid;            /* Aircraft: adapt_rx_seq is meaningful */
+    uint8_t adapt_rx_seq;           /* Aircraft: newest ground sequence seen */
+    uint32_t adapt_switch_time;     /* Tick of the last switch */
+    uint32_t adapt_hold_until;      /* Ground: no stepping up before this tick */
+    uint8_t adapt_backoff;          /* Step-ups that failed in a row */
+    uint8_t adapt_prev;             /* Profile before the last step up */
+    bool adapt_probing;             /* Last step up not yet held RC_ADAPT_HOLD_MS */
+    uint32_t adapt_contact_time;    /* Tick of the last ACK or valid packet */
+#endif
 
 #if RC_ENABLE_STATISTICS
     rc_stats_t stats;
+    uint32_t spi_stats_base;        /* spi_transactions at last stats reset */
+    uint32_t spi_frame_mark;        /* spi_transactions at end of last frame */
+#endif
+
+#if RC_ENABLE_LATENCY_STATS
+    rc_latency_stats_t latency;
+    uint32_t lat_tx_mark;           /* Cycles: upload start, then upload end */
+    uint32_t lat_rx_ready;          /* Cycles: last RX_DR serviced */
+    uint32_t rx_pool_stamp[RC_RX_POOL_SIZE];  /* lat_rx_ready of each entry */
+#endif
+
+#if RC_ENABLE_PREDICT
+    /* Missed-frame prediction - the last two commands and when they came */
+    rc_command_payload_t pred_command;
+    uint16_t pred_prev[RC_COMMAND_CHANNELS];
+    uint32_t pred_time;                 /* Cycle count pred_command arrived at */
+    uint32_t pred_interval;             /* Cycles from the one before */
+    uint8_t pred_count;                 /* Commands held, up to 2 */
+#if RC_ENABLE_MAILBOX
+    uint32_t pred_seen;                 /* mb_count last fed in */
+#endif
 #endif
+
+#if RC_ENABLE_TRACE
+    rc_trace_t trace;
+#endif
+};
+
+/*============================================================================*/
+/* Private Variables                                                          */
+/*============================================================================*/
+
+static rc_link_t link_instances[RC_LINK_INSTANCES];
+
+#if RC_ENABLE_LINK_ADAPT
+/** Most robust first; the ground steps up while attempts keep succeeding */
+static const rc_adapt_profile_t adapt_profiles[RC_ADAPT_PROFILES] = {
+    { NRF24_DATA_RATE_250KBPS, NRF24_TX_POWER_0DBM,  5 },  /* 1500 µs */
+    { NRF24_DATA_RATE_1MBPS,   NRF24_TX_POWER_0DBM,  1 },  /* 500 µs */
+    { NRF24_DATA_RATE_2MBPS,   NRF24_TX_POWER_0DBM,  1 },
+    { NRF24_DATA_RATE_2MBPS,   NRF24_TX_POWER_N6DBM, 1 },
 };
+#endif
 
 /*============================================================================*/
 /* Private Function Prototypes                                                */
 /*============================================================================*/
 
+static void link_state_init(rc_link_t *link);
+static uint32_t link_tick_us(rc_link_t *link);
 static void update_link_state(rc_link_t *link);
 static void calculate_link_quality(rc_link_t *link);
+#if RC_ENABLE_STATISTICS
+static uint32_t spi_count(const rc_link_t *link);
+#endif
+static void record_frame(rc_link_t *link);
+static uint8_t window_push(uint32_t *window, uint8_t *filled, uint8_t misses, bool hit);
+static void lq_on_packet(rc_link_t *link, uint8_t gap);
+#if RC_ENABLE_RSSI || RC_ENABLE_LINK_ADAPT
+static uint8_t tx_retries(rc_link_t *link, bool delivered);
+#endif
+#if RC_ENABLE_RSSI
+static void rssi_sample_rx(rc_link_t *link);
+static void rssi_sample_tx(rc_link_t *link, uint8_t retries);
+static void rssi_update(rc_link_t *link);
+#endif
 static rc_status_t encode_and_send(rc_link_t *link, rc_packet_type_t type,
                                     const void *payload, uint8_t payload_len);
 static rc_status_t receive_and_decode(rc_link_t *link, rc_packet_type_t expected_type,
-                                       void *payload, uint8_t *payload_len);
+                                       void *payload, uint8_t *payload_len, uint8_t *lent);
+static rc_status_t decode_packet(rc_link_t *link, rc_packet_type_t expected_type,
+                                 void *payload, uint8_t *payload_len);
+static void tx_select(rc_link_t *link);
+static rc_status_t tx_transmit(rc_link_t *link);
+#if RC_ENABLE_IRQ
+static bool tx_upload(rc_link_t *link);
+#endif
+static void tx_sent(rc_link_t *link);
+#if RC_TX_NO_ACK
+static void tx_ack_policy(rc_link_t *link, const rc_packet_t *frame);
+#endif
+#if RC_NO_ACK_REPEAT
+static void repeat_service(rc_link_t *link);
+#endif
+#if RC_ENABLE_BULK
+static void bulk_on_control(rc_link_t *link);
+static uint32_t bulk_clock_us(rc_link_t *link, uint32_t now);
+static uint32_t bulk_frame_us(rc_link_t *link, uint8_t payload_len);
+static rc_status_t bulk_send(rc_link_t *link, const uint8_t *payload, uint8_t len);
+static void bulk_on_rx(rc_link_t *link, const rc_packet_t *packet);
+static void bulk_service(rc_link_t *link);
+static void bulk_ground_service(rc_link_t *link);
+static void bulk_aircraft_service(rc_link_t *link);
+#endif
+static bool tx_via_ack(rc_packet_type_t type);
+static bool is_downlink_type(uint8_t type);
+static rc_status_t tx_open(rc_link_t *link, rc_packet_type_t type, uint8_t payload_len);
+static rc_status_t tx_commit(rc_link_t *link);
+static rc_crc_t encode_header(rc_link_t *link, rc_packet_type_t type, uint8_t payload_len);
+static void encode_finish(rc_link_t *link, rc_crc_t crc, uint8_t payload_len);
+static void encode_packet(rc_link_t *link, rc_packet_type_t type,
+                          const void *payload, uint8_t payload_len);
+static uint8_t packet_crc_offset(uint8_t payload_len);
+static void crc_store(uint8_t *dst, rc_crc_t crc);
+static rc_crc_t crc_load(const uint8_t *src);
+static void mark_received(rc_link_t *link, rc_packet_type_t type);
+#if RC_ENABLE_PREDICT
+static void predict_feed(rc_link_t *link, const rc_command_payload_t *command, uint32_t cycles);
+static uint8_t predict_missed(const rc_link_t *link);
+static void predict_apply(const rc_link_t *link, rc_command_payload_t *command, uint8_t missed);
+#endif
+#if !RC_ENABLE_SPI_DMA
+static void rx_drain(rc_link_t *link, nrf24_t *radio);
+#endif
+#if RC_ENABLE_FEC
+static bool fec_correct(rc_link_t *link, uint8_t *frame, uint8_t len);
+#endif
+#if !RC_ENABLE_IRQ
+static void rx_poll(rc_link_t *link);
+#endif
+static uint8_t rx_pool_alloc(rc_link_t *link);
+static void rx_ring_append(rc_link_t *link, uint8_t entry);
+#if RC_ENABLE_SPI_DMA || RC_ENABLE_MULTI_LINK
+static void rx_ring_push(rc_link_t *link, const void *data, uint8_t len);
+#endif
+static void rx_ring_remove(rc_link_t *link, uint8_t index);
+static void rx_release_held(rc_link_t *link);
+static bool rx_app_type(uint8_t type);
+static rc_status_t rx_take(rc_link_t *link, rc_packet_type_t expected_type,
+                           void *payload, uint8_t *payload_len, uint8_t *lent);
+static void failsafe_expand(const rc_link_t *link, rc_channels_t *channels);
+static void failsafe_pack(rc_link_t *link);
+static void failsafe_enter(rc_link_t *link);
+static void failsafe_exit(rc_link_t *link);
+#if RC_ENABLE_ACK_TELEMETRY
+#if !RC_ENABLE_MAILBOX
+static rc_status_t queue_ack_payload(rc_link_t *link, rc_packet_type_t type,
+                                     const void *payload, uint8_t payload_len);
+static rc_status_t upload_ack_payload(rc_link_t *link);
+#endif
+static bool ack_write(rc_link_t *link);
+#endif
+#if RC_ENABLE_MULTI_LINK
+static void peer_select(rc_link_t *link);
+#if RC_ENABLE_IRQ || !RC_ENABLE_ACK_TELEMETRY
+static void peer_listen(rc_link_t *host);
+#endif
+static void peer_detach(rc_link_t *peer);
+#if RC_ENABLE_IRQ
+static void peer_close_pipes(rc_link_t *host);
+#endif
+static rc_link_t *peer_route(rc_link_t *host, uint8_t pipe);
+#endif
+#if RC_ENABLE_IRQ
+static rc_link_t *link_host(rc_link_t *link);
+static bool bus_try_acquire(rc_link_t *link);
+static void bus_release(rc_link_t *link);
+static void check_tx_timeout(rc_link_t *link);
+static bool tx_held(rc_link_t *link);
+#endif
+#if RC_ENABLE_REPLY_WINDOW
+static void reply_window_open(rc_link_t *link, rc_link_t *sender);
+#endif
+#if RC_ENABLE_DIVERSITY
+static bool diversity_init(rc_link_t *link, const nrf24_hw_t *hw);
+static void diversity_pause(rc_link_t *link);
+static void diversity_resume(rc_link_t *link);
+static bool diversity_accept(rc_link_t *link, const rc_packet_t *packet, uint8_t len,
+                             uint8_t antenna);
+#endif
+#if RC_ENABLE_TIERED_COMMAND
+static uint8_t tier_select(rc_link_t *link, const rc_command_payload_t *command);
+static uint8_t tier_encode(const rc_command_payload_t *command, uint8_t slot,
+                           rc_command_tier_t *frame);
+static void tier_after_tx(rc_link_t *link, bool delivered);
+static rc_status_t tier_expand(rc_link_t *link, rc_packet_t *packet);
+static bool tier_slot_differs(const rc_command_payload_t *a, const rc_command_payload_t *b,
+                              uint8_t slot);
+static void tier_slot_copy(rc_command_payload_t *dst, const rc_command_payload_t *src,
+                           uint8_t slot);
+#endif
+
+#if RC_ENABLE_MAILBOX
+static uint32_t mailbox_read(rc_link_t *link, rc_command_sample_t *sample);
+static void mailbox_publish(rc_link_t *link);
+static rc_mailbox_frame_t *mailbox_tx_slot(rc_link_t *link);
+static rc_status_t mailbox_tx_queue(rc_link_t *link, rc_packet_type_t type,
+                                    const void *payload, uint8_t payload_len);
+static void mailbox_tx_publish(rc_link_t *link, rc_packet_type_t type, uint8_t payload_len);
+static rc_status_t mailbox_tx_direct(rc_link_t *link, rc_packet_type_t type,
+                                     const void *payload, uint8_t payload_len);
+static bool mailbox_tx_frame(rc_link_t *link, rc_packet_type_t type,
+                             const void *payload, uint8_t payload_len);
+static void mailbox_tx_service(rc_link_t *link);
+#endif
+#if RC_ENABLE_TX_QUEUE
+static void txq_complete(rc_link_t *link, rc_status_t status);
+static void txq_service(rc_link_t *link, uint8_t events);
+#endif
+#if RC_ENABLE_TDMA
+static rc_status_t tdma_stage(rc_link_t *link, rc_packet_type_t type,
+                              const void *payload, uint8_t payload_len);
+static void tdma_publish(rc_link_t *link, rc_packet_type_t type, uint8_t payload_len);
+static rc_status_t tdma_send(rc_link_t *link, const rc_tdma_frame_t *frame);
+static void tdma_uplink_slot(rc_link_t *link);
+static void tdma_downlink_slot(rc_link_t *link);
+static void tdma_sync(rc_link_t *link, const rc_packet_t *packet, uint8_t len);
+#endif
+#if RC_ENABLE_SPI_DMA
+static rc_status_t encode_and_send_async(rc_link_t *link, rc_packet_type_t type,
+                                         const void *payload, uint8_t payload_len);
+static void complete_async_tx(rc_link_t *link, rc_status_t status);
+static void deliver_rx(rc_link_t *link);
+static void on_dma_complete(nrf24_t *nrf, nrf24_dma_op_t op, bool ok,
+                            const uint8_t *data, uint8_t len, void *ctx);
+#endif
+#if RC_ENABLE_FHSS
+static void fhss_reset(rc_link_t *link, uint32_t bind_id);
+static void fhss_switch(rc_link_t *link, uint8_t gen);
+static uint8_t fhss_select(rc_link_t *link, uint8_t sequence);
+static uint8_t fhss_tx_channel(rc_link_t *link);
+static bool fhss_retune(rc_link_t *link, uint8_t channel);
+static void fhss_after_tx(rc_link_t *link, bool delivered);
+static bool fhss_on_rx(rc_link_t *link);
+static void fhss_service(rc_link_t *link);
+#if RC_ENABLE_TDMA
+static void fhss_frame_tick(rc_link_t *link, bool defer_hop);
+#endif
+static bool fhss_coasting(const rc_link_t *link, uint32_t now);
+#endif
+
+#if RC_ENABLE_BIND
+static void bind_load(rc_link_t *link, uint8_t *address);
+static bool bind_switch(rc_link_t *link, rc_bind_state_t state);
+static void bind_on_rx(rc_link_t *link, const rc_packet_t *packet);
+static void bind_service(rc_link_t *link);
+#endif
+#if RC_ENABLE_CLOCK_SYNC
+static void sync_tx_start(rc_link_t *link);
+static void sync_after_tx(rc_link_t *link, bool delivered, uint32_t done_us);
+static void sync_on_rx(rc_link_t *link, const rc_packet_t *packet);
+static void sync_service(rc_link_t *link);
+#endif
+#if RC_ENABLE_LINK_ADAPT
+static void adapt_reset(rc_link_t *link);
+static void adapt_switch(rc_link_t *link, uint8_t profile);
+static void adapt_stage(rc_link_t *link, uint8_t profile);
+static void adapt_select(rc_link_t *link);
+static void adapt_apply(rc_link_t *link);
+static uint8_t adapt_flags(rc_link_t *link);
+static void adapt_after_tx(rc_link_t *link, bool delivered, uint8_t retries);
+static void adapt_on_rx(rc_link_t *link);
+static void adapt_service(rc_link_t *link);
+#endif
+#if RC_ENABLE_LATENCY_STATS
+static void latency_record(rc_link_t *link, rc_latency_stage_t stage, uint32_t start);
+static void latency_tx_uploaded(rc_link_t *link);
+#endif
 
 /*============================================================================*/
 /* Initialization                                                             */
 /*============================================================================*/
 
+rc_link_t *rc_link_instance(uint8_t index)
+{
+    if (index >= RC_LINK_INSTANCES) {
+        return NULL;
+    }
+
+    return &link_instances[index];
+}
+
 rc_status_t rc_link_init(rc_link_t *link, const rc_hardware_config_t *hw_config)
 {
     if (!link || !hw_config || !hw_config->get_tick_ms) {
@@ -81,24 +761,106 @@ rc_status_t rc_link_init(rc_link_t *link, const rc_hardware_config_t *hw_config)
 
     /* Copy hardware config */
     memcpy(&link->hw, hw_config, sizeof(rc_hardware_config_t));
+    link->radio = &link->nrf24;
 
     /* Initialize nRF24 */
-    if (!nrf24_init(&link->nrf24, RC_RF_CHANNEL, 32)) {
+    bool ready = hw_config->radio ?
+                 nrf24_init_hw(link->radio, hw_config->radio, RC_RF_CHANNEL, 32) :
+                 nrf24_init(link->radio, RC_RF_CHANNEL, 32);
+    if (!ready) {
         RC_LOG_ERROR("nRF24 initialization failed\n");
         return RC_ERROR_HARDWARE;
     }
 
     /* Configure nRF24 */
-    nrf24_set_tx_power(&link->nrf24, (nrf24_tx_power_t)RC_TX_POWER);
-    nrf24_set_data_rate(&link->nrf24, (nrf24_data_rate_t)RC_DATA_RATE);
-    nrf24_set_auto_retransmit(&link->nrf24, RC_AUTO_RETRANSMIT_DELAY,
+#if RC_ENABLE_ACK_TELEMETRY
+    nrf24_enable_ack_payload(link->radio, true);
+#elif RC_ENABLE_DYNAMIC_PAYLOAD
+    nrf24_enable_dynamic_payload(link->radio, true);
+#endif
+#if RC_ENABLE_LINK_ADAPT
+    adapt_reset(link);
+#else
+    nrf24_set_tx_power(link->radio, (nrf24_tx_power_t)RC_TX_POWER);
+    nrf24_set_data_rate(link->radio, (nrf24_data_rate_t)RC_DATA_RATE);
+    nrf24_set_auto_retransmit(link->radio, RC_AUTO_RETRANSMIT_DELAY,
                               RC_AUTO_RETRANSMIT_COUNT);
+#endif
+#if RC_TX_NO_ACK
+    nrf24_enable_dyn_ack(link->radio, true);
+#endif
+#if RC_ENABLE_FEC
+    /* Damaged frames must reach the decoder: the radio would drop them on
+     * its own CRC, which auto-ACK forces on */
+    nrf24_set_auto_ack(link->radio, false);
+    nrf24_set_crc(link->radio, false);
+#endif
 
     /* Set default addresses */
-    uint8_t addr[5] = {0xE7, 0xE7, 0xE7, 0xE7, 0xE7};
-    nrf24_set_addresses(&link->nrf24, addr, addr);
+    uint8_t addr[5] = RC_RF_ADDRESS;
+#if RC_ENABLE_BIND
+    bind_load(link, addr);  /* A stored pair replaces them */
+#endif
+    nrf24_set_addresses(link->radio, addr, addr);
+
+#if RC_ENABLE_MULTI_LINK
+    /* The host is the link on pipe 0 */
+    link->host = link;
+    link->pipe_link[0] = link;
+    link->tx_link = link;
+    memcpy(link->address, addr, sizeof(link->address));
+#endif
+
+#if RC_ENABLE_DIVERSITY
+    if (hw_config->diversity_radio && !diversity_init(link, hw_config->diversity_radio)) {
+        RC_LOG_ERROR("Diversity receiver initialization failed\n");
+        return RC_ERROR_HARDWARE;
+    }
+#endif
+
+#if RC_ENABLE_IRQ
+    atomic_flag_clear(&link->bus_lock);
+
+    /* Listen by default; TX completion returns here from the IRQ */
+    nrf24_listen(link->radio);
+#endif
+
+#if RC_ENABLE_SPI_DMA
+    nrf24_set_dma_callback(link->radio, on_dma_complete, link);
+#endif
+
+#if RC_ENABLE_FHSS && RC_ENABLE_BIND
+    fhss_reset(link, link->bind_state == RC_BIND_BOUND ? link->bind_info.hop_seed
+                                                       : RC_FHSS_BIND_ID);
+#elif RC_ENABLE_FHSS
+    fhss_reset(link, RC_FHSS_BIND_ID);
+#endif
+
+    link_state_init(link);
 
-    /* Initialize state */
+    link->initialized = true;
+
+#if RC_ENABLE_TDMA
+    uint32_t exchange_us = rc_link_get_airtime_us(link, RC_MAX_PAYLOAD_SIZE);
+    if (exchange_us > RC_TDMA_HALF_FRAME_US) {
+        RC_LOG_WARN("Frame exchange (%lu us) exceeds TDMA slot (%lu us)\n",
+                    (unsigned long)exchange_us, (unsigned long)RC_TDMA_HALF_FRAME_US);
+    }
+
+    /* Slot clock: one update per half frame */
+    __HAL_TIM_SET_AUTORELOAD(&NRF24_TIM_HANDLE, RC_TDMA_HALF_FRAME_US - 1);
+    __HAL_TIM_SET_COUNTER(&NRF24_TIM_HANDLE, 0);
+    HAL_TIM_Base_Start_IT(&NRF24_TIM_HANDLE);
+#endif
+
+    RC_LOG_INFO("RC link initialized (ch=%d, pwr=%d, rate=%d)\n",
+                RC_RF_CHANNEL, RC_TX_POWER, RC_DATA_RATE);
+
+    return RC_OK;
+}
+
+static void link_state_init(rc_link_t *link)
+{
     link->role = RC_ROLE_GROUND;
     link->tx_sequence = 0;
     link->rx_sequence_last = 0;
@@ -110,17 +872,21 @@ rc_status_t rc_link_init(rc_link_t *link, const rc_hardware_config_t *hw_config)
     /* Set default failsafe */
     rc_command_payload_t default_failsafe = RC_FAILSAFE_COMMAND;
     memcpy(&link->failsafe_command, &default_failsafe, sizeof(rc_command_payload_t));
+    failsafe_pack(link);
 
-#if RC_ENABLE_STATISTICS
-    memset(&link->stats, 0, sizeof(rc_stats_t));
-#endif
+    link->rx_held = RC_RX_NONE;
 
-    link->initialized = true;
+#if RC_ENABLE_MULTI_LINK
+    link->peer_weight = 1;
+#endif
 
-    RC_LOG_INFO("RC link initialized (ch=%d, pwr=%d, rate=%d)\n",
-                RC_RF_CHANNEL, RC_TX_POWER, RC_DATA_RATE);
+#if RC_ENABLE_NO_ACK
+    link->no_ack_types = RC_NO_ACK_TYPES;
+#endif
 
-    return RC_OK;
+#if RC_ENABLE_STATISTICS
+    memset(&link->stats, 0, sizeof(rc_stats_t));
+#endif
 }
 
 void rc_link_deinit(rc_link_t *link)
@@ -129,7 +895,28 @@ void rc_link_deinit(rc_link_t *link)
         return;
     }
 
-    nrf24_power_down(&link->nrf24);
+#if RC_ENABLE_MULTI_LINK
+    if (link->host != link) {
+        peer_detach(link);  /* The radio stays with the host */
+        return;
+    }
+
+    /* Peers cannot outlive the radio they borrow */
+    for (uint8_t pipe = 1; pipe < NRF24_PIPE_COUNT; pipe++) {
+        if (link->pipe_link[pipe]) {
+            peer_detach(link->pipe_link[pipe]);
+        }
+    }
+#endif
+
+#if RC_ENABLE_TDMA
+    HAL_TIM_Base_Stop_IT(&NRF24_TIM_HANDLE);
+#endif
+
+    nrf24_power_down(link->radio);
+#if RC_ENABLE_DIVERSITY
+    nrf24_power_down(&link->diversity);
+#endif
     link->initialized = false;
 
     RC_LOG_INFO("RC link deinitialized\n");
@@ -147,22 +934,73 @@ rc_status_t rc_link_send_command(rc_link_t *link, const rc_command_payload_t *co
 
     link->role = RC_ROLE_GROUND;
 
-    rc_status_t status = encode_and_send(link, RC_PKT_COMMAND, command,
-                                         sizeof(rc_command_payload_t));
+#if RC_ENABLE_TIERED_COMMAND
+#if RC_ENABLE_IRQ
+    /* The frame in flight still owns the pending state */
+    if (tx_held(link)) {
+        return RC_ERROR_BUSY;
+    }
+#endif
 
-    if (status == RC_OK) {
-        link->tx_sequence++;
+    rc_command_tier_t tier;
+    uint8_t slot = tier_select(link, command);
+    rc_status_t status = (slot == RC_TIER_KEYFRAME) ?
+                         encode_and_send(link, RC_PKT_COMMAND, command,
+                                         sizeof(rc_command_payload_t)) :
+                         encode_and_send(link, RC_PKT_COMMAND, &tier,
+                                         tier_encode(command, slot, &tier));
 
+    if (status == RC_ERROR_BUSY) {
+        link->tier_pending = false;
+    } else if (slot == RC_TIER_KEYFRAME) {
+        link->tier_since_key = 0;
 #if RC_ENABLE_STATISTICS
-        link->stats.packets_sent++;
+        link->stats.tier_keyframes++;
+#endif
+    } else {
+        link->tier_since_key++;
+        link->tier_cursor = (uint8_t)((slot + 1) % RC_TIER_SLOTS);
+    }
+#else
+    rc_status_t status = encode_and_send(link, RC_PKT_COMMAND, command,
+                                         sizeof(rc_command_payload_t));
 #endif
 
+    if (status == RC_OK) {
+        tx_sent(link);
+
         RC_LOG_DEBUG("Command sent (seq=%d)\n", link->tx_sequence - 1);
     }
 
     return status;
 }
 
+rc_status_t rc_link_send_channels(rc_link_t *link, const rc_channels_t *channels)
+{
+    if (!link || !link->initialized || !channels) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->role = RC_ROLE_GROUND;
+
+    /* Packed straight into the frame */
+    LATENCY_MARK(t_encode);
+    rc_status_t status = tx_open(link, RC_PKT_CHANNELS, sizeof(rc_channels_payload_t));
+
+    if (status == RC_OK) {
+        rc_channels_encode(channels, (rc_channels_payload_t *)link->tx_open);
+        LATENCY_RECORD(link, RC_LATENCY_ENCODE, t_encode);
+
+        status = tx_commit(link);
+    }
+
+    if (status == RC_OK) {
+        RC_LOG_DEBUG("Channels sent (seq=%d)\n", link->tx_sequence - 1);
+    }
+
+    return status;
+}
+
 rc_status_t rc_link_receive_telemetry(rc_link_t *link, rc_telemetry_payload_t *telemetry)
 {
     if (!link || !link->initialized || !telemetry) {
@@ -170,16 +1008,37 @@ rc_status_t rc_link_receive_telemetry(rc_link_t *link, rc_telemetry_payload_t *t
     }
 
     uint8_t payload_len = 0;
-    rc_status_t status = receive_and_decode(link, RC_PKT_TELEMETRY, telemetry, &payload_len);
+    rc_status_t status = receive_and_decode(link, RC_PKT_TELEMETRY, telemetry,
+                                            &payload_len, NULL);
 
     if (status == RC_OK) {
-        link->last_rx_time = link->hw.get_tick_ms();
+        mark_received(link, RC_PKT_TELEMETRY);
 
-#if RC_ENABLE_STATISTICS
-        link->stats.packets_received++;
-#endif
+        RC_LOG_DEBUG("Telemetry received (seq=%d)\n", link->rx_packet->header.sequence);
+    }
+
+    return status;
+}
+
+rc_status_t rc_link_receive_telemetry_mux(rc_link_t *link, rc_tlm_cache_t *cache)
+{
+    if (!link || !link->initialized || !cache) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    /* Decoded from the pool entry it was received into */
+    uint8_t entry = RC_RX_NONE;
+    rc_status_t status = receive_and_decode(link, RC_PKT_TELEMETRY_MUX, NULL, NULL, &entry);
 
-        RC_LOG_DEBUG("Telemetry received (seq=%d)\n", link->rx_packet.header.sequence);
+    if (status == RC_OK) {
+        const rc_packet_t *packet = &link->rx_pool[entry];
+
+        rc_tlm_cache_decode(cache, packet->payload, packet->header.payload_len,
+                            link->hw.get_tick_ms());
+        link->rx_pool_used[entry] = false;
+        mark_received(link, RC_PKT_TELEMETRY_MUX);
+
+        RC_LOG_DEBUG("Telemetry mux received (seq=%d)\n", link->rx_sequence_last);
     }
 
     return status;
@@ -197,30 +1056,128 @@ rc_status_t rc_link_receive_command(rc_link_t *link, rc_command_payload_t *comma
 
     link->role = RC_ROLE_AIRCRAFT;
 
-    uint8_t payload_len = 0;
-    rc_status_t status = receive_and_decode(link, RC_PKT_COMMAND, command, &payload_len);
+#if RC_ENABLE_MAILBOX
+    /* Decoded by the IRQ; only the newest command is kept */
+    rc_command_sample_t sample;
+    uint32_t count = mailbox_read(link, &sample);
+    rc_status_t status = RC_ERROR_NO_DATA;
 
-    if (status == RC_OK) {
-        link->last_rx_time = link->hw.get_tick_ms();
-        link->failsafe_active = false;
+    if (count != link->mb_seen) {
+        link->mb_seen = count;
+        memcpy(command, &sample.command, sizeof(rc_command_payload_t));
+        failsafe_exit(link);
 
-#if RC_ENABLE_STATISTICS
-        link->stats.packets_received++;
+        RC_LOG_DEBUG("Command received (seq=%d)\n", sample.sequence);
+        return RC_OK;
+    }
+#else
+    uint8_t payload_len = 0;
+    rc_status_t status = receive_and_decode(link, RC_PKT_COMMAND, command, &payload_len, NULL);
+
+    if (status == RC_OK) {
+        mark_received(link, RC_PKT_COMMAND);
+#if RC_ENABLE_PREDICT
+        predict_feed(link, command, nrf24_cycle_count());
 #endif
 
-        RC_LOG_DEBUG("Command received (seq=%d)\n", link->rx_packet.header.sequence);
+        RC_LOG_DEBUG("Command received (seq=%d)\n", link->rx_packet->header.sequence);
         return RC_OK;
     }
+#endif
 
     /* If link lost, return failsafe values */
     if (!link->link_active) {
         memcpy(command, &link->failsafe_command, sizeof(rc_command_payload_t));
+        failsafe_enter(link);
+
+        return RC_OK;  /* Return OK with failsafe values */
+    }
+
+    return status;
+}
+
+#if RC_ENABLE_PREDICT
+rc_status_t rc_link_predict_command(rc_link_t *link, rc_command_payload_t *command,
+                                    uint8_t *missed)
+{
+    if (!link || !link->initialized || !command) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->role = RC_ROLE_AIRCRAFT;
+
+#if RC_ENABLE_MAILBOX
+    /* Commands the IRQ published since; the stamps keep the slope right
+     * even if the loop saw only some of them */
+    rc_command_sample_t sample;
+    uint32_t count = mailbox_read(link, &sample);
+
+    if (count != link->pred_seen) {
+        link->pred_seen = count;
+        predict_feed(link, &sample.command, sample.rx_cycles);
+    }
+#endif
+
+    uint8_t frames = predict_missed(link);
+    if (missed) {
+        *missed = frames;
+    }
+
+    if (!link->link_active) {
+        memcpy(command, &link->failsafe_command, sizeof(rc_command_payload_t));
+        failsafe_enter(link);
+
+        return RC_OK;
+    }
+
+    if (link->pred_count == 0) {
+        return RC_ERROR_NO_DATA;
+    }
+
+    predict_apply(link, command, frames);
+
+    return RC_OK;
+}
+#endif
+
+rc_status_t rc_link_receive_channels(rc_link_t *link, rc_channels_t *channels)
+{
+    if (!link || !link->initialized || !channels) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->role = RC_ROLE_AIRCRAFT;
 
-        if (!link->failsafe_active) {
-            link->failsafe_active = true;
-            RC_LOG_WARN("Link lost - activating failsafe\n");
+    /* Unpacked from the pool entry it was received into */
+    uint8_t entry = RC_RX_NONE;
+    rc_status_t status = receive_and_decode(link, RC_PKT_CHANNELS, NULL, NULL, &entry);
+
+    if (status == RC_OK) {
+        const rc_packet_t *packet = &link->rx_pool[entry];
+
+        if (packet->header.payload_len != sizeof(rc_channels_payload_t)) {
+            /* Other end built with a different RC_CHANNELS_* layout */
+            RC_LOG_WARN("Channel payload size mismatch: %d bytes\n", packet->header.payload_len);
+            status = RC_ERROR_INVALID_PARAM;
+        } else {
+            rc_channels_decode((const rc_channels_payload_t *)packet->payload, channels);
         }
 
+        link->rx_pool_used[entry] = false;
+    }
+
+    if (status == RC_OK) {
+        mark_received(link, RC_PKT_CHANNELS);
+
+        RC_LOG_DEBUG("Channels received (seq=%d)\n", link->rx_sequence_last);
+        return RC_OK;
+    }
+
+    /* If link lost, return failsafe values */
+    if (!link->link_active) {
+        failsafe_expand(link, channels);
+        failsafe_enter(link);
+
         return RC_OK;  /* Return OK with failsafe values */
     }
 
@@ -233,15 +1190,25 @@ rc_status_t rc_link_send_telemetry(rc_link_t *link, const rc_telemetry_payload_t
         return RC_ERROR_INVALID_PARAM;
     }
 
+    link->role = RC_ROLE_AIRCRAFT;
+
+#if RC_ENABLE_RSSI
+    rc_telemetry_payload_t stamped = *telemetry;
+    stamped.rssi = link->rssi;
+    telemetry = &stamped;
+#endif
+
+#if RC_ENABLE_ACK_TELEMETRY && !RC_ENABLE_MAILBOX
+    /* Rides back on the ACK of the next command */
+    rc_status_t status = queue_ack_payload(link, RC_PKT_TELEMETRY, telemetry,
+                                           sizeof(rc_telemetry_payload_t));
+#else
     rc_status_t status = encode_and_send(link, RC_PKT_TELEMETRY, telemetry,
                                          sizeof(rc_telemetry_payload_t));
+#endif
 
     if (status == RC_OK) {
-        link->tx_sequence++;
-
-#if RC_ENABLE_STATISTICS
-        link->stats.packets_sent++;
-#endif
+        tx_sent(link);
 
         RC_LOG_DEBUG("Telemetry sent (seq=%d)\n", link->tx_sequence - 1);
     }
@@ -249,248 +1216,4840 @@ rc_status_t rc_link_send_telemetry(rc_link_t *link, const rc_telemetry_payload_t
     return status;
 }
 
-/*============================================================================*/
-/* Common API                                                                 */
-/*============================================================================*/
-
-rc_status_t rc_link_update(rc_link_t *link)
+rc_status_t rc_link_send_telemetry_mux(rc_link_t *link, rc_tlm_mux_t *mux)
 {
-    if (!link || !link->initialized) {
+    if (!link || !link->initialized || !mux) {
         return RC_ERROR_INVALID_PARAM;
     }
 
-    update_link_state(link);
-    calculate_link_quality(link);
+    link->role = RC_ROLE_AIRCRAFT;
 
-    return RC_OK;
-}
+#if RC_ENABLE_RSSI
+    rc_tlm_set(mux, RC_TLM_RSSI, &link->rssi);  /* No-op unless registered */
+#endif
 
-bool rc_link_is_active(rc_link_t *link)
-{
-    if (!link || !link->initialized) {
-        return false;
+    uint32_t now = link->hw.get_tick_ms();
+    uint8_t payload[RC_MAX_PAYLOAD_SIZE];
+    uint8_t payload_len = rc_tlm_mux_build(mux, now, payload, sizeof(payload));
+
+    if (payload_len == 0) {
+        return RC_ERROR_NO_DATA;
     }
 
-    return link->link_active;
-}
+#if RC_ENABLE_ACK_TELEMETRY && !RC_ENABLE_MAILBOX
+    rc_status_t status = queue_ack_payload(link, RC_PKT_TELEMETRY_MUX, payload, payload_len);
+#else
+    rc_status_t status = encode_and_send(link, RC_PKT_TELEMETRY_MUX, payload, payload_len);
+#endif
 
-uint32_t rc_link_get_time_since_rx(rc_link_t *link)
-{
-    if (!link || !link->initialized || link->last_rx_time == UINT32_MAX) {
-        return UINT32_MAX;
+    /* Items of a frame that did not go out stay due for the next one */
+    if (status == RC_OK) {
+        rc_tlm_mux_commit(mux, now);
+        tx_sent(link);
+
+        RC_LOG_DEBUG("Telemetry mux sent (seq=%d, %d bytes)\n", link->tx_sequence - 1,
+                     payload_len);
     }
 
-    return link->hw.get_tick_ms() - link->last_rx_time;
+    return status;
 }
 
-rc_status_t rc_link_set_failsafe(rc_link_t *link, const rc_command_payload_t *failsafe)
+/*============================================================================*/
+/* Zero-Copy API                                                              */
+/*============================================================================*/
+
+rc_status_t rc_link_tx_acquire(rc_link_t *link, uint8_t type, uint8_t payload_len,
+                               void **payload)
 {
-    if (!link || !link->initialized || !failsafe) {
+    if (!link || !link->initialized || !payload) {
         return RC_ERROR_INVALID_PARAM;
     }
 
-    memcpy(&link->failsafe_command, failsafe, sizeof(rc_command_payload_t));
+    if (is_downlink_type(type)) {
+        link->role = RC_ROLE_AIRCRAFT;
+    } else if (type == RC_PKT_COMMAND || type == RC_PKT_CHANNELS || RC_PKT_IS_USER_UP(type)) {
+        link->role = RC_ROLE_GROUND;
+    }
 
-    RC_LOG_INFO("Failsafe values updated\n");
-    return RC_OK;
+    rc_status_t status = tx_open(link, (rc_packet_type_t)type, payload_len);
+    *payload = (status == RC_OK) ? link->tx_open : NULL;
+
+    return status;
 }
 
-rc_status_t rc_link_get_failsafe(rc_link_t *link, rc_command_payload_t *failsafe)
+rc_status_t rc_link_tx_write(rc_link_t *link, const void *data, uint8_t len)
 {
-    if (!link || !link->initialized || !failsafe) {
+    if (!link || !link->initialized || !link->tx_open || (!data && len > 0) ||
+        len > link->tx_open_len - link->tx_open_fill) {
         return RC_ERROR_INVALID_PARAM;
     }
 
-    memcpy(failsafe, &link->failsafe_command, sizeof(rc_command_payload_t));
+    uint8_t *dst = link->tx_open + link->tx_open_fill;
+
+#if RC_ENABLE_MAILBOX
+    memcpy(dst, data, len);  /* Checksummed by the IRQ that sends it */
+    link->tx_open_fill += len;
     return RC_OK;
-}
+#endif
 
-/*============================================================================*/
-/* Statistics API                                                             */
-/*============================================================================*/
+#if RC_ENABLE_TDMA
+    if (!tx_via_ack((rc_packet_type_t)link->tx_open_type)) {
+        memcpy(dst, data, len);  /* Checksummed by the slot */
+        link->tx_open_fill += len;
+        return RC_OK;
+    }
+#endif
 
-#if RC_ENABLE_STATISTICS
-rc_status_t rc_link_get_stats(rc_link_t *link, rc_stats_t *stats)
+    link->tx_open_crc = rc_crc_copy(link->tx_open_crc, dst, (const uint8_t *)data, len);
+    link->tx_open_fill += len;
+
+    return RC_OK;
+}
+
+rc_status_t rc_link_tx_commit(rc_link_t *link)
 {
-    if (!link || !link->initialized || !stats) {
+    if (!link || !link->initialized || !link->tx_open) {
         return RC_ERROR_INVALID_PARAM;
     }
 
-    memcpy(stats, &link->stats, sizeof(rc_stats_t));
-    return RC_OK;
+    rc_status_t status = tx_commit(link);
+
+    if (status == RC_OK) {
+        RC_LOG_DEBUG("Frame sent (type=%d, seq=%d)\n", link->tx_open_type, link->tx_sequence - 1);
+    }
+
+    return status;
 }
 
-void rc_link_reset_stats(rc_link_t *link)
+void rc_link_tx_abort(rc_link_t *link)
 {
-    if (!link || !link->initialized) {
+    if (!link) {
         return;
     }
 
-    memset(&link->stats, 0, sizeof(rc_stats_t));
-    RC_LOG_INFO("Statistics reset\n");
+    link->tx_open = NULL;
 }
-#endif
-
-/*============================================================================*/
-/* Private Functions                                                          */
-/*============================================================================*/
 
-static void update_link_state(rc_link_t *link)
+rc_status_t rc_link_rx_acquire(rc_link_t *link, uint8_t type, const void **payload,
+                               uint8_t *payload_len)
 {
-    uint32_t time_since_rx = rc_link_get_time_since_rx(link);
-    bool was_active = link->link_active;
+    if (!link || !link->initialized || !payload || !payload_len) {
+        return RC_ERROR_INVALID_PARAM;
+    }
 
-    /* Check timeout condition */
-    bool timeout = (time_since_rx != UINT32_MAX) && (time_since_rx > RC_LINK_TIMEOUT_MS);
+    bool control = (type == RC_PKT_COMMAND || type == RC_PKT_CHANNELS);
+    if (control) {
+        link->role = RC_ROLE_AIRCRAFT;
+    }
 
-    /* Check sequence gap condition */
-    bool sequence_gap = (link->consecutive_missed >= RC_LINK_LOSS_THRESHOLD);
+    /* The previous view goes back to the pool first */
+    rx_release_held(link);
+    rc_status_t status = receive_and_decode(link, (rc_packet_type_t)type, NULL, NULL,
+                                            &link->rx_held);
 
-    /* Link active if neither condition met */
-    link->link_active = !timeout && !sequence_gap;
+    if (status == RC_OK) {
+        const rc_packet_t *packet = &link->rx_pool[link->rx_held];
 
-    /* Log state changes */
-    if (was_active && !link->link_active) {
-        if (timeout) {
-            RC_LOG_WARN("Link lost: timeout (%lu ms)\n", time_since_rx);
+        *payload = packet->payload;
+        *payload_len = packet->header.payload_len;
+        mark_received(link, (rc_packet_type_t)type);
+        return RC_OK;
+    }
+
+    /* If link lost, a view of the failsafe values */
+    if (control && !link->link_active) {
+        if (type == RC_PKT_CHANNELS) {
+            *payload = &link->failsafe_channels;
+            *payload_len = sizeof(rc_channels_payload_t);
         } else {
-            RC_LOG_WARN("Link lost: %d consecutive missed packets\n",
-                       link->consecutive_missed);
+            *payload = &link->failsafe_command;
+            *payload_len = sizeof(rc_command_payload_t);
         }
-    } else if (!was_active && link->link_active) {
-        RC_LOG_INFO("Link restored\n");
-        link->consecutive_missed = 0;
+        failsafe_enter(link);
+
+        return RC_OK;
     }
+
+    *payload = NULL;
+    *payload_len = 0;
+
+    return status;
 }
 
-static void calculate_link_quality(rc_link_t *link)
+void rc_link_rx_release(rc_link_t *link)
 {
-#if RC_ENABLE_STATISTICS
-    if (link->stats.packets_sent == 0) {
-        link->stats.link_quality = 0;
+    if (!link || !link->initialized) {
         return;
     }
 
-    uint32_t total = link->stats.packets_sent;
-    uint32_t lost = link->stats.packets_missed;
-
-    if (total > 0) {
-        uint32_t received = total - lost;
-        link->stats.link_quality = (uint8_t)((received * 100) / total);
-
-        if (link->stats.link_quality > 100) {
-            link->stats.link_quality = 100;
-        }
-    }
-#endif
+    rx_release_held(link);
 }
 
-static rc_status_t encode_and_send(rc_link_t *link, rc_packet_type_t type,
-                                    const void *payload, uint8_t payload_len)
+#if RC_ENABLE_MAILBOX
+/*============================================================================*/
+/* Mailbox API                                                                */
+/*============================================================================*/
+
+rc_status_t rc_link_get_latest_command(rc_link_t *link, rc_command_sample_t *sample)
 {
-    if (payload_len > RC_MAX_PAYLOAD_SIZE) {
+    if (!link || !link->initialized || !sample) {
         return RC_ERROR_INVALID_PARAM;
     }
 
-    /* Build header */
-    link->tx_packet.header.version = RC_PROTOCOL_VERSION;
-    link->tx_packet.header.type = type;
-    link->tx_packet.header.sequence = link->tx_sequence;
-    link->tx_packet.header.flags = 0;
-    link->tx_packet.header.payload_len = payload_len;
+    link->role = RC_ROLE_AIRCRAFT;
 
-    /* Copy payload */
-    if (payload && payload_len > 0) {
-        memcpy(link->tx_packet.payload, payload, payload_len);
-    }
+    uint32_t count = mailbox_read(link, sample);
 
-    /* Calculate CRC over header + payload */
-    uint8_t crc_len = sizeof(rc_packet_header_t) + payload_len;
-    link->tx_packet.crc8 = rc_crc8_calculate((uint8_t*)&link->tx_packet, crc_len);
+    /* Nothing heard yet, or the link timed out: hold the failsafe values */
+    sample->failsafe = (count == 0 || !link->link_active);
 
-    /* Transmit */
-    if (!nrf24_transmit(&link->nrf24, (uint8_t*)&link->tx_packet, 32)) {
-        return RC_ERROR_HARDWARE;
+    if (sample->failsafe) {
+        memcpy(&sample->command, &link->failsafe_command, sizeof(rc_command_payload_t));
+        failsafe_enter(link);
+    } else {
+        failsafe_exit(link);
     }
 
     return RC_OK;
 }
 
-static rc_status_t receive_and_decode(rc_link_t *link, rc_packet_type_t expected_type,
-                                       void *payload, uint8_t *payload_len)
+#if RC_ENABLE_COMMAND_CALLBACK
+void rc_link_set_command_callback(rc_link_t *link, rc_command_callback_t callback, void *ctx)
 {
-    /* Check if data available */
-    if (!nrf24_is_data_available(&link->nrf24)) {
-        return RC_ERROR_NO_DATA;
+    if (!link) {
+        return;
     }
 
-    /* Receive packet */
-    uint8_t rx_len = 0;
-    if (!nrf24_receive(&link->nrf24, (uint8_t*)&link->rx_packet, &rx_len)) {
-        return RC_ERROR_HARDWARE;
-    }
+    link->command_callback = callback;
+    link->command_ctx = ctx;
+}
+#endif
 
-    /* Validate minimum size */
-    if (rx_len < sizeof(rc_packet_header_t) + 1) {
-        RC_LOG_WARN("Packet too small: %d bytes\n", rx_len);
-        return RC_ERROR_CRC_FAIL;
+uint8_t rc_link_mailbox_tx_free(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return 0;
     }
 
-    /* Validate CRC */
-    uint8_t crc_len = sizeof(rc_packet_header_t) + link->rx_packet.header.payload_len;
-    uint8_t expected_crc = rc_crc8_calculate((uint8_t*)&link->rx_packet, crc_len);
+    uint8_t used = (uint8_t)(atomic_load_explicit(&link->mb_tx_head, memory_order_relaxed) -
+                             atomic_load_explicit(&link->mb_tx_tail, memory_order_acquire));
 
-    if (link->rx_packet.crc8 != expected_crc) {
-        RC_LOG_WARN("CRC mismatch: expected 0x%02X, got 0x%02X\n",
-                   expected_crc, link->rx_packet.crc8);
-#if RC_ENABLE_STATISTICS
-        link->stats.crc_errors++;
+    return RC_MAILBOX_TX_SIZE - used;
+}
 #endif
-        return RC_ERROR_CRC_FAIL;
+
+/*============================================================================*/
+/* Common API                                                                 */
+/*============================================================================*/
+
+rc_status_t rc_link_update(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return RC_ERROR_INVALID_PARAM;
     }
 
-    /* Validate version */
-    if (link->rx_packet.header.version != RC_PROTOCOL_VERSION) {
-        RC_LOG_WARN("Version mismatch: expected %d, got %d\n",
-                   RC_PROTOCOL_VERSION, link->rx_packet.header.version);
-#if RC_ENABLE_STATISTICS
-        link->stats.version_mismatches++;
+#if RC_ENABLE_IRQ
+    check_tx_timeout(link);
 #endif
-        return RC_ERROR_VERSION_MISMATCH;
-    }
 
-    /* Check packet type */
-    if (link->rx_packet.header.type != expected_type) {
-        return RC_ERROR_NO_DATA;
-    }
+#if RC_ENABLE_BIND
+    bind_service(link);
+#endif
 
-    /* Check sequence gaps */
-    if (link->last_rx_time != UINT32_MAX) {
-        uint8_t expected_seq = link->rx_sequence_last + 1;
-        uint8_t gap = link->rx_packet.header.sequence - expected_seq;
+#if RC_ENABLE_CLOCK_SYNC
+    sync_service(link);
+#endif
 
-        if (gap > 0) {
-            link->consecutive_missed += gap;
+#if RC_ENABLE_FHSS
+    fhss_service(link);
+#endif
 
-#if RC_ENABLE_STATISTICS
-            link->stats.packets_missed += gap;
+#if RC_ENABLE_LINK_ADAPT
+    adapt_service(link);
 #endif
 
-            RC_LOG_DEBUG("Sequence gap: missed %d packets\n", gap);
-        } else {
-            link->consecutive_missed = 0;
-        }
-    }
+#if RC_NO_ACK_REPEAT
+    repeat_service(link);
+#endif
 
-    link->rx_sequence_last = link->rx_packet.header.sequence;
+#if RC_ENABLE_BULK
+    bulk_service(link);
+#endif
 
-    /* Copy payload */
-    if (payload && payload_len) {
-        *payload_len = link->rx_packet.header.payload_len;
-        if (*payload_len > 0) {
-            memcpy(payload, link->rx_packet.payload, *payload_len);
-        }
+#if RC_ENABLE_MAILBOX
+    /* The IRQ updates the same state as it decodes commands */
+    if (!bus_try_acquire(link)) {
+        return RC_OK;  /* Caught up on the next update */
     }
+#endif
+
+    update_link_state(link);
+    calculate_link_quality(link);
+
+#if RC_ENABLE_MAILBOX
+    bus_release(link);
+#endif
 
     return RC_OK;
-}
\ No newline at end of file
+}
+
+uint8_t rc_link_process_rx(rc_link_t *link, rc_rx_handler_t handler, void *ctx)
+{
+    if (!link || !link->initialized || !handler) {
+        return 0;
+    }
+
+#if !RC_ENABLE_IRQ
+    rx_poll(link);
+#endif
+
+    uint8_t delivered = 0;
+    uint8_t payload[RC_MAX_PAYLOAD_SIZE];
+
+    for (;;) {
+#if RC_ENABLE_IRQ
+        if (!bus_try_acquire(link)) {
+            break;  /* Rest stays queued for the next call */
+        }
+#endif
+
+        bool empty = (link->rx_ring_count == 0);
+        uint8_t type = 0;
+        uint8_t payload_len = 0;
+        rc_status_t status = RC_ERROR_NO_DATA;
+
+        if (!empty) {
+            /* Oldest first, whatever its type */
+            type = link->rx_pool[link->rx_ring[link->rx_ring_head]].header.type;
+            status = rx_take(link, (rc_packet_type_t)type, payload, &payload_len, NULL);
+        }
+
+#if RC_ENABLE_IRQ
+        bus_release(link);
+#endif
+
+        if (empty) {
+            break;
+        }
+
+        /* Handler runs with the bus free so it can reply */
+        if (status == RC_OK && rx_app_type(type)) {
+            mark_received(link, (rc_packet_type_t)type);
+            handler(link, type, payload, payload_len, ctx);
+            delivered++;
+        }
+    }
+
+    return delivered;
+}
+
+bool rc_link_is_active(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return false;
+    }
+
+    return link->link_active;
+}
+
+uint32_t rc_link_get_time_since_rx(rc_link_t *link)
+{
+    if (!link || !link->initialized || link->last_rx_time == UINT32_MAX) {
+        return UINT32_MAX;
+    }
+
+    return link->hw.get_tick_ms() - link->last_rx_time;
+}
+
+uint32_t rc_link_get_time_since_rx_us(rc_link_t *link)
+{
+    if (!link || !link->initialized || link->last_rx_time == UINT32_MAX) {
+        return UINT32_MAX;
+    }
+
+    return link_tick_us(link) - link->last_rx_us;
+}
+
+uint8_t rc_link_get_link_quality(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return 0;
+    }
+
+    return link->link_quality;
+}
+
+#if RC_ENABLE_RSSI
+uint8_t rc_link_get_rssi(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return 0;
+    }
+
+    return link->rssi;
+}
+#endif
+
+rc_status_t rc_link_set_failsafe(rc_link_t *link, const rc_command_payload_t *failsafe)
+{
+    if (!link || !link->initialized || !failsafe) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    memcpy(&link->failsafe_command, failsafe, sizeof(rc_command_payload_t));
+    failsafe_pack(link);
+
+    RC_LOG_INFO("Failsafe values updated\n");
+    return RC_OK;
+}
+
+rc_status_t rc_link_get_failsafe(rc_link_t *link, rc_command_payload_t *failsafe)
+{
+    if (!link || !link->initialized || !failsafe) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    memcpy(failsafe, &link->failsafe_command, sizeof(rc_command_payload_t));
+    return RC_OK;
+}
+
+#if RC_ENABLE_NO_ACK
+rc_status_t rc_link_set_no_ack(rc_link_t *link, uint8_t type, bool no_ack)
+{
+    if (!link || !link->initialized || type >= 32) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    if (no_ack) {
+        link->no_ack_types |= 1UL << type;
+    } else {
+        link->no_ack_types &= ~(1UL << type);
+    }
+
+    return RC_OK;
+}
+#endif
+
+uint32_t rc_link_get_airtime_us(rc_link_t *link, uint8_t payload_len)
+{
+    if (!link || !link->initialized || payload_len > RC_MAX_PAYLOAD_SIZE) {
+        return 0;
+    }
+
+#if RC_DYNAMIC_FRAMES
+    uint8_t frame_len = RC_PACKET_WIRE_LEN(payload_len);
+#else
+    uint8_t frame_len = sizeof(rc_packet_t);
+#endif
+
+#if RC_ENABLE_FEC
+    /* Sent without ACKs */
+    return NRF24_SETTLE_US + nrf24_airtime_us(link->radio, frame_len);
+#else
+#if RC_ENABLE_ACK_TELEMETRY
+    uint8_t ack_len = RC_PACKET_WIRE_LEN(sizeof(rc_telemetry_payload_t));
+#else
+    uint8_t ack_len = 0;
+#endif
+
+    return NRF24_SETTLE_US + nrf24_airtime_us(link->radio, frame_len) +
+           NRF24_SETTLE_US + nrf24_airtime_us(link->radio, ack_len);
+#endif
+}
+
+rc_status_t rc_link_check_radio(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+#if RC_ENABLE_IRQ
+    if (link->radio->tx_busy || !bus_try_acquire(link)) {
+        return RC_ERROR_BUSY;
+    }
+#endif
+
+    rc_status_t status = RC_OK;
+
+    if (!nrf24_verify_registers(link->radio)) {
+        RC_LOG_WARN("nRF24 registers diverged - restoring\n");
+        nrf24_resync_registers(link->radio);
+
+        if (!nrf24_verify_registers(link->radio)) {
+            RC_LOG_ERROR("nRF24 register restore failed\n");
+            status = RC_ERROR_HARDWARE;
+        }
+    }
+
+#if RC_ENABLE_DIVERSITY
+    if (link->diversity.initialized && !nrf24_verify_registers(&link->diversity)) {
+        RC_LOG_WARN("Diversity receiver registers diverged - restoring\n");
+        nrf24_resync_registers(&link->diversity);
+
+        if (!nrf24_verify_registers(&link->diversity)) {
+            RC_LOG_ERROR("Diversity receiver register restore failed\n");
+            status = RC_ERROR_HARDWARE;
+        }
+    }
+#endif
+
+#if RC_ENABLE_IRQ
+    bus_release(link);
+#endif
+
+    return status;
+}
+
+rc_status_t rc_link_set_address(rc_link_t *link, const uint8_t *address)
+{
+    if (!link || !link->initialized || !address) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+#if RC_ENABLE_IRQ
+    if (link->radio->tx_busy || !bus_try_acquire(link)) {
+        return RC_ERROR_BUSY;
+    }
+#endif
+
+    rc_status_t status = RC_OK;
+
+#if RC_ENABLE_MULTI_LINK
+    if (link->host != link && !nrf24_set_rx_pipe(link->radio, link->pipe, address)) {
+        status = RC_ERROR_INVALID_PARAM;  /* Bytes 1-4 clash with the other pipes */
+    } else {
+        memcpy(link->address, address, sizeof(link->address));
+
+        /* Otherwise applied the next time the link sends or listens */
+        if (link->host->pipe_link[0] == link) {
+            nrf24_set_addresses(link->radio, address, address);
+        }
+    }
+#else
+    /* Auto-ACK needs pipe 0 on the TX address */
+    nrf24_set_addresses(link->radio, address, address);
+#if RC_ENABLE_DIVERSITY
+    if (link->diversity.initialized) {
+        nrf24_set_addresses(&link->diversity, address, address);
+    }
+#endif
+#endif
+
+#if RC_ENABLE_IRQ
+    bus_release(link);
+#endif
+
+    return status;
+}
+
+#if RC_ENABLE_IRQ
+void rc_link_irq_handler(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return;
+    }
+
+    link = link_host(link);  /* The IRQ line belongs to the radio */
+
+    /* Someone is mid-transfer; bus_release() calls back in */
+    if (!bus_try_acquire(link)) {
+        link->irq_deferred = true;
+        return;
+    }
+
+#if RC_RX_STAMP
+    link->mb_irq_cycles = nrf24_cycle_count();  /* Either radio's RX_DR */
+#endif
+#if RC_ENABLE_CLOCK_SYNC
+    uint32_t irq_us = link_tick_us(link);       /* TX_DS of a ping */
+#endif
+
+    uint8_t events = nrf24_irq_handler(link->radio);
+
+#if RC_ENABLE_MULTI_LINK
+    rc_link_t *sender = link->tx_link;  /* Peer whose frame just completed */
+#else
+    rc_link_t *sender = link;
+#endif
+
+#if RC_ENABLE_RSSI || RC_ENABLE_LINK_ADAPT
+    uint8_t retries = 0;
+    if (events & (NRF24_EVENT_TX_DONE | NRF24_EVENT_MAX_RT)) {
+        bool delivered = !(events & NRF24_EVENT_MAX_RT);
+        retries = tx_retries(sender, delivered);
+
+#if RC_ENABLE_RSSI
+        rssi_sample_tx(sender, retries);
+#endif
+#if RC_ENABLE_LINK_ADAPT
+        adapt_after_tx(link, delivered, retries);
+#endif
+    }
+#endif
+
+#if RC_ENABLE_TX_QUEUE
+    /* Queued packets complete here, not through the single-send path */
+    if ((events & (NRF24_EVENT_TX_DONE | NRF24_EVENT_MAX_RT)) && link->txq_count > 0) {
+        txq_service(link, events);
+        events &= (uint8_t)~(NRF24_EVENT_TX_DONE | NRF24_EVENT_MAX_RT);
+    }
+#endif
+
+    if (events & (NRF24_EVENT_TX_DONE | NRF24_EVENT_MAX_RT)) {
+        TRACE_RECORD(sender, RC_TRACE_TX,
+                     (events & NRF24_EVENT_TX_DONE) ? RC_OK : RC_ERROR_TIMEOUT,
+                     sender->tx_packet.header.type, TRACE_RETRIES(retries),
+                     sender->tx_packet.header.sequence);
+#if RC_ENABLE_STATISTICS
+        if (events & NRF24_EVENT_TX_DONE) {
+            sender->stats.packets_sent++;
+        }
+#endif
+#if RC_ENABLE_LATENCY_STATS
+        if (events & NRF24_EVENT_TX_DONE) {
+            latency_record(sender, RC_LATENCY_AIR, sender->lat_tx_mark);
+        }
+#endif
+        record_frame(sender);
+
+#if RC_ENABLE_FHSS
+        fhss_after_tx(link, events & NRF24_EVENT_TX_DONE);
+#endif
+#if RC_ENABLE_TIERED_COMMAND
+        tier_after_tx(sender, events & NRF24_EVENT_TX_DONE);
+#endif
+#if RC_ENABLE_CLOCK_SYNC
+        sync_after_tx(sender, events & NRF24_EVENT_TX_DONE, irq_us);
+#endif
+
+#if !RC_ENABLE_ACK_TELEMETRY
+        /* Listen between transmissions (ACK mode never turns around) */
+#if RC_ENABLE_MULTI_LINK
+        peer_listen(link);
+#endif
+        nrf24_listen(link->radio);
+#endif
+#if RC_ENABLE_REPLY_WINDOW
+        reply_window_open(link, sender);
+#endif
+#if RC_ENABLE_DIVERSITY
+        diversity_resume(link);
+#endif
+
+#if RC_ENABLE_SPI_DMA
+        complete_async_tx(link, (events & NRF24_EVENT_TX_DONE) ? RC_OK : RC_ERROR_TIMEOUT);
+#endif
+    }
+
+    if (events & NRF24_EVENT_RX_READY) {
+#if RC_ENABLE_SPI_DMA
+        LATENCY_RX_READY(link);
+        link->rx_ready_us = link_tick_us(link);
+#if RC_ENABLE_RSSI
+        rssi_sample_rx(link);
+#endif
+        if (nrf24_read_payload_dma(link->radio)) {
+            return;  /* Bus released in on_dma_complete() */
+        }
+#else
+        rx_drain(link, link->radio);
+#endif
+    }
+
+#if RC_ENABLE_DIVERSITY
+    /* Both IRQ lines land here; the second receiver only ever has RX */
+    if (link->diversity.initialized &&
+        (nrf24_irq_handler(&link->diversity) & NRF24_EVENT_RX_READY)) {
+        rx_drain(link, &link->diversity);
+    }
+#endif
+
+#if RC_ENABLE_MAILBOX
+    mailbox_publish(link);
+    mailbox_tx_service(link);
+#endif
+
+    bus_release(link);
+}
+#endif
+
+#if RC_ENABLE_TDMA
+void rc_link_tdma_tick(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return;
+    }
+
+    bool downlink = link->tdma_downlink;
+    link->tdma_downlink = !downlink;
+
+    if (!downlink) {
+        /* Frame boundary */
+        link->tdma_frame++;
+        link->tdma_rx_frame = false;
+
+        if (link->role == RC_ROLE_GROUND) {
+            tdma_uplink_slot(link);
+        }
+    } else if (link->role == RC_ROLE_AIRCRAFT) {
+        tdma_downlink_slot(link);
+    }
+}
+#endif
+
+#if RC_ENABLE_TX_QUEUE
+/*============================================================================*/
+/* TX Queue API                                                               */
+/*============================================================================*/
+
+void rc_link_set_tx_queue_callback(rc_link_t *link, rc_tx_complete_t callback, void *ctx)
+{
+    if (!link) {
+        return;
+    }
+
+    link->txq_callback = callback;
+    link->txq_ctx = ctx;
+}
+
+rc_status_t rc_link_queue_packet(rc_link_t *link, uint8_t type, const void *payload,
+                                 uint8_t payload_len, uint8_t *sequence)
+{
+    if (!link || !link->initialized || (!payload && payload_len > 0) ||
+        payload_len > RC_MAX_PAYLOAD_SIZE) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    if (!bus_try_acquire(link)) {
+        return RC_ERROR_BUSY;
+    }
+
+    /* A regular send owns the radio until its IRQ */
+    if (link->txq_count >= NRF24_FIFO_DEPTH ||
+        (link->radio->tx_busy && link->txq_count == 0)) {
+        bus_release(link);
+        return RC_ERROR_BUSY;
+    }
+
+    encode_packet(link, (rc_packet_type_t)type, payload, payload_len);
+
+    rc_txq_entry_t *entry = &link->txq[(link->txq_head + link->txq_count) % NRF24_FIFO_DEPTH];
+    entry->type = type;
+    entry->sequence = link->tx_sequence;
+    entry->len = link->tx_len;
+    memcpy(&entry->frame, &link->tx_packet, link->tx_len);
+
+#if RC_TX_NO_ACK
+    tx_ack_policy(link, &entry->frame);
+#endif
+    bool queued = nrf24_queue_payload(link->radio, (uint8_t*)&entry->frame, entry->len);
+    if (queued) {
+        if (link->txq_count == 0) {
+            link->tx_start_time = link->hw.get_tick_ms();
+        }
+        link->txq_count++;
+
+        if (sequence) {
+            *sequence = link->tx_sequence;
+        }
+        link->tx_sequence++;
+    }
+
+    bus_release(link);
+
+    return queued ? RC_OK : RC_ERROR_BUSY;
+}
+
+uint8_t rc_link_tx_queue_free(rc_link_t *link)
+{
+    if (!link || !link->initialized ||
+        (link->radio->tx_busy && link->txq_count == 0)) {
+        return 0;
+    }
+
+    return NRF24_FIFO_DEPTH - link->txq_count;
+}
+#endif
+
+#if RC_ENABLE_SPI_DMA
+/*============================================================================*/
+/* Async API                                                                  */
+/*============================================================================*/
+
+void rc_link_set_async_callback(rc_link_t *link, rc_async_callback_t callback, void *ctx)
+{
+    if (!link) {
+        return;
+    }
+
+    link->async_callback = callback;
+    link->async_ctx = ctx;
+}
+
+rc_status_t rc_link_send_command_async(rc_link_t *link, const rc_command_payload_t *command)
+{
+    if (!link || !link->initialized || !command) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->role = RC_ROLE_GROUND;
+
+    rc_status_t status = encode_and_send_async(link, RC_PKT_COMMAND, command,
+                                               sizeof(rc_command_payload_t));
+
+    if (status == RC_OK) {
+        link->tx_sequence++;
+    }
+
+    return status;
+}
+
+rc_status_t rc_link_send_telemetry_async(rc_link_t *link, const rc_telemetry_payload_t *telemetry)
+{
+    if (!link || !link->initialized || !telemetry) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->role = RC_ROLE_AIRCRAFT;
+
+#if RC_ENABLE_RSSI
+    rc_telemetry_payload_t stamped = *telemetry;
+    stamped.rssi = link->rssi;
+    telemetry = &stamped;
+#endif
+
+#if RC_ENABLE_ACK_TELEMETRY
+    /* Short blocking upload; TX_DS reports when the ACK carried it */
+    link->async_tx_type = RC_PKT_TELEMETRY;
+    link->async_tx_active = true;
+
+    rc_status_t status = queue_ack_payload(link, RC_PKT_TELEMETRY, telemetry,
+                                           sizeof(rc_telemetry_payload_t));
+
+    if (status != RC_OK) {
+        link->async_tx_active = false;
+    }
+#else
+    rc_status_t status = encode_and_send_async(link, RC_PKT_TELEMETRY, telemetry,
+                                               sizeof(rc_telemetry_payload_t));
+#endif
+
+    if (status == RC_OK) {
+        link->tx_sequence++;
+    }
+
+    return status;
+}
+
+rc_status_t rc_link_receive_command_async(rc_link_t *link, rc_command_payload_t *command)
+{
+    if (!link || !link->initialized || !command) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->role = RC_ROLE_AIRCRAFT;
+
+    /* Type first: the ISR keys on the buffer pointer */
+    link->async_rx_type = RC_PKT_COMMAND;
+    link->async_rx_buffer = command;
+
+    return RC_OK;
+}
+
+rc_status_t rc_link_receive_telemetry_async(rc_link_t *link, rc_telemetry_payload_t *telemetry)
+{
+    if (!link || !link->initialized || !telemetry) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->async_rx_type = RC_PKT_TELEMETRY;
+    link->async_rx_buffer = telemetry;
+
+    return RC_OK;
+}
+
+void rc_link_spi_dma_complete(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return;
+    }
+
+    nrf24_spi_dma_complete(link->radio);
+}
+
+void rc_link_spi_dma_error(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return;
+    }
+
+    nrf24_spi_dma_error(link->radio);
+}
+#endif
+
+#if RC_ENABLE_FHSS
+/*============================================================================*/
+/* Frequency Hopping API                                                      */
+/*============================================================================*/
+
+rc_status_t rc_link_fhss_set_bind_id(rc_link_t *link, uint32_t bind_id)
+{
+    if (!link || !link->initialized) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+#if RC_ENABLE_IRQ
+    if (link->radio->tx_busy || !bus_try_acquire(link)) {
+        return RC_ERROR_BUSY;
+    }
+#endif
+
+    fhss_reset(link, bind_id);
+
+#if RC_ENABLE_IRQ
+    bus_release(link);
+#endif
+
+    RC_LOG_INFO("FHSS bind ID set to 0x%08lX\n", (unsigned long)bind_id);
+    return RC_OK;
+}
+
+rc_status_t rc_link_fhss_set_blacklist(rc_link_t *link, const uint8_t *blacklist)
+{
+    if (!link || !link->initialized || !blacklist) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    if (link->hop_staged) {
+        return RC_ERROR_BUSY;
+    }
+
+    uint8_t next = link->hop_gen ^ 1;
+
+    memcpy(link->hop_blacklist[next], blacklist, RC_FHSS_MAP_BYTES);
+    rc_fhss_build_table(link->hop_table[next], link->fhss_bind_id, blacklist);
+    link->hop_valid |= (uint8_t)(1u << next);
+
+    link->hop_staged_acked = false;
+    link->hop_apply_seq = link->tx_sequence + RC_FHSS_MAP_LEAD;
+    link->hop_staged = true;
+
+    RC_LOG_INFO("FHSS blacklist staged (apply at seq=%d)\n", link->hop_apply_seq);
+    return RC_OK;
+}
+
+rc_status_t rc_link_fhss_send_map(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->role = RC_ROLE_GROUND;
+
+    rc_fhss_map_payload_t map;
+    uint8_t gen = link->hop_staged ? (link->hop_gen ^ 1) : link->hop_gen;
+
+    memcpy(map.blacklist, link->hop_blacklist[gen], RC_FHSS_MAP_BYTES);
+    map.apply_sequence = link->hop_staged ? link->hop_apply_seq : link->tx_sequence;
+    map.generation = gen;
+
+    rc_status_t status = encode_and_send(link, RC_PKT_HOP_MAP, &map,
+                                         sizeof(rc_fhss_map_payload_t));
+
+    if (status == RC_OK) {
+        tx_sent(link);
+
+        RC_LOG_DEBUG("Hop map sent (gen=%d, seq=%d)\n", gen, link->tx_sequence - 1);
+    }
+
+    return status;
+}
+
+bool rc_link_fhss_map_pending(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return false;
+    }
+
+    return link->hop_staged;
+}
+
+rc_status_t rc_link_fhss_get_stats(rc_link_t *link, rc_fhss_slot_stats_t *stats)
+{
+    if (!link || !link->initialized || !stats) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    for (uint8_t slot = 0; slot < RC_FHSS_HOP_COUNT; slot++) {
+        stats[slot] = link->hop_stats[slot];
+        stats[slot].channel = link->hop_table[link->hop_gen][slot];
+    }
+
+    return RC_OK;
+}
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+/*============================================================================*/
+/* Link Adaptation API                                                        */
+/*============================================================================*/
+
+uint8_t rc_link_adapt_get_profile(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return RC_ADAPT_HOME;
+    }
+
+    return link->adapt_profile;
+}
+
+bool rc_link_adapt_switch_pending(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return false;
+    }
+
+    return link->adapt_staged;
+}
+
+uint8_t rc_link_adapt_get_quality(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return 0;
+    }
+
+    return link->adapt_quality;
+}
+#endif
+
+#if RC_ENABLE_MULTI_LINK
+/*============================================================================*/
+/* Multi-Link API                                                             */
+/*============================================================================*/
+
+rc_status_t rc_link_add_peer(rc_link_t *host, uint8_t pipe, rc_link_t *peer,
+                             const uint8_t *address, uint8_t weight)
+{
+    if (!host || !host->initialized || host->host != host || !peer || peer == host ||
+        peer->initialized || !address || pipe == 0 || pipe >= NRF24_PIPE_COUNT ||
+        host->pipe_link[pipe]) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+#if RC_ENABLE_IRQ
+    if (!bus_try_acquire(host)) {
+        return RC_ERROR_BUSY;
+    }
+#endif
+
+    bool opened = nrf24_set_rx_pipe(host->radio, pipe, address);
+
+#if RC_ENABLE_IRQ
+    host->pipe_close &= (uint8_t)~(1U << pipe);  /* Reopened before a detach closed it */
+    bus_release(host);
+#endif
+
+    if (!opened) {
+        RC_LOG_ERROR("Pipe %d address clashes with the other pipes\n", pipe);
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    memset(peer, 0, sizeof(rc_link_t));
+    memcpy(&peer->hw, &host->hw, sizeof(rc_hardware_config_t));
+    peer->radio = host->radio;
+    peer->host = host;
+    peer->pipe = pipe;
+    memcpy(peer->address, address, sizeof(peer->address));
+
+    link_state_init(peer);
+    peer->peer_weight = weight;
+#if RC_ENABLE_STATISTICS
+    peer->spi_stats_base = spi_count(peer);  /* Counts are radio-wide */
+    peer->spi_frame_mark = peer->spi_stats_base;
+#endif
+    peer->initialized = true;
+
+    /* Published last: the IRQ routes by this */
+    host->pipe_link[pipe] = peer;
+
+    RC_LOG_INFO("Peer added on pipe %d\n", pipe);
+
+    return RC_OK;
+}
+
+rc_link_t *rc_link_get_peer(rc_link_t *host, uint8_t pipe)
+{
+    if (!host || !host->initialized || host->host != host || pipe >= NRF24_PIPE_COUNT) {
+        return NULL;
+    }
+
+    return (pipe == 0) ? host : host->pipe_link[pipe];
+}
+
+rc_status_t rc_link_set_peer_weight(rc_link_t *link, uint8_t weight)
+{
+    if (!link || !link->initialized) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->peer_weight = weight;
+    link->peer_credit = 0;
+
+    return RC_OK;
+}
+
+rc_link_t *rc_link_next_peer(rc_link_t *host)
+{
+    if (!host || !host->initialized || host->host != host) {
+        return NULL;
+    }
+
+    /* Smooth weighted round-robin: everyone earns their weight, the
+     * richest sends and pays the total, so shares interleave evenly */
+    rc_link_t *best = NULL;
+    int16_t total = 0;
+
+    for (uint8_t pipe = 0; pipe < NRF24_PIPE_COUNT; pipe++) {
+        rc_link_t *peer = (pipe == 0) ? host : host->pipe_link[pipe];
+
+        if (!peer || peer->peer_weight == 0) {
+            continue;
+        }
+
+        peer->peer_credit += peer->peer_weight;
+        total += peer->peer_weight;
+
+        if (!best || peer->peer_credit > best->peer_credit) {
+            best = peer;
+        }
+    }
+
+    if (best) {
+        best->peer_credit -= total;
+    }
+
+    return best;
+}
+#endif
+
+#if RC_ENABLE_BULK
+/*============================================================================*/
+/* Bulk Stream API                                                            */
+/*============================================================================*/
+
+rc_status_t rc_link_bulk_send(rc_link_t *link, const void *data, uint32_t len)
+{
+    if (!link || !link->initialized || (!data && len > 0)) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    if (link->bulk_tx.state == RC_BULK_ACTIVE) {
+        return RC_ERROR_BUSY;
+    }
+
+    rc_bulk_tx_start(&link->bulk_tx, data, len, link->hw.get_tick_ms());
+    link->bulk_grant = 0;  /* Earned afresh by the new stream */
+
+    return RC_OK;
+}
+
+rc_status_t rc_link_bulk_receive(rc_link_t *link, void *buffer, uint32_t size)
+{
+    if (!link || !link->initialized || (!buffer && size > 0)) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    if (link->bulk_rx.state == RC_BULK_ACTIVE) {
+        return RC_ERROR_BUSY;
+    }
+
+    rc_bulk_rx_start(&link->bulk_rx, buffer, size);
+    link->bulk_ack_owed = false;
+    link->bulk_linger = 0;
+
+    return RC_OK;
+}
+
+void rc_link_bulk_cancel(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return;
+    }
+
+    link->bulk_tx.state = RC_BULK_IDLE;
+    link->bulk_rx.state = RC_BULK_IDLE;
+    link->bulk_waiting = false;
+    link->bulk_ack_owed = false;
+    link->bulk_linger = 0;
+    link->bulk_grant = 0;
+}
+
+rc_status_t rc_link_bulk_get_tx_status(rc_link_t *link, rc_bulk_status_t *status)
+{
+    if (!link || !link->initialized || !status) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    rc_bulk_tx_status(&link->bulk_tx, link->hw.get_tick_ms(), status);
+
+    return RC_OK;
+}
+
+rc_status_t rc_link_bulk_get_rx_status(rc_link_t *link, rc_bulk_status_t *status)
+{
+    if (!link || !link->initialized || !status) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    rc_bulk_rx_status(&link->bulk_rx, link->hw.get_tick_ms(), status);
+
+    return RC_OK;
+}
+#endif
+
+#if RC_ENABLE_TRACE
+/*============================================================================*/
+/* Trace API                                                                  */
+/*============================================================================*/
+
+/* Records taken from the ring; lost ones reach the statistics */
+static uint16_t trace_take(rc_link_t *link, rc_trace_record_t *out, uint16_t max)
+{
+#if RC_ENABLE_STATISTICS
+    uint32_t lost = link->trace.lost;
+#endif
+
+    uint16_t n = rc_trace_read(&link->trace, out, max);
+
+#if RC_ENABLE_STATISTICS
+    link->stats.trace_lost += link->trace.lost - lost;
+#endif
+
+    return n;
+}
+
+uint16_t rc_link_trace_read(rc_link_t *link, uint8_t *buffer, uint16_t size)
+{
+    if (!link || !link->initialized || !buffer) {
+        return 0;
+    }
+
+    rc_trace_record_t records[16];
+    uint16_t max = size / RC_TRACE_RECORD_SIZE;
+    uint16_t written = 0;
+
+    while (written < max) {
+        uint16_t want = max - written;
+        uint16_t n = trace_take(link, records, want < 16 ? want : 16);
+        if (n == 0) {
+            break;
+        }
+
+        for (uint16_t i = 0; i < n; i++) {
+            rc_trace_pack(&records[i], buffer + (written + i) * RC_TRACE_RECORD_SIZE);
+        }
+        written += n;
+    }
+
+    return (uint16_t)(written * RC_TRACE_RECORD_SIZE);
+}
+
+uint16_t rc_link_trace_drain_itm(rc_link_t *link, uint8_t port, uint16_t max)
+{
+    if (!link || !link->initialized || port > 31) {
+        return 0;
+    }
+
+    /* No debugger listening: leave the records for later */
+    if (!(ITM->TCR & ITM_TCR_ITMENA_Msk) || !(ITM->TER & (1UL << port))) {
+        return 0;
+    }
+
+    uint16_t written = 0;
+    rc_trace_record_t record;
+
+    /* A record is only taken while the FIFO has room for its first word;
+     * the second follows as soon as that one is out */
+    while (written < max && ITM->PORT[port].u32 != 0 && trace_take(link, &record, 1) == 1) {
+        ITM->PORT[port].u32 = record.time;
+        while (ITM->PORT[port].u32 == 0) {
+        }
+        ITM->PORT[port].u32 = record.info;
+        written++;
+    }
+
+    return written;
+}
+#endif
+
+#if RC_ENABLE_BIND
+/*============================================================================*/
+/* Bind API                                                                   */
+/*============================================================================*/
+
+rc_status_t rc_link_bind_start(rc_link_t *link, const rc_bind_info_t *info)
+{
+    if (!link || !link->initialized || (info && !rc_bind_valid(info))) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    /* Started again while binding: cancel still returns to the old pair */
+    rc_bind_state_t prev = BIND_RUNNING(link) ? link->bind_prev : link->bind_state;
+
+    if (!bind_switch(link, RC_BIND_RUNNING)) {
+        return RC_ERROR_BUSY;
+    }
+
+    link->role = info ? RC_ROLE_GROUND : RC_ROLE_AIRCRAFT;
+    link->bind_prev = prev;
+    link->bind_heard = false;
+    link->bind_reply = false;
+    link->bind_start = link->hw.get_tick_ms();
+    link->bind_last = link->bind_start - RC_BIND_INTERVAL_MS;  /* Offer on the next update */
+
+    if (info) {
+        link->bind_offer = *info;
+    }
+
+    RC_LOG_INFO("Binding as %s (ch=%d)\n", info ? "ground" : "aircraft", RC_BIND_CHANNEL);
+    return RC_OK;
+}
+
+rc_status_t rc_link_bind_cancel(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    if (!BIND_RUNNING(link)) {
+        return RC_OK;
+    }
+
+    if (!bind_switch(link, link->bind_prev)) {
+        return RC_ERROR_BUSY;
+    }
+
+    RC_LOG_INFO("Bind cancelled\n");
+    return RC_OK;
+}
+
+rc_bind_state_t rc_link_get_bind_state(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return RC_BIND_UNBOUND;
+    }
+
+    return link->bind_state;
+}
+
+rc_status_t rc_link_get_bind_info(rc_link_t *link, rc_bind_info_t *info)
+{
+    if (!link || !link->initialized || !info) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    rc_bind_state_t state = BIND_RUNNING(link) ? link->bind_prev : link->bind_state;
+    if (state != RC_BIND_BOUND) {
+        return RC_ERROR_NO_DATA;
+    }
+
+    *info = link->bind_info;
+    return RC_OK;
+}
+#endif
+
+#if RC_ENABLE_CLOCK_SYNC
+/*============================================================================*/
+/* Clock Sync API                                                             */
+/*============================================================================*/
+
+rc_status_t rc_link_sync_ping(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->role = RC_ROLE_GROUND;
+
+    rc_sync_payload_t ping;
+    ping.phase = RC_SYNC_PING;
+    ping.id = (uint8_t)(link->sync_id + 1);
+    ping.rx_us = 0;
+
+    /* Armed first: the polling path stamps and completes it inside the send */
+    rc_sync_state_t prev = link->sync_state;
+    link->sync_state = RC_SYNC_ARMED;
+
+    rc_status_t status = encode_and_send(link, RC_PKT_HEARTBEAT, &ping, sizeof(ping));
+
+    if (status == RC_ERROR_BUSY) {
+        link->sync_state = prev;  /* Nothing went out; an echo due still counts */
+        return status;
+    }
+
+    link->sync_id = ping.id;
+    link->sync_last = link->hw.get_tick_ms();
+
+    if (status == RC_OK) {
+        tx_sent(link);
+    } else {
+        link->sync_state = RC_SYNC_IDLE;
+    }
+
+    return status;
+}
+
+bool rc_link_sync_pending(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return false;
+    }
+
+    return link->hw.get_tick_ms() - link->sync_last >= RC_SYNC_INTERVAL_MS;
+}
+
+rc_status_t rc_link_get_clock_sync(rc_link_t *link, uint32_t *rtt_us, int32_t *offset_us)
+{
+    if (!link || !link->initialized) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t rtt;
+    int32_t offset;
+
+    if (!rc_sync_estimate(&link->sync_filter, &rtt, &offset)) {
+        return RC_ERROR_NO_DATA;
+    }
+
+    if (rtt_us) {
+        *rtt_us = rtt;
+    }
+    if (offset_us) {
+        *offset_us = offset;
+    }
+
+    return RC_OK;
+}
+#endif
+
+/*============================================================================*/
+/* Statistics API                                                             */
+/*============================================================================*/
+
+#if RC_ENABLE_STATISTICS
+rc_status_t rc_link_get_stats(rc_link_t *link, rc_stats_t *stats)
+{
+    if (!link || !link->initialized || !stats) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    link->stats.spi_transactions = spi_count(link) - link->spi_stats_base;
+
+    memcpy(stats, &link->stats, sizeof(rc_stats_t));
+    return RC_OK;
+}
+
+void rc_link_reset_stats(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return;
+    }
+
+    memset(&link->stats, 0, sizeof(rc_stats_t));
+    link->spi_stats_base = spi_count(link);
+#if RC_ENABLE_FHSS
+    memset(link->hop_stats, 0, sizeof(link->hop_stats));
+#endif
+    RC_LOG_INFO("Statistics reset\n");
+}
+#endif
+
+#if RC_ENABLE_LATENCY_STATS
+rc_status_t rc_link_get_latency_stats(rc_link_t *link, rc_latency_stats_t *stats)
+{
+    if (!link || !link->initialized || !stats) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    memcpy(stats, &link->latency, sizeof(rc_latency_stats_t));
+    return RC_OK;
+}
+
+void rc_link_reset_latency_stats(rc_link_t *link)
+{
+    if (!link || !link->initialized) {
+        return;
+    }
+
+    memset(&link->latency, 0, sizeof(rc_latency_stats_t));
+}
+
+uint32_t rc_latency_percentile_us(const rc_latency_hist_t *hist, uint8_t percent)
+{
+    if (!hist || hist->count == 0) {
+        return 0;
+    }
+
+    if (percent > 100) {
+        percent = 100;
+    }
+
+    /* Rank of the sample at the percentile, rounded up */
+    uint32_t rank = (uint32_t)(((uint64_t)hist->count * percent + 99) / 100);
+    uint32_t seen = 0;
+
+    for (uint8_t i = 0; i < RC_LATENCY_BUCKETS - 1; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            uint32_t edge = 2UL << i;  /* Exclusive upper edge of bucket i */
+            return (edge - 1 < hist->max_us) ? edge - 1 : hist->max_us;
+        }
+    }
+
+    return hist->max_us;
+}
+#endif
+
+/*============================================================================*/
+/* Private Functions                                                          */
+/*============================================================================*/
+
+static void update_link_state(rc_link_t *link)
+{
+    uint32_t time_since_rx = rc_link_get_time_since_rx(link);
+    bool was_active = link->link_active;
+
+    /* Check timeout condition */
+    bool timeout = (time_since_rx != UINT32_MAX) && (time_since_rx > RC_LINK_TIMEOUT_MS);
+
+    /* Check sequence gap condition */
+    bool sequence_gap = (link->consecutive_missed >= RC_LINK_LOSS_THRESHOLD);
+
+    /* Link active if neither condition met */
+    link->link_active = !timeout && !sequence_gap;
+
+    /* Log state changes */
+    if (was_active && !link->link_active) {
+        if (timeout) {
+            RC_LOG_WARN("Link lost: timeout (%lu ms)\n", time_since_rx);
+        } else {
+            RC_LOG_WARN("Link lost: %d consecutive missed packets\n",
+                       link->consecutive_missed);
+        }
+#if RC_ENABLE_STATISTICS
+        link->loss_rx_time = link->last_rx_time;
+        link->loss_pending = true;
+#endif
+    } else if (!was_active && link->link_active) {
+        RC_LOG_INFO("Link restored\n");
+        link->consecutive_missed = 0;
+#if RC_ENABLE_STATISTICS
+        if (link->loss_pending) {
+            /* The frame that brought it back, not this update */
+            uint32_t down = link->last_rx_time - link->loss_rx_time;
+
+            link->stats.reconnects++;
+            link->stats.reconnect_ms = down;
+            if (down > link->stats.reconnect_max_ms) {
+                link->stats.reconnect_max_ms = down;
+            }
+            link->loss_pending = false;
+        }
+#endif
+    }
+}
+
+static void calculate_link_quality(rc_link_t *link)
+{
+    /* Aircraft: commands are periodic, so silence is loss too. A slot
+     * counts as missed half an interval after it was due */
+    if (link->role == RC_ROLE_AIRCRAFT && link->last_rx_time != UINT32_MAX &&
+        RC_LQ_INTERVAL_MS > 0) {
+        uint32_t silent = link->hw.get_tick_ms() - link->last_rx_time;
+        uint32_t due = (silent >= RC_LQ_INTERVAL_MS / 2) ?
+                       (silent - RC_LQ_INTERVAL_MS / 2) / RC_LQ_INTERVAL_MS : 0;
+
+        if (due > UINT8_MAX) {
+            due = UINT8_MAX;
+        }
+
+        if (due > link->lq_aged) {
+            link->link_quality = window_push(&link->lq_window, &link->lq_filled,
+                                             (uint8_t)(due - link->lq_aged), false);
+            link->lq_aged = (uint8_t)due;
+        }
+    }
+
+#if RC_ENABLE_STATISTICS
+    link->stats.link_quality = link->link_quality;
+#if RC_ENABLE_RSSI
+    link->stats.rssi = link->rssi;
+#endif
+#endif
+}
+
+static uint8_t window_push(uint32_t *window, uint8_t *filled, uint8_t misses, bool hit)
+{
+    uint32_t bits = *window;
+    uint8_t count = *filled;
+
+    if (misses >= RC_LQ_WINDOW) {
+        bits = 0;
+        count = RC_LQ_WINDOW;
+    } else {
+        bits <<= misses;
+        count += misses;
+    }
+
+    if (hit) {
+        bits = (bits << 1) | 1U;
+        count++;
+    }
+
+    if (count > RC_LQ_WINDOW) {
+        count = RC_LQ_WINDOW;
+    }
+
+    *window = bits & RC_LQ_MASK;
+    *filled = count;
+
+    return count ? (uint8_t)(__builtin_popcount(*window) * 100U / count) : 0;
+}
+
+static void lq_on_packet(rc_link_t *link, uint8_t gap)
+{
+    uint8_t misses = 0;
+
+    if (link->lq_aged > gap) {
+        /* Silence overcounted (sender late or slower than RC_LQ_INTERVAL_MS):
+         * the newest bits are those zeros, take them back */
+        uint8_t extra = link->lq_aged - gap;
+
+        link->lq_window = (extra >= 32) ? 0 : link->lq_window >> extra;
+        link->lq_filled = (link->lq_filled > extra) ? link->lq_filled - extra : 0;
+    } else {
+        misses = gap - link->lq_aged;
+    }
+
+    link->lq_aged = 0;
+    link->link_quality = window_push(&link->lq_window, &link->lq_filled, misses, true);
+}
+
+#if RC_ENABLE_RSSI || RC_ENABLE_LINK_ADAPT
+static uint8_t tx_retries(rc_link_t *link, bool delivered)
+{
+    /* MAX_RT used every retry; its payload is flushed, so nothing to read */
+    return delivered ? nrf24_retransmit_count(link->radio)
+                     : RC_AUTO_RETRANSMIT_COUNT + 1;
+}
+#endif
+
+#if RC_ENABLE_RSSI
+static void rssi_sample_rx(rc_link_t *link)
+{
+    bool high = nrf24_received_power_high(link->radio);
+
+    link->rpd_percent = window_push(&link->rpd_window, &link->rpd_filled,
+                                    high ? 0 : 1, high);
+    rssi_update(link);
+}
+
+static void rssi_sample_tx(rc_link_t *link, uint8_t retries)
+{
+#if RC_TX_NO_ACK
+    if (link->radio->tx_no_ack) {
+        return;  /* Sent once, so no retransmits to go by */
+    }
+#endif
+
+    int32_t sample = (int32_t)retries * 16;
+
+    if (!link->arc_valid) {
+        link->arc_avg = (uint16_t)sample;
+        link->arc_valid = true;
+    } else {
+        link->arc_avg = (uint16_t)(link->arc_avg + (sample - (int32_t)link->arc_avg) / 8);
+    }
+
+    rssi_update(link);
+}
+
+static void rssi_update(rc_link_t *link)
+{
+    /* Half from how many packets cleared RPD, half from retransmits */
+    uint32_t worst = (RC_AUTO_RETRANSMIT_COUNT + 1) * 16U;
+    uint32_t retry_penalty = (uint32_t)link->arc_avg * 100U / worst;
+    uint8_t retry_score = (uint8_t)(retry_penalty >= 100 ? 0 : 100 - retry_penalty);
+
+    if (link->rpd_filled && link->arc_valid) {
+        link->rssi = (uint8_t)((link->rpd_percent + retry_score) / 2);
+    } else if (link->rpd_filled) {
+        link->rssi = link->rpd_percent;
+    } else if (link->arc_valid) {
+        link->rssi = retry_score;
+    }
+}
+#endif
+
+#if RC_ENABLE_STATISTICS
+static uint32_t spi_count(const rc_link_t *link)
+{
+#if RC_ENABLE_DIVERSITY
+    return link->radio->spi_transactions + link->diversity.spi_transactions;
+#else
+    return link->radio->spi_transactions;
+#endif
+}
+#endif
+
+static void record_frame(rc_link_t *link)
+{
+#if RC_ENABLE_STATISTICS
+    uint32_t spi_total = spi_count(link);
+    uint32_t used = spi_total - link->spi_frame_mark;
+
+    link->stats.spi_per_frame = (used > UINT8_MAX) ? UINT8_MAX : (uint8_t)used;
+    link->spi_frame_mark = spi_total;
+#else
+    (void)link;
+#endif
+}
+
+#if RC_ENABLE_LATENCY_STATS
+static void latency_record(rc_link_t *link, rc_latency_stage_t stage, uint32_t start)
+{
+    uint32_t us = nrf24_cycles_to_us(nrf24_cycle_count() - start);
+    rc_latency_hist_t *hist = &link->latency.stage[stage];
+
+    /* log2 bucket: 0 and 1 µs share bucket 0 */
+    uint8_t bucket = 0;
+    for (uint32_t v = us >> 1; v && bucket < RC_LATENCY_BUCKETS - 1; v >>= 1) {
+        bucket++;
+    }
+    hist->buckets[bucket]++;
+
+    if (hist->count == 0 || us < hist->min_us) {
+        hist->min_us = us;
+    }
+    if (us > hist->max_us) {
+        hist->max_us = us;
+    }
+    hist->total_us += us;
+    hist->count++;
+}
+
+static void latency_tx_uploaded(rc_link_t *link)
+{
+    latency_record(link, RC_LATENCY_SPI_UPLOAD, link->lat_tx_mark);
+
+    /* Air time runs from here to TX_DS */
+    link->lat_tx_mark = nrf24_cycle_count();
+}
+#endif
+
+#if RC_ENABLE_IRQ
+static rc_link_t *link_host(rc_link_t *link)
+{
+#if RC_ENABLE_MULTI_LINK
+    return link->host;
+#else
+    return link;
+#endif
+}
+
+static bool bus_try_acquire(rc_link_t *link)
+{
+    return !atomic_flag_test_and_set(&link_host(link)->bus_lock);
+}
+
+static void bus_release(rc_link_t *link)
+{
+    link = link_host(link);  /* One bus per radio */
+
+#if RC_ENABLE_MULTI_LINK
+    peer_close_pipes(link);
+#endif
+    atomic_flag_clear(&link->bus_lock);
+
+    /* Service an IRQ that fired while the bus was held */
+    if (link->irq_deferred) {
+        link->irq_deferred = false;
+        rc_link_irq_handler(link);
+    }
+}
+
+static bool tx_held(rc_link_t *link)
+{
+    if (link->radio->tx_busy) {
+        return true;
+    }
+
+#if RC_ENABLE_REPLY_WINDOW
+    /* The aircraft may be turning around to answer the last frame */
+    if (link->role == RC_ROLE_GROUND) {
+        rc_link_t *host = link_host(link);
+        return (int32_t)(link_tick_us(host) - host->reply_until_us) < 0;
+    }
+#endif
+
+    return false;
+}
+
+#if RC_ENABLE_REPLY_WINDOW
+static void reply_window_open(rc_link_t *link, rc_link_t *sender)
+{
+    if (sender->role != RC_ROLE_GROUND) {
+        return;
+    }
+
+#if RC_ENABLE_BULK
+    if (sender->tx_packet.header.type == RC_PKT_BULK) {
+        return;  /* The transfer polls for its own replies */
+    }
+#endif
+
+    /* Its settle, a full downlink frame and our ACK, plus its IRQ and loop */
+    link->reply_until_us = link_tick_us(link) + RC_REPLY_SLACK_US +
+                           rc_link_get_airtime_us(sender, RC_MAX_PAYLOAD_SIZE);
+}
+#endif
+
+static void check_tx_timeout(rc_link_t *link)
+{
+    link = link_host(link);
+
+    if (!link->radio->tx_busy ||
+        (link->hw.get_tick_ms() - link->tx_start_time) <= RC_IRQ_TX_TIMEOUT_MS) {
+        return;
+    }
+
+    if (!bus_try_acquire(link)) {
+        return;  /* Retry on the next update */
+    }
+
+    /* Completion IRQ never arrived - recover the radio */
+    if (!nrf24_reinit(link->radio)) {
+        RC_LOG_ERROR("nRF24 re-init failed\n");
+        link->radio->tx_busy = false;
+    }
+#if RC_ENABLE_MULTI_LINK
+    peer_listen(link);
+#endif
+    nrf24_listen(link->radio);
+#if RC_ENABLE_DIVERSITY
+    diversity_resume(link);
+#endif
+
+#if RC_ENABLE_SPI_DMA
+    complete_async_tx(link, RC_ERROR_TIMEOUT);
+#endif
+
+#if RC_ENABLE_TX_QUEUE
+    /* Re-init flushed the FIFO */
+    while (link->txq_count > 0) {
+        txq_complete(link, RC_ERROR_TIMEOUT);
+    }
+#endif
+
+    bus_release(link);
+
+    RC_LOG_WARN("TX completion IRQ missed\n");
+}
+#endif
+
+#if RC_ENABLE_MULTI_LINK
+static void peer_select(rc_link_t *link)
+{
+    /* Bus held. Pipe 0 doubles as the ACK pipe, so it follows TX_ADDR */
+    rc_link_t *host = link->host;
+
+    host->tx_link = link;
+    if (host->pipe_link[0] == link) {
+        return;
+    }
+
+    /* Frames already in the FIFO were matched against the old pipe 0 */
+    if (nrf24_is_data_available(link->radio)) {
+        rx_drain(host, host->radio);
+    }
+
+    nrf24_set_addresses(link->radio, link->address, link->address);
+    host->pipe_link[0] = link;
+}
+
+#if RC_ENABLE_IRQ || !RC_ENABLE_ACK_TELEMETRY
+static void peer_listen(rc_link_t *host)
+{
+    /* While listening, pipe 0 is the host's own address again */
+    if (host->pipe_link[0] == host) {
+        return;
+    }
+
+    nrf24_set_addresses(host->radio, host->address, host->address);
+    host->pipe_link[0] = host;
+}
+#endif
+
+static void peer_detach(rc_link_t *peer)
+{
+    rc_link_t *host = peer->host;
+
+    /* Unrouted first: pointer stores the IRQ sees whole, so nothing
+     * reaches the peer once this returns, bus or no bus */
+    host->pipe_link[peer->pipe] = NULL;
+    if (host->pipe_link[0] == peer) {
+        host->pipe_link[0] = NULL;  /* Restored by the next peer_listen()/peer_select() */
+    }
+    if (host->tx_link == peer) {
+        host->tx_link = host;
+    }
+    peer->initialized = false;
+
+#if RC_ENABLE_IRQ
+    /* Closing the pipe takes the bus: now if free, else on its release */
+    host->pipe_close |= (uint8_t)(1U << peer->pipe);
+    if (bus_try_acquire(host)) {
+        bus_release(host);
+    }
+#else
+    nrf24_set_rx_pipe(host->radio, peer->pipe, NULL);
+#endif
+
+    RC_LOG_INFO("Peer removed from pipe %d\n", peer->pipe);
+}
+
+#if RC_ENABLE_IRQ
+static void peer_close_pipes(rc_link_t *host)
+{
+    /* Bus held */
+    if (!host->pipe_close) {
+        return;
+    }
+
+    for (uint8_t pipe = 1; pipe < NRF24_PIPE_COUNT; pipe++) {
+        if (host->pipe_close & (1U << pipe)) {
+            nrf24_set_rx_pipe(host->radio, pipe, NULL);
+        }
+    }
+    host->pipe_close = 0;
+}
+#endif
+
+static rc_link_t *peer_route(rc_link_t *host, uint8_t pipe)
+{
+    return (pipe < NRF24_PIPE_COUNT) ? host->pipe_link[pipe] : NULL;
+}
+#endif
+
+#if RC_ENABLE_DIVERSITY
+static bool diversity_init(rc_link_t *link, const nrf24_hw_t *hw)
+{
+    nrf24_t *rx = &link->diversity;
+
+    if (!nrf24_init_hw(rx, hw, link->radio->channel, link->radio->payload_size)) {
+        return false;
+    }
+
+    /* Listens only: an ACK of its own would collide with the primary's */
+    nrf24_set_auto_ack(rx, false);
+#if RC_ENABLE_FEC
+    nrf24_set_crc(rx, false);
+#endif
+    nrf24_set_data_rate(rx, link->radio->data_rate);
+    nrf24_set_addresses(rx, link->radio->tx_addr, link->radio->rx_addr);
+
+    return true;
+}
+
+static void diversity_pause(rc_link_t *link)
+{
+    /* Would hear the primary's own frame; CE only, no SPI */
+    if (link->diversity.initialized) {
+        nrf24_standby(&link->diversity);
+    }
+}
+
+static void diversity_resume(rc_link_t *link)
+{
+    if (link->diversity.initialized) {
+        nrf24_listen(&link->diversity);
+    }
+}
+
+static bool diversity_accept(rc_link_t *link, const rc_packet_t *packet, uint8_t len,
+                             uint8_t antenna)
+{
+    if (!link->diversity.initialized) {
+        return true;  /* Single receiver */
+    }
+
+    /* Only a copy that decodes may claim its sequence, so a corrupt one
+     * never hides the other antenna's good one */
+    uint8_t payload_len = packet->header.payload_len;
+    if (len < RC_PACKET_OVERHEAD || payload_len > RC_MAX_PAYLOAD_SIZE) {
+        return true;  /* decode_packet() rejects and counts it */
+    }
+
+    rc_crc_t crc = crc_load((const uint8_t *)packet + packet_crc_offset(payload_len));
+    if (crc != rc_crc_calculate((const uint8_t *)packet, sizeof(rc_packet_header_t) + payload_len)) {
+        return true;
+    }
+
+    /* Same sequence and CRC is the other copy (or an auto-retransmit the
+     * ACK-less receiver kept); a sequence resent with new contents after
+     * a failed send is a new frame */
+    rc_div_slot_t *slot = &link->div_slots[packet->header.sequence & (RC_DIV_SLOTS - 1)];
+
+    if (slot->used && slot->sequence == packet->header.sequence && slot->crc == crc) {
+#if RC_ENABLE_STATISTICS
+        link->stats.diversity_duplicates++;
+#endif
+        return false;
+    }
+
+    slot->used = true;
+    slot->sequence = packet->header.sequence;
+    slot->crc = crc;
+
+#if RC_ENABLE_STATISTICS
+    link->stats.diversity_rx[antenna]++;
+#else
+    (void)antenna;
+#endif
+
+    return true;
+}
+#endif
+
+#if RC_ENABLE_TIERED_COMMAND
+static uint8_t tier_select(rc_link_t *link, const rc_command_payload_t *command)
+{
+    uint8_t slot = RC_TIER_KEYFRAME;
+
+    /* Keyframes until the aircraft has one, then one in every interval */
+    if (link->tier_synced && link->tier_since_key < RC_TIER_KEYFRAME_INTERVAL - 1) {
+        /* Whatever the aircraft does not have yet, else the next in turn */
+        slot = link->tier_cursor;
+        for (uint8_t i = 0; i < RC_TIER_SLOTS; i++) {
+            uint8_t candidate = (uint8_t)((link->tier_cursor + i) % RC_TIER_SLOTS);
+
+            if (tier_slot_differs(command, &link->tier_acked, candidate)) {
+                slot = candidate;
+                break;
+            }
+        }
+    }
+
+    /* Picked up by tier_after_tx() when this frame completes */
+    memcpy(&link->tier_sent, command, sizeof(rc_command_payload_t));
+    link->tier_pending_seq = link->tx_sequence;
+    link->tier_pending_slot = slot;
+    link->tier_pending = true;
+
+    return slot;
+}
+
+static uint8_t tier_encode(const rc_command_payload_t *command, uint8_t slot,
+                           rc_command_tier_t *frame)
+{
+    uint16_t value;
+
+    if (slot == RC_TIER_SLOT_SWITCHES) {
+        value = (uint16_t)(command->switches | (command->mode << 8));
+    } else {
+        value = command->channels[RC_TIER_STICKS + slot];
+        if (value > RC_CHANNEL_MAX) {
+            value = RC_CHANNEL_MAX;  /* As the packed sticks are */
+        }
+    }
+
+    /* Aligned copy: the command struct is packed */
+    uint16_t sticks[RC_TIER_STICKS];
+    memcpy(sticks, command->channels, sizeof(sticks));
+
+    rc_channels_pack_11bit(frame->sticks, sticks, RC_TIER_STICKS);
+    frame->slot = slot;
+    frame->value[0] = (uint8_t)value;
+    frame->value[1] = (uint8_t)(value >> 8);
+
+    return sizeof(rc_command_tier_t);
+}
+
+static void tier_after_tx(rc_link_t *link, bool delivered)
+{
+    /* Only the frame rc_link_send_command() put on air */
+    if (!link->tier_pending || link->tx_packet.header.type != RC_PKT_COMMAND ||
+        link->tx_packet.header.sequence != link->tier_pending_seq) {
+        return;
+    }
+
+    link->tier_pending = false;
+
+    if (!delivered) {
+        return;  /* Still differs, so it goes out again */
+    }
+
+    if (link->tier_pending_slot == RC_TIER_KEYFRAME) {
+        memcpy(&link->tier_acked, &link->tier_sent, sizeof(rc_command_payload_t));
+        link->tier_synced = true;
+    } else {
+        tier_slot_copy(&link->tier_acked, &link->tier_sent, link->tier_pending_slot);
+    }
+}
+
+static rc_status_t tier_expand(rc_link_t *link, rc_packet_t *packet)
+{
+    uint8_t len = packet->header.payload_len;
+
+    if (len == sizeof(rc_command_payload_t)) {
+        /* Keyframe: everything else is built on top of it */
+        memcpy(&link->tier_rx, packet->payload, sizeof(rc_command_payload_t));
+        link->tier_rx_valid = true;
+        return RC_OK;
+    }
+
+    if (len != sizeof(rc_command_tier_t)) {
+        return RC_OK;  /* Not ours; the reader's size check reports it */
+    }
+
+    const rc_command_tier_t *frame = (const rc_command_tier_t *)packet->payload;
+
+    if (!link->tier_rx_valid || frame->slot >= RC_TIER_SLOTS) {
+#if RC_ENABLE_STATISTICS
+        link->stats.tier_unsynced++;
+#endif
+        return RC_ERROR_NO_DATA;
+    }
+
+    uint16_t value = (uint16_t)(frame->value[0] | (frame->value[1] << 8));
+
+    uint16_t sticks[RC_TIER_STICKS];
+    rc_channels_unpack_11bit(sticks, frame->sticks, RC_TIER_STICKS);
+    memcpy(link->tier_rx.channels, sticks, sizeof(sticks));
+
+    if (frame->slot == RC_TIER_SLOT_SWITCHES) {
+        link->tier_rx.switches = (uint8_t)value;
+        link->tier_rx.mode = (uint8_t)(value >> 8);
+    } else {
+        link->tier_rx.channels[RC_TIER_STICKS + frame->slot] =
+            (value > RC_CHANNEL_MAX) ? RC_CHANNEL_MAX : value;
+    }
+
+    memcpy(packet->payload, &link->tier_rx, sizeof(rc_command_payload_t));
+    packet->header.payload_len = sizeof(rc_command_payload_t);
+
+    return RC_OK;
+}
+
+static bool tier_slot_differs(const rc_command_payload_t *a, const rc_command_payload_t *b,
+                              uint8_t slot)
+{
+    if (slot == RC_TIER_SLOT_SWITCHES) {
+        return a->switches != b->switches || a->mode != b->mode;
+    }
+
+    return a->channels[RC_TIER_STICKS + slot] != b->channels[RC_TIER_STICKS + slot];
+}
+
+static void tier_slot_copy(rc_command_payload_t *dst, const rc_command_payload_t *src,
+                           uint8_t slot)
+{
+    if (slot == RC_TIER_SLOT_SWITCHES) {
+        dst->switches = src->switches;
+        dst->mode = src->mode;
+    } else {
+        dst->channels[RC_TIER_STICKS + slot] = src->channels[RC_TIER_STICKS + slot];
+    }
+}
+#endif
+
+#if RC_ENABLE_MAILBOX
+static uint32_t mailbox_read(rc_link_t *link, rc_command_sample_t *sample)
+{
+    unsigned seq;
+    uint32_t count;
+
+    /* Retry if the IRQ published while we copied; it never waits on us */
+    do {
+        seq = atomic_load_explicit(&link->mb_seq, memory_order_acquire);
+
+        memcpy(&sample->command, &link->mb_command, sizeof(rc_command_payload_t));
+        sample->rx_time_ms = link->mb_rx_time;
+#if RC_RX_STAMP
+        sample->rx_cycles = link->mb_rx_cycles;
+#else
+        sample->rx_cycles = 0;
+#endif
+        sample->sequence = link->mb_sequence;
+        count = link->mb_count;
+
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1) || atomic_load_explicit(&link->mb_seq, memory_order_relaxed) != seq);
+
+    return count;
+}
+
+static void mailbox_publish(rc_link_t *link)
+{
+    uint8_t entry = RC_RX_NONE;
+    rc_status_t status;
+
+    /* Bus held. Every queued command is decoded so sequence and link
+     * quality stay exact; the newest one ends up in the mailbox */
+    while ((status = rx_take(link, RC_PKT_COMMAND, NULL, NULL, &entry)) != RC_ERROR_NO_DATA) {
+        if (status != RC_OK) {
+            continue;
+        }
+
+        const rc_packet_t *packet = &link->rx_pool[entry];
+        uint32_t now = link->hw.get_tick_ms();
+
+        if (packet->header.payload_len == sizeof(rc_command_payload_t)) {
+            unsigned seq = atomic_load_explicit(&link->mb_seq, memory_order_relaxed);
+
+            atomic_store_explicit(&link->mb_seq, seq + 1, memory_order_relaxed);
+            atomic_thread_fence(memory_order_release);
+
+            memcpy(&link->mb_command, packet->payload, sizeof(rc_command_payload_t));
+            link->mb_rx_time = now;
+#if RC_RX_STAMP
+            link->mb_rx_cycles = link->mb_irq_cycles;
+#endif
+            link->mb_sequence = packet->header.sequence;
+            link->mb_count++;
+
+            atomic_store_explicit(&link->mb_seq, seq + 2, memory_order_release);
+
+#if RC_ENABLE_COMMAND_CALLBACK
+            if (link->command_callback) {
+                rc_command_sample_t sample;
+
+                memcpy(&sample.command, packet->payload, sizeof(rc_command_payload_t));
+                sample.rx_time_ms = now;
+                sample.rx_cycles = link->mb_irq_cycles;
+                sample.sequence = packet->header.sequence;
+                sample.failsafe = false;
+                link->command_callback(link, &sample, link->command_ctx);
+            }
+#endif
+
+            /* mark_received() minus failsafe_active, which the reader owns */
+            link->last_rx_time = now;
+            link->last_rx_us = link->rx_pool_us[entry];
+#if RC_ENABLE_STATISTICS
+            link->stats.packets_received++;
+#endif
+        } else {
+            RC_LOG_WARN("Command payload size mismatch: %d bytes\n", packet->header.payload_len);
+        }
+
+        link->rx_pool_used[entry] = false;
+    }
+}
+
+static rc_mailbox_frame_t *mailbox_tx_slot(rc_link_t *link)
+{
+    uint8_t head = atomic_load_explicit(&link->mb_tx_head, memory_order_relaxed);
+    uint8_t tail = atomic_load_explicit(&link->mb_tx_tail, memory_order_acquire);
+
+    if ((uint8_t)(head - tail) == RC_MAILBOX_TX_SIZE) {
+        return NULL;
+    }
+
+    return &link->mb_tx[head & (RC_MAILBOX_TX_SIZE - 1)];
+}
+
+static rc_status_t mailbox_tx_queue(rc_link_t *link, rc_packet_type_t type,
+                                    const void *payload, uint8_t payload_len)
+{
+    rc_mailbox_frame_t *frame = mailbox_tx_slot(link);
+
+    if (!frame) {
+        return RC_ERROR_BUSY;
+    }
+
+    if (payload && payload_len > 0) {
+        memcpy(frame->payload, payload, payload_len);
+    }
+
+    mailbox_tx_publish(link, type, payload_len);
+
+    return RC_OK;
+}
+
+static void mailbox_tx_publish(rc_link_t *link, rc_packet_type_t type, uint8_t payload_len)
+{
+    uint8_t head = atomic_load_explicit(&link->mb_tx_head, memory_order_relaxed);
+    rc_mailbox_frame_t *frame = &link->mb_tx[head & (RC_MAILBOX_TX_SIZE - 1)];
+
+    frame->type = (uint8_t)type;
+    frame->len = payload_len;
+    atomic_store_explicit(&link->mb_tx_head, (uint8_t)(head + 1), memory_order_release);
+
+    /* Send now if the radio is idle; otherwise the next IRQ picks it up */
+    if (bus_try_acquire(link)) {
+        mailbox_tx_service(link);
+        bus_release(link);
+    }
+}
+
+static rc_status_t mailbox_tx_direct(rc_link_t *link, rc_packet_type_t type,
+                                     const void *payload, uint8_t payload_len)
+{
+    /* The IRQ encodes telemetry into tx_packet too: hold the bus throughout */
+    if (!bus_try_acquire(link)) {
+        return RC_ERROR_BUSY;
+    }
+
+    if (!tx_via_ack(type) && tx_held(link)) {
+        bus_release(link);
+        return RC_ERROR_BUSY;
+    }
+
+    bool sent = mailbox_tx_frame(link, type, payload, payload_len);
+    bus_release(link);
+
+    return sent ? RC_OK : RC_ERROR_HARDWARE;
+}
+
+static bool mailbox_tx_frame(rc_link_t *link, rc_packet_type_t type,
+                             const void *payload, uint8_t payload_len)
+{
+    bool via_ack = tx_via_ack(type);
+
+    if (!via_ack) {
+        tx_select(link);
+    }
+    encode_packet(link, type, payload, payload_len);
+    link->tx_sequence++;
+
+    if (via_ack) {
+#if RC_ENABLE_ACK_TELEMETRY
+        return ack_write(link);
+#endif
+    }
+
+    link->tx_start_time = link->hw.get_tick_ms();
+
+    return tx_upload(link);
+}
+
+static void mailbox_tx_service(rc_link_t *link)
+{
+    uint8_t tail = atomic_load_explicit(&link->mb_tx_tail, memory_order_relaxed);
+
+    if (tail == atomic_load_explicit(&link->mb_tx_head, memory_order_acquire)) {
+        return;
+    }
+
+    const rc_mailbox_frame_t *frame = &link->mb_tx[tail & (RC_MAILBOX_TX_SIZE - 1)];
+    rc_packet_type_t type = (rc_packet_type_t)frame->type;
+
+    if (link->radio->tx_busy && !tx_via_ack(type)) {
+        return;  /* Goes out after TX_DS / MAX_RT */
+    }
+
+    if (!mailbox_tx_frame(link, type, frame->payload, frame->len)) {
+        RC_LOG_WARN("Telemetry frame dropped\n");
+    }
+
+    /* Copied into tx_packet; the slot is the producer's again */
+    atomic_store_explicit(&link->mb_tx_tail, (uint8_t)(tail + 1), memory_order_release);
+}
+#endif
+
+#if RC_ENABLE_TX_QUEUE
+static void txq_complete(rc_link_t *link, rc_status_t status)
+{
+    rc_txq_entry_t *entry = &link->txq[link->txq_head];
+
+    link->txq_head = (link->txq_head + 1) % NRF24_FIFO_DEPTH;
+    link->txq_count--;
+
+    /* Completions can merge into one IRQ, so no retransmit count */
+    TRACE_RECORD(link, RC_TRACE_TX, status, entry->type, RC_TRACE_COUNT_UNKNOWN,
+                 entry->sequence);
+
+#if RC_ENABLE_STATISTICS
+    if (status == RC_OK) {
+        link->stats.packets_sent++;
+    }
+#endif
+
+    if (link->txq_callback) {
+        link->txq_callback(link, entry->type, entry->sequence, status, link->txq_ctx);
+    }
+}
+
+static void txq_service(rc_link_t *link, uint8_t events)
+{
+    bool failed = (events & NRF24_EVENT_MAX_RT) != 0;
+
+    if (events & NRF24_EVENT_TX_DONE) {
+        /* TX_DS is a single flag, so back-to-back completions can merge into
+         * one IRQ; an empty FIFO settles the count. MAX_RT already flushed it,
+         * and then the failed packet is still queued here. */
+        if (!failed && nrf24_tx_fifo_empty(link->radio)) {
+            while (link->txq_count > 0) {
+                txq_complete(link, RC_OK);
+            }
+        } else if (!failed || link->txq_count > 1) {
+            txq_complete(link, RC_OK);
+        }
+    }
+
+    if (failed && link->txq_count > 0) {
+        txq_complete(link, RC_ERROR_TIMEOUT);
+
+        /* Upload the survivors again behind the flushed one */
+        for (uint8_t i = 0; i < link->txq_count; i++) {
+            rc_txq_entry_t *entry = &link->txq[(link->txq_head + i) % NRF24_FIFO_DEPTH];
+#if RC_TX_NO_ACK
+            tx_ack_policy(link, &entry->frame);
+#endif
+            nrf24_queue_payload(link->radio, (uint8_t*)&entry->frame, entry->len);
+        }
+    }
+
+    record_frame(link);
+
+    if (link->txq_count > 0) {
+        link->radio->tx_busy = true;  /* Cleared by nrf24_irq_handler() */
+        link->tx_start_time = link->hw.get_tick_ms();
+    } else {
+#if !RC_ENABLE_ACK_TELEMETRY
+        nrf24_listen(link->radio);
+#endif
+    }
+}
+#endif
+
+#if RC_ENABLE_TDMA
+static rc_status_t tdma_stage(rc_link_t *link, rc_packet_type_t type,
+                              const void *payload, uint8_t payload_len)
+{
+    /* Fill the buffer the slot is not reading, then publish it */
+    memcpy(link->tdma_staged[link->tdma_staged_idx ^ 1].payload, payload, payload_len);
+    tdma_publish(link, type, payload_len);
+
+    return RC_OK;
+}
+
+static void tdma_publish(rc_link_t *link, rc_packet_type_t type, uint8_t payload_len)
+{
+    uint8_t idx = link->tdma_staged_idx ^ 1;
+    rc_tdma_frame_t *frame = &link->tdma_staged[idx];
+
+    frame->type = (uint8_t)type;
+    frame->len = payload_len;
+
+    link->tdma_staged_idx = idx;
+    link->tdma_staged_ready = true;
+}
+
+static rc_status_t tdma_send(rc_link_t *link, const rc_tdma_frame_t *frame)
+{
+    link->tdma_in_slot = true;
+    rc_status_t status = encode_and_send(link, (rc_packet_type_t)frame->type,
+                                         frame->payload, frame->len);
+    link->tdma_in_slot = false;
+
+#if RC_ENABLE_STATISTICS
+    if (status == RC_ERROR_BUSY) {
+        /* Last exchange still on air or SPI held - this slot is lost */
+        if (link->role == RC_ROLE_GROUND) {
+            link->stats.tdma_uplink_overruns++;
+        } else {
+            link->stats.tdma_downlink_overruns++;
+        }
+    }
+#endif
+
+    return status;
+}
+
+static void tdma_uplink_slot(rc_link_t *link)
+{
+    const rc_tdma_frame_t *frame = &link->tdma_repeat;
+
+    if (link->tdma_staged_ready) {
+        frame = &link->tdma_staged[link->tdma_staged_idx];
+        link->tdma_staged_ready = false;
+
+        /* Hop maps are one-shot; commands keep the link fed */
+        if (frame->type == RC_PKT_COMMAND || frame->type == RC_PKT_CHANNELS) {
+            link->tdma_repeat = *frame;
+        }
+    }
+
+    if (frame->len == 0) {
+        return;  /* Nothing sent yet */
+    }
+
+    /* The frame counter is the on-air sequence (and the hop clock) */
+    link->tx_sequence = link->tdma_frame;
+    tdma_send(link, frame);
+}
+
+static void tdma_downlink_slot(rc_link_t *link)
+{
+    bool due = link->tdma_staged_ready && link->link_active &&
+               (link->tdma_frame % RC_TDMA_TELEMETRY_RATIO) == 0;
+
+#if RC_ENABLE_FHSS
+    /* Telemetry goes out on this frame's channel; hop once it is sent */
+    fhss_frame_tick(link, due);
+#endif
+
+    if (!due) {
+        return;
+    }
+
+    const rc_tdma_frame_t *frame = &link->tdma_staged[link->tdma_staged_idx];
+    link->tdma_staged_ready = false;
+
+    link->tx_sequence = link->tdma_downlink_seq++;
+    tdma_send(link, frame);
+}
+
+static void tdma_sync(rc_link_t *link, const rc_packet_t *packet, uint8_t len)
+{
+    /* RX_DR fires at the end of the frame: back-date the slot timer to its start */
+    uint32_t elapsed = NRF24_SETTLE_US + nrf24_airtime_us(link->radio, len);
+    if (elapsed >= RC_TDMA_HALF_FRAME_US) {
+        elapsed = RC_TDMA_HALF_FRAME_US - 1;
+    }
+
+    __HAL_TIM_SET_COUNTER(&NRF24_TIM_HANDLE, elapsed);
+
+    link->tdma_downlink = true;
+    link->tdma_frame = packet->header.sequence;
+    link->tdma_rx_frame = true;
+
+#if RC_ENABLE_FHSS
+    link->hop_synced = true;
+#endif
+}
+#endif
+
+#if RC_ENABLE_SPI_DMA
+static rc_status_t encode_and_send_async(rc_link_t *link, rc_packet_type_t type,
+                                         const void *payload, uint8_t payload_len)
+{
+    if (payload_len > RC_MAX_PAYLOAD_SIZE) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+#if RC_ENABLE_TDMA
+    /* Goes out in the next slot; TX completion reports it as usual */
+    link->async_tx_type = type;
+    link->async_tx_active = true;
+    return tdma_stage(link, type, payload, payload_len);
+#else
+    if (tx_held(link) || !bus_try_acquire(link)) {
+        return RC_ERROR_BUSY;
+    }
+
+#if RC_ENABLE_FHSS
+    nrf24_hop(link->radio, fhss_tx_channel(link));
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+    adapt_select(link);
+    adapt_apply(link);
+#endif
+
+    encode_packet(link, type, payload, payload_len);
+
+    link->async_tx_type = type;
+    link->async_tx_active = true;
+    link->tx_start_time = link->hw.get_tick_ms();
+    LATENCY_TX_START(link);
+
+#if RC_TX_NO_ACK
+    tx_ack_policy(link, &link->tx_packet);
+#endif
+    if (!nrf24_transmit_start_dma(link->radio, (uint8_t*)&link->tx_packet, link->tx_len)) {
+        link->async_tx_active = false;
+        bus_release(link);
+        return RC_ERROR_HARDWARE;
+    }
+
+    return RC_OK;  /* Bus released in on_dma_complete() */
+#endif
+}
+
+static void complete_async_tx(rc_link_t *link, rc_status_t status)
+{
+    if (!link->async_tx_active) {
+        return;
+    }
+
+    link->async_tx_active = false;
+
+    if (link->async_callback) {
+        link->async_callback(link, link->async_tx_type, status, link->async_ctx);
+    }
+}
+
+static void deliver_rx(rc_link_t *link)
+{
+    void *buffer = link->async_rx_buffer;
+
+    if (buffer) {
+        rc_packet_type_t type = (rc_packet_type_t)link->async_rx_type;
+        uint8_t payload_len = 0;
+        LATENCY_MARK(t_decode);
+        rc_status_t status = decode_packet(link, type, buffer, &payload_len);
+
+        if (status == RC_OK) {
+            LATENCY_RECORD(link, RC_LATENCY_RX_QUEUE, link->lat_rx_ready);
+            LATENCY_RECORD(link, RC_LATENCY_DECODE, t_decode);
+            link->async_rx_buffer = NULL;
+            mark_received(link, type);
+
+            if (link->async_callback) {
+                link->async_callback(link, type, RC_OK, link->async_ctx);
+            }
+            return;
+        }
+
+        if (status != RC_ERROR_NO_DATA) {
+            return;  /* Invalid packet, keep waiting */
+        }
+    }
+
+    /* Leave it for the synchronous receive calls */
+    rx_ring_push(link, link->rx_packet, link->rx_len);
+}
+
+static void on_dma_complete(nrf24_t *nrf, nrf24_dma_op_t op, bool ok,
+                            const uint8_t *data, uint8_t len, void *ctx)
+{
+    rc_link_t *link = (rc_link_t*)ctx;
+
+    if (op == NRF24_DMA_TX_PAYLOAD && !ok) {
+        nrf24_listen(nrf);
+        complete_async_tx(link, RC_ERROR_HARDWARE);
+    } else if (op == NRF24_DMA_TX_PAYLOAD) {
+        LATENCY_TX_UPLOADED(link);
+    } else if (op == NRF24_DMA_RX_PAYLOAD && ok) {
+        /* Decoded in the driver's DMA buffer; copied only if it must queue */
+        link->rx_packet = (const rc_packet_t *)data;
+        link->rx_len = len;
+        link->rx_us = link->rx_ready_us;
+#if RC_ENABLE_TDMA
+        if (link->role == RC_ROLE_AIRCRAFT) {
+            tdma_sync(link, link->rx_packet, len);
+        }
+#endif
+        deliver_rx(link);
+
+        /* RX_DR covered the whole FIFO: keep reading while it holds more */
+        if (nrf24_is_data_available(nrf) && nrf24_read_payload_dma(nrf)) {
+            return;
+        }
+    }
+
+    /* After a good TX upload the radio is on air; the IRQ reports the outcome */
+    bus_release(link);
+}
+#endif
+
+#if RC_ENABLE_ACK_TELEMETRY
+#if !RC_ENABLE_MAILBOX
+static rc_status_t queue_ack_payload(rc_link_t *link, rc_packet_type_t type,
+                                     const void *payload, uint8_t payload_len)
+{
+    if (payload_len > RC_MAX_PAYLOAD_SIZE) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    if (BIND_RUNNING(link) && type != RC_PKT_BIND) {
+        return RC_ERROR_BUSY;
+    }
+
+#if RC_ENABLE_CLOCK_SYNC
+    if (link->sync_on_ack && type != RC_PKT_HEARTBEAT) {
+        return RC_ERROR_BUSY;  /* The echo goes out on the next ACK first */
+    }
+#endif
+
+    encode_packet(link, type, payload, payload_len);
+
+    return upload_ack_payload(link);
+}
+
+static rc_status_t upload_ack_payload(rc_link_t *link)
+{
+#if RC_ENABLE_IRQ
+    if (!bus_try_acquire(link)) {
+        return RC_ERROR_BUSY;
+    }
+#endif
+
+    bool queued = ack_write(link);
+
+#if RC_ENABLE_IRQ
+    bus_release(link);
+#endif
+
+    return queued ? RC_OK : RC_ERROR_HARDWARE;
+}
+#endif
+
+static bool ack_write(rc_link_t *link)
+{
+    /* Replace any stale payload so the next ACK carries the newest data */
+    nrf24_flush_tx(link->radio);
+
+    return nrf24_write_ack_payload(link->radio, 0, (uint8_t*)&link->tx_packet, link->tx_len);
+}
+#endif
+
+static uint32_t link_tick_us(rc_link_t *link)
+{
+    return link->hw.get_tick_us ? link->hw.get_tick_us() : link->hw.get_tick_ms() * 1000U;
+}
+
+static void mark_received(rc_link_t *link, rc_packet_type_t type)
+{
+    link->last_rx_time = link->hw.get_tick_ms();
+    link->last_rx_us = link->rx_us;
+
+    if (type == RC_PKT_COMMAND || type == RC_PKT_CHANNELS) {
+        failsafe_exit(link);
+    }
+
+#if RC_ENABLE_STATISTICS
+    link->stats.packets_received++;
+#endif
+}
+
+static void failsafe_expand(const rc_link_t *link, rc_channels_t *channels)
+{
+    const uint8_t failsafe_count = sizeof(link->failsafe_command.channels) /
+                                   sizeof(link->failsafe_command.channels[0]);
+
+    for (uint8_t i = 0; i < RC_CHANNELS_COUNT; i++) {
+        channels->channels[i] = (i < failsafe_count) ? link->failsafe_command.channels[i]
+                                                     : RC_CHANNEL_CENTER;
+    }
+    channels->switches = link->failsafe_command.switches;
+    channels->mode = link->failsafe_command.mode;
+}
+
+static void failsafe_pack(rc_link_t *link)
+{
+    rc_channels_t channels;
+
+    failsafe_expand(link, &channels);
+    rc_channels_encode(&channels, &link->failsafe_channels);
+}
+
+static void failsafe_enter(rc_link_t *link)
+{
+    if (!link->failsafe_active) {
+        link->failsafe_active = true;
+        RC_LOG_WARN("Link lost - activating failsafe\n");
+        TRACE_RECORD(link, RC_TRACE_FAILSAFE, RC_ERROR_TIMEOUT, 0, 0, 0);
+    }
+}
+
+static void failsafe_exit(rc_link_t *link)
+{
+    if (link->failsafe_active) {
+        link->failsafe_active = false;
+        TRACE_RECORD(link, RC_TRACE_FAILSAFE, RC_OK, 0, 0, 0);
+    }
+}
+
+#if RC_ENABLE_PREDICT
+static void predict_feed(rc_link_t *link, const rc_command_payload_t *command, uint32_t cycles)
+{
+    if (link->pred_count > 0) {
+        memcpy(link->pred_prev, link->pred_command.channels, sizeof(link->pred_prev));
+        link->pred_interval = cycles - link->pred_time;
+    }
+
+    memcpy(&link->pred_command, command, sizeof(rc_command_payload_t));
+    link->pred_time = cycles;
+
+    if (link->pred_count < 2) {
+        link->pred_count++;
+    }
+}
+
+static uint8_t predict_missed(const rc_link_t *link)
+{
+    const uint32_t period_us = 1000000U / RC_UPDATE_RATE_HZ;
+
+    if (link->pred_count == 0) {
+        return 0;
+    }
+
+    /* A frame counts as missed half a period after it was due */
+    uint32_t elapsed_us = nrf24_cycles_to_us(nrf24_cycle_count() - link->pred_time);
+    if (elapsed_us < period_us + period_us / 2) {
+        return 0;
+    }
+
+    uint32_t missed = (elapsed_us - period_us / 2) / period_us;
+
+    return (uint8_t)(missed < UINT8_MAX ? missed : UINT8_MAX);
+}
+
+static void predict_apply(const rc_link_t *link, rc_command_payload_t *command, uint8_t missed)
+{
+    const uint32_t period_us = 1000000U / RC_UPDATE_RATE_HZ;
+
+    memcpy(command, &link->pred_command, sizeof(rc_command_payload_t));
+
+    uint8_t steps = missed < RC_PREDICT_FRAMES ? missed : RC_PREDICT_FRAMES;
+    if (steps == 0 || link->pred_count < 2) {
+        return;
+    }
+
+    /* Two commands drained back to back say nothing about the slope */
+    uint32_t interval_us = nrf24_cycles_to_us(link->pred_interval);
+    if (interval_us < period_us / 2) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < RC_COMMAND_CHANNELS; i++) {
+        if (!(RC_PREDICT_CHANNELS & (1U << i))) {
+            continue;
+        }
+
+        int32_t last = link->pred_command.channels[i];
+        int32_t delta = last - (int32_t)link->pred_prev[i];
+        int32_t value = last + (int32_t)((int64_t)delta * steps * period_us / interval_us);
+
+        if (value < 0) {
+            value = 0;
+        } else if (value > RC_CHANNEL_MAX) {
+            value = RC_CHANNEL_MAX;
+        }
+        command->channels[i] = (uint16_t)value;
+    }
+}
+#endif
+
+static rc_status_t encode_and_send(rc_link_t *link, rc_packet_type_t type,
+                                    const void *payload, uint8_t payload_len)
+{
+    if (payload_len > RC_MAX_PAYLOAD_SIZE) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    if (BIND_RUNNING(link) && type != RC_PKT_BIND) {
+        return RC_ERROR_BUSY;  /* Only bind frames on the bind channel */
+    }
+
+#if RC_ENABLE_MAILBOX
+    if (is_downlink_type(type)) {
+        return mailbox_tx_queue(link, type, payload, payload_len);
+    }
+    return mailbox_tx_direct(link, type, payload, payload_len);
+#endif
+
+#if RC_ENABLE_TDMA
+    if (!link->tdma_in_slot) {
+        return tdma_stage(link, type, payload, payload_len);
+    }
+#endif
+
+#if RC_ENABLE_IRQ
+    if (tx_held(link)) {
+        return RC_ERROR_BUSY;
+    }
+#endif
+
+    tx_select(link);
+    encode_packet(link, type, payload, payload_len);
+
+    return tx_transmit(link);
+}
+
+static void tx_select(rc_link_t *link)
+{
+#if RC_ENABLE_FHSS
+    /* Before encoding: a table switch changes the header flags */
+    link->hop_tx_channel = fhss_tx_channel(link);
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+    adapt_select(link);
+#endif
+
+    (void)link;
+}
+
+static rc_status_t tx_transmit(rc_link_t *link)
+{
+#if RC_ENABLE_IRQ
+    link_host(link)->tx_start_time = link->hw.get_tick_ms();
+
+    if (!bus_try_acquire(link)) {
+        return RC_ERROR_BUSY;
+    }
+
+#if RC_ENABLE_MULTI_LINK
+    peer_select(link);
+#endif
+    bool started = tx_upload(link);
+    bus_release(link);
+
+    if (!started) {
+        return RC_ERROR_HARDWARE;
+    }
+#else
+#if RC_ENABLE_FHSS
+    nrf24_hop(link->radio, link->hop_tx_channel);
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+    adapt_apply(link);
+#endif
+
+#if RC_ENABLE_MULTI_LINK
+    peer_select(link);
+#endif
+
+#if RC_ENABLE_DIVERSITY
+    diversity_pause(link);
+#endif
+
+#if RC_TX_NO_ACK
+    tx_ack_policy(link, &link->tx_packet);
+#endif
+
+#if RC_ENABLE_CLOCK_SYNC
+    sync_tx_start(link);
+#endif
+
+    /* Settle into TX first so the upload stage times only the SPI write */
+    nrf24_mode_tx(link->radio);
+    LATENCY_TX_START(link);
+    bool delivered = nrf24_transmit_upload(link->radio, (uint8_t*)&link->tx_packet, link->tx_len);
+    LATENCY_TX_UPLOADED(link);
+    delivered = delivered && nrf24_transmit_wait(link->radio);
+
+#if RC_ENABLE_CLOCK_SYNC
+    sync_after_tx(link, delivered, link_tick_us(link));
+#endif
+
+#if RC_ENABLE_DIVERSITY
+    diversity_resume(link);
+#endif
+
+#if RC_ENABLE_RSSI || RC_ENABLE_LINK_ADAPT
+    uint8_t retries = tx_retries(link, delivered);
+#endif
+#if RC_ENABLE_RSSI
+    rssi_sample_tx(link, retries);
+#endif
+#if RC_ENABLE_LINK_ADAPT
+    adapt_after_tx(link, delivered, retries);
+#endif
+
+#if RC_ENABLE_FHSS
+    fhss_after_tx(link, delivered);
+#endif
+
+#if RC_ENABLE_TIERED_COMMAND
+    tier_after_tx(link, delivered);
+#endif
+
+    TRACE_RECORD(link, RC_TRACE_TX, delivered ? RC_OK : RC_ERROR_TIMEOUT,
+                 link->tx_packet.header.type, TRACE_RETRIES(retries),
+                 link->tx_packet.header.sequence);
+
+    if (!delivered) {
+#if RC_ENABLE_FHSS
+        link->tx_sequence++;  /* Hop clock runs whether or not the frame got through */
+#endif
+        return RC_ERROR_HARDWARE;
+    }
+
+    LATENCY_RECORD(link, RC_LATENCY_AIR, link->lat_tx_mark);  /* Air + ACK */
+    record_frame(link);
+#endif
+
+    return RC_OK;
+}
+
+#if RC_ENABLE_IRQ
+static bool tx_upload(rc_link_t *link)
+{
+    /* Bus held; completion arrives as TX_DS / MAX_RT */
+#if RC_ENABLE_FHSS
+    nrf24_hop(link->radio, link->hop_tx_channel);
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+    adapt_apply(link);
+#endif
+
+#if RC_ENABLE_DIVERSITY
+    diversity_pause(link);  /* Resumed with the primary's listen */
+#endif
+
+#if RC_TX_NO_ACK
+    tx_ack_policy(link, &link->tx_packet);
+#endif
+
+    LATENCY_TX_START(link);
+    bool started = nrf24_transmit_start(link->radio, (uint8_t*)&link->tx_packet, link->tx_len);
+    LATENCY_TX_UPLOADED(link);
+
+#if RC_ENABLE_DIVERSITY
+    if (!started) {
+        diversity_resume(link);
+    }
+#endif
+#if RC_ENABLE_CLOCK_SYNC
+    /* Timed from CE going high, which leaves the upload out of it */
+    if (started) {
+        sync_tx_start(link);
+    } else {
+        sync_after_tx(link, false, 0);
+    }
+#endif
+
+    return started;
+}
+#endif
+
+static void tx_sent(rc_link_t *link)
+{
+#if RC_ENABLE_MAILBOX
+    (void)link;  /* Sequenced with the bus held, see mailbox_tx_frame() */
+#else
+#if RC_NO_ACK_REPEAT
+    /* tx_packet still holds the frame as sent; a newer one replaces it */
+    if (link->no_ack_types & (1UL << link->tx_packet.header.type)) {
+        memcpy(&link->repeat_frame, &link->tx_packet, link->tx_len);
+        link->repeat_len = link->tx_len;
+        link->repeat_left = RC_NO_ACK_REPEATS - 1;
+        link->repeat_time = link->hw.get_tick_ms();
+    }
+#endif
+
+#if RC_ENABLE_BULK
+    uint8_t type = link->tx_packet.header.type;
+    if (type == RC_PKT_COMMAND || type == RC_PKT_CHANNELS) {
+        bulk_on_control(link);
+    }
+#endif
+
+    link->tx_sequence++;
+
+#if RC_ENABLE_STATISTICS && !RC_ENABLE_IRQ
+    link->stats.packets_sent++;  /* Counted on TX_DS in IRQ mode */
+#endif
+#endif
+}
+
+#if RC_TX_NO_ACK
+static void tx_ack_policy(rc_link_t *link, const rc_packet_t *frame)
+{
+    uint8_t type = frame->header.type;
+    bool no_ack = false;
+
+#if RC_ENABLE_NO_ACK
+    no_ack = type < 32 && (link->no_ack_types & (1UL << type));
+#endif
+#if RC_ENABLE_CLOCK_SYNC
+    no_ack = no_ack && type != RC_PKT_HEARTBEAT;    /* Pings are timed by their ACK */
+#endif
+#if RC_ENABLE_BULK
+    no_ack = no_ack || type == RC_PKT_BULK;  /* Recovered by the stream's own ACKs */
+#endif
+
+    nrf24_set_tx_no_ack(link->radio, no_ack);
+}
+#endif
+
+#if RC_NO_ACK_REPEAT
+static void repeat_service(rc_link_t *link)
+{
+    if (link->repeat_left == 0 ||
+        link->hw.get_tick_ms() - link->repeat_time < RC_NO_ACK_REPEAT_GAP_MS) {
+        return;
+    }
+
+#if RC_ENABLE_IRQ
+    if (link->radio->tx_busy) {
+        return;  /* Tried again on the next update */
+    }
+#endif
+
+    /* Same bytes, same sequence: the aircraft keeps whichever copy lands first */
+    memcpy(&link->tx_packet, &link->repeat_frame, link->repeat_len);
+    link->tx_len = link->repeat_len;
+
+    if (tx_transmit(link) == RC_ERROR_BUSY) {
+        return;
+    }
+
+    link->repeat_left--;
+    link->repeat_time = link->hw.get_tick_ms();
+
+#if RC_ENABLE_STATISTICS
+    link->stats.no_ack_repeats++;
+#endif
+}
+#endif
+
+static bool tx_via_ack(rc_packet_type_t type)
+{
+#if RC_ENABLE_ACK_TELEMETRY
+    /* Rides back on the ACK of the next command */
+    return is_downlink_type(type);
+#else
+    (void)type;
+    return false;
+#endif
+}
+
+static bool is_downlink_type(uint8_t type)
+{
+    /* Aircraft → ground frames, whichever telemetry layout they carry */
+    return type == RC_PKT_TELEMETRY || type == RC_PKT_TELEMETRY_MUX || RC_PKT_IS_USER_DOWN(type);
+}
+
+static rc_status_t tx_open(rc_link_t *link, rc_packet_type_t type, uint8_t payload_len)
+{
+    if (payload_len > RC_MAX_PAYLOAD_SIZE) {
+        return RC_ERROR_INVALID_PARAM;
+    }
+
+    if (BIND_RUNNING(link)) {
+        return RC_ERROR_BUSY;
+    }
+
+    uint8_t *payload = link->tx_packet.payload;
+
+#if RC_ENABLE_MAILBOX
+    /* Next ring slot; header and CRC are added when it is sent */
+    rc_mailbox_frame_t *frame = mailbox_tx_slot(link);
+    if (!frame) {
+        return RC_ERROR_BUSY;
+    }
+    payload = frame->payload;
+#else
+    if (tx_via_ack(type)) {
+        link->tx_open_crc = encode_header(link, type, payload_len);
+    } else {
+#if RC_ENABLE_TDMA
+        /* Buffer the slot is not reading; it adds header and CRC on air */
+        payload = link->tdma_staged[link->tdma_staged_idx ^ 1].payload;
+#else
+#if RC_ENABLE_IRQ
+        if (tx_held(link)) {
+            return RC_ERROR_BUSY;
+        }
+#endif
+
+        tx_select(link);
+        link->tx_open_crc = encode_header(link, type, payload_len);
+#endif
+    }
+#endif
+
+    link->tx_open = payload;
+    link->tx_open_type = (uint8_t)type;
+    link->tx_open_len = payload_len;
+    link->tx_open_fill = 0;
+
+    return RC_OK;
+}
+
+static rc_status_t tx_commit(rc_link_t *link)
+{
+    rc_packet_type_t type = (rc_packet_type_t)link->tx_open_type;
+    uint8_t payload_len = link->tx_open_len;
+
+#if RC_ENABLE_MAILBOX
+    const uint8_t *payload = link->tx_open;
+    link->tx_open = NULL;
+
+    if (is_downlink_type(type)) {
+        mailbox_tx_publish(link, type, payload_len);
+        return RC_OK;
+    }
+
+    /* Other types go out now; the unpublished slot was only a buffer */
+    return mailbox_tx_direct(link, type, payload, payload_len);
+#else
+    rc_status_t status = RC_OK;
+
+    /* Fold in whatever went through the pointer instead of rc_link_tx_write() */
+    rc_crc_t crc = link->tx_open_crc;
+    if (link->tx_open_fill < payload_len) {
+        crc = rc_crc_update(crc, link->tx_open + link->tx_open_fill,
+                            payload_len - link->tx_open_fill);
+    }
+    link->tx_open = NULL;
+
+    if (tx_via_ack(type)) {
+        encode_finish(link, crc, payload_len);
+#if RC_ENABLE_ACK_TELEMETRY
+        status = upload_ack_payload(link);
+#endif
+    } else {
+#if RC_ENABLE_TDMA
+        (void)crc;
+        tdma_publish(link, type, payload_len);
+#else
+        encode_finish(link, crc, payload_len);
+        status = tx_transmit(link);
+#endif
+    }
+
+    if (status == RC_OK) {
+        tx_sent(link);
+    }
+
+    return status;
+#endif
+}
+
+static uint8_t packet_crc_offset(uint8_t payload_len)
+{
+#if RC_DYNAMIC_FRAMES
+    /* CRC sits right after the payload; payload_len <= RC_MAX_PAYLOAD_SIZE
+     * keeps this at or before the crc field */
+    return sizeof(rc_packet_header_t) + payload_len;
+#else
+    (void)payload_len;
+    return offsetof(rc_packet_t, crc);
+#endif
+}
+
+static void crc_store(uint8_t *dst, rc_crc_t crc)
+{
+    dst[0] = (uint8_t)crc;
+#if RC_CRC_WIDTH == 16
+    dst[1] = (uint8_t)(crc >> 8);
+#endif
+}
+
+static rc_crc_t crc_load(const uint8_t *src)
+{
+#if RC_CRC_WIDTH == 16
+    return (rc_crc_t)(src[0] | (src[1] << 8));
+#else
+    return src[0];
+#endif
+}
+
+static rc_crc_t encode_header(rc_link_t *link, rc_packet_type_t type, uint8_t payload_len)
+{
+    rc_packet_header_t *header = &link->tx_packet.header;
+
+    header->version = RC_PROTOCOL_VERSION;
+    header->type = type;
+    header->sequence = link->tx_sequence;
+    header->flags = 0;
+#if RC_ENABLE_FHSS
+    if (link->hop_gen) {
+        header->flags |= RC_FLAG_HOP_GEN;
+    }
+#endif
+#if RC_ENABLE_LINK_ADAPT
+    header->flags |= adapt_flags(link);
+#endif
+    header->payload_len = payload_len;
+
+    return rc_crc_update(RC_CRC_INIT, (const uint8_t *)header, sizeof(rc_packet_header_t));
+}
+
+static void encode_finish(rc_link_t *link, rc_crc_t crc, uint8_t payload_len)
+{
+    crc_store((uint8_t *)&link->tx_packet + packet_crc_offset(payload_len), crc);
+
+#if RC_DYNAMIC_FRAMES
+    link->tx_len = RC_PACKET_WIRE_LEN(payload_len);
+#else
+    link->tx_len = sizeof(rc_packet_t);
+#endif
+#if RC_ENABLE_FEC
+    rc_fec_encode((uint8_t *)&link->tx_packet, sizeof(rc_packet_t));
+#endif
+}
+
+static void encode_packet(rc_link_t *link, rc_packet_type_t type,
+                          const void *payload, uint8_t payload_len)
+{
+    LATENCY_MARK(t_encode);
+
+    rc_crc_t crc = encode_header(link, type, payload_len);
+
+    /* Copy payload, folding it into the CRC on the way */
+    if (payload && payload_len > 0) {
+        crc = rc_crc_copy(crc, link->tx_packet.payload, (const uint8_t *)payload, payload_len);
+    } else {
+        crc = rc_crc_update(crc, link->tx_packet.payload, payload_len);
+    }
+
+    encode_finish(link, crc, payload_len);
+
+    LATENCY_RECORD(link, RC_LATENCY_ENCODE, t_encode);
+}
+
+static rc_status_t receive_and_decode(rc_link_t *link, rc_packet_type_t expected_type,
+                                       void *payload, uint8_t *payload_len, uint8_t *lent)
+{
+#if RC_ENABLE_IRQ
+    /* The ring is filled by rc_link_irq_handler() with the bus held */
+    if (!bus_try_acquire(link)) {
+        return RC_ERROR_NO_DATA;  /* Mid-transfer, packets stay queued */
+    }
+
+    rc_status_t status = rx_take(link, expected_type, payload, payload_len, lent);
+    bus_release(link);
+
+    return status;
+#else
+    rx_poll(link);
+
+    return rx_take(link, expected_type, payload, payload_len, lent);
+#endif
+}
+
+#if !RC_ENABLE_IRQ
+static void rx_poll(rc_link_t *link)
+{
+#if RC_ENABLE_MULTI_LINK
+    link = link->host;  /* Peers are heard through the shared radio */
+#endif
+
+#if RC_ENABLE_ACK_TELEMETRY
+    /* Ground stays in PTX; telemetry arrives in the RX FIFO with each ACK */
+    if (link->role != RC_ROLE_GROUND) {
+        nrf24_mode_rx(link->radio);
+    }
+#else
+#if RC_ENABLE_MULTI_LINK
+    peer_listen(link);
+#endif
+    nrf24_mode_rx(link->radio);
+#endif
+
+    if (nrf24_is_data_available(link->radio)) {
+        rx_drain(link, link->radio);
+    }
+#if RC_ENABLE_DIVERSITY
+    /* The second receiver's copy of a frame the primary just produced
+     * waits for the next poll, so it never delays the first */
+    else if (link->diversity.initialized && nrf24_is_data_available(&link->diversity)) {
+        rx_drain(link, &link->diversity);
+    }
+#endif
+}
+#endif
+
+#if !RC_ENABLE_SPI_DMA
+/* DMA builds read through nrf24_read_payload_dma(); diversity and
+ * multi-link, the other callers, exclude SPI_DMA */
+static void rx_drain(rc_link_t *link, nrf24_t *radio)
+{
+    LATENCY_RX_READY(link);
+    link->rx_ready_us = link_tick_us(link);
+
+    /* Read straight into pool entries; the ring only records their order */
+    uint8_t entries[NRF24_FIFO_DEPTH];
+    uint8_t *buffers[NRF24_FIFO_DEPTH];
+    uint8_t lens[NRF24_FIFO_DEPTH];
+
+    for (uint8_t i = 0; i < NRF24_FIFO_DEPTH; i++) {
+        entries[i] = rx_pool_alloc(link);
+        buffers[i] = (uint8_t *)&link->rx_pool[entries[i]];
+    }
+
+#if RC_ENABLE_MULTI_LINK
+    uint8_t pipes[NRF24_FIFO_DEPTH];
+    uint8_t count = nrf24_receive_batch(radio, buffers, lens, pipes, NRF24_FIFO_DEPTH);
+#else
+    uint8_t count = nrf24_receive_batch(radio, buffers, lens, NULL, NRF24_FIFO_DEPTH);
+#endif
+#if RC_ENABLE_FEC && RC_ENABLE_TDMA
+    bool synced = true;
+#endif
+
+    for (uint8_t i = 0; i < NRF24_FIFO_DEPTH; i++) {
+#if RC_ENABLE_MULTI_LINK
+        rc_link_t *dest = (i < count) ? peer_route(link, pipes[i]) : link;
+
+        if (dest != link) {
+            /* A peer's frame (or an unassigned pipe's): move it over */
+            if (dest) {
+#if RC_ENABLE_LATENCY_STATS
+                dest->lat_rx_ready = link->lat_rx_ready;
+#endif
+                dest->rx_ready_us = link->rx_ready_us;
+                rx_ring_push(dest, buffers[i], lens[i]);
+            }
+            link->rx_pool_used[entries[i]] = false;
+            continue;
+        }
+#endif
+#if RC_ENABLE_FEC
+        if (i < count && !fec_correct(link, buffers[i], lens[i])) {
+#if RC_ENABLE_TDMA
+            /* Its timing is fine, but the frame number in it is not */
+            synced = synced && i != count - 1;
+#endif
+            link->rx_pool_used[entries[i]] = false;
+            continue;
+        }
+#endif
+#if RC_ENABLE_DIVERSITY
+        bool keep = i < count && diversity_accept(link, &link->rx_pool[entries[i]], lens[i],
+                                                  radio == link->radio ? 0 : 1);
+#else
+        bool keep = i < count;
+#endif
+        if (keep) {
+            link->rx_pool_len[entries[i]] = lens[i];
+            link->rx_pool_us[entries[i]] = link->rx_ready_us;
+#if RC_ENABLE_LATENCY_STATS
+            link->rx_pool_stamp[entries[i]] = link->lat_rx_ready;
+#endif
+            rx_ring_append(link, entries[i]);
+        } else {
+            link->rx_pool_used[entries[i]] = false;
+        }
+    }
+
+#if RC_ENABLE_RSSI
+    if (count > 0 && radio == link->radio) {
+#if RC_ENABLE_MULTI_LINK
+        /* RPD is latched by the last frame */
+        rc_link_t *heard = peer_route(link, pipes[count - 1]);
+        if (heard) {
+            rssi_sample_rx(heard);
+        }
+#else
+        rssi_sample_rx(link);
+#endif
+    }
+#endif
+
+#if RC_ENABLE_FEC && RC_ENABLE_TDMA
+    if (count > 0 && synced && link->role == RC_ROLE_AIRCRAFT) {
+        tdma_sync(link, &link->rx_pool[entries[count - 1]], lens[count - 1]);
+    }
+#elif RC_ENABLE_TDMA
+    if (count > 0 && link->role == RC_ROLE_AIRCRAFT) {
+        tdma_sync(link, &link->rx_pool[entries[count - 1]], lens[count - 1]);
+    }
+#endif
+}
+#endif
+
+#if RC_ENABLE_FEC
+static bool fec_correct(rc_link_t *link, uint8_t *frame, uint8_t len)
+{
+    if (len != sizeof(rc_packet_t)) {
+        return false;   /* Frames are fixed size with FEC */
+    }
+
+    int8_t corrected = rc_fec_decode(frame, len);
+
+#if RC_ENABLE_STATISTICS
+    if (corrected > 0) {
+        link->stats.fec_corrected++;
+    } else if (corrected == RC_FEC_UNCORRECTABLE) {
+        link->stats.fec_uncorrectable++;
+    }
+#else
+    (void)link;
+#endif
+
+    return corrected != RC_FEC_UNCORRECTABLE;
+}
+#endif
+
+static uint8_t rx_pool_alloc(rc_link_t *link)
+{
+    /* RC_RX_POOL_SIZE leaves room for a drain with the ring full and both
+     * lent entries out, so this always finds one */
+    uint8_t entry = 0;
+
+    while (entry < RC_RX_POOL_SIZE - 1 && link->rx_pool_used[entry]) {
+        entry++;
+    }
+
+    link->rx_pool_used[entry] = true;
+
+    return entry;
+}
+
+static void rx_ring_append(rc_link_t *link, uint8_t entry)
+{
+    if (link->rx_ring_count == RC_RX_RING_SIZE) {
+        /* Drop the oldest; fresh control data matters more */
+        link->rx_pool_used[link->rx_ring[link->rx_ring_head]] = false;
+        link->rx_ring_head = (link->rx_ring_head + 1) % RC_RX_RING_SIZE;
+        link->rx_ring_count--;
+#if RC_ENABLE_STATISTICS
+        link->stats.rx_ring_overflows++;
+#endif
+    }
+
+    uint8_t slot = (link->rx_ring_head + link->rx_ring_count) % RC_RX_RING_SIZE;
+
+    link->rx_ring[slot] = entry;
+    link->rx_ring_count++;
+}
+
+#if RC_ENABLE_SPI_DMA || RC_ENABLE_MULTI_LINK
+static void rx_ring_push(rc_link_t *link, const void *data, uint8_t len)
+{
+    uint8_t entry = rx_pool_alloc(link);
+
+    memcpy(&link->rx_pool[entry], data, len);
+    link->rx_pool_len[entry] = len;
+    link->rx_pool_us[entry] = link->rx_ready_us;
+#if RC_ENABLE_LATENCY_STATS
+    link->rx_pool_stamp[entry] = link->lat_rx_ready;
+#endif
+
+    rx_ring_append(link, entry);
+}
+#endif
+
+static void rx_ring_remove(rc_link_t *link, uint8_t index)
+{
+    if (index == 0) {
+        link->rx_ring_head = (link->rx_ring_head + 1) % RC_RX_RING_SIZE;
+        link->rx_ring_count--;
+        return;
+    }
+
+    /* Close the gap by moving newer entries back one slot */
+    for (uint8_t i = index; i + 1 < link->rx_ring_count; i++) {
+        uint8_t dst = (link->rx_ring_head + i) % RC_RX_RING_SIZE;
+
+        link->rx_ring[dst] = link->rx_ring[(dst + 1) % RC_RX_RING_SIZE];
+    }
+
+    link->rx_ring_count--;
+}
+
+static void rx_release_held(rc_link_t *link)
+{
+    if (link->rx_held != RC_RX_NONE) {
+        link->rx_pool_used[link->rx_held] = false;
+        link->rx_held = RC_RX_NONE;
+    }
+}
+
+static bool rx_app_type(uint8_t type)
+{
+    switch (type) {
+        case RC_PKT_COMMAND:
+        case RC_PKT_TELEMETRY:
+        case RC_PKT_TELEMETRY_MUX:
+        case RC_PKT_ACK:
+#if !RC_ENABLE_CLOCK_SYNC
+        case RC_PKT_HEARTBEAT:  /* Pings and echoes otherwise */
+#endif
+        case RC_PKT_CHANNELS:
+            return true;
+        default:
+            /* Schema payloads (payload_schema.h); anything else is
+             * protocol-internal or corrupt */
+            return RC_PKT_IS_USER_UP(type) || RC_PKT_IS_USER_DOWN(type);
+    }
+}
+
+static rc_status_t rx_take(rc_link_t *link, rc_packet_type_t expected_type,
+                           void *payload, uint8_t *payload_len, uint8_t *lent)
+{
+    uint8_t i = 0;
+
+    while (i < link->rx_ring_count) {
+        uint8_t entry = link->rx_ring[(link->rx_ring_head + i) % RC_RX_RING_SIZE];
+        uint8_t type = link->rx_pool[entry].header.type;
+
+        /* Other readers' packets stay; internal ones are consumed in order */
+        if (type != expected_type && rx_app_type(type)) {
+            i++;
+            continue;
+        }
+
+        rx_ring_remove(link, i);
+
+        /* Validated where it landed; the entry stays ours until freed */
+        link->rx_packet = &link->rx_pool[entry];
+        link->rx_len = link->rx_pool_len[entry];
+        link->rx_us = link->rx_pool_us[entry];
+
+        if (type == expected_type) {
+            LATENCY_RECORD(link, RC_LATENCY_RX_QUEUE, link->rx_pool_stamp[entry]);
+            LATENCY_MARK(t_decode);
+
+            rc_status_t status = decode_packet(link, expected_type, payload, payload_len);
+            if (status == RC_OK) {
+                LATENCY_RECORD(link, RC_LATENCY_DECODE, t_decode);
+            }
+
+            if (status == RC_OK && lent) {
+                *lent = entry;  /* Caller reads it in place, then frees it */
+            } else {
+                link->rx_pool_used[entry] = false;
+            }
+            return status;
+        }
+
+        decode_packet(link, (rc_packet_type_t)type, NULL, NULL);
+        link->rx_pool_used[entry] = false;
+    }
+
+    return RC_ERROR_NO_DATA;
+}
+
+static rc_status_t decode_packet(rc_link_t *link, rc_packet_type_t expected_type,
+                                 void *payload, uint8_t *payload_len)
+{
+    const rc_packet_t *packet = link->rx_packet;
+
+    /* Validate minimum size */
+    if (link->rx_len < RC_PACKET_OVERHEAD) {
+        RC_LOG_WARN("Packet too small: %d bytes\n", link->rx_len);
+        TRACE_RECORD(link, RC_TRACE_RX_DROP, RC_ERROR_CRC_FAIL, 0, 0, 0);
+        return RC_ERROR_CRC_FAIL;
+    }
+
+    /* Validate length before trusting payload_len as an offset */
+    uint8_t rx_payload_len = packet->header.payload_len;
+#if RC_DYNAMIC_FRAMES
+    if (rx_payload_len > RC_MAX_PAYLOAD_SIZE ||
+        link->rx_len != RC_PACKET_WIRE_LEN(rx_payload_len)) {
+#else
+    if (rx_payload_len > RC_MAX_PAYLOAD_SIZE) {
+#endif
+        RC_LOG_WARN("Bad payload length: %d in %d bytes\n", rx_payload_len, link->rx_len);
+#if RC_ENABLE_STATISTICS
+        link->stats.crc_errors++;
+#endif
+        TRACE_RECORD(link, RC_TRACE_RX_DROP, RC_ERROR_CRC_FAIL, packet->header.type, 0,
+                     packet->header.sequence);
+        return RC_ERROR_CRC_FAIL;
+    }
+
+    /* Validate CRC */
+    uint8_t crc_len = sizeof(rc_packet_header_t) + rx_payload_len;
+    rc_crc_t expected_crc = rc_crc_calculate((const uint8_t *)packet, crc_len);
+    rc_crc_t received_crc = crc_load((const uint8_t *)packet + packet_crc_offset(rx_payload_len));
+
+    if (received_crc != expected_crc) {
+        RC_LOG_WARN("CRC mismatch: expected 0x%04X, got 0x%04X\n",
+                   expected_crc, received_crc);
+#if RC_ENABLE_STATISTICS
+        link->stats.crc_errors++;
+#endif
+        TRACE_RECORD(link, RC_TRACE_RX_DROP, RC_ERROR_CRC_FAIL, packet->header.type, 0,
+                     packet->header.sequence);
+        return RC_ERROR_CRC_FAIL;
+    }
+
+    /* Validate version */
+    if (packet->header.version != RC_PROTOCOL_VERSION) {
+        RC_LOG_WARN("Version mismatch: expected %d, got %d\n",
+                   RC_PROTOCOL_VERSION, packet->header.version);
+#if RC_ENABLE_STATISTICS
+        link->stats.version_mismatches++;
+#endif
+        TRACE_RECORD(link, RC_TRACE_RX_DROP, RC_ERROR_VERSION_MISMATCH, packet->header.type, 0,
+                     packet->header.sequence);
+        return RC_ERROR_VERSION_MISMATCH;
+    }
+
+#if RC_ENABLE_NO_ACK
+    /* Another copy of the frame read last; a sequence reused after a failed
+     * send carries new contents, so its CRC differs */
+    if (link->last_rx_time != UINT32_MAX && packet->header.sequence == link->rx_sequence_last &&
+        received_crc == link->rx_last_crc) {
+#if RC_ENABLE_STATISTICS
+        link->stats.no_ack_duplicates++;
+#endif
+        return RC_ERROR_NO_DATA;
+    }
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+    adapt_on_rx(link);
+#endif
+
+#if RC_ENABLE_BIND
+    /* Bind frames end here, and nothing else counts on the bind channel */
+    if (BIND_RUNNING(link) || packet->header.type == RC_PKT_BIND) {
+        bind_on_rx(link, packet);
+        return RC_ERROR_NO_DATA;
+    }
+#endif
+
+#if RC_ENABLE_FHSS
+    /* Every valid ground frame clocks the hop sequence; maps end here */
+    if (link->role == RC_ROLE_AIRCRAFT && fhss_on_rx(link)) {
+        return RC_ERROR_NO_DATA;
+    }
+#endif
+
+#if RC_ENABLE_CLOCK_SYNC && RC_ENABLE_ACK_TELEMETRY
+    /* A ground frame heard after the echo was queued took it on its ACK */
+    if (link->sync_on_ack && (int32_t)(link->rx_us - link->sync_ack_us) > 0) {
+        link->sync_on_ack = false;
+    }
+#endif
+
+#if RC_ENABLE_CLOCK_SYNC
+    /* Pings and echoes end here */
+    if (packet->header.type == RC_PKT_HEARTBEAT) {
+        sync_on_rx(link, packet);
+        return RC_ERROR_NO_DATA;
+    }
+#endif
+
+    /* Check packet type */
+    if (packet->header.type != expected_type) {
+        return RC_ERROR_NO_DATA;
+    }
+
+    /* Check sequence gaps; a packet older than the last one read (it
+     * queued behind another type) neither counts nor rewinds the sequence */
+    uint8_t gap = packet->header.sequence - (uint8_t)(link->rx_sequence_last + 1);
+    bool stale = link->last_rx_time != UINT32_MAX && (int8_t)gap < 0;
+
+    if (link->last_rx_time != UINT32_MAX && !stale) {
+        if (gap > 0) {
+            link->consecutive_missed += gap;
+
+#if RC_ENABLE_STATISTICS
+            link->stats.packets_missed += gap;
+#endif
+
+            RC_LOG_DEBUG("Sequence gap: missed %d packets\n", gap);
+        } else {
+            link->consecutive_missed = 0;
+        }
+
+#if RC_ENABLE_REACQUIRE
+        /* This frame ends the outage: the frames it took are not a new
+         * loss, whether or not the timeout already declared one */
+        if (!link->link_active || gap >= RC_LINK_LOSS_THRESHOLD) {
+            link->consecutive_missed = 0;
+        }
+#endif
+    }
+
+    TRACE_RECORD(link, RC_TRACE_RX, RC_OK, packet->header.type,
+                 (link->last_rx_time == UINT32_MAX || stale) ? 0 : (gap < 15 ? gap : 15),
+                 packet->header.sequence);
+
+    if (!stale) {
+        lq_on_packet(link, link->last_rx_time != UINT32_MAX ? gap : 0);
+        link->rx_sequence_last = packet->header.sequence;
+#if RC_ENABLE_NO_ACK
+        link->rx_last_crc = received_crc;
+#endif
+    }
+
+    rc_status_t status = RC_OK;
+
+#if RC_ENABLE_TIERED_COMMAND
+    if (expected_type == RC_PKT_COMMAND) {
+        /* A pool entry, ours until freed: rebuilt in place, so every
+         * reader below sees a full command */
+        status = tier_expand(link, &link->rx_pool[packet - link->rx_pool]);
+    }
+#endif
+
+#if RC_ENABLE_BULK
+    if (expected_type == RC_PKT_BULK) {
+        bulk_on_rx(link, packet);
+    } else if (expected_type == RC_PKT_COMMAND || expected_type == RC_PKT_CHANNELS) {
+        bulk_on_control(link);  /* The aircraft's gap opens as the ground's does */
+    }
+#endif
+
+    /* Copy payload */
+    if (status == RC_OK && payload && payload_len) {
+        *payload_len = packet->header.payload_len;
+        if (*payload_len > 0) {
+            memcpy(payload, packet->payload, *payload_len);
+        }
+    }
+
+    record_frame(link);
+
+    return status;
+}
+
+#if RC_ENABLE_FHSS
+static void fhss_reset(rc_link_t *link, uint32_t bind_id)
+{
+    link->fhss_bind_id = bind_id;
+    memset(link->hop_blacklist, 0, sizeof(link->hop_blacklist));
+    memset(link->hop_stats, 0, sizeof(link->hop_stats));
+    rc_fhss_build_table(link->hop_table[0], bind_id, NULL);
+
+    link->hop_valid = 0x01;
+    link->hop_gen = 0;
+    link->hop_slot = 0;
+    link->hop_staged = false;
+    link->hop_synced = false;
+    link->hop_pending = false;
+    link->hop_missed = 0;
+    link->hop_scan = 0;
+    link->hop_dwell_start = link->hw.get_tick_ms();
+
+    nrf24_hop(link->radio, link->hop_table[0][0]);
+}
+
+static void fhss_switch(rc_link_t *link, uint8_t gen)
+{
+    /* Statistics follow the channel, not the slot */
+    for (uint8_t slot = 0; slot < RC_FHSS_HOP_COUNT; slot++) {
+        if (link->hop_table[gen][slot] != link->hop_table[link->hop_gen][slot]) {
+            link->hop_stats[slot].good = 0;
+            link->hop_stats[slot].lost = 0;
+        }
+    }
+
+    link->hop_gen = gen;
+}
+
+static uint8_t fhss_select(rc_link_t *link, uint8_t sequence)
+{
+    if (link->hop_staged && (int8_t)(sequence - link->hop_apply_seq) >= 0) {
+        /* Ground only switches once it knows the aircraft has the table */
+        if (link->role == RC_ROLE_AIRCRAFT || link->hop_staged_acked) {
+            fhss_switch(link, link->hop_gen ^ 1);
+            RC_LOG_INFO("FHSS switched to table %d\n", link->hop_gen);
+        } else {
+            RC_LOG_WARN("FHSS hop map not acknowledged - dropped\n");
+        }
+
+        link->hop_staged = false;
+    }
+
+    link->hop_slot = sequence % RC_FHSS_HOP_COUNT;
+    return link->hop_table[link->hop_gen][link->hop_slot];
+}
+
+static uint8_t fhss_tx_channel(rc_link_t *link)
+{
+    /* Aircraft answers on the channel it heard the ground on */
+    if (link->role == RC_ROLE_AIRCRAFT) {
+        return link->radio->channel;
+    }
+
+#if RC_ENABLE_BIND
+    if (BIND_RUNNING(link)) {
+        return RC_BIND_CHANNEL;
+    }
+#endif
+
+    return fhss_select(link, link->tx_sequence);
+}
+
+static bool fhss_retune(rc_link_t *link, uint8_t channel)
+{
+#if RC_ENABLE_IRQ
+    if (link->radio->tx_busy || !bus_try_acquire(link)) {
+        return false;  /* Retry on the next update */
+    }
+
+    nrf24_hop(link->radio, channel);
+    bus_release(link);
+#else
+    nrf24_hop(link->radio, channel);
+#endif
+
+    return true;
+}
+
+static void fhss_after_tx(rc_link_t *link, bool delivered)
+{
+    if (BIND_RUNNING(link)) {
+        return;  /* Not on the hop table */
+    }
+
+    if (link->role == RC_ROLE_GROUND) {
+        if (delivered) {
+            link->hop_stats[link->hop_slot].good++;
+
+            if (link->hop_staged && link->tx_packet.header.type == RC_PKT_HOP_MAP) {
+                link->hop_staged_acked = true;
+            }
+        } else {
+            link->hop_stats[link->hop_slot].lost++;
+        }
+        return;
+    }
+
+    /* Aircraft: telemetry is out, no need to wait for the hop delay.
+     * Called with the bus held (or from the polling path). */
+    if (link->hop_synced && link->hop_pending) {
+        nrf24_hop(link->radio, fhss_select(link, link->hop_expected));
+        link->hop_pending = false;
+    }
+}
+
+static bool fhss_on_rx(rc_link_t *link)
+{
+    const rc_packet_header_t *header = &link->rx_packet->header;
+    uint8_t gen = (header->flags & RC_FLAG_HOP_GEN) ? 1 : 0;
+
+    /* Follow the ground onto the other table if we have it */
+    if (gen != link->hop_gen && (link->hop_valid & (1u << gen))) {
+        fhss_switch(link, gen);
+        link->hop_staged = false;
+    }
+
+    link->hop_stats[header->sequence % RC_FHSS_HOP_COUNT].good++;
+#if RC_ENABLE_REACQUIRE
+    link->hop_heard = link->hw.get_tick_ms();
+#endif
+#if !RC_ENABLE_TDMA
+    /* With TDMA the slot timer owns hop timing (fhss_frame_tick()). A frame
+     * that sat in the RX ring behind newer ones must not rewind it. */
+    if (!link->hop_synced || (int8_t)(header->sequence + 1 - link->hop_expected) >= 0) {
+        link->hop_synced = true;
+        link->hop_pending = true;
+        link->hop_missed = 0;
+        link->hop_expected = header->sequence + 1;
+        link->hop_rx_time = link->hw.get_tick_ms();
+    }
+#endif
+
+    if (header->type != RC_PKT_HOP_MAP) {
+        return false;
+    }
+
+    if (header->payload_len == sizeof(rc_fhss_map_payload_t)) {
+        const rc_fhss_map_payload_t *map = (const rc_fhss_map_payload_t *)link->rx_packet->payload;
+        uint8_t map_gen = map->generation & 1;
+
+        memcpy(link->hop_blacklist[map_gen], map->blacklist, RC_FHSS_MAP_BYTES);
+        rc_fhss_build_table(link->hop_table[map_gen], link->fhss_bind_id, map->blacklist);
+        link->hop_valid |= (uint8_t)(1u << map_gen);
+
+        if (map_gen == gen) {
+            /* Refresh of the table the ground is on */
+            fhss_switch(link, gen);
+            link->hop_staged = false;
+        } else {
+            link->hop_apply_seq = map->apply_sequence;
+            link->hop_staged = true;
+        }
+
+        RC_LOG_DEBUG("Hop map received (gen=%d)\n", map_gen);
+    }
+
+    /* Not a gap in the command stream */
+    link->rx_sequence_last = header->sequence;
+    return true;
+}
+
+static void fhss_service(rc_link_t *link)
+{
+    if (link->role != RC_ROLE_AIRCRAFT || BIND_RUNNING(link)) {
+        return;
+    }
+
+    uint32_t now = link->hw.get_tick_ms();
+
+    if (!link->hop_synced) {
+        /* Dwell on one slot long enough for the ground to come past, then
+         * move on in case that channel is jammed; alternate tables each pass */
+        if (now - link->hop_dwell_start >= RC_FHSS_DWELL_MS) {
+            uint8_t other = link->hop_gen ^ 1;
+
+            link->hop_scan = (link->hop_scan + 1) % RC_FHSS_HOP_COUNT;
+            if (link->hop_scan == 0 && (link->hop_valid & (1u << other))) {
+                fhss_switch(link, other);
+            }
+
+            if (fhss_retune(link, link->hop_table[link->hop_gen][link->hop_scan])) {
+                link->hop_dwell_start = now;
+            }
+        }
+        return;
+    }
+
+#if !RC_ENABLE_TDMA
+    /* Flywheel: the expected frame never came, hop on schedule anyway */
+    if (now - link->hop_rx_time >= RC_FHSS_FRAME_MS + RC_FHSS_FRAME_MS / 2) {
+        link->hop_stats[link->hop_expected % RC_FHSS_HOP_COUNT].lost++;
+        link->hop_expected++;
+        link->hop_rx_time += RC_FHSS_FRAME_MS;
+        link->hop_pending = true;
+
+        if (link->hop_missed < UINT8_MAX) {
+            link->hop_missed++;
+        }
+
+        if (link->hop_missed >= RC_FHSS_SYNC_LOSS_HOPS && !fhss_coasting(link, now)) {
+            link->hop_synced = false;
+            link->hop_pending = false;
+            link->hop_scan = link->hop_expected % RC_FHSS_HOP_COUNT;
+            link->hop_dwell_start = now;
+            fhss_retune(link, link->hop_table[link->hop_gen][link->hop_scan]);
+
+            RC_LOG_WARN("FHSS sync lost - scanning\n");
+            return;
+        }
+    }
+
+    if (link->hop_pending && (now - link->hop_rx_time) >= RC_FHSS_HOP_DELAY_MS) {
+        uint8_t channel = fhss_select(link, link->hop_expected);
+
+        if (fhss_retune(link, channel)) {
+            link->hop_pending = false;
+        }
+    }
+#endif
+}
+
+#if RC_ENABLE_TDMA
+static void fhss_frame_tick(rc_link_t *link, bool defer_hop)
+{
+    if (!link->hop_synced) {
+        return;  /* fhss_service() is scanning */
+    }
+
+    if (link->tdma_rx_frame) {
+        link->hop_missed = 0;
+    } else {
+        /* Flywheel: keep hopping with the ground's schedule */
+        link->hop_stats[link->tdma_frame % RC_FHSS_HOP_COUNT].lost++;
+
+        if (link->hop_missed < UINT8_MAX) {
+            link->hop_missed++;
+        }
+
+        if (link->hop_missed >= RC_FHSS_SYNC_LOSS_HOPS &&
+            !fhss_coasting(link, link->hw.get_tick_ms())) {
+            link->hop_synced = false;
+            link->hop_pending = false;
+            link->hop_scan = (uint8_t)(link->tdma_frame + 1) % RC_FHSS_HOP_COUNT;
+            link->hop_dwell_start = link->hw.get_tick_ms();
+            fhss_retune(link, link->hop_table[link->hop_gen][link->hop_scan]);
+            return;
+        }
+    }
+
+    link->hop_expected = link->tdma_frame + 1;
+
+    if (defer_hop) {
+        link->hop_pending = true;  /* fhss_after_tx() hops */
+        return;
+    }
+
+    link->hop_pending = !fhss_retune(link, fhss_select(link, link->hop_expected));
+}
+#endif
+
+static bool fhss_coasting(const rc_link_t *link, uint32_t now)
+{
+#if RC_ENABLE_REACQUIRE
+    /* The ground has most likely hopped on as well: stay in step with it */
+    return now - link->hop_heard < RC_REACQUIRE_COAST_MS;
+#else
+    (void)link;
+    (void)now;
+    return false;
+#endif
+}
+#endif
+
+#if RC_ENABLE_BIND
+static void bind_load(rc_link_t *link, uint8_t *address)
+{
+    rc_bind_info_t info;
+
+    if (!link->hw.bind_load || !link->hw.bind_load(&info, link->hw.bind_ctx)) {
+        return;
+    }
+
+    if (!rc_bind_valid(&info)) {
+        RC_LOG_WARN("Stored bind pair invalid - unbound\n");
+        return;
+    }
+
+    link->bind_info = info;
+    link->bind_state = RC_BIND_BOUND;
+    memcpy(address, info.address, RC_BIND_ADDRESS_SIZE);
+}
+
+static bool bind_switch(rc_link_t *link, rc_bind_state_t state)
+{
+    static const uint8_t bind_address[RC_BIND_ADDRESS_SIZE] = RC_BIND_ADDRESS;
+    static const uint8_t default_address[RC_BIND_ADDRESS_SIZE] = RC_RF_ADDRESS;
+
+    const uint8_t *address = (state == RC_BIND_RUNNING) ? bind_address :
+                             (state == RC_BIND_BOUND) ? link->bind_info.address :
+                                                        default_address;
+
+#if RC_ENABLE_IRQ
+    if (link->radio->tx_busy || !bus_try_acquire(link)) {
+        return false;  /* Retry on the next update */
+    }
+#endif
+
+    link->bind_state = state;
+
+    /* Auto-ACK needs pipe 0 on the TX address */
+    nrf24_set_addresses(link->radio, address, address);
+#if RC_ENABLE_FHSS
+    if (state == RC_BIND_RUNNING) {
+        nrf24_hop(link->radio, RC_BIND_CHANNEL);
+    } else {
+        /* From the first slot of the pair's table; the aircraft rescans */
+        fhss_reset(link, state == RC_BIND_BOUND ? link->bind_info.hop_seed : link->fhss_bind_id);
+    }
+#else
+    nrf24_hop(link->radio, state == RC_BIND_RUNNING ? RC_BIND_CHANNEL : RC_RF_CHANNEL);
+#endif
+#if RC_ENABLE_DIVERSITY
+    if (link->diversity.initialized) {
+        nrf24_set_addresses(&link->diversity, address, address);
+        nrf24_hop(&link->diversity, link->radio->channel);
+    }
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+    adapt_reset(link);  /* Both ends meet on the home profile */
+#endif
+
+#if RC_ENABLE_IRQ
+    bus_release(link);
+#endif
+
+    return true;
+}
+
+static void bind_on_rx(rc_link_t *link, const rc_packet_t *packet)
+{
+    if (!BIND_RUNNING(link) || packet->header.type != RC_PKT_BIND ||
+        packet->header.payload_len != sizeof(rc_bind_payload_t)) {
+        return;  /* Left over from before, or another link's traffic */
+    }
+
+    const rc_bind_payload_t *bind = (const rc_bind_payload_t *)packet->payload;
+    rc_bind_info_t info;
+
+    memcpy(info.address, bind->address, RC_BIND_ADDRESS_SIZE);
+    info.hop_seed = bind->hop_seed;
+
+    if (!rc_bind_valid(&info)) {
+        return;
+    }
+
+    bool same = memcmp(info.address, link->bind_offer.address, RC_BIND_ADDRESS_SIZE) == 0 &&
+                info.hop_seed == link->bind_offer.hop_seed;
+
+    if (link->role == RC_ROLE_AIRCRAFT && bind->phase == RC_BIND_OFFER) {
+        /* Bound to the first ground heard, even if another one starts up */
+        if (!link->bind_heard || same) {
+            link->bind_offer = info;
+            link->bind_heard = true;
+            link->bind_reply = true;
+            link->bind_last = link->hw.get_tick_ms();
+        }
+    } else if (link->role == RC_ROLE_GROUND && bind->phase == RC_BIND_ACCEPT && same) {
+        link->bind_heard = true;
+    }
+}
+
+static void bind_service(rc_link_t *link)
+{
+    if (!BIND_RUNNING(link)) {
+        return;
+    }
+
+    uint32_t now = link->hw.get_tick_ms();
+    bool ground = (link->role == RC_ROLE_GROUND);
+
+    /* Offers and answers are taken as they are read, in bind_on_rx() */
+    receive_and_decode(link, RC_PKT_BIND, NULL, NULL, NULL);
+
+    /* The ground is done once answered; the aircraft once the offers
+     * stop, which means the ground has its answer */
+    if (link->bind_heard &&
+        (ground || (!link->bind_reply && now - link->bind_last >= RC_BIND_SETTLE_MS))) {
+        link->bind_info = link->bind_offer;
+
+        if (bind_switch(link, RC_BIND_BOUND)) {
+            if (link->hw.bind_save) {
+                link->hw.bind_save(&link->bind_info, link->hw.bind_ctx);
+            }
+            RC_LOG_INFO("Bound after %lu ms\n", (unsigned long)(now - link->bind_start));
+        }
+        return;
+    }
+
+    if (RC_BIND_TIMEOUT_MS > 0 && now - link->bind_start >= RC_BIND_TIMEOUT_MS) {
+        if (bind_switch(link, link->bind_prev)) {
+            RC_LOG_WARN("Bind timed out\n");
+        }
+        return;
+    }
+
+#if RC_ENABLE_ACK_TELEMETRY
+    if (ground ? (now - link->bind_last < RC_BIND_INTERVAL_MS) : !link->bind_reply) {
+        return;
+    }
+#else
+    /* The aircraft answers between offers, once the ground is listening */
+    if (now - link->bind_last < (ground ? RC_BIND_INTERVAL_MS : RC_BIND_INTERVAL_MS / 2) ||
+        (!ground && !link->bind_reply)) {
+        return;
+    }
+#endif
+
+    rc_bind_payload_t payload;
+    payload.phase = ground ? RC_BIND_OFFER : RC_BIND_ACCEPT;
+    memcpy(payload.address, link->bind_offer.address, RC_BIND_ADDRESS_SIZE);
+    payload.hop_seed = link->bind_offer.hop_seed;
+
+#if RC_ENABLE_ACK_TELEMETRY
+    /* The aircraft's answer rides back on the ACK of the next offer */
+    rc_status_t status = ground ? encode_and_send(link, RC_PKT_BIND, &payload, sizeof(payload)) :
+                                  queue_ack_payload(link, RC_PKT_BIND, &payload, sizeof(payload));
+#else
+    rc_status_t status = encode_and_send(link, RC_PKT_BIND, &payload, sizeof(payload));
+#endif
+
+    if (status == RC_OK) {
+        tx_sent(link);
+    }
+
+    /* Undelivered is fine: the ground offers again, the aircraft answers that */
+    if (status != RC_ERROR_BUSY) {
+        if (ground) {
+            link->bind_last = now;
+        } else {
+            link->bind_reply = false;
+        }
+    }
+}
+#endif
+
+#if RC_ENABLE_CLOCK_SYNC
+static void sync_tx_start(rc_link_t *link)
+{
+    /* Only the send that armed it: a TDMA repeat is not timed again */
+    if (link->sync_state == RC_SYNC_ARMED && link->tx_packet.header.type == RC_PKT_HEARTBEAT) {
+        link->sync_t1 = link_tick_us(link);
+        link->sync_state = RC_SYNC_SENT;
+    }
+}
+
+static void sync_after_tx(rc_link_t *link, bool delivered, uint32_t done_us)
+{
+    if (link->sync_state != RC_SYNC_SENT) {
+        return;
+    }
+
+    if (!delivered) {
+        link->sync_state = RC_SYNC_IDLE;  /* The aircraft may echo it, but the round trip is unknown */
+        return;
+    }
+
+    link->sync_rtt = done_us - link->sync_t1;
+    link->sync_state = RC_SYNC_ACKED;
+
+#if RC_ENABLE_STATISTICS
+    link->stats.sync_rtt_last_us = link->sync_rtt;
+#endif
+}
+
+static void sync_on_rx(rc_link_t *link, const rc_packet_t *packet)
+{
+    rc_sync_payload_t sync;
+
+    if (packet->header.payload_len != sizeof(sync)) {
+        return;
+    }
+    memcpy(&sync, packet->payload, sizeof(sync));
+
+    /* Sent in place of a command or telemetry frame: not a gap */
+    if (link->last_rx_time == UINT32_MAX ||
+        (int8_t)(packet->header.sequence - link->rx_sequence_last) > 0) {
+        link->rx_sequence_last = packet->header.sequence;
+    }
+
+    if (link->role == RC_ROLE_AIRCRAFT && sync.phase == RC_SYNC_PING) {
+        /* A copy (retransmit or TDMA repeat) would echo a later stamp */
+        if (link->sync_heard && sync.id == link->sync_id) {
+            return;
+        }
+
+        link->sync_heard = true;
+        link->sync_id = sync.id;
+        link->sync_echo.phase = RC_SYNC_ECHO;
+        link->sync_echo.id = sync.id;
+        link->sync_echo.rx_us = link->rx_us;
+        link->sync_reply = true;
+    } else if (link->role == RC_ROLE_GROUND && sync.phase == RC_SYNC_ECHO &&
+               link->sync_state == RC_SYNC_ACKED && sync.id == link->sync_id) {
+        /* Assumes the ping reached the aircraft half way through the round trip */
+        int32_t offset = (int32_t)(sync.rx_us - (link->sync_t1 + link->sync_rtt / 2));
+
+        rc_sync_add(&link->sync_filter, link->sync_rtt, offset);
+        link->sync_state = RC_SYNC_IDLE;
+
+#if RC_ENABLE_STATISTICS
+        link->stats.sync_samples++;
+        rc_sync_estimate(&link->sync_filter, &link->stats.sync_rtt_us, &link->stats.sync_offset_us);
+#endif
+    }
+}
+
+static void sync_service(rc_link_t *link)
+{
+    if (BIND_RUNNING(link)) {
+        return;
+    }
+
+    if (link->role == RC_ROLE_GROUND) {
+        /* Take the echo in even if nothing reads telemetry */
+        if (link->sync_state == RC_SYNC_ACKED) {
+            receive_and_decode(link, RC_PKT_HEARTBEAT, NULL, NULL, NULL);
+        }
+        return;
+    }
+
+    if (!link->sync_reply) {
+        return;
+    }
+
+#if RC_ENABLE_ACK_TELEMETRY
+    /* Rides back on the ACK of the next ground frame, ahead of telemetry */
+    rc_status_t status = queue_ack_payload(link, RC_PKT_HEARTBEAT, &link->sync_echo,
+                                           sizeof(link->sync_echo));
+    if (status == RC_OK) {
+        link->sync_on_ack = true;
+        link->sync_ack_us = link_tick_us(link);
+    }
+#else
+    rc_status_t status = encode_and_send(link, RC_PKT_HEARTBEAT, &link->sync_echo,
+                                         sizeof(link->sync_echo));
+#endif
+
+    if (status == RC_OK) {
+        tx_sent(link);
+    }
+
+    /* Undelivered is fine: the next ping gives another sample */
+    if (status != RC_ERROR_BUSY) {
+        link->sync_reply = false;
+    }
+}
+#endif
+
+#if RC_ENABLE_LINK_ADAPT
+static void adapt_reset(rc_link_t *link)
+{
+    uint32_t now = link->hw.get_tick_ms();
+
+    link->adapt_profile = RC_ADAPT_HOME;
+    link->adapt_radio = RC_ADAPT_PROFILES;  /* Forces the first apply */
+    link->adapt_staged = false;
+    link->adapt_window = 0;
+    link->adapt_filled = 0;
+    link->adapt_quality = 0;
+    link->adapt_rx_valid = false;
+    link->adapt_switch_time = now;
+    link->adapt_hold_until = now;
+    link->adapt_backoff = 0;
+    link->adapt_probing = false;
+    link->adapt_contact_time = now;
+
+    adapt_apply(link);
+}
+
+static void adapt_switch(rc_link_t *link, uint8_t profile)
+{
+    if (profile == link->adapt_profile) {
+        return;
+    }
+
+    uint32_t now = link->hw.get_tick_ms();
+
+    if (profile > link->adapt_profile) {
+        link->adapt_prev = link->adapt_profile;
+        link->adapt_probing = true;
+    } else {
+        /* A faster profile that did not last is tried again less often */
+        if (link->adapt_probing) {
+            if (link->adapt_backoff < RC_ADAPT_MAX_BACKOFF) {
+                link->adapt_backoff++;
+            }
+        } else {
+            link->adapt_backoff = 0;
+        }
+        link->adapt_hold_until = now + ((uint32_t)RC_ADAPT_HOLD_MS << link->adapt_backoff);
+        link->adapt_probing = false;
+    }
+
+    link->adapt_profile = profile;
+    link->adapt_switch_time = now;
+
+    /* Attempts on the old profile say nothing about the new one */
+    link->adapt_window = 0;
+    link->adapt_filled = 0;
+
+#if RC_ENABLE_STATISTICS
+    link->stats.profile_switches++;
+#endif
+
+    RC_LOG_INFO("Link profile %d (rate=%d, pwr=%d)\n", profile,
+                adapt_profiles[profile].rate, adapt_profiles[profile].power);
+}
+
+static void adapt_stage(rc_link_t *link, uint8_t profile)
+{
+    link->adapt_target = profile;
+    link->adapt_apply_seq = link->tx_sequence + RC_ADAPT_LEAD;
+    link->adapt_staged_acked = false;
+    link->adapt_staged = true;
+
+    RC_LOG_DEBUG("Link profile %d staged (attempts %d%%, apply at seq=%d)\n",
+                 profile, link->adapt_quality, link->adapt_apply_seq);
+}
+
+static void adapt_select(rc_link_t *link)
+{
+    if (link->role != RC_ROLE_GROUND || !link->adapt_staged ||
+        (int8_t)(link->tx_sequence - link->adapt_apply_seq) < 0) {
+        return;
+    }
+
+    /* Ground only switches once it knows the aircraft will follow */
+    if (link->adapt_staged_acked) {
+        adapt_switch(link, link->adapt_target);
+    } else {
+        RC_LOG_WARN("Link profile switch not acknowledged - dropped\n");
+    }
+
+    link->adapt_staged = false;
+}
+
+static void adapt_apply(rc_link_t *link)
+{
+    if (link->adapt_radio == link->adapt_profile) {
+        return;
+    }
+
+    const rc_adapt_profile_t *profile = &adapt_profiles[link->adapt_profile];
+    uint8_t delay = profile->retransmit_delay > RC_AUTO_RETRANSMIT_DELAY ?
+                    profile->retransmit_delay : RC_AUTO_RETRANSMIT_DELAY;
+
+    nrf24_set_rf(link->radio, profile->rate, profile->power);
+    nrf24_set_auto_retransmit(link->radio, delay, RC_AUTO_RETRANSMIT_COUNT);
+    link->adapt_radio = link->adapt_profile;
+
+    TRACE_RECORD(link, RC_TRACE_MODE, RC_OK, 0, link->adapt_profile, 0);
+}
+
+static uint8_t adapt_flags(rc_link_t *link)
+{
+    uint8_t profile = link->adapt_profile;
+    uint8_t countdown = 0;
+
+    if (link->role == RC_ROLE_GROUND && link->adapt_staged) {
+        profile = link->adapt_target;
+        countdown = (uint8_t)(link->adapt_apply_seq - link->tx_sequence);
+    }
+
+    return (uint8_t)((profile << RC_FLAG_PROFILE_SHIFT) & RC_FLAG_PROFILE_MASK) |
+           (uint8_t)((countdown << RC_FLAG_SWITCH_SHIFT) & RC_FLAG_SWITCH_MASK);
+}
+
+static void adapt_after_tx(rc_link_t *link, bool delivered, uint8_t retries)
+{
+    if (link->role != RC_ROLE_GROUND) {
+        /* Aircraft: a switch heard mid-telemetry waits for the radio (bus
+         * held here, or the polling path) */
+        if (!link->radio->tx_busy) {
+            adapt_apply(link);
+        }
+        return;
+    }
+
+    /* One bit per attempt: each retransmit was a miss */
+    link->adapt_quality = window_push(&link->adapt_window, &link->adapt_filled,
+                                      retries, delivered);
+
+    if (!delivered) {
+        return;
+    }
+
+    link->adapt_contact_time = link->hw.get_tick_ms();
+
+    uint8_t flags = link->tx_packet.header.flags;
+    if (link->adapt_staged && (flags & RC_FLAG_SWITCH_MASK) &&
+        ((flags & RC_FLAG_PROFILE_MASK) >> RC_FLAG_PROFILE_SHIFT) == link->adapt_target) {
+        link->adapt_staged_acked = true;
+    }
+}
+
+static void adapt_on_rx(rc_link_t *link)
+{
+    const rc_packet_header_t *header = &link->rx_packet->header;
+
+    link->adapt_contact_time = link->hw.get_tick_ms();
+
+    if (link->role != RC_ROLE_AIRCRAFT) {
+        return;
+    }
+
+    /* A frame that sat in the RX ring behind newer ones is out of date */
+    if (link->adapt_rx_valid && (int8_t)(header->sequence - link->adapt_rx_seq) <= 0) {
+        return;
+    }
+
+    link->adapt_rx_valid = true;
+    link->adapt_rx_seq = header->sequence;
+
+    uint8_t profile = (header->flags & RC_FLAG_PROFILE_MASK) >> RC_FLAG_PROFILE_SHIFT;
+    uint8_t countdown = (header->flags & RC_FLAG_SWITCH_MASK) >> RC_FLAG_SWITCH_SHIFT;
+
+    if (countdown == 0) {
+        /* Heard the ground on its current profile: only power can differ */
+        adapt_switch(link, profile);
+        link->adapt_staged = false;
+    } else if (profile != link->adapt_profile) {
+        link->adapt_target = profile;
+        link->adapt_apply_seq = header->sequence + countdown;
+        link->adapt_staged = true;
+    } else {
+        link->adapt_staged = false;
+    }
+
+    /* The ground's next frame goes out on the new profile */
+    if (link->adapt_staged && (int8_t)(header->sequence + 1 - link->adapt_apply_seq) >= 0) {
+        adapt_switch(link, link->adapt_target);
+        link->adapt_staged = false;
+    }
+
+    /* Bus held here with RC_ENABLE_IRQ; a running TX finishes first */
+    if (!link->radio->tx_busy) {
+        adapt_apply(link);
+    }
+}
+
+static void adapt_service(rc_link_t *link)
+{
+    uint32_t now = link->hw.get_tick_ms();
+    uint32_t silent = now - link->adapt_contact_time;
+
+    if (link->adapt_probing && now - link->adapt_switch_time >= RC_ADAPT_HOLD_MS) {
+        link->adapt_probing = false;
+    }
+
+    if (link->adapt_profile != RC_ADAPT_HOME && silent > RC_ADAPT_FALLBACK_MS) {
+        /* Both ends end up here when a switch goes wrong or the link dies:
+         * back to where a fresh step up came from, else all the way home */
+        adapt_switch(link, link->adapt_probing ? link->adapt_prev : RC_ADAPT_HOME);
+        link->adapt_staged = false;
+        link->adapt_rx_valid = false;
+        link->adapt_contact_time = now;  /* Full period on the fallback too */
+        RC_LOG_WARN("Link profile fallback after %lu ms\n", (unsigned long)silent);
+    } else if (link->role == RC_ROLE_AIRCRAFT) {
+        /* Missed the last frame before the switch: the ground has moved */
+        if (link->adapt_staged && silent > RC_ADAPT_FALLBACK_MS / 2) {
+            adapt_switch(link, link->adapt_target);
+            link->adapt_staged = false;
+        }
+    } else if (!link->adapt_staged && link->adapt_filled >= RC_LQ_WINDOW) {
+        if (link->adapt_quality < RC_ADAPT_LQ_DOWN && link->adapt_profile > RC_ADAPT_HOME) {
+            adapt_stage(link, link->adapt_profile - 1);
+        } else if (link->adapt_quality >= RC_ADAPT_LQ_UP &&
+                   link->adapt_profile < RC_ADAPT_PROFILES - 1 &&
+                   (int32_t)(now - link->adapt_hold_until) >= 0) {
+            adapt_stage(link, link->adapt_profile + 1);
+        }
+    }
+
+    if (link->adapt_radio == link->adapt_profile) {
+        return;
+    }
+
+#if RC_ENABLE_IRQ
+    if (link->radio->tx_busy || !bus_try_acquire(link)) {
+        return;  /* Retry on the next update */
+    }
+
+    adapt_apply(link);
+    bus_release(link);
+#else
+    adapt_apply(link);
+#endif
+}
+#endif
+
+#if RC_ENABLE_BULK
+static void bulk_on_control(rc_link_t *link)
+{
+    /* A new gap opens; whatever the last one left unanswered is lost */
+    link->bulk_waiting = false;
+    link->bulk_grant = 0;
+    rc_bulk_tx_timeout(&link->bulk_tx);
+
+    link->bulk_anchor = link->hw.get_tick_ms();
+    link->bulk_air_us = 0;
+    link->bulk_anchored = true;
+    link->bulk_turn_rx = !link->bulk_turn_rx;  /* Push and pull take turns */
+}
+
+static uint32_t bulk_clock_us(rc_link_t *link, uint32_t now)
+{
+    /* Ticks are whole ms, so the time since the command is anywhere in
+     * (since - 1, since + 1) ms: the gap opens a tick late and the clock
+     * is always taken to be at the later end. The aircraft heard the
+     * command up to a tick after it went out, so counts one more. Frames
+     * booked run the clock ahead of the tick, for the several that go out
+     * within one */
+    uint32_t since = now - link->bulk_anchor;
+    if (link->role == RC_ROLE_AIRCRAFT) {
+        since++;
+    }
+
+    uint32_t end = 1000U / RC_UPDATE_RATE_HZ - RC_BULK_GUARD_MS;
+    if (since < RC_BULK_REPLY_MS + 1 || since + 1 >= end) {
+        return UINT32_MAX;
+    }
+
+    uint32_t clock = (since + 1) * 1000U;
+
+    return clock > link->bulk_air_us ? clock : link->bulk_air_us;
+}
+
+static uint32_t bulk_frame_us(rc_link_t *link, uint8_t payload_len)
+{
+#if RC_DYNAMIC_FRAMES
+    uint8_t frame_len = RC_PACKET_WIRE_LEN(payload_len);
+#else
+    (void)payload_len;
+    uint8_t frame_len = sizeof(rc_packet_t);
+#endif
+
+#if RC_ENABLE_IRQ
+    return NRF24_SETTLE_US + nrf24_airtime_us(link->radio, frame_len);
+#else
+    /* The send settles out of RX first, and rx_poll() back into it */
+    return 3 * NRF24_SETTLE_US + nrf24_airtime_us(link->radio, frame_len);
+#endif
+}
+
+static rc_status_t bulk_send(rc_link_t *link, const uint8_t *payload, uint8_t len)
+{
+    rc_status_t status = encode_and_send(link, RC_PKT_BULK, payload, len);
+
+    if (status == RC_OK) {
+        tx_sent(link);
+    }
+
+    return status;
+}
+
+static void bulk_on_rx(rc_link_t *link, const rc_packet_t *packet)
+{
+    const uint8_t *payload = packet->payload;
+    uint8_t len = packet->header.payload_len;
+    uint32_t now = link->hw.get_tick_ms();
+
+    if (len == 0) {
+        return;
+    }
+
+    if (payload[0] & RC_BULK_ACK) {
+        uint8_t grant = rc_bulk_tx_on_ack(&link->bulk_tx, payload, len, now);
+
+        if (link->role == RC_ROLE_AIRCRAFT) {
+            link->bulk_grant = grant;
+        } else {
+            link->bulk_waiting = false;
+        }
+        return;
+    }
+
+    rc_bulk_state_t before = link->bulk_rx.state;
+
+    if (rc_bulk_rx_on_data(&link->bulk_rx, payload, len, now)) {
+        link->bulk_ack_owed = true;
+    }
+
+    if (link->role == RC_ROLE_AIRCRAFT) {
+        return;
+    }
+
+    /* A granted burst: each segment holds the wait off, the poll ends it */
+    link->bulk_wait_time = now;
+    if (payload[0] & RC_BULK_POLL) {
+        link->bulk_waiting = false;
+    }
+
+    if (before == RC_BULK_ACTIVE && link->bulk_rx.state == RC_BULK_DONE) {
+        link->bulk_linger = RC_BULK_LINGER;  /* The aircraft still needs to hear it */
+    }
+}
+
+static void bulk_service(rc_link_t *link)
+{
+    if (link->bulk_tx.state != RC_BULK_ACTIVE && link->bulk_rx.state == RC_BULK_IDLE) {
+        return;
+    }
+
+    /* Bulk frames are internal and never reach an app reader */
+    while (receive_and_decode(link, RC_PKT_BULK, NULL, NULL, NULL) == RC_OK) {
+    }
+
+#if RC_ENABLE_IRQ
+    if (tx_held(link)) {
+        return;  /* One frame on air at a time; next update */
+    }
+#endif
+
+    if (!link->bulk_anchored) {
+        return;  /* No command yet to time the gaps from */
+    }
+
+    if (link->role == RC_ROLE_AIRCRAFT) {
+        bulk_aircraft_service(link);
+    } else {
+        bulk_ground_service(link);
+    }
+}
+
+static void bulk_ground_service(rc_link_t *link)
+{
+    uint32_t now = link->hw.get_tick_ms();
+
+    if (link->bulk_waiting) {
+        if (now - link->bulk_wait_time < RC_BULK_ACK_TIMEOUT_MS) {
+            return;
+        }
+        link->bulk_waiting = false;
+        rc_bulk_tx_timeout(&link->bulk_tx);
+    }
+
+    uint32_t clock = bulk_clock_us(link, now);
+    uint32_t end = (1000U / RC_UPDATE_RATE_HZ - RC_BULK_GUARD_MS) * 1000U;
+    if (clock >= end) {
+        return;  /* Outside the gap */
+    }
+
+    uint32_t left = end - clock;
+    uint32_t frame_us = bulk_frame_us(link, RC_MAX_PAYLOAD_SIZE);
+    uint32_t ack_us = bulk_frame_us(link, RC_BULK_ACK_LEN);
+    uint8_t frame[RC_MAX_PAYLOAD_SIZE];
+
+    /* A finished pull is acknowledged again once a gap, so one lost ACK
+     * does not leave the aircraft waiting */
+    bool tx_ready = rc_bulk_tx_ready(&link->bulk_tx);
+    bool lingering = link->bulk_rx.state != RC_BULK_ACTIVE && !link->bulk_ack_owed;
+    bool rx_due = link->bulk_ack_owed || link->bulk_rx.state == RC_BULK_ACTIVE ||
+                  (link->bulk_linger > 0 && link->bulk_air_us == 0);
+
+    /* Pull: an ACK granting the aircraft segments; it stops at its own
+     * end of the gap */
+    if (rx_due && (!tx_ready || link->bulk_turn_rx || link->bulk_ack_owed)) {
+        if (left < ack_us) {
+            return;
+        }
+
+        uint8_t grant = 0;
+        if (link->bulk_rx.state == RC_BULK_ACTIVE) {
+            uint32_t room = (left - ack_us) / frame_us;
+            grant = (uint8_t)(room < RC_BULK_WINDOW ? room : RC_BULK_WINDOW);
+            if (grant == 0 && !link->bulk_ack_owed) {
+                return;
+            }
+        }
+
+        uint8_t len = rc_bulk_rx_build_ack(&link->bulk_rx, frame, grant);
+        if (bulk_send(link, frame, len) != RC_OK) {
+            return;
+        }
+
+        link->bulk_ack_owed = false;
+        if (lingering && link->bulk_linger > 0) {
+            link->bulk_linger--;
+        }
+
+        link->bulk_air_us = clock + ack_us;
+        link->bulk_waiting = grant > 0;
+        link->bulk_wait_time = link->hw.get_tick_ms();
+        return;
+    }
+
+    /* Push: a segment, the last that fits with room for the ACK polling */
+    if (!tx_ready || left < frame_us + ack_us) {
+        return;
+    }
+
+    bool poll = left < 2 * frame_us + ack_us;
+    uint8_t len = rc_bulk_tx_build(&link->bulk_tx, frame, poll);
+
+    /* A frame that fails to go out is one lost on air: the next ACK
+     * reports it missing */
+    bulk_send(link, frame, len);
+
+    link->bulk_air_us = clock + frame_us;
+    if (frame[0] & RC_BULK_POLL) {
+        link->bulk_air_us += ack_us;
+        link->bulk_waiting = true;
+        link->bulk_wait_time = link->hw.get_tick_ms();
+    }
+}
+
+static void bulk_aircraft_service(rc_link_t *link)
+{
+    uint8_t frame[RC_MAX_PAYLOAD_SIZE];
+
+    /* Answered straight away: the ground left room for it */
+    if (link->bulk_ack_owed) {
+        uint8_t len = rc_bulk_rx_build_ack(&link->bulk_rx, frame, 0);
+        if (bulk_send(link, frame, len) != RC_ERROR_BUSY) {
+            link->bulk_ack_owed = false;
+        }
+        return;
+    }
+
+    if (link->bulk_grant == 0) {
+        return;
+    }
+
+    /* The grant is a window, not a time: the gap is kept by our own clock */
+    uint32_t clock = bulk_clock_us(link, link->hw.get_tick_ms());
+    uint32_t end = (1000U / RC_UPDATE_RATE_HZ - RC_BULK_GUARD_MS) * 1000U;
+    uint32_t frame_us = bulk_frame_us(link, RC_MAX_PAYLOAD_SIZE);
+
+    if (clock >= end || end - clock < frame_us) {
+        link->bulk_grant = 0;  /* The ground times the wait out */
+        return;
+    }
+
+    bool poll = link->bulk_grant == 1 || end - clock < 2 * frame_us;
+    uint8_t len = rc_bulk_tx_build(&link->bulk_tx, frame, poll);
+    if (len == 0) {
+        link->bulk_grant = 0;
+        return;
+    }
+
+    link->bulk_grant = (frame[0] & RC_BULK_POLL) ? 0 : (uint8_t)(link->bulk_grant - 1);
+    link->bulk_air_us = clock + frame_us;
+    bulk_send(link, frame, len);
+}
+#endif
@@ -0,0 +1,224 @@
+/**
+* @file telemetry_mux.c
+ * @brief Priority-scheduled multiplexed telemetry
+ */
+
+#include "telemetry_mux.h"
+#include <string.h>
+
+/*============================================================================*/
+/* Aircraft Side                                                              */
+/*============================================================================*/
+
+static rc_tlm_item_t *tlm_find(rc_tlm_mux_t *mux, uint8_t id)
+{
+    for (uint8_t i = 0; i < mux->count; i++) {
+        if (mux->items[i].id == id) {
+            return &mux->items[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* How far past its due tick an item is; negative if not due yet */
+static int32_t tlm_lateness(const rc_tlm_item_t *item, uint32_t now_ms)
+{
+    if (!item->sent) {
+        return INT32_MAX;   /* First value goes out as soon as it is set */
+    }
+
+    return (int32_t)(now_ms - item->due_ms);
+}
+
+/* True if a should go into the frame before b */
+static bool tlm_before(const rc_tlm_item_t *a, const rc_tlm_item_t *b, uint32_t now_ms)
+{
+    if (a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+
+    return tlm_lateness(a, now_ms) > tlm_lateness(b, now_ms);
+}
+
+void rc_tlm_mux_init(rc_tlm_mux_t *mux)
+{
+    memset(mux, 0, sizeof(*mux));
+}
+
+bool rc_tlm_register(rc_tlm_mux_t *mux, uint8_t id, uint8_t len,
+                     uint16_t rate_hz, uint8_t priority)
+{
+    if (!mux || mux->count >= RC_TLM_MAX_ITEMS || tlm_find(mux, id)) {
+        return false;
+    }
+
+    if (len == 0 || len > RC_TLM_MAX_ITEM_SIZE || rate_hz == 0 || rate_hz > 1000) {
+        return false;
+    }
+
+    rc_tlm_item_t *item = &mux->items[mux->count++];
+    memset(item, 0, sizeof(*item));
+    item->id = id;
+    item->len = len;
+    item->priority = priority;
+    item->period_ms = (uint16_t)(1000U / rate_hz);
+
+    return true;
+}
+
+bool rc_tlm_set(rc_tlm_mux_t *mux, uint8_t id, const void *data)
+{
+    if (!mux || !data) {
+        return false;
+    }
+
+    rc_tlm_item_t *item = tlm_find(mux, id);
+    if (!item) {
+        return false;
+    }
+
+    memcpy(item->data, data, item->len);
+    item->valid = true;
+
+    return true;
+}
+
+uint8_t rc_tlm_mux_build(rc_tlm_mux_t *mux, uint32_t now_ms, uint8_t *out, uint8_t max_len)
+{
+    if (!mux || !out) {
+        return 0;
+    }
+
+    uint32_t candidates = 0;
+    for (uint8_t i = 0; i < mux->count; i++) {
+        const rc_tlm_item_t *item = &mux->items[i];
+        if (item->valid && tlm_lateness(item, now_ms) >= 0) {
+            candidates |= 1UL << i;
+        }
+    }
+
+    /* Best remaining candidate each round; one that does not fit drops out */
+    uint8_t len = 0;
+    mux->built = 0;
+
+    while (candidates) {
+        int8_t best = -1;
+        for (uint8_t i = 0; i < mux->count; i++) {
+            if ((candidates & (1UL << i)) &&
+                (best < 0 || tlm_before(&mux->items[i], &mux->items[best], now_ms))) {
+                best = (int8_t)i;
+            }
+        }
+
+        const rc_tlm_item_t *item = &mux->items[best];
+        candidates &= ~(1UL << best);
+
+        if (len + RC_TLM_RECORD_HEADER + item->len > max_len) {
+            continue;
+        }
+
+        out[len++] = item->id;
+        out[len++] = item->len;
+        memcpy(&out[len], item->data, item->len);
+        len += item->len;
+        mux->built |= 1UL << best;
+    }
+
+    return len;
+}
+
+void rc_tlm_mux_commit(rc_tlm_mux_t *mux, uint32_t now_ms)
+{
+    if (!mux) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < mux->count; i++) {
+        if (!(mux->built & (1UL << i))) {
+            continue;
+        }
+
+        rc_tlm_item_t *item = &mux->items[i];
+        if (!item->sent || tlm_lateness(item, now_ms) >= (int32_t)item->period_ms) {
+            item->due_ms = now_ms + item->period_ms;
+        } else {
+            item->due_ms += item->period_ms;
+        }
+        item->sent = true;
+    }
+
+    mux->built = 0;
+}
+
+/*============================================================================*/
+/* Ground Side                                                                */
+/*============================================================================*/
+
+void rc_tlm_cache_init(rc_tlm_cache_t *cache)
+{
+    memset(cache, 0, sizeof(*cache));
+}
+
+const rc_tlm_value_t *rc_tlm_cache_get(const rc_tlm_cache_t *cache, uint8_t id)
+{
+    if (!cache) {
+        return NULL;
+    }
+
+    for (uint8_t i = 0; i < cache->count; i++) {
+        if (cache->values[i].id == id) {
+            return &cache->values[i];
+        }
+    }
+
+    return NULL;
+}
+
+uint8_t rc_tlm_cache_decode(rc_tlm_cache_t *cache, const uint8_t *payload,
+                            uint8_t len, uint32_t now_ms)
+{
+    if (!cache || !payload) {
+        return 0;
+    }
+
+    uint8_t pos = 0;
+    uint8_t decoded = 0;
+
+    while (pos < len) {
+        if (len - pos < RC_TLM_RECORD_HEADER ||
+            payload[pos + 1] > len - pos - RC_TLM_RECORD_HEADER) {
+            cache->malformed++;
+            break;
+        }
+
+        uint8_t id = payload[pos];
+        uint8_t value_len = payload[pos + 1];
+        const uint8_t *value = &payload[pos + RC_TLM_RECORD_HEADER];
+        pos += RC_TLM_RECORD_HEADER + value_len;
+
+        if (value_len > RC_TLM_MAX_ITEM_SIZE) {
+            cache->dropped++;
+            continue;
+        }
+
+        rc_tlm_value_t *slot = (rc_tlm_value_t *)rc_tlm_cache_get(cache, id);
+        if (!slot) {
+            if (cache->count >= RC_TLM_MAX_ITEMS) {
+                cache->dropped++;
+                continue;
+            }
+            slot = &cache->values[cache->count++];
+            memset(slot, 0, sizeof(*slot));
+            slot->id = id;
+        }
+
+        memcpy(slot->data, value, value_len);
+        slot->len = value_len;
+        slot->time_ms = now_ms;
+        slot->updates++;
+        decoded++;
+    }
+
+    return decoded;
+}
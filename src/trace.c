@@ -0,0 +1,99 @@
+/**
+* @file trace.c
+ * @brief Binary packet trace ring and wire format
+ */
+
+#include "trace.h"
+#include <string.h>
+
+static const char *const event_names[RC_TRACE_EVENT_COUNT] = {
+    [RC_TRACE_NONE]     = "?",
+    [RC_TRACE_TX]       = "TX",
+    [RC_TRACE_RX]       = "RX",
+    [RC_TRACE_RX_DROP]  = "DROP",
+    [RC_TRACE_MODE]     = "MODE",
+    [RC_TRACE_FAILSAFE] = "FAILSAFE",
+};
+
+/*============================================================================*/
+/* Helpers                                                                    */
+/*============================================================================*/
+
+static void put_le32(uint8_t *out, uint32_t v)
+{
+    out[0] = (uint8_t)v;
+    out[1] = (uint8_t)(v >> 8);
+    out[2] = (uint8_t)(v >> 16);
+    out[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_le32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) |
+           ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+/*============================================================================*/
+/* Ring                                                                       */
+/*============================================================================*/
+
+uint16_t rc_trace_read(rc_trace_t *trace, rc_trace_record_t *out, uint16_t max)
+{
+    uint32_t head = atomic_load_explicit(&trace->head, memory_order_acquire);
+    uint32_t tail = trace->tail;
+
+    /* Fallen more than a ring behind: the oldest are gone */
+    if (head - tail > RC_TRACE_SIZE) {
+        trace->lost += head - tail - RC_TRACE_SIZE;
+        tail = head - RC_TRACE_SIZE;
+    }
+
+    uint32_t n = head - tail;
+    if (n > max) {
+        n = max;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = trace->records[(tail + i) & (RC_TRACE_SIZE - 1)];
+    }
+
+    /* Writers that lapped the copy replaced its front */
+    head = atomic_load_explicit(&trace->head, memory_order_acquire);
+    uint32_t over = 0;
+    if (head - tail > RC_TRACE_SIZE) {
+        over = head - tail - RC_TRACE_SIZE;
+        if (over > n) {
+            over = n;
+        }
+        memmove(out, out + over, (n - over) * sizeof(*out));
+        trace->lost += over;
+    }
+
+    trace->tail = tail + n;
+
+    return (uint16_t)(n - over);
+}
+
+/*============================================================================*/
+/* Wire Format                                                                */
+/*============================================================================*/
+
+void rc_trace_pack(const rc_trace_record_t *record, uint8_t *out)
+{
+    put_le32(out, record->time);
+    put_le32(out + 4, record->info);
+}
+
+bool rc_trace_unpack(const uint8_t *in, rc_trace_record_t *record)
+{
+    record->time = get_le32(in);
+    record->info = get_le32(in + 4);
+
+    uint8_t event = RC_TRACE_EVENT(record->info);
+    return event != RC_TRACE_NONE && event < RC_TRACE_EVENT_COUNT;
+}
+
+const char *rc_trace_event_name(uint8_t event)
+{
+    return event < RC_TRACE_EVENT_COUNT ? event_names[event] : "?";
+}
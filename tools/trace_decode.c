@@ -0,0 +1,217 @@
+/**
+* @file trace_decode.c
+ * @brief Host decoder for packet trace exports
+ *
+ * Reads what rc_link_trace_read() sent over a UART, or what the SWO pin
+ * carried from rc_link_trace_drain_itm(), and prints one line per record:
+ *
+ *   time_us  event  type  seq  ch  count  status
+ *
+ * Times are unwrapped from the 32-bit cycle counter, so they stay right
+ * over long captures as long as no gap between records is longer than
+ * one wrap. A raw byte stream that starts mid-record is resynchronised.
+ *
+ * Usage: trace_decode [-c core_hz] [-i port] [file]
+ *   -c  Core clock the cycle counter ran at (default 72000000)
+ *   -i  Input is ITM/SWO packets; decode stimulus port <port>
+ *   file defaults to stdin
+ */
+
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DECODE_DEFAULT_HZ   72000000UL
+
+/** Highest RF channel; a record claiming more is misaligned */
+#define DECODE_MAX_CHANNEL  125
+
+static const char *const type_names[] = {
+    "-", "COMMAND", "TELEMETRY", "ACK", "HEARTBEAT", "CHANNELS", "HOP_MAP",
+    "TLM_MUX", "BULK", "BIND", "?", "?", "?", "?", "?", "USER",
+};
+
+static const char *const status_names[] = {
+    "OK", "INVALID_PARAM", "TIMEOUT", "NO_DATA", "CRC_FAIL", "VERSION_MISMATCH",
+    "HARDWARE", "NOT_INITIALIZED", "BUSY",
+};
+
+typedef struct {
+    uint8_t pending[RC_TRACE_RECORD_SIZE * 2];
+    size_t filled;
+    uint64_t cycles;            /* Unwrapped time of the last record */
+    uint32_t last;
+    bool started;
+    unsigned long hz;
+    unsigned long records;
+    unsigned long skipped;      /* Bytes dropped to resynchronise */
+} decoder_t;
+
+/*============================================================================*/
+/* Records                                                                    */
+/*============================================================================*/
+
+static bool decode_plausible(const rc_trace_record_t *record)
+{
+    return RC_TRACE_CHANNEL(record->info) <= DECODE_MAX_CHANNEL &&
+           RC_TRACE_STATUS(record->info) < sizeof(status_names) / sizeof(status_names[0]);
+}
+
+static void decode_print(decoder_t *d, const rc_trace_record_t *record)
+{
+    if (d->started) {
+        d->cycles += (uint32_t)(record->time - d->last);
+    } else {
+        d->cycles = record->time;
+        d->started = true;
+    }
+    d->last = record->time;
+
+    uint8_t type = RC_TRACE_TYPE(record->info);
+    uint8_t count = RC_TRACE_COUNT(record->info);
+    char count_text[4];
+
+    if (count == RC_TRACE_COUNT_UNKNOWN && RC_TRACE_EVENT(record->info) == RC_TRACE_TX) {
+        strcpy(count_text, "?");
+    } else {
+        snprintf(count_text, sizeof(count_text), "%u", count);
+    }
+
+    printf("%14.3f  %-8s %-9s %3u %3u %3s  %s\n",
+           (double)d->cycles * 1e6 / (double)d->hz,
+           rc_trace_event_name(RC_TRACE_EVENT(record->info)),
+           type < sizeof(type_names) / sizeof(type_names[0]) ? type_names[type] : "?",
+           RC_TRACE_SEQUENCE(record->info),
+           RC_TRACE_CHANNEL(record->info),
+           count_text,
+           status_names[RC_TRACE_STATUS(record->info)]);
+
+    d->records++;
+}
+
+/* Bytes of the record stream, in order */
+static void decode_bytes(decoder_t *d, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        d->pending[d->filled++] = data[i];
+
+        while (d->filled >= RC_TRACE_RECORD_SIZE) {
+            rc_trace_record_t record;
+
+            if (rc_trace_unpack(d->pending, &record) && decode_plausible(&record)) {
+                decode_print(d, &record);
+                d->filled -= RC_TRACE_RECORD_SIZE;
+                memmove(d->pending, d->pending + RC_TRACE_RECORD_SIZE, d->filled);
+            } else {
+                d->skipped++;
+                d->filled--;
+                memmove(d->pending, d->pending + 1, d->filled);
+            }
+        }
+    }
+}
+
+/*============================================================================*/
+/* ITM / SWO                                                                  */
+/*============================================================================*/
+
+/* Keeps the payload of software packets on one stimulus port; sync,
+ * overflow, timestamp, extension and hardware (DWT) packets are skipped */
+static void decode_itm(decoder_t *d, FILE *in, unsigned port)
+{
+    int c;
+
+    while ((c = fgetc(in)) != EOF) {
+        uint8_t header = (uint8_t)c;
+
+        if ((header & 0x03) == 0) {
+            /* Sync (0x00 ... 0x80), overflow (0x70), timestamp or extension:
+             * continuation bytes follow while bit 7 is set */
+            if (header != 0x00 && header != 0x70 && header != 0x80 && (header & 0x80)) {
+                while ((c = fgetc(in)) != EOF && (c & 0x80)) {
+                }
+            }
+            continue;
+        }
+
+        static const uint8_t sizes[4] = { 0, 1, 2, 4 };
+        uint8_t payload[4];
+        size_t size = sizes[header & 0x03];
+
+        if (fread(payload, 1, size, in) != size) {
+            break;
+        }
+
+        if (!(header & 0x04) && (unsigned)(header >> 3) == port) {
+            decode_bytes(d, payload, size);
+        }
+    }
+}
+
+/*============================================================================*/
+/* Main                                                                       */
+/*============================================================================*/
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-c core_hz] [-i port] [file]\n", name);
+}
+
+int main(int argc, char **argv)
+{
+    decoder_t d;
+    memset(&d, 0, sizeof(d));
+    d.hz = DECODE_DEFAULT_HZ;
+
+    int itm_port = -1;
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            d.hz = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            itm_port = atoi(argv[++i]);
+        } else if (argv[i][0] == '-' || path) {
+            usage(argv[0]);
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    if (d.hz == 0 || itm_port > 31) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE *in = path ? fopen(path, "rb") : stdin;
+    if (!in) {
+        perror(path);
+        return 1;
+    }
+
+    printf("%14s  %-8s %-9s %3s %3s %3s  %s\n",
+           "time_us", "event", "type", "seq", "ch", "cnt", "status");
+
+    if (itm_port >= 0) {
+        decode_itm(&d, in, (unsigned)itm_port);
+    } else {
+        uint8_t chunk[256];
+        size_t n;
+
+        while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+            decode_bytes(&d, chunk, n);
+        }
+    }
+
+    if (in != stdin) {
+        fclose(in);
+    }
+
+    /* A partial record at the end is the capture stopping mid-record */
+    fprintf(stderr, "%lu records, %lu bytes skipped, %zu left over\n",
+            d.records, d.skipped, d.filled);
+
+    return 0;
+}